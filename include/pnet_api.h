@@ -316,6 +316,10 @@ extern "C" {
 #define PNET_ERROR_CODE_2_INVALID_BLOCK_VERSION_HIGH 0x02
 #define PNET_ERROR_CODE_2_INVALID_BLOCK_VERSION_LOW  0x03
 
+/* For PNET_ERROR_CODE_1_CONN_FAULTY_AR_FSU. Missing FSParameterBlock or
+ * reserved FSParameterMode. */
+#define PNET_ERROR_CODE_2_AR_FSU_FS_PARAMETER_MODE 0x04
+
 /**
  * # List of error_code_2 values, for
  * PNET_ERROR_CODE_1_RTA_ERR_CLS_PROTOCOL (not exhaustive).
@@ -1383,6 +1387,26 @@ typedef struct pnet_cfg
    /** Send diagnosis in the qualified format (otherwise extended format) */
    bool use_qualified_diagnosis;
 
+   /** Defer loading of data that is not needed to answer DCP (port data and
+    *  SNMP system data) from pnet_init() to the first call of
+    *  pnet_handle_periodic(), after that call has sent any DCP responses.
+    *  This shortens the time from power-on until the device is reachable.
+    *  SNMP system values are empty and the LLDP peer check is not done
+    *  until the data has been loaded. RPC requests are handled from the
+    *  second call. */
+   bool defer_noncritical_init;
+
+#if PNET_OPTION_FAST_STARTUP
+   /** Fast start-up. Do not forward writes of user specific records
+    *  (index 0..0x7fff) to the application during startup of an AR, if the
+    *  controller sends the same FSParameterUUID as at the latest
+    *  parameterization and the submodule has not been pulled since then.
+    *  Only enable if the application keeps its submodule parameters, also
+    *  over a restart. The FSParameterUUID and the parameterized submodules
+    *  are stored in nvm. */
+   bool fsu_skip_unchanged_parameters;
+#endif
+
    pnet_if_cfg_t if_cfg;
 
 #if PNET_OPTION_DRIVER_ENABLE
@@ -1553,6 +1577,72 @@ PNET_EXPORT int pnet_pull_submodule (
    uint16_t slot,
    uint16_t subslot);
 
+/**
+ * Kind of change in a configuration delta, see \a pnet_apply_config_changes().
+ */
+typedef enum pnet_config_change_type
+{
+   PNET_CONFIG_CHANGE_PLUG_MODULE,
+   PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+   PNET_CONFIG_CHANGE_PULL_SUBMODULE,
+   PNET_CONFIG_CHANGE_PULL_MODULE
+} pnet_config_change_type_t;
+
+/**
+ * One entry in a configuration delta, see \a pnet_apply_config_changes().
+ *
+ * Fields not used by the change type are ignored. Plugging a sub-module uses
+ * all fields, plugging a module uses \a module_ident and pulling uses only the
+ * address fields.
+ */
+typedef struct pnet_config_change
+{
+   pnet_config_change_type_t type;
+   uint32_t api;
+   uint16_t slot;
+   uint16_t subslot;
+   uint32_t module_ident;
+   uint32_t submodule_ident;
+   pnet_submodule_dir_t direction;
+   uint16_t length_input;
+   uint16_t length_output;
+} pnet_config_change_t;
+
+/**
+ * Plug and pull several modules and sub-modules in one operation.
+ *
+ * The whole list is checked against the current configuration before
+ * anything is changed. If any entry is invalid, or if the resulting
+ * configuration would not fit in PNET_MAX_SLOTS / PNET_MAX_SUBSLOTS, no
+ * change is made and -1 is returned.
+ *
+ * The list must be sorted by API and slot number, so that all changes for a
+ * slot are adjacent. The order within a slot does not matter.
+ *
+ * The list is a delta: all pulls are done before all plugs, so a module or
+ * sub-module may be replaced by pulling and plugging the same location in
+ * one call. Each slot may be pulled and plugged at most once and each
+ * sub-slot may be pulled and plugged at most once per call. Plugging a
+ * sub-module that is already plugged with the same ident number is allowed
+ * and has no effect. Sub-modules in a pulled module are pulled implicitly,
+ * so they must not also be pulled explicitly.
+ *
+ * Alarms are consolidated: pulling a module sends one pull module alarm to
+ * each owning AR that supports it, instead of one pull alarm per
+ * sub-module. Plug alarms are still sent per sub-module.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of entries in \a p_changes.
+ * @return  0  if all changes were applied.
+ *          -1 if the list was rejected (configuration unchanged) or if a
+ *             plug alarm could not be sent.
+ */
+PNET_EXPORT int pnet_apply_config_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes);
+
 /**
  * Updates the IOPS and data of one sub-slot to send to the controller.
  *
@@ -1763,6 +1853,18 @@ PNET_EXPORT int pnet_ar_abort (pnet_t * net, uint32_t arep);
  */
 PNET_EXPORT int pnet_factory_reset (pnet_t * net);
 
+/**
+ * Save pending changes of non-volatile data to file immediately.
+ *
+ * The stack delays saving of for example I&M data and port data a short
+ * while, so that many changes in a row result in a single file write. Use
+ * this before a controlled shutdown or power off of the device, to make
+ * sure that no recent change is lost.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+PNET_EXPORT void pnet_flush_data_files (pnet_t * net);
+
 /**
  * Delete data files.
  *
@@ -1880,6 +1982,339 @@ PNET_EXPORT int pnet_alarm_send_ack (
    const pnet_alarm_argument_t * p_alarm_argument,
    const pnet_pnio_status_t * p_pnio_status);
 
+/** Number of buckets in each alarm statistics histogram */
+#define PNET_ALARM_HISTOGRAM_BUCKETS 8
+
+/**
+ * Alarm latency statistics, for one alarm priority of an AR.
+ *
+ * Covers alarms sent by the IO-device (process alarms, diagnosis alarms,
+ * plug/pull alarms etc). All times are in microseconds.
+ *
+ * The time histograms use the bucket upper limits 1, 2, 5, 10, 20, 50 and
+ * 100 milliseconds. The last bucket counts all larger values.
+ *
+ * In the retransmission histogram the bucket index is the number of
+ * RTA retransmissions needed for an alarm. The last bucket counts all
+ * larger values.
+ */
+typedef struct pnet_alarm_latency_statistics
+{
+   /** Number of alarms put in the send queue */
+   uint32_t queued;
+
+   /** Number of alarms taken from the send queue and sent */
+   uint32_t sent;
+
+   /** Number of Alarm ACKs received from the IO-controller */
+   uint32_t acknowledged;
+
+   /** Number of alarm frames never acknowledged on transport level,
+    *  after all retransmissions */
+   uint32_t timeouts;
+
+   /** Total number of RTA retransmissions */
+   uint32_t retransmissions;
+
+   /** Time in the send queue, from the API call until sent on wire */
+   uint32_t queue_time_last_us;
+   uint32_t queue_time_max_us;
+   uint32_t queue_time_histogram[PNET_ALARM_HISTOGRAM_BUCKETS];
+
+   /** Time from sent on wire until the Alarm ACK from the IO-controller
+    *  was received */
+   uint32_t ack_time_last_us;
+   uint32_t ack_time_max_us;
+   uint32_t ack_time_histogram[PNET_ALARM_HISTOGRAM_BUCKETS];
+
+   /** Number of RTA retransmissions per acknowledged alarm */
+   uint32_t retransmission_histogram[PNET_ALARM_HISTOGRAM_BUCKETS];
+} pnet_alarm_latency_statistics_t;
+
+/**
+ * Alarm statistics for an AR.
+ */
+typedef struct pnet_alarm_statistics
+{
+   pnet_alarm_latency_statistics_t low_prio;
+   pnet_alarm_latency_statistics_t high_prio;
+} pnet_alarm_statistics_t;
+
+/**
+ * Read alarm latency statistics for an AR.
+ *
+ * The statistics are cleared when the AR is established.
+ *
+ * Call this function from the same thread as \a pnet_handle_periodic().
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param arep             In:    The AREP.
+ * @param p_statistics     Out:   Alarm statistics for low and high prio
+ *                                alarms.
+ * @return  0  if the operation succeeded.
+ *          -1 if the AREP is not valid.
+ */
+PNET_EXPORT int pnet_get_alarm_statistics (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_alarm_statistics_t * p_statistics);
+
+/**
+ * Phases in the startup of an AR, in the order they normally occur.
+ *
+ * See \a pnet_get_ar_startup_timeline().
+ */
+typedef enum pnet_ar_startup_phase
+{
+   /** Connect request received */
+   PNET_AR_STARTUP_CONNECT_RECEIVED = 0,
+   /** Connect request parsed */
+   PNET_AR_STARTUP_CONNECT_PARSED,
+   /** Connect request checked against the plugged modules. Includes the
+    *  \a pnet_exp_module_ind() and \a pnet_exp_submodule_ind() call-backs */
+   PNET_AR_STARTUP_CONNECT_CHECKED,
+   /** The \a pnet_connect_ind() call-back has returned */
+   PNET_AR_STARTUP_CONNECT_IND_DONE,
+   /** Connect response created */
+   PNET_AR_STARTUP_CONNECT_RESPONSE,
+   /** DControl PrmEnd request received, after parameter writes */
+   PNET_AR_STARTUP_PRMEND_RECEIVED,
+   /** DControl PrmEnd response sent. Includes the \a pnet_dcontrol_ind()
+    *  call-back */
+   PNET_AR_STARTUP_PRMEND_RESPONSE,
+   /** The application has called \a pnet_application_ready() */
+   PNET_AR_STARTUP_APPLICATION_READY,
+   /** CControl ApplicationReady request sent to the IO-controller */
+   PNET_AR_STARTUP_CCONTROL_SENT,
+   /** CControl ApplicationReady confirmation received */
+   PNET_AR_STARTUP_CCONTROL_CONFIRMED,
+   /** Cyclic data exchange started (state PNET_EVENT_DATA) */
+   PNET_AR_STARTUP_DATA,
+   PNET_AR_STARTUP_NUMBER_OF_PHASES
+} pnet_ar_startup_phase_t;
+
+/**
+ * Startup timeline for an AR.
+ *
+ * All times are in microseconds, from the same clock as
+ * os_get_current_time_us(). A timestamp is valid only if the corresponding
+ * bit in \a reached_phases is set.
+ */
+typedef struct pnet_ar_startup_timeline
+{
+   /** Time when each phase was reached. Index is pnet_ar_startup_phase_t */
+   uint32_t timestamp_us[PNET_AR_STARTUP_NUMBER_OF_PHASES];
+
+   /** Bit mask of reached phases. Bit number is pnet_ar_startup_phase_t */
+   uint32_t reached_phases;
+
+   /** Total time spent in the \a pnet_exp_module_ind() and
+    *  \a pnet_exp_submodule_ind() call-backs during connect */
+   uint32_t exp_module_callbacks_us;
+} pnet_ar_startup_timeline_t;
+
+/**
+ * Read the startup timeline for an AR.
+ *
+ * Shows where time is spent between the Connect request and the start of
+ * cyclic data exchange. The timeline is cleared when a Connect request
+ * is received.
+ *
+ * Call this function from the same thread as \a pnet_handle_periodic().
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param arep             In:    The AREP.
+ * @param p_timeline       Out:   Startup timeline.
+ * @return  0  if the operation succeeded.
+ *          -1 if the AREP is not valid.
+ */
+PNET_EXPORT int pnet_get_ar_startup_timeline (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_ar_startup_timeline_t * p_timeline);
+
+/**
+ * Phases of \a pnet_init(), see \a pnet_get_init_profile().
+ */
+typedef enum pnet_init_phase
+{
+   PNET_INIT_PHASE_FSPM = 0, /**< Configuration and I&M data load */
+   PNET_INIT_PHASE_RT,       /**< Scheduler, driver, CPM, PPM and alarms */
+   PNET_INIT_PHASE_ETH,      /**< Network interfaces */
+   PNET_INIT_PHASE_CMINA,    /**< Background worker, IP and name load */
+   PNET_INIT_PHASE_DCP,      /**< DCP, ports and LLDP */
+   PNET_INIT_PHASE_PDPORT,   /**< Port data load. May be deferred. */
+   PNET_INIT_PHASE_SNMP,     /**< SNMP server and data load. Data load may be
+                                  deferred. */
+   PNET_INIT_PHASE_CMDEV,    /**< Device model, fast start-up and RPC */
+   PNET_INIT_PHASE_NUMBER_OF_PHASES
+} pnet_init_phase_t;
+
+/**
+ * Time spent in the phases of \a pnet_init().
+ */
+typedef struct pnet_init_profile
+{
+   /** Time spent in each phase, in microseconds. Includes deferred work
+    *  when it has been done. */
+   uint32_t phase_us[PNET_INIT_PHASE_NUMBER_OF_PHASES];
+
+   /** Duration of pnet_init(), in microseconds */
+   uint32_t total_us;
+
+   /** Non-critical initialization is deferred, see
+    *  \a pnet_cfg_t.defer_noncritical_init */
+   bool deferred;
+
+   /** Deferred initialization has been done */
+   bool deferred_done;
+
+   /** Time from start of pnet_init() until the deferred initialization was
+    *  done, in microseconds. */
+   uint32_t deferred_done_us;
+
+   /** The device can answer DCP requests. DCP responses are sent by the
+    *  first call to \a pnet_handle_periodic() after \a pnet_init(). */
+   bool dcp_ready;
+
+   /** Time from start of pnet_init() until the first DCP responses could be
+    *  sent, in microseconds. */
+   uint32_t dcp_ready_us;
+} pnet_init_profile_t;
+
+/**
+ * Read the time spent in the phases of the stack initialization.
+ *
+ * Shows where time is spent between power-on and the point where the
+ * device can answer DCP requests.
+ *
+ * Call this function from the same thread as \a pnet_handle_periodic().
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_profile        Out:   Initialization profile.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+PNET_EXPORT int pnet_get_init_profile (
+   pnet_t * net,
+   pnet_init_profile_t * p_profile);
+
+/**
+ * Statistics for the consumer (CPM) of an output IOCR.
+ *
+ * Each received frame is counted in frames_received, and then either in
+ * frames_accepted or in one of the invalid_xxx counters.
+ */
+typedef struct pnet_cpm_statistics
+{
+   /** Number of cyclic frames received */
+   uint32_t frames_received;
+
+   /** Number of frames that reloaded the data hold timer */
+   uint32_t frames_accepted;
+
+   /** Frames received before the CPM was started */
+   uint32_t invalid_state;
+
+   /** Frames with a non-zero transfer status */
+   uint32_t invalid_transfer_status;
+
+   /** Frames from another MAC address than the IO-controller */
+   uint32_t invalid_source_address;
+
+   /** Frames with wrong length */
+   uint32_t invalid_length;
+
+   /** Frames with an old or repeated cycle counter */
+   uint32_t invalid_cycle_counter;
+
+   /** Frames with the DataValid bit cleared in the data status */
+   uint32_t data_invalid;
+
+   /** Number of times the cycle counter of an accepted frame advanced more
+    *  than one control interval */
+   uint32_t cycle_counter_gaps;
+
+   /** Estimated number of frames missing in those gaps */
+   uint32_t frames_missed;
+
+   /** Highest data hold timer value, in control intervals. The AR is
+    *  aborted when it reaches data_hold_factor. */
+   uint16_t dht_max;
+   uint16_t data_hold_factor;
+} pnet_cpm_statistics_t;
+
+/**
+ * Statistics for the provider (PPM) of an input IOCR.
+ */
+typedef struct pnet_ppm_statistics
+{
+   /** Number of cyclic frames sent */
+   uint32_t frames_sent;
+
+   /** Time from when the frame should have been sent until the send
+    *  started, in microseconds */
+   uint32_t send_lateness_last_us;
+   uint32_t send_lateness_max_us;
+
+   /** Number of frames sent one control interval or more too late */
+   uint32_t frames_late;
+} pnet_ppm_statistics_t;
+
+/**
+ * Statistics for one IOCR.
+ */
+typedef struct pnet_iocr_statistics
+{
+   uint16_t frame_id;
+
+   /** True for an input IOCR (the IO-device sends frames, ppm is valid).
+    *  False for an output IOCR (the IO-device receives frames, cpm is
+    *  valid). */
+   bool provider;
+
+   /** Time between frames, in microseconds */
+   uint32_t control_interval_us;
+
+   pnet_ppm_statistics_t ppm;
+   pnet_cpm_statistics_t cpm;
+} pnet_iocr_statistics_t;
+
+/**
+ * Statistics for all IOCRs of an AR.
+ */
+typedef struct pnet_ar_iocr_statistics
+{
+   uint16_t nbr_iocrs;
+   pnet_iocr_statistics_t iocr[PNET_MAX_CR];
+} pnet_ar_iocr_statistics_t;
+
+/**
+ * Read cyclic data statistics for the IOCRs of an AR.
+ *
+ * The statistics of an IOCR are cleared when its cyclic data exchange is
+ * started. They are updated by the default software CPM and PPM drivers.
+ *
+ * This function does not block the cyclic data exchange, and may be called
+ * from another thread than \a pnet_handle_periodic(), for example from a
+ * monitoring thread. It briefly takes the mutex protecting the ARs, so
+ * that the AR is not released while it is read. Without atomics
+ * (PNET_USE_ATOMICS 0) the statistics are also protected by mutexes.
+ * The counters of each IOCR are consistent with each other, except for
+ * dht_max which is updated separately.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param arep             In:    The AREP.
+ * @param p_statistics     Out:   IOCR statistics.
+ * @return  0  if the operation succeeded.
+ *          -1 if the AREP is not valid, or if the statistics were
+ *             continuously being written.
+ */
+PNET_EXPORT int pnet_get_iocr_statistics (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_ar_iocr_statistics_t * p_statistics);
+
 /* ****************************** Diagnosis ****************************** */
 
 #define PNET_CHANNEL_WHOLE_SUBMODULE 0x8000
@@ -2288,19 +2723,19 @@ PNET_EXPORT int pnet_diag_remove (
  * @param net              InOut: The p-net stack instance
  * @param level            In:   The amount of detail to show.
  *
- *     0x0010              | Show compile time options
+ *     0x0010              | Show compile time options and init profile
  *     0x0020              | Show CMDEV
  *     0x0080              | Show SNMP
  *     0x0100              | Show Ports
  *     0x0200              | Show diagnosis
  *     0x0400              | Show logbook
  *     0x0800              | Show all sessions.
- *     0x1000              | Show all ARs.
+ *     0x1000              | Show all ARs, including startup timeline.
  *     0x1001              |     include IOCR.
  *     0x1002              |     include data_descriptors.
  *     0x1003              |     include IOCR and data_descriptors.
- *     0x2000              | Show config/CMINA information.
- *     0x4000              | Show scheduler information.
+ *     0x2000              | Show config/CMINA/DCP information.
+ *     0x4000              | Show scheduler and frame buffer information.
  *     0x8000              | Show I&M data.
  *
  *     Bit in the level parameter:
@@ -59,6 +59,7 @@
  */
 
 #ifdef UNIT_TEST
+#define os_get_current_time_us mock_os_get_current_time_us
 #endif
 
 /*
@@ -93,6 +94,15 @@
 
 CC_STATIC_ASSERT (PNET_MAX_ALARM_PAYLOAD_DATA_SIZE >= sizeof (pf_diag_item_t));
 
+/* Upper limits for the alarm statistics time histogram buckets. The last
+ * bucket has no upper limit. */
+static const uint32_t pf_alarm_histogram_limits_us[] =
+   {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+CC_STATIC_ASSERT (
+   NELEMENTS (pf_alarm_histogram_limits_us) ==
+   PNET_ALARM_HISTOGRAM_BUCKETS - 1);
+
 /*************** Diagnostic strings *****************************************/
 
 /**
@@ -237,6 +247,102 @@ static const char * pf_alarm_apmr_state_to_string (pf_apmr_state_values_t state)
    return s;
 }
 
+/************************** Statistics **************************************/
+
+uint16_t pf_alarm_histogram_index (uint32_t time_us)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < NELEMENTS (pf_alarm_histogram_limits_us); ix++)
+   {
+      if (time_us < pf_alarm_histogram_limits_us[ix])
+      {
+         return ix;
+      }
+   }
+
+   return PNET_ALARM_HISTOGRAM_BUCKETS - 1;
+}
+
+/**
+ * @internal
+ * Add a time measurement to alarm statistics.
+ *
+ * @param time_us          In:    Measured time, in microseconds
+ * @param p_last_us        Out:   Latest measured time
+ * @param p_max_us         InOut: Max measured time
+ * @param p_histogram      InOut: Histogram with PNET_ALARM_HISTOGRAM_BUCKETS
+ *                                elements
+ */
+static void pf_alarm_statistics_add_time (
+   uint32_t time_us,
+   uint32_t * p_last_us,
+   uint32_t * p_max_us,
+   uint32_t * p_histogram)
+{
+   *p_last_us = time_us;
+   if (time_us > *p_max_us)
+   {
+      *p_max_us = time_us;
+   }
+   p_histogram[pf_alarm_histogram_index (time_us)]++;
+}
+
+int pf_alarm_get_statistics (
+   const pf_ar_t * p_ar,
+   pnet_alarm_statistics_t * p_statistics)
+{
+   if (p_ar == NULL || p_statistics == NULL)
+   {
+      return -1;
+   }
+
+   p_statistics->low_prio = p_ar->apmx[0].statistics;
+   p_statistics->high_prio = p_ar->apmx[1].statistics;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Show alarm statistics for one alarm priority.
+ *
+ * @param p_statistics     In:    Statistics to show
+ */
+static void pf_alarm_statistics_show (
+   const pnet_alarm_latency_statistics_t * p_statistics)
+{
+   uint16_t ix;
+
+   printf (
+      "  Queued / sent / acked       = %u / %u / %u\n",
+      (unsigned)p_statistics->queued,
+      (unsigned)p_statistics->sent,
+      (unsigned)p_statistics->acknowledged);
+   printf (
+      "  Timeouts / retransmissions  = %u / %u\n",
+      (unsigned)p_statistics->timeouts,
+      (unsigned)p_statistics->retransmissions);
+   printf (
+      "  Queue time last / max [us]  = %u / %u\n",
+      (unsigned)p_statistics->queue_time_last_us,
+      (unsigned)p_statistics->queue_time_max_us);
+   printf (
+      "  ACK time last / max [us]    = %u / %u\n",
+      (unsigned)p_statistics->ack_time_last_us,
+      (unsigned)p_statistics->ack_time_max_us);
+   printf ("  Histograms (queue time, ACK time, retransmissions):\n");
+   for (ix = 0; ix < PNET_ALARM_HISTOGRAM_BUCKETS; ix++)
+   {
+      printf (
+         "    [%u] %8u %8u %8u\n",
+         ix,
+         (unsigned)p_statistics->queue_time_histogram[ix],
+         (unsigned)p_statistics->ack_time_histogram[ix],
+         (unsigned)p_statistics->retransmission_histogram[ix]);
+   }
+}
+
 void pf_alarm_show (const pf_ar_t * p_ar)
 {
    printf ("Alarms\n");
@@ -303,6 +409,10 @@ void pf_alarm_show (const pf_ar_t * p_ar)
    printf (
       "  Number of frames in incoming queue = %u\n",
       p_ar->apmx[1].alarm_receive_q.accountant.count);
+   printf ("Alarm statistics (low prio)\n");
+   pf_alarm_statistics_show (&p_ar->apmx[0].statistics);
+   printf ("Alarm statistics (high prio)\n");
+   pf_alarm_statistics_show (&p_ar->apmx[1].statistics);
 }
 
 /*****************************************************************************/
@@ -517,6 +627,8 @@ static int pf_alarm_alpmi_apmr_a_data_ind (
    const pnet_pnio_status_t * p_pnio_status)
 {
    int ret = -1;
+   pnet_alarm_latency_statistics_t * p_stats = &p_apmx->statistics;
+   uint16_t retransmissions_ix;
 
    switch (p_apmx->p_alpmx->alpmi_state)
    {
@@ -527,6 +639,19 @@ static int pf_alarm_alpmi_apmr_a_data_ind (
       break;
    case PF_ALPMI_STATE_W_ACK:
       /* This function is only called for DATA = ACK */
+      p_stats->acknowledged++;
+      pf_alarm_statistics_add_time (
+         os_get_current_time_us() - p_apmx->timestamp_alarm_sent_us,
+         &p_stats->ack_time_last_us,
+         &p_stats->ack_time_max_us,
+         p_stats->ack_time_histogram);
+      retransmissions_ix = p_apmx->alarm_retransmissions;
+      if (retransmissions_ix >= PNET_ALARM_HISTOGRAM_BUCKETS)
+      {
+         retransmissions_ix = PNET_ALARM_HISTOGRAM_BUCKETS - 1;
+      }
+      p_stats->retransmission_histogram[retransmissions_ix]++;
+
       p_apmx->p_alpmx->alpmi_state = PF_ALPMI_STATE_W_ALARM;
       pf_fspm_alpmi_alarm_cnf (net, p_apmx->p_ar, p_pnio_status);
       ret = 0;
@@ -792,6 +917,8 @@ static int pf_alarm_apmr_frame_handler (
             priority ? "high" : "low",
             p_buf);
 
+         pf_alarm_ring_doorbell (ar);
+
          ret = 1; /* Means that calling function should not free buffer,
                      as that will be done when reading the queue */
       }
@@ -868,6 +995,11 @@ static void pf_alarm_apms_timeout (
       else if (p_apmx->resend_counter > 0)
       {
          p_apmx->resend_counter--;
+         p_apmx->statistics.retransmissions++;
+         if (p_apmx->p_alpmx->alpmi_state == PF_ALPMI_STATE_W_ACK)
+         {
+            p_apmx->alarm_retransmissions++;
+         }
 
          /* Retransmit */
          if (p_apmx->p_ar->alarm_cr_request.alarm_cr_properties.transport_udp == true)
@@ -913,7 +1045,7 @@ static void pf_alarm_apms_timeout (
          {
             p_rta = p_apmx->p_rta;
             p_apmx->p_rta = NULL;
-            pnal_buf_free(p_rta);
+            pf_frame_buf_free (net, p_rta);
          }
 
          pf_alarm_alpmi_apms_a_data_cnf(net, p_apmx, -1);
@@ -923,6 +1055,7 @@ static void pf_alarm_apms_timeout (
 
          /* Timeout */
          p_apmx->apms_state = PF_APMS_STATE_OPEN;
+         p_apmx->statistics.timeouts++;
 
          p_apmx->p_ar->err_cls = PNET_ERROR_CODE_1_APMS;
          p_apmx->p_ar->err_code = PNET_ERROR_CODE_2_ABORT_AR_ALARM_SEND_CNF_NEG;
@@ -948,7 +1081,7 @@ static void pf_alarm_apms_timeout (
       {
          p_rta = p_apmx->p_rta;
          p_apmx->p_rta = NULL;
-         pnal_buf_free (p_rta);
+         pf_frame_buf_free (net, p_rta);
       }
    }
 }
@@ -1049,6 +1182,13 @@ static int pf_alarm_apmx_activate (pnet_t * net, pf_ar_t * p_ar)
          p_ar->apmx[ix].p_ar = p_ar;
          p_ar->apmx[ix].p_alpmx = &p_ar->alpmx[ix];
 
+         p_ar->apmx[ix].timestamp_alarm_sent_us = 0;
+         p_ar->apmx[ix].alarm_retransmissions = 0;
+         memset (
+            &p_ar->apmx[ix].statistics,
+            0,
+            sizeof (p_ar->apmx[ix].statistics));
+
          pf_scheduler_init_handle (&p_ar->apmx[ix].resend_timeout, "apmx");
 
          p_ar->apmx[ix].apms_state = PF_APMS_STATE_OPEN;
@@ -1131,7 +1271,7 @@ static int pf_alarm_apms_a_data_ind (
             {
                p_rta = p_apmx->p_rta;
                p_apmx->p_rta = NULL;
-               pnal_buf_free (p_rta);
+               pf_frame_buf_free (net, p_rta);
             }
 
             /* This is APMS_A_Data.cnf(+) */
@@ -1255,7 +1395,7 @@ static int pf_alarm_apms_a_data_req (
    }
    else
    {
-      p_rta = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+      p_rta = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
       if (p_rta == NULL)
       {
          LOG_ERROR (
@@ -1447,7 +1587,7 @@ static int pf_alarm_apms_a_data_req (
                   __LINE__,
                   p_rta,
                   p_apmx->p_rta);
-               pnal_buf_free (p_rta);
+               pf_frame_buf_free (net, p_rta);
             }
          }
          else
@@ -1458,7 +1598,7 @@ static int pf_alarm_apms_a_data_req (
                "Alarm(%d): Free unsaved alarm output buffer %p\n",
                __LINE__,
                p_rta);
-            pnal_buf_free (p_rta);
+            pf_frame_buf_free (net, p_rta);
          }
       }
    }
@@ -1661,7 +1801,7 @@ static int pf_alarm_apmx_close (pnet_t * net, pf_ar_t * p_ar, uint8_t err_code)
       {
          p_rta = p_ar->apmx[ix].p_rta;
          p_ar->apmx[ix].p_rta = NULL;
-         pnal_buf_free (p_rta);
+         pf_frame_buf_free (net, p_rta);
       }
 
       /* Close APMR */
@@ -2299,6 +2439,7 @@ static int pf_alarm_send_internal (
 {
    int ret = -1;
    uint32_t maint_status = 0;
+   uint32_t now_us = os_get_current_time_us();
 
    CC_ASSERT (net->global_alarm_enable == true);
    CC_ASSERT (p_ar->alarm_enable == true);
@@ -2331,6 +2472,15 @@ static int pf_alarm_send_internal (
    if (ret == 0)
    {
       p_apmx->p_alpmx->alpmi_state = PF_ALPMI_STATE_W_ACK;
+
+      p_apmx->timestamp_alarm_sent_us = now_us;
+      p_apmx->alarm_retransmissions = 0;
+      p_apmx->statistics.sent++;
+      pf_alarm_statistics_add_time (
+         now_us - alarm_data->timestamp_queued_us,
+         &p_apmx->statistics.queue_time_last_us,
+         &p_apmx->statistics.queue_time_max_us,
+         p_apmx->statistics.queue_time_histogram);
    }
    else
    {
@@ -2410,6 +2560,93 @@ static void pf_alarm_queue_unlock (pf_queue_accountant_t * p_accountant)
    os_mutex_unlock (p_accountant->mutex);
 }
 
+/**
+ * @internal
+ * Check whether a queue is empty.
+ *
+ * @param p_accountant     InOut: Queue accountant
+ * @return true if the queue is empty or not initialized
+ *         false if there are items in the queue
+ */
+static bool pf_alarm_queue_is_empty (pf_queue_accountant_t * p_accountant)
+{
+   bool is_empty;
+
+   if (pf_alarm_queue_is_available (p_accountant) == false)
+   {
+      return true;
+   }
+
+   pf_alarm_queue_lock (p_accountant);
+   is_empty = (p_accountant->count == 0);
+   pf_alarm_queue_unlock (p_accountant);
+
+   return is_empty;
+}
+
+/**
+ * @internal
+ * Lock the alarm doorbell of an AR, on platforms without atomics.
+ *
+ * The doorbell is rung from the receive thread, the application and the
+ * stack thread, so without atomic operations increments could be lost.
+ * Use the mutex of the low priority send queue, which exists as long as
+ * the alarm handling for the AR is active.
+ *
+ * @param p_ar             InOut: The AR instance.
+ */
+static void pf_alarm_doorbell_lock (pf_ar_t * p_ar)
+{
+#if !PNET_USE_ATOMICS
+   if (pf_alarm_queue_is_available (&p_ar->alarm_send_q[0].accountant))
+   {
+      pf_alarm_queue_lock (&p_ar->alarm_send_q[0].accountant);
+   }
+#endif
+}
+
+/**
+ * @internal
+ * Unlock the alarm doorbell of an AR, on platforms without atomics.
+ *
+ * @param p_ar             InOut: The AR instance.
+ */
+static void pf_alarm_doorbell_unlock (pf_ar_t * p_ar)
+{
+#if !PNET_USE_ATOMICS
+   if (pf_alarm_queue_is_available (&p_ar->alarm_send_q[0].accountant))
+   {
+      pf_alarm_queue_unlock (&p_ar->alarm_send_q[0].accountant);
+   }
+#endif
+}
+
+void pf_alarm_ring_doorbell (pf_ar_t * p_ar)
+{
+   pf_alarm_doorbell_lock (p_ar);
+   (void)atomic_fetch_add (&p_ar->alarm_work_pending, 1);
+   pf_alarm_doorbell_unlock (p_ar);
+}
+
+bool pf_alarm_has_queued_work (pf_ar_t * p_ar)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < PF_ALARM_NUMBER_OF_PRIORITY_LEVELS; ix++)
+   {
+      if (
+         (pf_alarm_queue_is_empty (
+             &p_ar->apmx[ix].alarm_receive_q.accountant) == false) ||
+         (pf_alarm_queue_is_empty (&p_ar->alarm_send_q[ix].accountant) ==
+          false))
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
 /**
  * @internal
  * Reset the queue indexes.
@@ -2779,6 +3016,7 @@ int pf_alarm_activate (pnet_t * net, pf_ar_t * p_ar)
       pf_alarm_queue_mutex_create (&q->accountant);
       pf_alarm_send_queue_reset (q);
    }
+   p_ar->alarm_work_pending = 0;
 
    if (pf_alarm_alpmx_activate (p_ar) != 0)
    {
@@ -2981,6 +3219,7 @@ int pf_alarm_periodic (pnet_t * net)
 {
    uint16_t ix;
    pf_ar_t * p_ar;
+   uint32_t work_pending;
 
    if (net->global_alarm_enable == true)
    {
@@ -2989,11 +3228,28 @@ int pf_alarm_periodic (pnet_t * net)
          p_ar = pf_ar_find_by_index (net, ix);
          if ((p_ar != NULL) && (p_ar->in_use == true))
          {
+            /* Skip ARs without queued alarm work, without locking queues */
+            work_pending = p_ar->alarm_work_pending;
+            if (work_pending == 0)
+            {
+               continue;
+            }
+
             /* Handle incoming alarm frames */
             (void)pf_alarm_apmr_periodic (net, p_ar);
 
             /* Handle outgoing alarm messages */
             (void)pf_alarm_almpi_periodic (net, p_ar);
+
+            /* Outgoing alarms might need to wait for an ACK from the
+             * controller, so keep the doorbell until all queues are empty.
+             * Events arriving after we read the doorbell are kept. */
+            if (pf_alarm_has_queued_work (p_ar) == false)
+            {
+               pf_alarm_doorbell_lock (p_ar);
+               (void)atomic_fetch_sub (&p_ar->alarm_work_pending, work_pending);
+               pf_alarm_doorbell_unlock (p_ar);
+            }
          }
       }
    }
@@ -3119,6 +3375,7 @@ static int pf_alarm_send_alarm (
    const uint8_t * p_payload)
 {
    pf_alarm_data_t alarm_data;
+   int ret;
 
    if (net->global_alarm_enable == false || p_ar->alarm_enable == false)
    {
@@ -3179,6 +3436,8 @@ static int pf_alarm_send_alarm (
    alarm_data.module_ident = module_ident;
    alarm_data.submodule_ident = submodule_ident;
 
+   alarm_data.timestamp_queued_us = os_get_current_time_us();
+
    alarm_data.payload.usi = payload_usi;
    alarm_data.payload.len = payload_len;
 
@@ -3196,9 +3455,21 @@ static int pf_alarm_send_alarm (
       alarm_type,
       payload_len);
 
-   return pf_alarm_send_queue_post (
+   ret = pf_alarm_send_queue_post (
       &p_ar->alarm_send_q[high_prio ? 1 : 0],
       &alarm_data);
+   if (ret == 0)
+   {
+      /* Alarms may be sent both from the application and from the stack
+       * thread, so use the queue mutex for the counter. */
+      pf_alarm_queue_lock (&p_ar->alarm_send_q[high_prio ? 1 : 0].accountant);
+      p_ar->apmx[high_prio ? 1 : 0].statistics.queued++;
+      pf_alarm_queue_unlock (
+         &p_ar->alarm_send_q[high_prio ? 1 : 0].accountant);
+      pf_alarm_ring_doorbell (p_ar);
+   }
+
+   return ret;
 }
 
 /************************ Send specific alarm types **************************/
@@ -319,6 +319,18 @@ int pf_alarm_alpmr_alarm_ack (
    const pnet_alarm_argument_t * p_alarm_argument,
    const pnet_pnio_status_t * p_pnio_status);
 
+/**
+ * Read alarm latency statistics for the specified AR.
+ *
+ * @param p_ar             In:    The AR instance.
+ * @param p_statistics     Out:   Alarm statistics for low and high prio.
+ * @return  0  if operation succeeded.
+ *          -1 if an error occurred.
+ */
+int pf_alarm_get_statistics (
+   const pf_ar_t * p_ar,
+   pnet_alarm_statistics_t * p_statistics);
+
 /**
  * Show all alarm information of the specified AR.
  *
@@ -328,6 +340,33 @@ void pf_alarm_show (const pf_ar_t * p_ar);
 
 /************ Internal functions, made available for unit testing ************/
 
+/**
+ * Find the alarm statistics histogram bucket for a time measurement.
+ *
+ * @param time_us          In:    Measured time, in microseconds
+ * @return Histogram bucket index, 0 .. PNET_ALARM_HISTOGRAM_BUCKETS - 1
+ */
+uint16_t pf_alarm_histogram_index (uint32_t time_us);
+
+/**
+ * Tell the alarm periodic handling that there is work to do for an AR.
+ *
+ * Called when an alarm frame or an outgoing alarm has been put in a queue.
+ * Might be called from the Ethernet receive thread.
+ *
+ * @param p_ar             InOut: The AR instance.
+ */
+void pf_alarm_ring_doorbell (pf_ar_t * p_ar);
+
+/**
+ * Check whether there are items in any of the alarm queues of an AR.
+ *
+ * @param p_ar             InOut: The AR instance.
+ * @return true if any alarm send or receive queue has items.
+ *         false if all queues are empty (or not initialized).
+ */
+bool pf_alarm_has_queued_work (pf_ar_t * p_ar);
+
 void pf_alarm_queue_mutex_create (pf_queue_accountant_t * p_accountant);
 
 void pf_alarm_queue_mutex_destroy (pf_queue_accountant_t * p_accountant);
@@ -14,119 +14,440 @@
  * full license information.
  ********************************************************************/
 
-#include "pf_includes.h"
-
-#include <inttypes.h>
-
 #ifdef UNIT_TEST
-/* Background worker is disabled during unit tests.
+/* Background worker thread is disabled during unit tests.
  * Stack reinitialization during test recreates
  * the background task which cause problems.
  * Disabling is implemented using mock functions
  * - mock_pf_bg_worker_init
  * - mock_pf_bg_worker_start_job
+ * - mock_pf_bg_worker_flush
+ * Tests of this file run the jobs using pf_bg_worker_run_due_jobs() and
+ * pf_bg_worker_run_queued_job().
  */
+#define os_get_current_time_us mock_os_get_current_time_us
+#define os_thread_create       mock_os_thread_create
 #endif
 
+#include "pf_includes.h"
+
+#include <inttypes.h>
+
 /* Events handled by bg worker task */
 
-#define BG_JOB_EVENT_UPDATE_PORTS_STATUS  BIT (0)
-#define BG_JOB_EVENT_SAVE_ASE_NVM_DATA    BIT (1)
-#define BG_JOB_EVENT_SAVE_IM_NVM_DATA     BIT (2)
-#define BG_JOB_EVENT_SAVE_PDPORT_NVM_DATA BIT (3)
+#define BG_JOB_EVENT_NEW_REQUEST    BIT (0)
+#define BG_JOB_EVENT_NEW_QUEUED_JOB BIT (1) /* For additional threads */
+
+CC_STATIC_ASSERT (
+   PF_BGJOB_SAVE_FSU_NVM_DATA + 1 == PF_BG_WORKER_NUMBER_OF_JOBS);
+CC_STATIC_ASSERT (
+   PF_BG_JOB_PRIORITY_LOW + 1 == PF_BG_WORKER_NUMBER_OF_PRIORITIES);
+CC_STATIC_ASSERT (PF_BG_WORKER_MAX_QUEUED_JOBS < PF_BG_WORKER_QUEUE_END);
+CC_STATIC_ASSERT (PF_BG_WORKER_NUMBER_OF_THREADS >= 1);
+
+/* Debounce window for each job, in milliseconds */
+static const uint32_t debounce_ms[PF_BG_WORKER_NUMBER_OF_JOBS] = {
+   [PF_BGJOB_UPDATE_PORTS_STATUS] = 0,
+   [PF_BGJOB_SAVE_ASE_NVM_DATA] = PF_BG_WORKER_SAVE_ASE_DEBOUNCE_MS,
+   [PF_BGJOB_SAVE_IM_NVM_DATA] = PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS,
+   [PF_BGJOB_SAVE_PDPORT_NVM_DATA] = PF_BG_WORKER_SAVE_PDPORT_DEBOUNCE_MS,
+   [PF_BGJOB_SAVE_FSU_NVM_DATA] = PF_BG_WORKER_SAVE_FSU_DEBOUNCE_MS,
+};
 
 static void bg_worker_task (void * arg);
+static void bg_worker_queue_task (void * arg);
 
 void pf_bg_worker_init (pnet_t * net)
 {
+   uint16_t ix;
+
    net->pf_bg_worker.events = os_event_create();
    CC_ASSERT (net->pf_bg_worker.events != NULL);
 
+   if (net->pf_bg_worker.request_mutex == NULL)
+   {
+      net->pf_bg_worker.request_mutex = os_mutex_create();
+      CC_ASSERT (net->pf_bg_worker.request_mutex != NULL);
+   }
+   if (net->pf_bg_worker.job_mutex == NULL)
+   {
+      net->pf_bg_worker.job_mutex = os_mutex_create();
+      CC_ASSERT (net->pf_bg_worker.job_mutex != NULL);
+   }
+   memset (
+      net->pf_bg_worker.requests,
+      0,
+      sizeof (net->pf_bg_worker.requests));
+
+   /* All queue entries in the free list */
+   for (ix = 0; ix < PF_BG_WORKER_MAX_QUEUED_JOBS; ix++)
+   {
+      net->pf_bg_worker.queue[ix].next = ix + 1;
+   }
+   net->pf_bg_worker.queue[PF_BG_WORKER_MAX_QUEUED_JOBS - 1].next =
+      PF_BG_WORKER_QUEUE_END;
+   net->pf_bg_worker.queue_free = 0;
+   for (ix = 0; ix < PF_BG_WORKER_NUMBER_OF_PRIORITIES; ix++)
+   {
+      net->pf_bg_worker.queue_head[ix] = PF_BG_WORKER_QUEUE_END;
+      net->pf_bg_worker.queue_tail[ix] = PF_BG_WORKER_QUEUE_END;
+   }
+
    os_thread_create (
       "p-net_bg_worker",
       net->fspm_cfg.pnal_cfg.bg_worker_thread.prio,
       net->fspm_cfg.pnal_cfg.bg_worker_thread.stack_size,
       bg_worker_task,
       (void *)net);
+   for (ix = 1; ix < PF_BG_WORKER_NUMBER_OF_THREADS; ix++)
+   {
+      os_thread_create (
+         "p-net_bg_worker_queue",
+         net->fspm_cfg.pnal_cfg.bg_worker_thread.prio,
+         net->fspm_cfg.pnal_cfg.bg_worker_thread.stack_size,
+         bg_worker_queue_task,
+         (void *)net);
+   }
 }
 
 int pf_bg_worker_start_job (pnet_t * net, pf_bg_job_t job_id)
 {
+   pf_bg_job_request_t * p_request = NULL;
+   uint32_t now_us = 0;
+
    if (net == NULL)
    {
       return -1;
    }
 
+   if ((unsigned)job_id >= PF_BG_WORKER_NUMBER_OF_JOBS)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "BGW(%d): Unsupported job %d\n",
+         __LINE__,
+         (int)job_id);
+      return -1;
+   }
+
+   now_us = os_get_current_time_us();
+   p_request = &net->pf_bg_worker.requests[job_id];
+
+   os_mutex_lock (net->pf_bg_worker.request_mutex);
+   if (!p_request->is_pending)
+   {
+      p_request->is_pending = true;
+      p_request->first_request_us = now_us;
+   }
+   p_request->last_request_us = now_us;
+   os_mutex_unlock (net->pf_bg_worker.request_mutex);
+
+   os_event_set (net->pf_bg_worker.events, BG_JOB_EVENT_NEW_REQUEST);
+
+   return 0;
+}
+
+int pf_bg_worker_queue_job (
+   pnet_t * net,
+   pf_bg_job_priority_t priority,
+   pf_bg_job_callback_t callback,
+   const void * p_payload,
+   uint16_t payload_size)
+{
+   pf_bg_queued_job_t * p_job = NULL;
+   uint16_t ix;
+
+   if (
+      net == NULL || callback == NULL ||
+      (unsigned)priority >= PF_BG_WORKER_NUMBER_OF_PRIORITIES ||
+      payload_size > PF_BG_WORKER_MAX_PAYLOAD_SIZE ||
+      (p_payload == NULL && payload_size > 0))
+   {
+      return -1;
+   }
+
+   os_mutex_lock (net->pf_bg_worker.request_mutex);
+   ix = net->pf_bg_worker.queue_free;
+   if (ix == PF_BG_WORKER_QUEUE_END)
+   {
+      os_mutex_unlock (net->pf_bg_worker.request_mutex);
+      LOG_WARNING (
+         PNET_LOG,
+         "BGW(%d): Job queue is full. Job not queued.\n",
+         __LINE__);
+      return -1;
+   }
+
+   p_job = &net->pf_bg_worker.queue[ix];
+   net->pf_bg_worker.queue_free = p_job->next;
+
+   p_job->callback = callback;
+   p_job->payload_size = payload_size;
+   if (payload_size > 0)
+   {
+      memcpy (p_job->payload.bytes, p_payload, payload_size);
+   }
+
+   /* Append to the list for the priority */
+   p_job->next = PF_BG_WORKER_QUEUE_END;
+   if (net->pf_bg_worker.queue_tail[priority] == PF_BG_WORKER_QUEUE_END)
+   {
+      net->pf_bg_worker.queue_head[priority] = ix;
+   }
+   else
+   {
+      net->pf_bg_worker.queue[net->pf_bg_worker.queue_tail[priority]].next =
+         ix;
+   }
+   net->pf_bg_worker.queue_tail[priority] = ix;
+   os_mutex_unlock (net->pf_bg_worker.request_mutex);
+
+   os_event_set (
+      net->pf_bg_worker.events,
+      BG_JOB_EVENT_NEW_REQUEST | BG_JOB_EVENT_NEW_QUEUED_JOB);
+
+   return 0;
+}
+
+int pf_bg_worker_run_queued_job (pnet_t * net)
+{
+   pf_bg_queued_job_t * p_job = NULL;
+   uint16_t priority;
+   uint16_t ix = PF_BG_WORKER_QUEUE_END;
+
+   /* Remove the first job with highest priority from its list */
+   os_mutex_lock (net->pf_bg_worker.request_mutex);
+   for (priority = 0; priority < PF_BG_WORKER_NUMBER_OF_PRIORITIES;
+        priority++)
+   {
+      ix = net->pf_bg_worker.queue_head[priority];
+      if (ix != PF_BG_WORKER_QUEUE_END)
+      {
+         p_job = &net->pf_bg_worker.queue[ix];
+         net->pf_bg_worker.queue_head[priority] = p_job->next;
+         if (p_job->next == PF_BG_WORKER_QUEUE_END)
+         {
+            net->pf_bg_worker.queue_tail[priority] = PF_BG_WORKER_QUEUE_END;
+         }
+         break;
+      }
+   }
+   os_mutex_unlock (net->pf_bg_worker.request_mutex);
+
+   if (p_job == NULL)
+   {
+      return -1;
+   }
+
+   /* The entry is not reused until it is returned to the free list */
+   p_job->callback (net, p_job->payload.bytes, p_job->payload_size);
+
+   os_mutex_lock (net->pf_bg_worker.request_mutex);
+   p_job->next = net->pf_bg_worker.queue_free;
+   net->pf_bg_worker.queue_free = ix;
+   os_mutex_unlock (net->pf_bg_worker.request_mutex);
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Take a pending job request, if the job is due.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param job_id           In:    Job
+ * @param now_us           In:    Current time, in microseconds
+ * @param force            In:    True if the debounce window should be
+ *                                ignored.
+ * @param p_delay_us       InOut: Lowered to the time until the job is due,
+ *                                if it is pending but not due.
+ * @return  true if the job should run now, false otherwise.
+ */
+static bool pf_bg_worker_take_request (
+   pnet_t * net,
+   pf_bg_job_t job_id,
+   uint32_t now_us,
+   bool force,
+   uint32_t * p_delay_us)
+{
+   pf_bg_job_request_t * p_request = &net->pf_bg_worker.requests[job_id];
+   uint32_t debounce_us = debounce_ms[job_id] * 1000;
+   uint32_t max_delay_us = PF_BG_WORKER_MAX_SAVE_DELAY_MS * 1000;
+   uint32_t since_last_us = 0;
+   uint32_t since_first_us = 0;
+   uint32_t delay_us = 0;
+   bool is_due = false;
+
+   os_mutex_lock (net->pf_bg_worker.request_mutex);
+   if (p_request->is_pending)
+   {
+      since_last_us = now_us - p_request->last_request_us;
+      since_first_us = now_us - p_request->first_request_us;
+
+      if (
+         force || since_last_us >= debounce_us ||
+         since_first_us >= max_delay_us)
+      {
+         p_request->is_pending = false;
+         is_due = true;
+      }
+      else
+      {
+         delay_us = debounce_us - since_last_us;
+         if (max_delay_us - since_first_us < delay_us)
+         {
+            delay_us = max_delay_us - since_first_us;
+         }
+         if (delay_us < *p_delay_us)
+         {
+            *p_delay_us = delay_us;
+         }
+      }
+   }
+   os_mutex_unlock (net->pf_bg_worker.request_mutex);
+
+   return is_due;
+}
+
+/**
+ * @internal
+ * Run a background job.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param job_id           In:    Job to run
+ */
+static void pf_bg_worker_run_job (pnet_t * net, pf_bg_job_t job_id)
+{
    switch (job_id)
    {
    case PF_BGJOB_UPDATE_PORTS_STATUS:
-      os_event_set (net->pf_bg_worker.events, BG_JOB_EVENT_UPDATE_PORTS_STATUS);
+      pf_pdport_update_eth_status (net);
       break;
    case PF_BGJOB_SAVE_ASE_NVM_DATA:
-      os_event_set (net->pf_bg_worker.events, BG_JOB_EVENT_SAVE_ASE_NVM_DATA);
+      pf_cmina_save_ase (net, &net->cmina_nonvolatile_dcp_ase);
       break;
    case PF_BGJOB_SAVE_IM_NVM_DATA:
-      os_event_set (net->pf_bg_worker.events, BG_JOB_EVENT_SAVE_IM_NVM_DATA);
+      pf_fspm_save_im (net);
       break;
    case PF_BGJOB_SAVE_PDPORT_NVM_DATA:
-      os_event_set (net->pf_bg_worker.events, BG_JOB_EVENT_SAVE_PDPORT_NVM_DATA);
+      (void)pf_pdport_save_all (net);
+      break;
+   case PF_BGJOB_SAVE_FSU_NVM_DATA:
+#if PNET_OPTION_FAST_STARTUP
+      pf_fsu_save (net);
+#endif
       break;
    default:
-      LOG_ERROR (
-         PNET_LOG,
-         "BGW(%d): Unsupported job %d\n",
-         __LINE__,
-         (int)job_id);
-      return -1;
+      break;
    }
+}
 
-   return 0;
+uint32_t pf_bg_worker_run_due_jobs (pnet_t * net, uint32_t now_us)
+{
+   uint32_t delay_us = UINT32_MAX;
+   uint16_t ix;
+
+   for (ix = 0; ix < PF_BG_WORKER_NUMBER_OF_JOBS; ix++)
+   {
+      os_mutex_lock (net->pf_bg_worker.job_mutex);
+      if (pf_bg_worker_take_request (net, ix, now_us, false, &delay_us))
+      {
+         pf_bg_worker_run_job (net, ix);
+      }
+      os_mutex_unlock (net->pf_bg_worker.job_mutex);
+   }
+
+   return delay_us;
+}
+
+void pf_bg_worker_flush (pnet_t * net)
+{
+   uint32_t now_us = os_get_current_time_us();
+   uint32_t delay_us = UINT32_MAX;
+   uint16_t ix;
+
+   for (ix = 0; ix < PF_BG_WORKER_NUMBER_OF_JOBS; ix++)
+   {
+      if (ix == PF_BGJOB_UPDATE_PORTS_STATUS)
+      {
+         /* Nothing to save */
+         continue;
+      }
+
+      os_mutex_lock (net->pf_bg_worker.job_mutex);
+      if (pf_bg_worker_take_request (net, ix, now_us, true, &delay_us))
+      {
+         pf_bg_worker_run_job (net, ix);
+      }
+      os_mutex_unlock (net->pf_bg_worker.job_mutex);
+   }
 }
 
 /**
- * Event handling loop for background thread
+ * Event handling loop for the first background thread.
+ *
+ * Runs the built-in jobs, and the queued jobs. The built-in jobs are
+ * checked before each queued job.
  *
  * @param arg              InOut: Thread argument, must be of type pnet_t *
  */
 static void bg_worker_task (void * arg)
 {
    pnet_t * net = (pnet_t *)arg;
-   uint32_t mask =
-      BG_JOB_EVENT_UPDATE_PORTS_STATUS | BG_JOB_EVENT_SAVE_ASE_NVM_DATA |
-      BG_JOB_EVENT_SAVE_IM_NVM_DATA | BG_JOB_EVENT_SAVE_PDPORT_NVM_DATA;
+   uint32_t timeout_ms = OS_WAIT_FOREVER;
+   uint32_t delay_us = 0;
    uint32_t flags = 0;
 
    for (;;)
    {
-      os_event_wait (net->pf_bg_worker.events, mask, &flags, OS_WAIT_FOREVER);
+      os_event_wait (
+         net->pf_bg_worker.events,
+         BG_JOB_EVENT_NEW_REQUEST,
+         &flags,
+         timeout_ms);
+      os_event_clr (net->pf_bg_worker.events, BG_JOB_EVENT_NEW_REQUEST);
 
-      if (flags & BG_JOB_EVENT_SAVE_ASE_NVM_DATA)
+      do
       {
-         os_event_clr (net->pf_bg_worker.events, BG_JOB_EVENT_SAVE_ASE_NVM_DATA);
+         delay_us = pf_bg_worker_run_due_jobs (net, os_get_current_time_us());
+      } while (pf_bg_worker_run_queued_job (net) == 0);
 
-         pf_cmina_save_ase (net, &net->cmina_nonvolatile_dcp_ase);
-      }
-      if (flags & BG_JOB_EVENT_SAVE_IM_NVM_DATA)
+      if (delay_us == UINT32_MAX)
       {
-         os_event_clr (net->pf_bg_worker.events, BG_JOB_EVENT_SAVE_IM_NVM_DATA);
-
-         pf_fspm_save_im (net);
+         timeout_ms = OS_WAIT_FOREVER;
       }
-      if (flags & BG_JOB_EVENT_SAVE_PDPORT_NVM_DATA)
+      else
       {
-         os_event_clr (
-            net->pf_bg_worker.events,
-            BG_JOB_EVENT_SAVE_PDPORT_NVM_DATA);
-
-         (void)pf_pdport_save_all (net);
+         /* Round up, so that the job is due when the wait times out */
+         timeout_ms = (delay_us + 999) / 1000;
       }
-      if (flags & BG_JOB_EVENT_UPDATE_PORTS_STATUS)
-      {
-         os_event_clr (
-            net->pf_bg_worker.events,
-            BG_JOB_EVENT_UPDATE_PORTS_STATUS);
+   }
+}
+
+/**
+ * Event handling loop for additional background threads.
+ *
+ * Runs queued jobs only. Uses its own event flag, so that the
+ * BG_JOB_EVENT_NEW_REQUEST flag is only cleared by bg_worker_task().
+ *
+ * @param arg              InOut: Thread argument, must be of type pnet_t *
+ */
+static void bg_worker_queue_task (void * arg)
+{
+   pnet_t * net = (pnet_t *)arg;
+   uint32_t flags = 0;
 
-         pf_pdport_update_eth_status (net);
+   for (;;)
+   {
+      os_event_wait (
+         net->pf_bg_worker.events,
+         BG_JOB_EVENT_NEW_QUEUED_JOB,
+         &flags,
+         OS_WAIT_FOREVER);
+      os_event_clr (net->pf_bg_worker.events, BG_JOB_EVENT_NEW_QUEUED_JOB);
+
+      while (pf_bg_worker_run_queued_job (net) == 0)
+      {
       }
    }
 }
@@ -21,7 +21,7 @@ extern "C" {
 #endif
 
 /**
- * Background worker jobs
+ * Built-in background worker jobs
  */
 typedef enum pf_bg_job
 {
@@ -36,8 +36,51 @@ typedef enum pf_bg_job
 
    /** Save non volatile PDPort data to file */
    PF_BGJOB_SAVE_PDPORT_NVM_DATA,
+
+   /** Save non volatile fast startup data to file */
+   PF_BGJOB_SAVE_FSU_NVM_DATA,
 } pf_bg_job_t;
 
+/**
+ * Priority of a queued background worker job.
+ *
+ * Queued jobs with the same priority are run in the order they were
+ * queued.
+ */
+typedef enum pf_bg_job_priority
+{
+   PF_BG_JOB_PRIORITY_HIGH = 0,
+   PF_BG_JOB_PRIORITY_NORMAL,
+   PF_BG_JOB_PRIORITY_LOW,
+} pf_bg_job_priority_t;
+
+/*
+ * Saving of non volatile data is delayed until no new save request for the
+ * same data has arrived during the debounce window, so that a burst of
+ * changes (for example an engineering tool writing I&M1-4 records) results
+ * in a single write. A save is never delayed more than
+ * PF_BG_WORKER_MAX_SAVE_DELAY_MS after the first request.
+ */
+#ifndef PF_BG_WORKER_SAVE_ASE_DEBOUNCE_MS
+#define PF_BG_WORKER_SAVE_ASE_DEBOUNCE_MS 100
+#endif
+
+#ifndef PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS
+#define PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS 500
+#endif
+
+#ifndef PF_BG_WORKER_SAVE_PDPORT_DEBOUNCE_MS
+#define PF_BG_WORKER_SAVE_PDPORT_DEBOUNCE_MS 500
+#endif
+
+#ifndef PF_BG_WORKER_SAVE_FSU_DEBOUNCE_MS
+#define PF_BG_WORKER_SAVE_FSU_DEBOUNCE_MS 500
+#endif
+
+#ifndef PF_BG_WORKER_MAX_SAVE_DELAY_MS
+#define PF_BG_WORKER_MAX_SAVE_DELAY_MS 2000
+#endif
+
 /**
  * Initialize the background worker.
  *
@@ -46,7 +89,7 @@ typedef enum pf_bg_job
 void pf_bg_worker_init (pnet_t * net);
 
 /**
- * Start a background job.
+ * Start a built-in background job.
  * This function is non-blocking and sends the job request
  * to the background worker task.
  * @param net              InOut: The p-net stack instance
@@ -56,6 +99,65 @@ void pf_bg_worker_init (pnet_t * net);
  */
 int pf_bg_worker_start_job (pnet_t * net, pf_bg_job_t job_id);
 
+/**
+ * Queue a job for the background worker.
+ *
+ * This function is non-blocking and may be called from the cyclic context.
+ * The payload is copied, so it does not need to be valid after the call.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param priority         In:    Job priority
+ * @param callback         In:    Function that runs the job
+ * @param p_payload        In:    Job payload, or NULL if none
+ * @param payload_size     In:    Size of payload. Max
+ *                                PF_BG_WORKER_MAX_PAYLOAD_SIZE.
+ * @return  0  if the job was queued.
+ *          -1 if the queue is full or an error occurred.
+ */
+int pf_bg_worker_queue_job (
+   pnet_t * net,
+   pf_bg_job_priority_t priority,
+   pf_bg_job_callback_t callback,
+   const void * p_payload,
+   uint16_t payload_size);
+
+/**
+ * Run the queued job with the highest priority.
+ *
+ * Called by the background worker threads. Also used by unit tests.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @return  0  if a job was run.
+ *          -1 if the queue is empty.
+ */
+int pf_bg_worker_run_queued_job (pnet_t * net);
+
+/**
+ * Run the built-in jobs that are due.
+ *
+ * A job is due when its debounce window has passed since the latest
+ * request, or when the max delay has passed since the first request.
+ *
+ * Called by the background worker task. Also used by unit tests.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param now_us           In:    Current time, in microseconds
+ * @return  Time in microseconds until the next pending job is due, or
+ *          UINT32_MAX if no job is pending.
+ */
+uint32_t pf_bg_worker_run_due_jobs (pnet_t * net, uint32_t now_us);
+
+/**
+ * Save all pending non volatile data immediately.
+ *
+ * Runs the pending save jobs in the context of the caller, without waiting
+ * for their debounce windows. When this function returns, all data
+ * requested to be saved before the call has been written.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_bg_worker_flush (pnet_t * net);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,8 +43,12 @@
 #include "pf_includes.h"
 
 #include <inttypes.h>
+#include <stddef.h>
 #include <string.h>
 
+/* Number of attempts to read a consistent copy of the statistics */
+#define PF_CPM_STATISTICS_READ_ATTEMPTS 100
+
 #include "pf_includes.h"
 #include "pf_block_reader.h"
 
@@ -77,6 +81,13 @@ static const char * pf_cpm_state_to_string (pf_cpm_state_values_t state)
 void pf_cpm_init (pnet_t * net)
 {
    net->cpm_instance_cnt = ATOMIC_VAR_INIT (0);
+#if !PNET_USE_ATOMICS
+   if (net->cpm_statistics_lock == NULL)
+   {
+      net->cpm_statistics_lock = os_mutex_create();
+      CC_ASSERT (net->cpm_statistics_lock != NULL);
+   }
+#endif
 
    LOG_DEBUG (PF_CPM_LOG, "CPM(%d): Init driver\n", __LINE__);
 
@@ -192,6 +203,127 @@ int pf_cpm_check_cycle (int32_t prev, uint16_t now)
    return ret;
 }
 
+uint32_t pf_cpm_frames_missed (int32_t prev, uint16_t now, uint32_t step)
+{
+   uint16_t diff;
+   uint32_t steps;
+
+   if ((prev < 0) || (step == 0))
+   {
+      return 0;
+   }
+
+   /* Round to the nearest number of steps, to allow for jitter */
+   diff = now - (uint16_t)prev;
+   steps = ((uint32_t)diff + step / 2) / step;
+   if (steps <= 1)
+   {
+      return 0;
+   }
+
+   return steps - 1;
+}
+
+/**
+ * @internal
+ * Clear the CPM statistics, except dht_max.
+ *
+ * The dht_max field is written by pf_cpm_control_interval_expired(), and is
+ * cleared by pf_cpm_activate_req() in the same thread.
+ * @param p_statistics     Out:   The CPM statistics.
+ */
+static void pf_cpm_statistics_clear (pnet_cpm_statistics_t * p_statistics)
+{
+   memset (p_statistics, 0, offsetof (pnet_cpm_statistics_t, dht_max));
+}
+
+/**
+ * @internal
+ * Request the CPM statistics to be cleared.
+ *
+ * The frame handler owns the counters, so with atomics they are cleared
+ * at its next pf_cpm_statistics_begin_write(). Until then readers see
+ * cleared counters.
+ * @param net              InOut: The p-net stack instance
+ * @param p_cpm            InOut: The CPM instance.
+ */
+static void pf_cpm_statistics_reset (pnet_t * net, pf_cpm_t * p_cpm)
+{
+   p_cpm->statistics.dht_max = 0;
+#if PNET_USE_ATOMICS
+   (void)atomic_fetch_or (&p_cpm->statistics_reset, 1);
+#else
+   os_mutex_lock (net->cpm_statistics_lock);
+   pf_cpm_statistics_clear (&p_cpm->statistics);
+   os_mutex_unlock (net->cpm_statistics_lock);
+#endif
+}
+
+void pf_cpm_statistics_begin_write (pnet_t * net, pf_cpm_t * p_cpm)
+{
+#if PNET_USE_ATOMICS
+   (void)atomic_fetch_add (&p_cpm->statistics_sequence, 1);
+   if (atomic_fetch_and (&p_cpm->statistics_reset, 0) != 0)
+   {
+      pf_cpm_statistics_clear (&p_cpm->statistics);
+   }
+#else
+   os_mutex_lock (net->cpm_statistics_lock);
+#endif
+}
+
+void pf_cpm_statistics_end_write (pnet_t * net, pf_cpm_t * p_cpm)
+{
+#if PNET_USE_ATOMICS
+   (void)atomic_fetch_add (&p_cpm->statistics_sequence, 1);
+#else
+   os_mutex_unlock (net->cpm_statistics_lock);
+#endif
+}
+
+int pf_cpm_get_statistics (
+   pnet_t * net,
+   pf_cpm_t * p_cpm,
+   pnet_cpm_statistics_t * p_statistics)
+{
+#if PNET_USE_ATOMICS
+   uint32_t sequence_before;
+   uint32_t sequence_after;
+   uint32_t reset;
+   uint16_t attempt;
+
+   for (attempt = 0; attempt < PF_CPM_STATISTICS_READ_ATTEMPTS; attempt++)
+   {
+      /* Adding zero gives a read with full memory ordering */
+      sequence_before = atomic_fetch_add (&p_cpm->statistics_sequence, 0);
+      if ((sequence_before & 1) == 0)
+      {
+         *p_statistics = p_cpm->statistics;
+         reset = atomic_fetch_add (&p_cpm->statistics_reset, 0);
+         sequence_after = atomic_fetch_add (&p_cpm->statistics_sequence, 0);
+         if (sequence_after == sequence_before)
+         {
+            if (reset != 0)
+            {
+               pf_cpm_statistics_clear (p_statistics);
+            }
+            p_statistics->data_hold_factor = p_cpm->data_hold_factor;
+            return 0;
+         }
+      }
+   }
+
+   return -1;
+#else
+   os_mutex_lock (net->cpm_statistics_lock);
+   *p_statistics = p_cpm->statistics;
+   os_mutex_unlock (net->cpm_statistics_lock);
+   p_statistics->data_hold_factor = p_cpm->data_hold_factor;
+
+   return 0;
+#endif
+}
+
 int pf_cpm_check_src_addr (const pf_cpm_t * p_cpm, const pnal_buf_t * p_buf)
 {
    int ret = -1;
@@ -249,6 +381,8 @@ int pf_cpm_activate_req (pnet_t * net, pf_ar_t * p_ar, uint32_t crep)
       p_cpm->dht = 0;
       p_cpm->recv_cnt = 0;
 
+      pf_cpm_statistics_reset (net, p_cpm);
+
       memcpy (
          &p_cpm->sa,
          &p_ar->ar_param.cm_initiator_mac_add,
@@ -607,6 +741,34 @@ void pf_cpm_show (const pnet_t * net, const pf_cpm_t * p_cpm)
    printf ("   cycle              = %i\n", (int)p_cpm->cycle);
    printf ("   recv_cnt           = %u\n", (unsigned)p_cpm->recv_cnt);
    printf ("   free_cnt           = %u\n", (unsigned)p_cpm->free_cnt);
+   printf (
+      "   accepted           = %u\n",
+      (unsigned)p_cpm->statistics.frames_accepted);
+   printf (
+      "   invalid state      = %u\n",
+      (unsigned)p_cpm->statistics.invalid_state);
+   printf (
+      "   invalid transfer   = %u\n",
+      (unsigned)p_cpm->statistics.invalid_transfer_status);
+   printf (
+      "   invalid src addr   = %u\n",
+      (unsigned)p_cpm->statistics.invalid_source_address);
+   printf (
+      "   invalid length     = %u\n",
+      (unsigned)p_cpm->statistics.invalid_length);
+   printf (
+      "   invalid cycle      = %u\n",
+      (unsigned)p_cpm->statistics.invalid_cycle_counter);
+   printf (
+      "   data invalid       = %u\n",
+      (unsigned)p_cpm->statistics.data_invalid);
+   printf (
+      "   cycle gaps         = %u\n",
+      (unsigned)p_cpm->statistics.cycle_counter_gaps);
+   printf (
+      "   frames missed      = %u\n",
+      (unsigned)p_cpm->statistics.frames_missed);
+   printf ("   dHT max            = %u\n", (unsigned)p_cpm->statistics.dht_max);
    printf ("   p_buffer_app       = %p\n", p_cpm->p_buffer_app);
    printf ("   p_buffer_cpm       = %p\n", p_cpm->p_buffer_cpm);
    printf (
@@ -131,6 +131,22 @@ int pf_cpm_get_data_and_iops (
  */
 int pf_cpm_get_data_status (const pf_cpm_t * p_cpm, uint8_t * p_data_status);
 
+/**
+ * Read a consistent copy of the CPM statistics.
+ *
+ * Does not block the frame handler. May be called from any thread.
+ * Without atomics (PNET_USE_ATOMICS 0) a mutex is used.
+ * @param net              InOut: The p-net stack instance
+ * @param p_cpm            InOut: The CPM instance.
+ * @param p_statistics     Out:   The CPM statistics.
+ * @return  0  if the operation succeeded.
+ *          -1 if the statistics were continuously being written.
+ */
+int pf_cpm_get_statistics (
+   pnet_t * net,
+   pf_cpm_t * p_cpm,
+   pnet_cpm_statistics_t * p_statistics);
+
 /**
  * Show information about a CPM instance.
  * @param net              In:    The p-net stack instance
@@ -156,6 +172,24 @@ void pf_cpm_set_state (pf_cpm_t * p_cpm, pf_cpm_state_values_t state);
  */
 void pf_cpm_state_ind (pnet_t * net, pf_ar_t * p_ar, uint32_t crep, bool start);
 
+/**
+ * Start updating the CPM statistics.
+ *
+ * Readers will retry until pf_cpm_statistics_end_write() is called.
+ * Only one thread may update the statistics. A pending reset from
+ * pf_cpm_activate_req() is done here, in the updating thread.
+ * @param net              InOut: The p-net stack instance
+ * @param p_cpm            InOut: The CPM instance.
+ */
+void pf_cpm_statistics_begin_write (pnet_t * net, pf_cpm_t * p_cpm);
+
+/**
+ * Finish updating the CPM statistics.
+ * @param net              InOut: The p-net stack instance
+ * @param p_cpm            InOut: The CPM instance.
+ */
+void pf_cpm_statistics_end_write (pnet_t * net, pf_cpm_t * p_cpm);
+
 /**
  * Perform a check of the source address of the received frame.
  * @param p_cpm            In:    The CPM instance.
@@ -185,6 +219,19 @@ int pf_cpm_check_src_addr (const pf_cpm_t * p_cpm, const pnal_buf_t * p_buf);
  */
 int pf_cpm_check_cycle (int32_t prev, uint16_t now);
 
+/**
+ * Calculate the number of frames missing between two accepted frames.
+ *
+ * @param prev             In:   The previous cycle counter. -1 if no
+ *                               frame has been accepted.
+ * @param now              In:   The current cycle counter.
+ * @param step             In:   Cycle counter increment per frame, in
+ *                               units of 31.25 us.
+ * @return  Number of missing frames. 0 if the cycle counter advanced
+ *          by about one step.
+ */
+uint32_t pf_cpm_frames_missed (int32_t prev, uint16_t now, uint32_t step);
+
 #ifdef __cplusplus
 }
 #endif
@@ -79,6 +79,10 @@ static void pf_cpm_control_interval_expired (
          else
          {
             p_iocr->cpm.dht++;
+            if (p_iocr->cpm.dht > p_iocr->cpm.statistics.dht_max)
+            {
+               p_iocr->cpm.statistics.dht_max = p_iocr->cpm.dht;
+            }
          }
          break;
       }
@@ -278,6 +282,8 @@ static int pf_cpm_c_data_ind (
    bool primary;
    bool backup;
    bool update_data;
+   uint32_t * p_invalid_cnt = NULL;
+   uint32_t missed = 0;
 
    p_cpm->recv_cnt++;
 
@@ -288,6 +294,7 @@ static int pf_cpm_c_data_ind (
       p_iocr->p_ar->err_code = PNET_ERROR_CODE_2_CPM_INVALID_STATE;
       p_cpm->errline = __LINE__;
       p_cpm->errcnt++;
+      p_invalid_cnt = &p_cpm->statistics.invalid_state;
       ret = 1; /* Means "handled" */
       break;
    case PF_CPM_STATE_FRUN:
@@ -324,6 +331,30 @@ static int pf_cpm_c_data_ind (
          (frame_structure && c_sdu_structure && data_valid &&
           (primary || backup));
 
+      if (frame_structure == false)
+      {
+         if (transfer_status != 0)
+         {
+            p_invalid_cnt = &p_cpm->statistics.invalid_transfer_status;
+         }
+         else if (len != p_cpm->buffer_length)
+         {
+            p_invalid_cnt = &p_cpm->statistics.invalid_length;
+         }
+         else
+         {
+            p_invalid_cnt = &p_cpm->statistics.invalid_source_address;
+         }
+      }
+      else if (c_sdu_structure == false)
+      {
+         p_invalid_cnt = &p_cpm->statistics.invalid_cycle_counter;
+      }
+      else if (data_valid == false)
+      {
+         p_invalid_cnt = &p_cpm->statistics.data_invalid;
+      }
+
       if (data_valid == false)
       {
          /* 19 */
@@ -358,6 +389,11 @@ static int pf_cpm_c_data_ind (
          /* 20, 21 */
          p_cpm->dht = 0;
 
+         missed = pf_cpm_frames_missed (
+            p_cpm->cycle,
+            cycle,
+            (uint32_t)p_iocr->param.send_clock_factor *
+               p_iocr->param.reduction_ratio);
          p_cpm->cycle = (int32_t)cycle;
          changes = p_cpm->data_status ^ data_status;
          p_cpm->data_status = data_status;
@@ -389,6 +425,23 @@ static int pf_cpm_c_data_ind (
 
    if (ret != 0)
    {
+      pf_cpm_statistics_begin_write (net, p_cpm);
+      p_cpm->statistics.frames_received++;
+      if (p_invalid_cnt != NULL)
+      {
+         (*p_invalid_cnt)++;
+      }
+      else
+      {
+         p_cpm->statistics.frames_accepted++;
+         if (missed > 0)
+         {
+            p_cpm->statistics.cycle_counter_gaps++;
+            p_cpm->statistics.frames_missed += missed;
+         }
+      }
+      pf_cpm_statistics_end_write (net, p_cpm);
+
       if (p_buf != NULL)
       {
          p_cpm->free_cnt++;
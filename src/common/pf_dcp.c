@@ -36,6 +36,7 @@
  */
 
 #ifdef UNIT_TEST
+#define os_get_current_time_us mock_os_get_current_time_us
 #endif
 
 #include <string.h>
@@ -158,6 +159,184 @@ static const pf_dcp_opt_sub_t device_options[] = {
    {PF_DCP_OPT_ALL, PF_DCP_SUB_ALL},
 };
 
+/**
+ * @internal
+ * Refill a token bucket and take a token from it.
+ *
+ * @param p_bucket         InOut: Token bucket.
+ * @param burst            In:    Max number of tokens in the bucket.
+ * @param interval_us      In:    Time to add one token, in microseconds.
+ * @param now_us           In:    Current time, in microseconds.
+ * @return  true if a token was taken,
+ *          false if the bucket is empty.
+ */
+bool pf_dcp_token_bucket_take (
+   pf_dcp_token_bucket_t * p_bucket,
+   uint16_t burst,
+   uint32_t interval_us,
+   uint32_t now_us)
+{
+   uint32_t new_tokens;
+
+   new_tokens = (now_us - p_bucket->timestamp_refill_us) / interval_us;
+   if (new_tokens >= (uint32_t)(burst - p_bucket->tokens))
+   {
+      p_bucket->tokens = burst;
+      p_bucket->timestamp_refill_us = now_us;
+   }
+   else if (new_tokens > 0)
+   {
+      p_bucket->tokens += (uint16_t)new_tokens;
+      p_bucket->timestamp_refill_us += new_tokens * interval_us;
+   }
+
+   if (p_bucket->tokens == 0)
+   {
+      return false;
+   }
+
+   p_bucket->tokens--;
+   return true;
+}
+
+/**
+ * @internal
+ * Take a token from the token bucket of a remote DCP source.
+ *
+ * Unknown sources get a full bucket, in a free entry or in the entry
+ * of the least recently seen source.
+ *
+ * @param p_sources          InOut: Token buckets.
+ * @param number_of_sources  In:    Number of elements in p_sources.
+ * @param mac_address        In:    Source MAC address of the request.
+ * @param now_us             In:    Current time, in microseconds.
+ * @return  true if the request should be handled,
+ *          false if it should be dropped.
+ */
+bool pf_dcp_rate_limit_check (
+   pf_dcp_rate_limit_source_t * p_sources,
+   uint16_t number_of_sources,
+   const pnet_ethaddr_t * mac_address,
+   uint32_t now_us)
+{
+   pf_dcp_rate_limit_source_t * p_source = NULL;
+   uint16_t ix;
+
+   for (ix = 0; ix < number_of_sources; ix++)
+   {
+      if (
+         (p_sources[ix].in_use == true) &&
+         (memcmp (
+             p_sources[ix].mac_address.addr,
+             mac_address->addr,
+             sizeof (pnet_ethaddr_t)) == 0))
+      {
+         p_source = &p_sources[ix];
+         break;
+      }
+   }
+
+   if (p_source == NULL)
+   {
+      /* Use a free entry, or replace the least recently seen source */
+      for (ix = 0; ix < number_of_sources; ix++)
+      {
+         if (p_sources[ix].in_use == false)
+         {
+            p_source = &p_sources[ix];
+            break;
+         }
+         if (
+            (p_source == NULL) ||
+            ((now_us - p_sources[ix].timestamp_last_frame_us) >
+             (now_us - p_source->timestamp_last_frame_us)))
+         {
+            p_source = &p_sources[ix];
+         }
+      }
+
+      if (p_source == NULL)
+      {
+         return true;
+      }
+
+      p_source->in_use = true;
+      p_source->mac_address = *mac_address;
+      p_source->bucket.tokens = PF_DCP_RATE_LIMIT_BURST;
+      p_source->bucket.timestamp_refill_us = now_us;
+      p_source->dropped = 0;
+   }
+   p_source->timestamp_last_frame_us = now_us;
+
+   if (
+      pf_dcp_token_bucket_take (
+         &p_source->bucket,
+         PF_DCP_RATE_LIMIT_BURST,
+         PF_DCP_RATE_LIMIT_INTERVAL,
+         now_us) == false)
+   {
+      p_source->dropped++;
+      return false;
+   }
+
+   return true;
+}
+
+/**
+ * @internal
+ * Check the rate limit for an incoming DCP request.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_ethhdr         In:    Ethernet header of the request.
+ * @return  true if the request should be handled,
+ *          false if it should be dropped.
+ */
+static bool pf_dcp_check_rate_limit (pnet_t * net, const pf_ethhdr_t * p_ethhdr)
+{
+   uint32_t now_us = os_get_current_time_us();
+
+   if (
+      pf_dcp_rate_limit_check (
+         net->dcp_rate_limit,
+         NELEMENTS (net->dcp_rate_limit),
+         &p_ethhdr->src,
+         now_us) == false)
+   {
+      net->dcp_statistics.rate_limited++;
+      LOG_DEBUG (
+         PF_DCP_LOG,
+         "DCP(%d): Rate limit exceeded. Dropping request from "
+         "%02X:%02X:%02X:%02X:%02X:%02X\n",
+         __LINE__,
+         p_ethhdr->src.addr[0],
+         p_ethhdr->src.addr[1],
+         p_ethhdr->src.addr[2],
+         p_ethhdr->src.addr[3],
+         p_ethhdr->src.addr[4],
+         p_ethhdr->src.addr[5]);
+
+      return false;
+   }
+
+   if (
+      pf_dcp_token_bucket_take (
+         &net->dcp_rate_limit_global,
+         PF_DCP_RATE_LIMIT_GLOBAL_BURST,
+         PF_DCP_RATE_LIMIT_GLOBAL_INTERVAL,
+         now_us) == false)
+   {
+      net->dcp_statistics.rate_limited_global++;
+      LOG_DEBUG (
+         PF_DCP_LOG,
+         "DCP(%d): Global rate limit exceeded. Dropping request.\n",
+         __LINE__);
+
+      return false;
+   }
+
+   return true;
+}
+
 /**
  * @internal
  * Send a delayed DCP response to an IDENTIFY request.
@@ -189,7 +368,7 @@ static void pf_dcp_responder (pnet_t * net, void * arg, uint32_t current_time)
       LOG_DEBUG (PNET_LOG, "DCP(%d): Sent a DCP identify response.\n", __LINE__);
    }
 
-   pnal_buf_free (p_buf);
+   pf_frame_buf_free (net, p_buf);
    net->dcp_delayed_response_waiting = false;
 }
 
@@ -966,19 +1145,26 @@ static int pf_dcp_get_set (
       goto out;
    }
 
-   p_rsp = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE); /* Get a transmit buffer
-                                                   for the response */
-   if (p_rsp == NULL)
+   net->dcp_statistics.get_set_received++;
+
+   if (pf_dcp_check_destination_address (mac_address, &p_src_ethhdr->dest) == false)
    {
       goto out;
    }
 
-   if (pf_dcp_check_sam (net, &p_src_ethhdr->src) == false)
+   if (pf_dcp_check_rate_limit (net, p_src_ethhdr) == false)
    {
       goto out;
    }
 
-   if (pf_dcp_check_destination_address (mac_address, &p_src_ethhdr->dest) == false)
+   /* Get a transmit buffer for the response */
+   p_rsp = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
+   if (p_rsp == NULL)
+   {
+      goto out;
+   }
+
+   if (pf_dcp_check_sam (net, &p_src_ethhdr->src) == false)
    {
       goto out;
    }
@@ -1117,7 +1303,7 @@ out:
    }
    if (p_rsp != NULL)
    {
-      pnal_buf_free (p_rsp);
+      pf_frame_buf_free (net, p_rsp);
    }
 
    return 1; /* Buffer handled */
@@ -1209,7 +1395,7 @@ static int pf_dcp_hello_ind (
 
 int pf_dcp_hello_req (pnet_t * net)
 {
-   pnal_buf_t * p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   pnal_buf_t * p_buf = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
    uint8_t * p_dst;
    uint16_t dst_pos;
    uint16_t dst_start_pos;
@@ -1230,7 +1416,7 @@ int pf_dcp_hello_req (pnet_t * net)
    p_dst = (uint8_t *)p_buf->payload;
    if (p_dst == NULL)
    {
-      pnal_buf_free (p_buf);
+      pf_frame_buf_free (net, p_buf);
       return -1;
    }
 
@@ -1380,7 +1566,7 @@ int pf_dcp_hello_req (pnet_t * net)
 
    (void)pf_eth_send_on_management_port (net, p_buf);
 
-   pnal_buf_free (p_buf);
+   pf_frame_buf_free (net, p_buf);
 
    return 0;
 }
@@ -1420,6 +1606,173 @@ uint32_t pf_dcp_calculate_response_delay (
    return spread * 10 * 1000;
 }
 
+/**
+ * @internal
+ * Check whether an incoming DCP identify request might be for us.
+ *
+ * Only the first block is inspected. If it is a NameOfStation or AliasName
+ * filter that does not match, the request is dropped before allocating a
+ * response buffer and parsing the remaining blocks. All other requests are
+ * left to the full parser.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_src            In:    The request frame.
+ * @param src_pos          In:    Position of the first block header.
+ * @param src_dcplen       In:    End position of the DCP data.
+ * @return  true if the request should be parsed,
+ *          false if it is not for us.
+ */
+static bool pf_dcp_identify_prefilter (
+   pnet_t * net,
+   const uint8_t * p_src,
+   uint16_t src_pos,
+   uint16_t src_dcplen)
+{
+   const pf_dcp_block_hdr_t * p_block_hdr;
+   uint16_t block_len;
+   uint16_t value_length;
+   uint8_t * p_value;
+   uint8_t block_error;
+   char alias[PF_ALIAS_NAME_MAX_SIZE]; /** Terminated */
+
+   if ((src_pos + sizeof (pf_dcp_block_hdr_t)) > src_dcplen)
+   {
+      return true;
+   }
+   p_block_hdr = (const pf_dcp_block_hdr_t *)&p_src[src_pos];
+   src_pos += sizeof (pf_dcp_block_hdr_t);
+   block_len = ntohs (p_block_hdr->block_length);
+
+   if (
+      ((src_pos + block_len) > src_dcplen) ||
+      (p_block_hdr->option != PF_DCP_OPT_DEVICE_PROPERTIES))
+   {
+      return true;
+   }
+
+   switch (p_block_hdr->sub_option)
+   {
+   case PF_DCP_SUB_DEV_PROP_NAME:
+      if (
+         pf_cmina_dcp_get_req (
+            net,
+            PF_DCP_OPT_DEVICE_PROPERTIES,
+            PF_DCP_SUB_DEV_PROP_NAME,
+            &value_length,
+            &p_value,
+            &block_error) != 0)
+      {
+         return true;
+      }
+      return (strlen ((char *)p_value) == block_len) &&
+             (memcmp (p_value, &p_src[src_pos], block_len) == 0);
+   case PF_DCP_SUB_DEV_PROP_ALIAS:
+      if (block_len >= PF_ALIAS_NAME_MAX_SIZE)
+      {
+         return false;
+      }
+      memcpy (alias, &p_src[src_pos], block_len);
+      alias[block_len] = '\0';
+      return pf_lldp_is_alias_matching (net, alias);
+   default:
+      return true;
+   }
+}
+
+/**
+ * @internal
+ * Insert the blocks of a DCP identify response.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_dst            Out:   The destination buffer.
+ * @param p_dst_pos        InOut: Position in the destination buffer.
+ * @param dst_max          In:    Size of destination buffer.
+ * @param alias_name       In:    Alias name appended if != NULL
+ */
+static void pf_dcp_put_identify_blocks (
+   pnet_t * net,
+   uint8_t * p_dst,
+   uint16_t * p_dst_pos,
+   uint16_t dst_max,
+   const char * alias_name)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < NELEMENTS (device_options); ix++)
+   {
+      (void)pf_dcp_get_req (
+         net,
+         p_dst,
+         p_dst_pos,
+         dst_max,
+         device_options[ix].opt,
+         device_options[ix].sub,
+         true,
+         alias_name);
+   }
+}
+
+/**
+ * @internal
+ * Insert the blocks of a DCP identify response, using the cached blocks
+ * when possible.
+ *
+ * The blocks are identical for all identify requests without alias filter,
+ * as long as the DCP ASE is unchanged. They are encoded once into
+ * net->dcp_identresp_cache, and then copied into each response until
+ * pf_dcp_identify_cache_invalidate() is called.
+ *
+ * The cache is encoded with the size left in the destination buffer,
+ * so truncation and padding are the same as when encoding in place.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_dst            Out:   The destination buffer.
+ * @param p_dst_pos        InOut: Position in the destination buffer.
+ *                                Should be even.
+ * @param dst_max          In:    Size of destination buffer.
+ * @param alias_name       In:    Alias name appended if != NULL. The cache
+ *                                is not used for such responses.
+ */
+static void pf_dcp_put_identify_response (
+   pnet_t * net,
+   uint8_t * p_dst,
+   uint16_t * p_dst_pos,
+   uint16_t dst_max,
+   const char * alias_name)
+{
+   if (
+      (alias_name != NULL) || ((*p_dst_pos & 1) != 0) ||
+      (*p_dst_pos >= dst_max))
+   {
+      pf_dcp_put_identify_blocks (net, p_dst, p_dst_pos, dst_max, alias_name);
+      return;
+   }
+
+   if (net->dcp_identresp_cache_valid == false)
+   {
+      net->dcp_identresp_cache_len = 0;
+      pf_dcp_put_identify_blocks (
+         net,
+         net->dcp_identresp_cache,
+         &net->dcp_identresp_cache_len,
+         dst_max - *p_dst_pos,
+         NULL);
+      net->dcp_identresp_cache_valid = true;
+   }
+
+   pf_put_mem (
+      net->dcp_identresp_cache,
+      net->dcp_identresp_cache_len,
+      dst_max,
+      p_dst,
+      p_dst_pos);
+}
+
+void pf_dcp_identify_cache_invalidate (pnet_t * net)
+{
+   net->dcp_identresp_cache_valid = false;
+}
+
 /**
  * @internal
  * Handle an incoming DCP identify request.
@@ -1450,7 +1803,6 @@ static int pf_dcp_identify_req (
    void * p_arg) /* Not used */
 {
    int ret = 0; /* Assume all OK */
-   uint16_t ix;
    bool first = true;   /* First of the blocks */
    bool match = false;  /* Is it for us? */
    bool filter = false; /* Is it IdentifyFilter or IdentifyAll? */
@@ -1511,6 +1863,19 @@ static int pf_dcp_identify_req (
       goto out1;
    }
 
+   net->dcp_statistics.identify_received++;
+
+   if (pf_dcp_identify_prefilter (net, p_src, src_pos, src_dcplen) == false)
+   {
+      net->dcp_statistics.identify_prefiltered++;
+      goto out1;
+   }
+
+   if (pf_dcp_check_rate_limit (net, p_src_ethhdr) == false)
+   {
+      goto out1;
+   }
+
    /* Only one pending response is supported */
    if (net->dcp_delayed_response_waiting == true)
    {
@@ -1522,8 +1887,8 @@ static int pf_dcp_identify_req (
       goto out1;
    }
 
-   p_rsp = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE); /* Get a transmit buffer
-                                                   for the response */
+   /* Get a transmit buffer for the response */
+   p_rsp = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
    if (p_rsp == NULL)
    {
       LOG_ERROR (
@@ -1910,18 +2275,12 @@ static int pf_dcp_identify_req (
    {
 
       /* Build the response */
-      for (ix = 0; ix < NELEMENTS (device_options); ix++)
-      {
-         pf_dcp_get_req (
-            net,
-            p_dst,
-            &dst_pos,
-            PF_FRAME_BUFFER_SIZE,
-            device_options[ix].opt,
-            device_options[ix].sub,
-            true,
-            p_req_alias_name);
-      }
+      pf_dcp_put_identify_response (
+         net,
+         p_dst,
+         &dst_pos,
+         PF_FRAME_BUFFER_SIZE,
+         p_req_alias_name);
 
       /* Insert final response length and ship it! */
       p_dst_dcphdr->data_length = htons (dst_pos - dst_start);
@@ -1966,7 +2325,7 @@ static int pf_dcp_identify_req (
             "DCP(%d): Failed to schedule response to DCP identity request\n",
             __LINE__);
 
-         pnal_buf_free (p_rsp);
+         pf_frame_buf_free (net, p_rsp);
       }
    }
    else
@@ -1985,7 +2344,7 @@ static int pf_dcp_identify_req (
          ntohl (p_src_dcphdr->xid));
 #endif
 
-      pnal_buf_free (p_rsp);
+      pf_frame_buf_free (net, p_rsp);
    }
 
 out1:
@@ -1997,6 +2356,48 @@ out1:
    return 1; /* Means: handled */
 }
 
+void pf_dcp_show (const pnet_t * net)
+{
+   uint16_t ix;
+   const pf_dcp_rate_limit_source_t * p_source;
+
+   printf ("DCP\n");
+   printf (
+      "Identify requests received    : %" PRIu32 "\n",
+      net->dcp_statistics.identify_received);
+   printf (
+      "Identify requests prefiltered : %" PRIu32 "\n",
+      net->dcp_statistics.identify_prefiltered);
+   printf (
+      "Get/set requests received     : %" PRIu32 "\n",
+      net->dcp_statistics.get_set_received);
+   printf (
+      "Requests rate limited         : %" PRIu32 "\n",
+      net->dcp_statistics.rate_limited);
+   printf (
+      "Requests globally rate limited: %" PRIu32 "\n",
+      net->dcp_statistics.rate_limited_global);
+   for (ix = 0; ix < NELEMENTS (net->dcp_rate_limit); ix++)
+   {
+      p_source = &net->dcp_rate_limit[ix];
+      if (p_source->in_use)
+      {
+         printf (
+            "   Source %02X:%02X:%02X:%02X:%02X:%02X  tokens: %u  dropped: "
+            "%" PRIu32 "\n",
+            p_source->mac_address.addr[0],
+            p_source->mac_address.addr[1],
+            p_source->mac_address.addr[2],
+            p_source->mac_address.addr[3],
+            p_source->mac_address.addr[4],
+            p_source->mac_address.addr[5],
+            p_source->bucket.tokens,
+            p_source->dropped);
+      }
+   }
+   printf ("\n");
+}
+
 void pf_dcp_exit (pnet_t * net)
 {
    pf_eth_frame_id_map_remove (net, PF_DCP_HELLO_FRAME_ID);
@@ -2009,6 +2410,11 @@ void pf_dcp_init (pnet_t * net)
    net->dcp_global_block_qualifier = 0;
    net->dcp_delayed_response_waiting = false;
    net->dcp_sam = mac_nil;
+   pf_dcp_identify_cache_invalidate (net);
+   memset (net->dcp_rate_limit, 0, sizeof (net->dcp_rate_limit));
+   net->dcp_rate_limit_global.tokens = PF_DCP_RATE_LIMIT_GLOBAL_BURST;
+   net->dcp_rate_limit_global.timestamp_refill_us = os_get_current_time_us();
+   memset (&net->dcp_statistics, 0, sizeof (net->dcp_statistics));
    pf_scheduler_init_handle (&net->dcp_sam_timeout, "dcp_sam");
    pf_scheduler_init_handle (&net->dcp_led_timeout, "dcp_led");
    pf_scheduler_init_handle (&net->dcp_identresp_timeout, "dcp_identresp");
@@ -128,8 +128,38 @@ void pf_dcp_exit (pnet_t * net);
  */
 int pf_dcp_hello_req (pnet_t * net);
 
+/**
+ * Invalidate the cached DCP IDENTIFY response.
+ *
+ * Must be called whenever any value reported in the IDENTIFY response
+ * (for example station name or IP suite) has been changed. The response
+ * is re-encoded on the next incoming IDENTIFY request.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_dcp_identify_cache_invalidate (pnet_t * net);
+
+/**
+ * Show DCP request statistics and rate limiter state.
+ *
+ * @param net              In:    The p-net stack instance
+ */
+void pf_dcp_show (const pnet_t * net);
+
 /************ Internal functions, made available for unit testing ************/
 
+bool pf_dcp_token_bucket_take (
+   pf_dcp_token_bucket_t * p_bucket,
+   uint16_t burst,
+   uint32_t interval_us,
+   uint32_t now_us);
+
+bool pf_dcp_rate_limit_check (
+   pf_dcp_rate_limit_source_t * p_sources,
+   uint16_t number_of_sources,
+   const pnet_ethaddr_t * mac_address,
+   uint32_t now_us);
+
 uint32_t pf_dcp_calculate_response_delay (
    const pnet_ethaddr_t * mac_address,
    uint16_t response_delay_factor);
@@ -17,15 +17,23 @@
  * @file
  * @brief Utility functions for reading and writing data from/to disk or flash.
  *
- * Adds the bytes "PNET" and a version indicator to the beginning of the file
- * when writing. Checks the corresponding values when reading.
+ * All objects are stored in a journal file, see below. Objects in separate
+ * files written by earlier versions are still read if not in the journal.
+ * Those files start with the bytes "PNET" and a version indicator.
+ *
+ * A CRC32 of the contents last read from or written to each file is kept in
+ * the stack instance. This allows pf_file_save_if_modified() to skip both
+ * the read and the write when the contents are unchanged. The files are
+ * assumed not to be modified by anyone else while the stack is running.
  *
  */
 
 #ifdef UNIT_TEST
-#define pnal_clear_file mock_pnal_clear_file
-#define pnal_load_file  mock_pnal_load_file
-#define pnal_save_file  mock_pnal_save_file
+#define pnal_append_file mock_pnal_append_file
+#define pnal_clear_file  mock_pnal_clear_file
+#define pnal_load_file   mock_pnal_load_file
+#define pnal_read_file   mock_pnal_read_file
+#define pnal_save_file   mock_pnal_save_file
 #endif
 
 #include "pf_includes.h"
@@ -41,6 +49,40 @@
 /* Increase every time the saved contents have another format */
 #define PF_FILE_VERSION 0x00000001U
 
+#define PF_FILE_CRC32_POLYNOMIAL 0xEDB88320U /* Reflected IEEE 802.3 */
+#define PF_FILE_CRC32_INIT       0xFFFFFFFFU
+
+/*
+ * Journal
+ *
+ * The objects are appended to a journal file as records, grouped into
+ * transactions. A transaction is valid only if it is followed by a commit
+ * record, so a power loss while writing can not leave a half written
+ * transaction behind. Each record is protected by a CRC32.
+ *
+ * Header:  Magic "PNJL" (4 bytes), version (4), generation (4), CRC (4)
+ * Record:  Type (1), name length (1), data length (2),
+ *          transaction sequence number (4), name, data, CRC (4)
+ *
+ * All numbers are big endian. The CRC covers the preceding fields.
+ *
+ * When the journal has grown too large, the current objects are written
+ * to the other journal file as a single transaction with a higher
+ * generation number. The old journal file is removed afterwards. At
+ * startup the journal file with the highest generation number that has at
+ * least one committed transaction is used.
+ */
+#define PF_FILE_JOURNAL_MAGIC              0x504E4A4CU /* "PNJL" */
+#define PF_FILE_JOURNAL_VERSION            0x00000001U
+#define PF_FILE_JOURNAL_HEADER_SIZE        16
+#define PF_FILE_JOURNAL_RECORD_HEADER_SIZE 8
+#define PF_FILE_JOURNAL_CRC_SIZE           4
+#define PF_FILE_JOURNAL_COPY_CHUNK_SIZE    512
+
+#define PF_FILE_JOURNAL_RECORD_OBJECT 1
+#define PF_FILE_JOURNAL_RECORD_REMOVE 2
+#define PF_FILE_JOURNAL_RECORD_COMMIT 3
+
 /* The configurable constant PNET_MAX_FILENAME_SIZE should be at least
  * as large as the longest filename used, including termination.
  */
@@ -51,6 +93,11 @@ CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_PDPORT_1));
 CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_PDPORT_2));
 CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_PDPORT_3));
 CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_PDPORT_4));
+CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_JOURNAL_1));
+CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE >= sizeof (PF_FILENAME_JOURNAL_2));
+
+/* The name length is stored in one byte */
+CC_STATIC_ASSERT (PNET_MAX_FILENAME_SIZE <= UINT8_MAX);
 
 /**
  * @internal
@@ -137,18 +184,235 @@ int pf_file_join_directory_filename (
    return 0;
 }
 
-int pf_file_load (
-   const char * directory,
-   const char * filename,
-   void * p_object,
+void pf_file_init (pnet_t * net)
+{
+   if (net->file_mutex == NULL)
+   {
+      net->file_mutex = os_mutex_create();
+      CC_ASSERT (net->file_mutex != NULL);
+   }
+   memset (net->file_cache, 0, sizeof (net->file_cache));
+   net->file_cache_next_replaced = 0;
+   memset (&net->file_journal, 0, sizeof (net->file_journal));
+}
+
+/**
+ * @internal
+ * Update a CRC32 (IEEE 802.3) calculation with more data.
+ *
+ * Start with PF_FILE_CRC32_INIT, and invert the result when all data
+ * has been added.
+ *
+ * @param crc              In:    CRC value so far
+ * @param p_data           In:    Data
+ * @param size             In:    Size of data
+ * @return  the updated CRC value.
+ */
+static uint32_t pf_file_update_crc32 (
+   uint32_t crc,
+   const void * p_data,
+   size_t size)
+{
+   const uint8_t * p_byte = (const uint8_t *)p_data;
+   size_t ix;
+   int bit;
+
+   for (ix = 0; ix < size; ix++)
+   {
+      crc ^= p_byte[ix];
+      for (bit = 0; bit < 8; bit++)
+      {
+         crc = (crc >> 1) ^ (PF_FILE_CRC32_POLYNOMIAL & (0U - (crc & 1U)));
+      }
+   }
+
+   return crc;
+}
+
+/**
+ * @internal
+ * Calculate the CRC32 (IEEE 802.3) of a memory area.
+ *
+ * @param p_object         In:    Data
+ * @param size             In:    Size of data
+ * @return  the CRC32 value.
+ */
+static uint32_t pf_file_calculate_crc32 (const void * p_object, size_t size)
+{
+   return ~pf_file_update_crc32 (PF_FILE_CRC32_INIT, p_object, size);
+}
+
+/**
+ * @internal
+ * Find the cache entry for a file.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param path             In:    Full path to file. Terminated string.
+ * @return  the cache entry, or NULL if the file has no entry.
+ */
+static pf_file_cache_entry_t * pf_file_cache_find (
+   pnet_t * net,
+   const char * path)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < NELEMENTS (net->file_cache); ix++)
+   {
+      if (
+         net->file_cache[ix].in_use &&
+         strcmp (net->file_cache[ix].path, path) == 0)
+      {
+         return &net->file_cache[ix];
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * @internal
+ * Remember the contents of a file.
+ *
+ * If the cache is full, the entries are replaced in round robin order.
+ * Inside a transaction the entry is marked as uncommitted, and it is
+ * removed if the transaction fails. See pf_file_cache_end_transaction().
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @param path             In:    Full path to file. Terminated string.
+ * @param crc              In:    CRC32 of the file contents
+ * @param size             In:    Size of the file contents
+ */
+static void pf_file_cache_update (
+   pnet_t * net,
+   const char * path,
+   uint32_t crc,
    size_t size)
+{
+   pf_file_cache_entry_t * p_entry = NULL;
+   uint16_t ix;
+
+   if (net == NULL)
+   {
+      return;
+   }
+
+   p_entry = pf_file_cache_find (net, path);
+   for (ix = 0; p_entry == NULL && ix < NELEMENTS (net->file_cache); ix++)
+   {
+      if (!net->file_cache[ix].in_use)
+      {
+         p_entry = &net->file_cache[ix];
+      }
+   }
+   if (p_entry == NULL)
+   {
+      p_entry = &net->file_cache[net->file_cache_next_replaced];
+      net->file_cache_next_replaced =
+         (net->file_cache_next_replaced + 1) % NELEMENTS (net->file_cache);
+   }
+
+   strcpy (p_entry->path, path);
+   p_entry->crc = crc;
+   p_entry->size = size;
+   p_entry->in_use = true;
+   p_entry->is_uncommitted = net->file_journal.transaction_depth > 0;
+}
+
+/**
+ * @internal
+ * Forget the contents of a file.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @param path             In:    Full path to file. Terminated string.
+ */
+static void pf_file_cache_remove (pnet_t * net, const char * path)
+{
+   pf_file_cache_entry_t * p_entry = NULL;
+
+   if (net == NULL)
+   {
+      return;
+   }
+
+   p_entry = pf_file_cache_find (net, path);
+   if (p_entry != NULL)
+   {
+      p_entry->in_use = false;
+   }
+}
+
+/**
+ * @internal
+ * Update the cache when the outermost transaction ends.
+ *
+ * The records of a failed transaction are dropped from the journal, so
+ * the cache entries updated in it no longer describe the stored files.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param is_committed     In:    True if the transaction was committed
+ */
+static void pf_file_cache_end_transaction (pnet_t * net, bool is_committed)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < NELEMENTS (net->file_cache); ix++)
+   {
+      if (net->file_cache[ix].is_uncommitted)
+      {
+         net->file_cache[ix].is_uncommitted = false;
+         if (!is_committed)
+         {
+            net->file_cache[ix].in_use = false;
+         }
+      }
+   }
+}
+
+/**
+ * @internal
+ * Lock the file mutex, if a stack instance is given.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ */
+static void pf_file_lock (pnet_t * net)
+{
+   if (net != NULL)
+   {
+      os_mutex_lock (net->file_mutex);
+   }
+}
+
+/**
+ * @internal
+ * Unlock the file mutex, if a stack instance is given.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ */
+static void pf_file_unlock (pnet_t * net)
+{
+   if (net != NULL)
+   {
+      os_mutex_unlock (net->file_mutex);
+   }
+}
+
+/**
+ * @internal
+ * Load a binary file, and verify the file version.
+ *
+ * @param path             In:    Full path to file. Terminated string.
+ * @param p_object         Out:   Struct to load
+ * @param size             In:    Size of struct to load
+ * @return  0  if the operation succeeded.
+ *          -1 if not found or an error occurred (for example wrong version).
+ */
+static int pf_file_load_path (const char * path, void * p_object, size_t size)
 {
    uint8_t versioning_buffer[8] = {0}; /* Two uint32_t */
    pf_get_info_t bufferinfo;
    uint32_t version = 0;
    uint32_t magic = 0;
    uint16_t pos = 0;
-   char path[PNET_MAX_FILE_FULLPATH_SIZE];
    uint32_t start_time_us = 0;
 
    bufferinfo.p_buf = versioning_buffer;
@@ -156,16 +420,6 @@ int pf_file_load (
    bufferinfo.is_big_endian = true;
    bufferinfo.result = PF_PARSE_OK;
 
-   if (
-      pf_file_join_directory_filename (
-         directory,
-         filename,
-         path,
-         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
-   {
-      return -1;
-   }
-
    /* Read file */
    start_time_us = os_get_current_time_us();
    if (
@@ -216,108 +470,1359 @@ int pf_file_load (
    return 0;
 }
 
-int pf_file_save (
-   const char * directory,
-   const char * filename,
-   const void * p_object,
+
+/**
+ * @internal
+ * Read an exact number of bytes from a file.
+ *
+ * @param path             In:    Full path to file. Terminated string.
+ * @param offset           In:    Position in file
+ * @param p_buf            Out:   Buffer for the data
+ * @param size             In:    Number of bytes to read
+ * @return  0  if all bytes were read.
+ *          -1 if not found, too short or an error occurred.
+ */
+static int pf_file_read_exact (
+   const char * path,
+   uint32_t offset,
+   void * p_buf,
    size_t size)
 {
-   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
-   uint8_t versioning_buffer[8] = {0};     /**< Two uint32_t */
-   uint16_t pos = 0;
-   int ret = 0;
-   uint32_t start_time_us = 0;
-
-   if (
-      pf_file_join_directory_filename (
-         directory,
-         filename,
-         path,
-         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+   if (size == 0)
    {
-      return -1;
+      return 0;
    }
 
-   pf_put_uint32 (
-      true,
-      PF_FILE_MAGIC,
-      sizeof (versioning_buffer),
-      versioning_buffer,
-      &pos); /* Big endian */
-   pf_put_uint32 (
-      true,
-      PF_FILE_VERSION,
-      sizeof (versioning_buffer),
-      versioning_buffer,
-      &pos); /* Big endian */
+   return (pnal_read_file (path, offset, p_buf, size) == (int)size) ? 0 : -1;
+}
 
-   start_time_us = os_get_current_time_us();
-   ret = pnal_save_file (
-      path,
-      versioning_buffer,
-      sizeof (versioning_buffer),
-      p_object,
-      size);
-   LOG_DEBUG (
-      PNET_LOG,
-      "FILE(%d): Did save file %s Access time %" PRIu32 " ms.\n",
-      __LINE__,
+/**
+ * @internal
+ * Get the full path to one of the journal files.
+ *
+ * @param p_journal        In:    Journal
+ * @param file_ix          In:    Journal file, 0 or 1
+ * @param path             Out:   Full path. Terminated string.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_get_path (
+   const pf_file_journal_t * p_journal,
+   uint16_t file_ix,
+   char * path)
+{
+   return pf_file_join_directory_filename (
+      p_journal->directory,
+      (file_ix == 0) ? PF_FILENAME_JOURNAL_1 : PF_FILENAME_JOURNAL_2,
       path,
-      ((os_get_current_time_us() - start_time_us) / 1000));
-
-   return ret;
+      PNET_MAX_FILE_FULLPATH_SIZE);
 }
 
-int pf_file_save_if_modified (
-   const char * directory,
-   const char * filename,
-   const void * p_object,
-   void * p_tempobject,
-   size_t size)
+/**
+ * @internal
+ * Find an object among journal objects.
+ *
+ * @param objects          In:    Journal objects
+ * @param name             In:    Object name. Terminated string.
+ * @return  the object, or NULL if not found.
+ */
+static pf_file_journal_object_t * pf_file_journal_find (
+   pf_file_journal_object_t objects[],
+   const char * name)
 {
-   bool save = false;
-   int ret = 0; /* Assume no changes */
+   uint16_t ix;
 
-   memset (p_tempobject, 0, size);
-
-   if (pf_file_load (directory, filename, p_tempobject, size) == 0)
+   for (ix = 0; ix < PF_FILE_MAX_FILES; ix++)
    {
-      if (memcmp (p_tempobject, p_object, size) != 0)
+      if (objects[ix].in_use && strcmp (objects[ix].name, name) == 0)
       {
-         ret = 1;
-         save = true;
+         return &objects[ix];
       }
    }
-   else
+
+   return NULL;
+}
+
+/**
+ * @internal
+ * Find an object among journal objects, or a free entry for it.
+ *
+ * @param objects          In:    Journal objects
+ * @param name             In:    Object name. Terminated string.
+ * @return  the object, or NULL if not found and no free entry is available.
+ */
+static pf_file_journal_object_t * pf_file_journal_find_or_free (
+   pf_file_journal_object_t objects[],
+   const char * name)
+{
+   pf_file_journal_object_t * p_object = NULL;
+   uint16_t ix;
+
+   p_object = pf_file_journal_find (objects, name);
+   for (ix = 0; p_object == NULL && ix < PF_FILE_MAX_FILES; ix++)
    {
-      ret = 2;
-      save = true;
+      if (!objects[ix].in_use)
+      {
+         p_object = &objects[ix];
+      }
    }
 
-   if (save == true)
+   return p_object;
+}
+
+/**
+ * @internal
+ * Apply a journal record to journal objects.
+ *
+ * @param objects          InOut: Journal objects
+ * @param type             In:    PF_FILE_JOURNAL_RECORD_OBJECT or
+ *                                PF_FILE_JOURNAL_RECORD_REMOVE
+ * @param name             In:    Object name. Terminated string.
+ * @param offset           In:    Position of object data in journal file
+ * @param size             In:    Size of object data
+ * @return  0  if the operation succeeded.
+ *          -1 if there is no room for the object.
+ */
+static int pf_file_journal_apply (
+   pf_file_journal_object_t objects[],
+   uint8_t type,
+   const char * name,
+   uint32_t offset,
+   uint16_t size)
+{
+   pf_file_journal_object_t * p_object = NULL;
+
+   if (type == PF_FILE_JOURNAL_RECORD_REMOVE)
    {
-      if (pf_file_save (directory, filename, p_object, size) != 0)
+      p_object = pf_file_journal_find (objects, name);
+      if (p_object != NULL)
       {
-         ret = -1;
+         p_object->in_use = false;
       }
+      return 0;
    }
 
-   return ret;
+   p_object = pf_file_journal_find_or_free (objects, name);
+   if (p_object == NULL)
+   {
+      return -1;
+   }
+
+   strcpy (p_object->name, name);
+   p_object->offset = offset;
+   p_object->size = size;
+   p_object->in_use = true;
+
+   return 0;
 }
 
-void pf_file_clear (const char * directory, const char * filename)
+/**
+ * @internal
+ * Read and verify the header of a journal file.
+ *
+ * @param path             In:    Full path to journal file
+ * @param p_generation     Out:   Generation of the journal file
+ * @return  0  if the header is valid.
+ *          -1 if not found or invalid.
+ */
+static int pf_file_journal_read_header (
+   const char * path,
+   uint32_t * p_generation)
 {
-   char path[PNET_MAX_FILE_FULLPATH_SIZE];
+   uint8_t buffer[PF_FILE_JOURNAL_HEADER_SIZE];
+   pf_get_info_t bufferinfo;
+   uint16_t pos = 0;
+   uint32_t magic = 0;
+   uint32_t version = 0;
+   uint32_t crc = 0;
+
+   if (pf_file_read_exact (path, 0, buffer, sizeof (buffer)) != 0)
+   {
+      return -1;
+   }
+
+   bufferinfo.p_buf = buffer;
+   bufferinfo.len = sizeof (buffer);
+   bufferinfo.is_big_endian = true;
+   bufferinfo.result = PF_PARSE_OK;
+
+   magic = pf_get_uint32 (&bufferinfo, &pos);
+   version = pf_get_uint32 (&bufferinfo, &pos);
+   *p_generation = pf_get_uint32 (&bufferinfo, &pos);
+   crc = pf_get_uint32 (&bufferinfo, &pos);
 
    if (
-      pf_file_join_directory_filename (
-         directory,
-         filename,
-         path,
-         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+      magic != PF_FILE_JOURNAL_MAGIC ||
+      crc != pf_file_calculate_crc32 (buffer, PF_FILE_JOURNAL_HEADER_SIZE -
+                                                 PF_FILE_JOURNAL_CRC_SIZE))
    {
-      return;
+      LOG_WARNING (
+         PNET_LOG,
+         "FILE(%d): Invalid journal file header in %s\n",
+         __LINE__,
+         path);
+      return -1;
    }
 
-   return pnal_clear_file (path);
+   if (version != PF_FILE_JOURNAL_VERSION)
+   {
+      LOG_WARNING (
+         PNET_LOG,
+         "FILE(%d): Wrong journal version in file %s  Expected %" PRIu32
+         " but got %" PRIu32 ".\n",
+         __LINE__,
+         path,
+         (uint32_t)PF_FILE_JOURNAL_VERSION,
+         version);
+      return -1;
+   }
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Replay the committed transactions in a journal file.
+ *
+ * Reading stops at the first invalid or incomplete record. Records after
+ * the last commit record are ignored.
+ *
+ * @param p_journal        InOut: Journal. Objects and file position are
+ *                                updated.
+ * @param path             In:    Full path to journal file
+ * @return  the number of committed transactions.
+ */
+static int pf_file_journal_scan (
+   pf_file_journal_t * p_journal,
+   const char * path)
+{
+   pf_file_journal_object_t uncommitted[PF_FILE_MAX_FILES];
+   uint8_t buffer[PF_FILE_JOURNAL_RECORD_HEADER_SIZE + PNET_MAX_FILENAME_SIZE];
+   uint8_t chunk[PF_FILE_JOURNAL_COPY_CHUNK_SIZE];
+   char name[PNET_MAX_FILENAME_SIZE];
+   pf_get_info_t bufferinfo;
+   uint16_t pos = 0;
+   uint32_t offset = PF_FILE_JOURNAL_HEADER_SIZE;
+   uint32_t committed_offset = PF_FILE_JOURNAL_HEADER_SIZE;
+   uint32_t data_offset = 0;
+   uint32_t crc = 0;
+   uint32_t stored_crc = 0;
+   uint32_t sequence = 0;
+   uint16_t data_length = 0;
+   uint16_t copied = 0;
+   uint16_t chunk_size = 0;
+   uint8_t type = 0;
+   uint8_t name_length = 0;
+   int transactions = 0;
+   bool is_valid = true;
+
+   memset (p_journal->objects, 0, sizeof (p_journal->objects));
+   memset (uncommitted, 0, sizeof (uncommitted));
+   p_journal->file.sequence = 0;
+
+   bufferinfo.p_buf = buffer;
+   bufferinfo.len = sizeof (buffer);
+   bufferinfo.is_big_endian = true;
+   bufferinfo.result = PF_PARSE_OK;
+
+   while (
+      pf_file_read_exact (
+         path,
+         offset,
+         buffer,
+         PF_FILE_JOURNAL_RECORD_HEADER_SIZE) == 0)
+   {
+      pos = 0;
+      type = pf_get_byte (&bufferinfo, &pos);
+      name_length = pf_get_byte (&bufferinfo, &pos);
+      data_length = pf_get_uint16 (&bufferinfo, &pos);
+      sequence = pf_get_uint32 (&bufferinfo, &pos);
+
+      switch (type)
+      {
+      case PF_FILE_JOURNAL_RECORD_OBJECT:
+         is_valid = name_length > 0 && name_length < PNET_MAX_FILENAME_SIZE;
+         break;
+      case PF_FILE_JOURNAL_RECORD_REMOVE:
+         is_valid = name_length > 0 && name_length < PNET_MAX_FILENAME_SIZE &&
+                    data_length == 0;
+         break;
+      case PF_FILE_JOURNAL_RECORD_COMMIT:
+         is_valid = name_length == 0 && data_length == 0;
+         break;
+      default:
+         is_valid = false;
+         break;
+      }
+      if (!is_valid || sequence != p_journal->file.sequence + 1)
+      {
+         break;
+      }
+
+      /* Verify CRC of header, name and data */
+      if (
+         pf_file_read_exact (
+            path,
+            offset + PF_FILE_JOURNAL_RECORD_HEADER_SIZE,
+            &buffer[PF_FILE_JOURNAL_RECORD_HEADER_SIZE],
+            name_length) != 0)
+      {
+         break;
+      }
+      crc = pf_file_update_crc32 (
+         PF_FILE_CRC32_INIT,
+         buffer,
+         PF_FILE_JOURNAL_RECORD_HEADER_SIZE + name_length);
+
+      data_offset = offset + PF_FILE_JOURNAL_RECORD_HEADER_SIZE + name_length;
+      for (copied = 0; copied < data_length; copied += chunk_size)
+      {
+         chunk_size = data_length - copied;
+         if (chunk_size > sizeof (chunk))
+         {
+            chunk_size = sizeof (chunk);
+         }
+         if (
+            pf_file_read_exact (
+               path,
+               data_offset + copied,
+               chunk,
+               chunk_size) != 0)
+         {
+            break;
+         }
+         crc = pf_file_update_crc32 (crc, chunk, chunk_size);
+      }
+      if (
+         copied < data_length ||
+         pf_file_read_exact (
+            path,
+            data_offset + data_length,
+            chunk,
+            PF_FILE_JOURNAL_CRC_SIZE) != 0)
+      {
+         break;
+      }
+      stored_crc = ((uint32_t)chunk[0] << 24) | ((uint32_t)chunk[1] << 16) |
+                   ((uint32_t)chunk[2] << 8) | chunk[3];
+      if (stored_crc != ~crc)
+      {
+         break;
+      }
+
+      offset = data_offset + data_length + PF_FILE_JOURNAL_CRC_SIZE;
+
+      if (type == PF_FILE_JOURNAL_RECORD_COMMIT)
+      {
+         memcpy (p_journal->objects, uncommitted, sizeof (uncommitted));
+         p_journal->file.sequence = sequence;
+         committed_offset = offset;
+         transactions++;
+      }
+      else
+      {
+         memcpy (
+            name,
+            &buffer[PF_FILE_JOURNAL_RECORD_HEADER_SIZE],
+            name_length);
+         name[name_length] = '\0';
+         if (
+            pf_file_journal_apply (
+               uncommitted,
+               type,
+               name,
+               data_offset,
+               data_length) != 0)
+         {
+            LOG_WARNING (
+               PNET_LOG,
+               "FILE(%d): Too many objects in journal. Ignoring %s\n",
+               __LINE__,
+               name);
+         }
+      }
+   }
+
+   p_journal->file.end_offset = committed_offset;
+   p_journal->file.has_pending_crc = false;
+
+   /* Data after the last commit is an interrupted transaction or a damaged
+    * record. Appending after it would make the new records unreachable. */
+   p_journal->is_compaction_needed =
+      pnal_read_file (path, committed_offset, chunk, 1) != 0;
+
+   return transactions;
+}
+
+/**
+ * @internal
+ * Open the journal in a directory, unless already open.
+ *
+ * @param p_journal        InOut: Journal
+ * @param directory        In:    Directory for files. Terminated string.
+ *                                NULL or empty string is interpreted as
+ *                                current directory.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_open (
+   pf_file_journal_t * p_journal,
+   const char * directory)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint32_t generation[2] = {0};
+   bool is_valid[2] = {false};
+   uint16_t first_ix = 0;
+   uint16_t ix;
+   uint16_t n;
+
+   if (directory == NULL)
+   {
+      directory = "";
+   }
+   if (p_journal->is_open && strcmp (p_journal->directory, directory) == 0)
+   {
+      return 0;
+   }
+   if (p_journal->transaction_depth > 0 && p_journal->uncommitted_records > 0)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "FILE(%d): Can not change directory during a transaction.\n",
+         __LINE__);
+      return -1;
+   }
+   if (strlen (directory) >= sizeof (p_journal->directory))
+   {
+      return -1;
+   }
+
+   p_journal->is_open = false;
+   strcpy (p_journal->directory, directory);
+   memset (&p_journal->file, 0, sizeof (p_journal->file));
+
+   for (ix = 0; ix < 2; ix++)
+   {
+      if (pf_file_journal_get_path (p_journal, ix, path) != 0)
+      {
+         return -1;
+      }
+      is_valid[ix] = pf_file_journal_read_header (path, &generation[ix]) == 0;
+      if (is_valid[ix] && generation[ix] > p_journal->file.generation)
+      {
+         p_journal->file.generation = generation[ix];
+      }
+   }
+
+   /* Prefer the newest journal file. If a compaction was interrupted it has
+    * no committed transaction, and the other file is used instead. */
+   if (is_valid[1] && (!is_valid[0] || generation[1] > generation[0]))
+   {
+      first_ix = 1;
+   }
+   for (n = 0; n < 2; n++)
+   {
+      ix = (n == 0) ? first_ix : 1 - first_ix;
+      if (!is_valid[ix])
+      {
+         continue;
+      }
+      (void)pf_file_journal_get_path (p_journal, ix, path);
+      if (pf_file_journal_scan (p_journal, path) > 0)
+      {
+         p_journal->file.ix = ix;
+         p_journal->file.generation = generation[ix];
+         if (p_journal->is_append_failed)
+         {
+            p_journal->is_compaction_needed = true;
+         }
+         p_journal->is_open = true;
+         return 0;
+      }
+   }
+
+   /* No usable journal file. A new one is created at the first write. */
+   memset (p_journal->objects, 0, sizeof (p_journal->objects));
+   p_journal->file.ix = 0;
+   p_journal->file.sequence = 0;
+   p_journal->file.end_offset = 0;
+   p_journal->is_compaction_needed = false;
+   p_journal->is_append_failed = false;
+   p_journal->is_open = true;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Create a journal file with a new generation number.
+ *
+ * An existing file with the same name is replaced.
+ *
+ * @param p_journal        InOut: Journal
+ * @param file_ix          In:    Journal file, 0 or 1
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_create (
+   pf_file_journal_t * p_journal,
+   uint16_t file_ix)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint8_t buffer[PF_FILE_JOURNAL_HEADER_SIZE];
+   uint32_t generation = p_journal->file.generation + 1;
+   uint16_t pos = 0;
+
+   if (pf_file_journal_get_path (p_journal, file_ix, path) != 0)
+   {
+      return -1;
+   }
+
+   pf_put_uint32 (true, PF_FILE_JOURNAL_MAGIC, sizeof (buffer), buffer, &pos);
+   pf_put_uint32 (true, PF_FILE_JOURNAL_VERSION, sizeof (buffer), buffer, &pos);
+   pf_put_uint32 (true, generation, sizeof (buffer), buffer, &pos);
+   pf_put_uint32 (
+      true,
+      pf_file_calculate_crc32 (buffer, pos),
+      sizeof (buffer),
+      buffer,
+      &pos);
+
+   if (pnal_save_file (path, buffer, sizeof (buffer), NULL, 0) != 0)
+   {
+      return -1;
+   }
+
+   p_journal->file.ix = file_ix;
+   p_journal->file.generation = generation;
+   p_journal->file.sequence = 0;
+   p_journal->file.end_offset = PF_FILE_JOURNAL_HEADER_SIZE;
+   p_journal->file.has_pending_crc = false;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Encode the beginning of a journal record.
+ *
+ * The CRC of the previous record is put first, if not yet written.
+ *
+ * @param p_journal        InOut: Journal
+ * @param type             In:    Record type
+ * @param name             In:    Object name, or NULL for commit records.
+ * @param size             In:    Size of object data
+ * @param buffer           Out:   Buffer of size PF_FILE_JOURNAL_CRC_SIZE +
+ *                                PF_FILE_JOURNAL_RECORD_HEADER_SIZE +
+ *                                PNET_MAX_FILENAME_SIZE
+ * @param p_pos            Out:   Number of bytes in buffer
+ * @param p_crc            Out:   CRC so far of the new record
+ */
+static void pf_file_journal_put_record_start (
+   pf_file_journal_t * p_journal,
+   uint8_t type,
+   const char * name,
+   uint16_t size,
+   uint8_t * buffer,
+   uint16_t * p_pos,
+   uint32_t * p_crc)
+{
+   const uint16_t buffer_size = PF_FILE_JOURNAL_CRC_SIZE +
+                                PF_FILE_JOURNAL_RECORD_HEADER_SIZE +
+                                PNET_MAX_FILENAME_SIZE;
+   uint8_t name_length = (name != NULL) ? (uint8_t)strlen (name) : 0;
+   uint16_t record_start = 0;
+
+   *p_pos = 0;
+   if (p_journal->file.has_pending_crc)
+   {
+      pf_put_uint32 (
+         true,
+         p_journal->file.pending_crc,
+         buffer_size,
+         buffer,
+         p_pos);
+   }
+   record_start = *p_pos;
+
+   pf_put_byte (type, buffer_size, buffer, p_pos);
+   pf_put_byte (name_length, buffer_size, buffer, p_pos);
+   pf_put_uint16 (true, size, buffer_size, buffer, p_pos);
+   pf_put_uint32 (
+      true,
+      p_journal->file.sequence + 1,
+      buffer_size,
+      buffer,
+      p_pos);
+   memcpy (&buffer[*p_pos], name, name_length);
+   *p_pos += name_length;
+
+   *p_crc = pf_file_update_crc32 (
+      PF_FILE_CRC32_INIT,
+      &buffer[record_start],
+      *p_pos - record_start);
+}
+
+/**
+ * @internal
+ * Append an object or remove record to the active journal file.
+ *
+ * @param p_journal        InOut: Journal
+ * @param type             In:    PF_FILE_JOURNAL_RECORD_OBJECT or
+ *                                PF_FILE_JOURNAL_RECORD_REMOVE
+ * @param name             In:    Object name. Terminated string.
+ * @param p_object         In:    Object data, or NULL
+ * @param size             In:    Size of object data
+ * @param p_offset         Out:   Position of object data in journal file
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_append_record (
+   pf_file_journal_t * p_journal,
+   uint8_t type,
+   const char * name,
+   const void * p_object,
+   uint16_t size,
+   uint32_t * p_offset)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint8_t buffer
+      [PF_FILE_JOURNAL_CRC_SIZE + PF_FILE_JOURNAL_RECORD_HEADER_SIZE +
+       PNET_MAX_FILENAME_SIZE];
+   uint16_t pos = 0;
+   uint32_t crc = 0;
+
+   if (pf_file_journal_get_path (p_journal, p_journal->file.ix, path) != 0)
+   {
+      return -1;
+   }
+
+   pf_file_journal_put_record_start (
+      p_journal,
+      type,
+      name,
+      size,
+      buffer,
+      &pos,
+      &crc);
+   crc = pf_file_update_crc32 (crc, p_object, size);
+
+   if (pnal_append_file (path, buffer, pos, p_object, size) != 0)
+   {
+      return -1;
+   }
+
+   *p_offset = p_journal->file.end_offset + pos;
+   p_journal->file.end_offset += pos + size;
+   p_journal->file.pending_crc = ~crc;
+   p_journal->file.has_pending_crc = true;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Append a commit record to the active journal file.
+ *
+ * @param p_journal        InOut: Journal
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_append_commit (pf_file_journal_t * p_journal)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint8_t buffer
+      [PF_FILE_JOURNAL_CRC_SIZE + PF_FILE_JOURNAL_RECORD_HEADER_SIZE +
+       PNET_MAX_FILENAME_SIZE];
+   uint16_t pos = 0;
+   uint32_t crc = 0;
+
+   if (pf_file_journal_get_path (p_journal, p_journal->file.ix, path) != 0)
+   {
+      return -1;
+   }
+
+   pf_file_journal_put_record_start (
+      p_journal,
+      PF_FILE_JOURNAL_RECORD_COMMIT,
+      NULL,
+      0,
+      buffer,
+      &pos,
+      &crc);
+   pf_put_uint32 (true, ~crc, sizeof (buffer), buffer, &pos);
+
+   if (pnal_append_file (path, buffer, pos, NULL, 0) != 0)
+   {
+      return -1;
+   }
+
+   p_journal->file.end_offset += pos;
+   p_journal->file.has_pending_crc = false;
+   p_journal->file.sequence++;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Copy an object from another journal file to the active journal file.
+ *
+ * @param p_journal        InOut: Journal
+ * @param source_path      In:    Full path to journal file to copy from
+ * @param p_object         In:    Object to copy
+ * @param p_offset         Out:   Position of object data in active
+ *                                journal file
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_copy_record (
+   pf_file_journal_t * p_journal,
+   const char * source_path,
+   const pf_file_journal_object_t * p_object,
+   uint32_t * p_offset)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint8_t buffer
+      [PF_FILE_JOURNAL_CRC_SIZE + PF_FILE_JOURNAL_RECORD_HEADER_SIZE +
+       PNET_MAX_FILENAME_SIZE];
+   uint8_t chunk[PF_FILE_JOURNAL_COPY_CHUNK_SIZE];
+   uint16_t pos = 0;
+   uint16_t copied = 0;
+   uint16_t chunk_size = 0;
+   uint32_t crc = 0;
+
+   if (pf_file_journal_get_path (p_journal, p_journal->file.ix, path) != 0)
+   {
+      return -1;
+   }
+
+   pf_file_journal_put_record_start (
+      p_journal,
+      PF_FILE_JOURNAL_RECORD_OBJECT,
+      p_object->name,
+      p_object->size,
+      buffer,
+      &pos,
+      &crc);
+   if (pnal_append_file (path, buffer, pos, NULL, 0) != 0)
+   {
+      return -1;
+   }
+
+   for (copied = 0; copied < p_object->size; copied += chunk_size)
+   {
+      chunk_size = p_object->size - copied;
+      if (chunk_size > sizeof (chunk))
+      {
+         chunk_size = sizeof (chunk);
+      }
+      if (
+         pf_file_read_exact (
+            source_path,
+            p_object->offset + copied,
+            chunk,
+            chunk_size) != 0 ||
+         pnal_append_file (path, chunk, chunk_size, NULL, 0) != 0)
+      {
+         return -1;
+      }
+      crc = pf_file_update_crc32 (crc, chunk, chunk_size);
+   }
+
+   *p_offset = p_journal->file.end_offset + pos;
+   p_journal->file.end_offset += pos + p_object->size;
+   p_journal->file.pending_crc = ~crc;
+   p_journal->file.has_pending_crc = true;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Write all objects to the other journal file, in a single transaction.
+ *
+ * The old journal file is removed when the new one is committed.
+ * Should not be called when there are uncommitted records.
+ *
+ * @param p_journal        InOut: Journal
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred. The old journal file is still used.
+ */
+static int pf_file_journal_compact (pf_file_journal_t * p_journal)
+{
+   char old_path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   uint32_t new_offset[PF_FILE_MAX_FILES] = {0};
+   const pf_file_journal_file_t old_file = p_journal->file;
+   uint16_t ix;
+
+   LOG_DEBUG (
+      PNET_LOG,
+      "FILE(%d): Compacting journal of size %" PRIu32 "\n",
+      __LINE__,
+      old_file.end_offset);
+
+   if (
+      pf_file_journal_get_path (p_journal, old_file.ix, old_path) != 0 ||
+      pf_file_journal_create (p_journal, 1 - old_file.ix) != 0)
+   {
+      p_journal->file = old_file;
+      return -1;
+   }
+
+   for (ix = 0; ix < PF_FILE_MAX_FILES; ix++)
+   {
+      if (
+         p_journal->objects[ix].in_use &&
+         pf_file_journal_copy_record (
+            p_journal,
+            old_path,
+            &p_journal->objects[ix],
+            &new_offset[ix]) != 0)
+      {
+         p_journal->file = old_file;
+         return -1;
+      }
+   }
+   if (pf_file_journal_append_commit (p_journal) != 0)
+   {
+      p_journal->file = old_file;
+      return -1;
+   }
+
+   for (ix = 0; ix < PF_FILE_MAX_FILES; ix++)
+   {
+      p_journal->objects[ix].offset = new_offset[ix];
+   }
+   p_journal->is_compaction_needed = false;
+   p_journal->is_append_failed = false;
+   pnal_clear_file (old_path);
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Mark the journal as failed.
+ *
+ * The journal is read again from file at next access, and the ongoing
+ * transaction (if any) will not be committed. A failed append might have
+ * written part of a record, so nothing more is appended to the active
+ * file. It is compacted into the other journal file at the next write.
+ *
+ * @param p_journal        InOut: Journal
+ */
+static void pf_file_journal_fail (pf_file_journal_t * p_journal)
+{
+   p_journal->is_open = false;
+   p_journal->is_append_failed = true;
+   p_journal->uncommitted_records = 0;
+   if (p_journal->transaction_depth > 0)
+   {
+      p_journal->is_transaction_failed = true;
+   }
+}
+
+/**
+ * @internal
+ * Commit the records written since the last commit.
+ *
+ * @param p_journal        InOut: Journal
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_commit (pf_file_journal_t * p_journal)
+{
+   if (p_journal->is_transaction_failed)
+   {
+      p_journal->is_transaction_failed = false;
+      return -1;
+   }
+   if (p_journal->uncommitted_records == 0)
+   {
+      return 0;
+   }
+   if (pf_file_journal_append_commit (p_journal) != 0)
+   {
+      pf_file_journal_fail (p_journal);
+      return -1;
+   }
+   p_journal->uncommitted_records = 0;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Write an object to the journal, or remove it.
+ *
+ * Committed directly unless a transaction is ongoing.
+ *
+ * @param p_journal        InOut: Journal
+ * @param directory        In:    Directory for files. Terminated string.
+ * @param filename         In:    File name. Terminated string.
+ * @param type             In:    PF_FILE_JOURNAL_RECORD_OBJECT or
+ *                                PF_FILE_JOURNAL_RECORD_REMOVE
+ * @param p_object         In:    Object data, or NULL
+ * @param size             In:    Size of object data
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+static int pf_file_journal_write (
+   pf_file_journal_t * p_journal,
+   const char * directory,
+   const char * filename,
+   uint8_t type,
+   const void * p_object,
+   size_t size)
+{
+   uint32_t offset = 0;
+
+   if (
+      p_journal->is_transaction_failed ||
+      pf_file_journal_open (p_journal, directory) != 0)
+   {
+      return -1;
+   }
+   if (size > UINT16_MAX || strlen (filename) >= PNET_MAX_FILENAME_SIZE)
+   {
+      return -1;
+   }
+   if (type == PF_FILE_JOURNAL_RECORD_REMOVE)
+   {
+      if (pf_file_journal_find (p_journal->objects, filename) == NULL)
+      {
+         return 0;
+      }
+   }
+   else if (pf_file_journal_find_or_free (p_journal->objects, filename) == NULL)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "FILE(%d): Too many objects in journal. Can not save %s\n",
+         __LINE__,
+         filename);
+      return -1;
+   }
+
+   if (p_journal->uncommitted_records == 0)
+   {
+      if (p_journal->file.end_offset == 0)
+      {
+         if (pf_file_journal_create (p_journal, p_journal->file.ix) != 0)
+         {
+            pf_file_journal_fail (p_journal);
+            return -1;
+         }
+      }
+      else if (
+         p_journal->is_compaction_needed ||
+         p_journal->file.end_offset > PF_FILE_JOURNAL_COMPACTION_SIZE)
+      {
+         if (pf_file_journal_compact (p_journal) != 0)
+         {
+            pf_file_journal_fail (p_journal);
+            return -1;
+         }
+      }
+   }
+
+   if (
+      pf_file_journal_append_record (
+         p_journal,
+         type,
+         filename,
+         p_object,
+         (uint16_t)size,
+         &offset) != 0)
+   {
+      pf_file_journal_fail (p_journal);
+      return -1;
+   }
+   (void)pf_file_journal_apply (
+      p_journal->objects,
+      type,
+      filename,
+      offset,
+      (uint16_t)size);
+   p_journal->uncommitted_records++;
+
+   if (p_journal->transaction_depth == 0)
+   {
+      return pf_file_journal_commit (p_journal);
+   }
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Load an object from the journal.
+ *
+ * @param p_journal        InOut: Journal
+ * @param directory        In:    Directory for files. Terminated string.
+ * @param filename         In:    File name. Terminated string.
+ * @param p_object         Out:   Struct to load
+ * @param size             In:    Size of struct to load
+ * @return  0  if the operation succeeded.
+ *          -1 if not found, of wrong size or an error occurred.
+ */
+static int pf_file_journal_load (
+   pf_file_journal_t * p_journal,
+   const char * directory,
+   const char * filename,
+   void * p_object,
+   size_t size)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   const pf_file_journal_object_t * p_journal_object = NULL;
+
+   if (pf_file_journal_open (p_journal, directory) != 0)
+   {
+      return -1;
+   }
+
+   p_journal_object = pf_file_journal_find (p_journal->objects, filename);
+   if (p_journal_object == NULL)
+   {
+      return -1;
+   }
+   if (p_journal_object->size != size)
+   {
+      LOG_WARNING (
+         PNET_LOG,
+         "FILE(%d): Wrong size of %s in journal. Expected %zu but got %u.\n",
+         __LINE__,
+         filename,
+         size,
+         (unsigned)p_journal_object->size);
+      return -1;
+   }
+
+   if (
+      pf_file_journal_get_path (p_journal, p_journal->file.ix, path) != 0 ||
+      pf_file_read_exact (path, p_journal_object->offset, p_object, size) != 0)
+   {
+      return -1;
+   }
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Get the journal to use.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @param p_temporary      Temp:  Journal to use if no stack instance is given
+ * @return  the journal.
+ */
+static pf_file_journal_t * pf_file_get_journal (
+   pnet_t * net,
+   pf_file_journal_t * p_temporary)
+{
+   if (net != NULL)
+   {
+      return &net->file_journal;
+   }
+
+   memset (p_temporary, 0, sizeof (*p_temporary));
+   return p_temporary;
+}
+
+/**
+ * @internal
+ * Load an object from the journal, or from a file written by an earlier
+ * version.
+ *
+ * @param p_journal        InOut: Journal
+ * @param directory        In:    Directory for files. Terminated string.
+ * @param filename         In:    File name. Terminated string.
+ * @param path             In:    Full path to file. Terminated string.
+ * @param p_object         Out:   Struct to load
+ * @param size             In:    Size of struct to load
+ * @return  0  if the operation succeeded.
+ *          -1 if not found or an error occurred.
+ */
+static int pf_file_load_object (
+   pf_file_journal_t * p_journal,
+   const char * directory,
+   const char * filename,
+   const char * path,
+   void * p_object,
+   size_t size)
+{
+   if (
+      pf_file_journal_load (p_journal, directory, filename, p_object, size) ==
+      0)
+   {
+      return 0;
+   }
+
+   return pf_file_load_path (path, p_object, size);
+}
+
+int pf_file_load (
+   pnet_t * net,
+   const char * directory,
+   const char * filename,
+   void * p_object,
+   size_t size)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   pf_file_journal_t temporary_journal;
+   pf_file_journal_t * p_journal = NULL;
+   uint32_t start_time_us = os_get_current_time_us();
+   int ret = 0;
+
+   if (
+      pf_file_join_directory_filename (
+         directory,
+         filename,
+         path,
+         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+   {
+      return -1;
+   }
+
+   pf_file_lock (net);
+   p_journal = pf_file_get_journal (net, &temporary_journal);
+   ret = pf_file_load_object (
+      p_journal,
+      directory,
+      filename,
+      path,
+      p_object,
+      size);
+   if (ret == 0)
+   {
+      pf_file_cache_update (
+         net,
+         path,
+         pf_file_calculate_crc32 (p_object, size),
+         size);
+      LOG_DEBUG (
+         PNET_LOG,
+         "FILE(%d): Did read %s Access time %" PRIu32 " ms.\n",
+         __LINE__,
+         path,
+         ((os_get_current_time_us() - start_time_us) / 1000));
+   }
+   pf_file_unlock (net);
+
+   return ret;
+}
+
+int pf_file_save (
+   pnet_t * net,
+   const char * directory,
+   const char * filename,
+   const void * p_object,
+   size_t size)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   pf_file_journal_t temporary_journal;
+   pf_file_journal_t * p_journal = NULL;
+   uint32_t start_time_us = os_get_current_time_us();
+   int ret = 0;
+
+   if (
+      pf_file_join_directory_filename (
+         directory,
+         filename,
+         path,
+         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+   {
+      return -1;
+   }
+
+   pf_file_lock (net);
+   p_journal = pf_file_get_journal (net, &temporary_journal);
+   ret = pf_file_journal_write (
+      p_journal,
+      directory,
+      filename,
+      PF_FILE_JOURNAL_RECORD_OBJECT,
+      p_object,
+      size);
+   if (ret == 0)
+   {
+      pf_file_cache_update (
+         net,
+         path,
+         pf_file_calculate_crc32 (p_object, size),
+         size);
+      LOG_DEBUG (
+         PNET_LOG,
+         "FILE(%d): Did save %s Access time %" PRIu32 " ms.\n",
+         __LINE__,
+         path,
+         ((os_get_current_time_us() - start_time_us) / 1000));
+   }
+   else
+   {
+      pf_file_cache_remove (net, path);
+   }
+   pf_file_unlock (net);
+
+   return ret;
+}
+
+int pf_file_save_if_modified (
+   pnet_t * net,
+   const char * directory,
+   const char * filename,
+   const void * p_object,
+   void * p_tempobject,
+   size_t size)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   pf_file_journal_t temporary_journal;
+   pf_file_journal_t * p_journal = NULL;
+   const pf_file_cache_entry_t * p_entry = NULL;
+   uint32_t crc = 0;
+   bool save = false;
+   int ret = 0; /* Assume no changes */
+
+   if (
+      pf_file_join_directory_filename (
+         directory,
+         filename,
+         path,
+         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+   {
+      return -1;
+   }
+
+   crc = pf_file_calculate_crc32 (p_object, size);
+
+   pf_file_lock (net);
+   p_journal = pf_file_get_journal (net, &temporary_journal);
+   if (net != NULL)
+   {
+      p_entry = pf_file_cache_find (net, path);
+   }
+   if (p_entry != NULL)
+   {
+      /* The file contents are known. No need to read the file. */
+      if (p_entry->size != size || p_entry->crc != crc)
+      {
+         ret = 1;
+         save = true;
+      }
+   }
+   else
+   {
+      memset (p_tempobject, 0, size);
+
+      if (
+         pf_file_load_object (
+            p_journal,
+            directory,
+            filename,
+            path,
+            p_tempobject,
+            size) == 0)
+      {
+         if (memcmp (p_tempobject, p_object, size) != 0)
+         {
+            ret = 1;
+            save = true;
+         }
+         else
+         {
+            pf_file_cache_update (net, path, crc, size);
+         }
+      }
+      else
+      {
+         ret = 2;
+         save = true;
+      }
+   }
+
+   if (save == true)
+   {
+      if (
+         pf_file_journal_write (
+            p_journal,
+            directory,
+            filename,
+            PF_FILE_JOURNAL_RECORD_OBJECT,
+            p_object,
+            size) == 0)
+      {
+         pf_file_cache_update (net, path, crc, size);
+      }
+      else
+      {
+         pf_file_cache_remove (net, path);
+         ret = -1;
+      }
+   }
+   pf_file_unlock (net);
+
+   return ret;
+}
+
+void pf_file_clear (pnet_t * net, const char * directory, const char * filename)
+{
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /**< Terminated string */
+   pf_file_journal_t temporary_journal;
+   pf_file_journal_t * p_journal = NULL;
+
+   if (
+      pf_file_join_directory_filename (
+         directory,
+         filename,
+         path,
+         PNET_MAX_FILE_FULLPATH_SIZE) != 0)
+   {
+      return;
+   }
+
+   pf_file_lock (net);
+   p_journal = pf_file_get_journal (net, &temporary_journal);
+   pf_file_cache_remove (net, path);
+   (void)pf_file_journal_write (
+      p_journal,
+      directory,
+      filename,
+      PF_FILE_JOURNAL_RECORD_REMOVE,
+      NULL,
+      0);
+   pnal_clear_file (path);
+   pf_file_unlock (net);
+}
+
+void pf_file_transaction_begin (pnet_t * net)
+{
+   if (net == NULL)
+   {
+      return;
+   }
+
+   pf_file_lock (net);
+   net->file_journal.transaction_depth++;
+}
+
+int pf_file_transaction_commit (pnet_t * net)
+{
+   int ret = 0;
+
+   if (net == NULL)
+   {
+      return 0;
+   }
+
+   CC_ASSERT (net->file_journal.transaction_depth > 0);
+   if (net->file_journal.transaction_depth == 1)
+   {
+      ret = pf_file_journal_commit (&net->file_journal);
+      pf_file_cache_end_transaction (net, ret == 0);
+   }
+   net->file_journal.transaction_depth--;
+   pf_file_unlock (net);
+
+   return ret;
 }
@@ -28,14 +28,41 @@ extern "C" {
 #define PF_FILENAME_IP          "pnet_data_ip.bin"
 #define PF_FILENAME_IM          "pnet_data_im.bin"
 #define PF_FILENAME_DIAGNOSTICS "pnet_data_diagnostics.bin"
+#define PF_FILENAME_FSU         "pnet_data_fsu.bin"
 #define PF_FILENAME_PDPORT_1    "pnet_data_pdport_1.bin"
 #define PF_FILENAME_PDPORT_2    "pnet_data_pdport_2.bin"
 #define PF_FILENAME_PDPORT_3    "pnet_data_pdport_3.bin"
 #define PF_FILENAME_PDPORT_4    "pnet_data_pdport_4.bin"
 
+/* Journal files, holding the objects above */
+#define PF_FILENAME_JOURNAL_1 "pnet_data_journal_1.bin"
+#define PF_FILENAME_JOURNAL_2 "pnet_data_journal_2.bin"
+
+/* The journal is compacted when it has grown beyond this size */
+#ifndef PF_FILE_JOURNAL_COMPACTION_SIZE
+#define PF_FILE_JOURNAL_COMPACTION_SIZE 4096
+#endif
+
+/**
+ * Initialize the file handling.
+ *
+ * Creates the file mutex and clears the cache of known file contents.
+ * The journal is read at first access.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_file_init (pnet_t * net);
+
 /**
  * Load a binary file, and verify the file version.
  *
+ * The file is read from the journal. If not found there, a separate file
+ * written by an earlier version is read.
+ *
+ * @param net              InOut: The p-net stack instance. NULL if no
+ *                                stack instance is available, in which case
+ *                                the cache of known file contents is not
+ *                                used or updated.
  * @param directory        In:    Directory for files. Terminated string. NULL
  *                                or empty string is interpreted as current
  *                                directory.
@@ -46,6 +73,7 @@ extern "C" {
  *          -1 if not found or an error occurred (for example wrong version).
  */
 int pf_file_load (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    void * p_object,
@@ -54,6 +82,13 @@ int pf_file_load (
 /**
  * Save a binary file, and include version information.
  *
+ * The file is appended to the journal, and committed unless a transaction
+ * is ongoing.
+ *
+ * @param net              InOut: The p-net stack instance. NULL if no
+ *                                stack instance is available, in which case
+ *                                the cache of known file contents is not
+ *                                used or updated.
  * @param directory        In:    Directory for files. Terminated string. NULL
  *                                or empty string is interpreted as current
  *                                directory.
@@ -64,6 +99,7 @@ int pf_file_load (
  *          -1 if an error occurred.
  */
 int pf_file_save (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
@@ -75,6 +111,14 @@ int pf_file_save (
  * No saving is done if the content would be the same. This reduces the flash
  * memory wear.
  *
+ * The CRC32 of the contents last read or written is remembered per file.
+ * If known, the file is not read at all. Otherwise the existing file is
+ * loaded into \a p_tempobject and compared.
+ *
+ * @param net              InOut: The p-net stack instance. NULL if no
+ *                                stack instance is available, in which case
+ *                                the cache of known file contents is not
+ *                                used or updated.
  * @param directory        In:    Directory for files. Terminated string. NULL
  *                                or empty string is interpreted as current
  *                                directory.
@@ -89,6 +133,7 @@ int pf_file_save (
  *          -1 if an error occurred.
  */
 int pf_file_save_if_modified (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
@@ -98,12 +143,43 @@ int pf_file_save_if_modified (
 /**
  * Clear a binary file.
  *
+ * @param net              InOut: The p-net stack instance. NULL if no
+ *                                stack instance is available, in which case
+ *                                the cache of known file contents is not
+ *                                used or updated.
  * @param directory        In:    Directory for files. Terminated string. NULL
  *                                or empty string is interpreted as current
  *                                directory.
  * @param filename         In:    File name. Terminated string.
  */
-void pf_file_clear (const char * directory, const char * filename);
+void pf_file_clear (
+   pnet_t * net,
+   const char * directory,
+   const char * filename);
+
+/**
+ * Start a transaction.
+ *
+ * Files saved or cleared before pf_file_transaction_commit() is called are
+ * committed together. After a power loss either all of them, or none, are
+ * updated. Transactions may be nested, and only the outermost one is
+ * committed.
+ *
+ * Other threads can not access files during the transaction.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL. If NULL
+ *                                every file is committed by itself.
+ */
+void pf_file_transaction_begin (pnet_t * net);
+
+/**
+ * Commit a transaction started by pf_file_transaction_begin().
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred. No file in the transaction is updated.
+ */
+int pf_file_transaction_commit (pnet_t * net);
 
 /************ Internal functions, made available for unit testing ************/
 
@@ -0,0 +1,273 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2021 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+/**
+ * @file
+ * @brief Pool of pre-allocated frame buffers
+ *
+ * DCP responses and alarm frames sent by the stack use buffers from this
+ * pool, so that no heap allocation is done per frame.
+ *
+ * The buffers are allocated from pnal at the first startup, and are kept
+ * if the stack instance is initialized again. A bitmap with one bit per
+ * buffer tells which buffers are free. Allocation atomically clears a
+ * bit, and freeing atomically sets it, so no lock is needed and the pool
+ * can be used from several threads. Without atomics (PNET_USE_ATOMICS 0)
+ * a mutex is used instead.
+ */
+
+#ifdef UNIT_TEST
+#define pnal_buf_alloc mock_pnal_buf_alloc
+#endif
+
+#include "pf_includes.h"
+
+#include <inttypes.h>
+
+CC_STATIC_ASSERT (PF_FRAME_POOL_BITS_PER_WORD <= 31);
+
+/**
+ * @internal
+ * Lock the pool, if atomics are not available.
+ *
+ * @param pool             InOut: Frame pool
+ */
+static void pf_frame_pool_lock (pf_frame_pool_t * pool)
+{
+#if !PNET_USE_ATOMICS
+   os_mutex_lock (pool->mutex);
+#endif
+}
+
+/**
+ * @internal
+ * Unlock the pool, if atomics are not available.
+ *
+ * @param pool             InOut: Frame pool
+ */
+static void pf_frame_pool_unlock (pf_frame_pool_t * pool)
+{
+#if !PNET_USE_ATOMICS
+   os_mutex_unlock (pool->mutex);
+#endif
+}
+
+void pf_frame_pool_init (pnet_t * net)
+{
+   pf_frame_pool_t * pool = &net->frame_pool;
+   uint16_t ix;
+
+   if (pool->p_self != pool)
+   {
+      memset (pool, 0, sizeof (*pool));
+      pool->p_self = pool;
+#if !PNET_USE_ATOMICS
+      pool->mutex = os_mutex_create();
+      CC_ASSERT (pool->mutex != NULL);
+#endif
+
+      for (ix = 0; ix < PF_FRAME_POOL_SIZE; ix++)
+      {
+         pool->buffers[ix] = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+         if (pool->buffers[ix] == NULL)
+         {
+            LOG_WARNING (
+               PNET_LOG,
+               "FRAME_POOL(%d): Could only allocate %u of %u frame "
+               "buffers.\n",
+               __LINE__,
+               (unsigned)ix,
+               (unsigned)PF_FRAME_POOL_SIZE);
+            break;
+         }
+         pool->number_of_buffers++;
+      }
+   }
+
+   /* All buffers are free */
+   memset (pool->free_bits, 0, sizeof (pool->free_bits));
+   for (ix = 0; ix < pool->number_of_buffers; ix++)
+   {
+      (void)atomic_fetch_or (
+         &pool->free_bits[ix / PF_FRAME_POOL_BITS_PER_WORD],
+         1U << (ix % PF_FRAME_POOL_BITS_PER_WORD));
+   }
+   pool->in_use = 0;
+   pool->high_watermark = 0;
+   pool->fallback_allocations = 0;
+}
+
+void pf_frame_pool_exit (pnet_t * net)
+{
+   pf_frame_pool_t * pool = &net->frame_pool;
+   uint16_t ix;
+
+   if (pool->p_self != pool)
+   {
+      return;
+   }
+
+   for (ix = 0; ix < pool->number_of_buffers; ix++)
+   {
+      pnal_buf_free (pool->buffers[ix]);
+   }
+#if !PNET_USE_ATOMICS
+   os_mutex_destroy (pool->mutex);
+#endif
+   memset (pool, 0, sizeof (*pool));
+}
+
+/**
+ * @internal
+ * Find the pool index of a buffer.
+ *
+ * @param pool             In:    Frame pool
+ * @param p_buf            In:    Buffer
+ * @return  the index, or -1 if the buffer is not from the pool.
+ */
+static int pf_frame_pool_find (
+   const pf_frame_pool_t * pool,
+   const pnal_buf_t * p_buf)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < pool->number_of_buffers; ix++)
+   {
+      if (pool->buffers[ix] == p_buf)
+      {
+         return ix;
+      }
+   }
+
+   return -1;
+}
+
+/**
+ * @internal
+ * Take a free buffer from the pool.
+ *
+ * @param pool             InOut: Frame pool
+ * @return  the index of the buffer, or -1 if the pool is empty.
+ */
+static int pf_frame_pool_take (pf_frame_pool_t * pool)
+{
+   uint32_t free_bits;
+   uint32_t previous;
+   uint32_t bit;
+   uint16_t word;
+   uint16_t pos;
+
+   for (word = 0; word < PF_FRAME_POOL_WORDS; word++)
+   {
+      free_bits = (uint32_t)atomic_fetch_or (&pool->free_bits[word], 0);
+      while (free_bits != 0)
+      {
+         /* Lowest free buffer in this word */
+         pos = 0;
+         while ((free_bits & (1U << pos)) == 0)
+         {
+            pos++;
+         }
+         bit = 1U << pos;
+
+         /* Another thread may have taken it since the bits were read */
+         previous = (uint32_t)atomic_fetch_and (&pool->free_bits[word], ~bit);
+         if ((previous & bit) != 0)
+         {
+            return word * PF_FRAME_POOL_BITS_PER_WORD + pos;
+         }
+         free_bits = previous & ~bit;
+      }
+   }
+
+   return -1;
+}
+
+pnal_buf_t * pf_frame_buf_alloc (pnet_t * net, uint16_t length)
+{
+   pf_frame_pool_t * pool = &net->frame_pool;
+   pnal_buf_t * p_buf = NULL;
+   uint32_t in_use;
+   int ix = -1;
+
+   pf_frame_pool_lock (pool);
+   if (length <= PF_FRAME_BUFFER_SIZE)
+   {
+      ix = pf_frame_pool_take (pool);
+   }
+   if (ix < 0)
+   {
+      (void)atomic_fetch_add (&pool->fallback_allocations, 1);
+      pf_frame_pool_unlock (pool);
+      return pnal_buf_alloc (length);
+   }
+
+   in_use = (uint32_t)atomic_fetch_add (&pool->in_use, 1) + 1;
+   if (in_use > (uint32_t)pool->high_watermark)
+   {
+      pool->high_watermark = in_use;
+   }
+   pf_frame_pool_unlock (pool);
+
+   p_buf = pool->buffers[ix];
+   p_buf->len = length;
+
+   return p_buf;
+}
+
+void pf_frame_buf_free (pnet_t * net, pnal_buf_t * p_buf)
+{
+   pf_frame_pool_t * pool = &net->frame_pool;
+   int ix;
+
+   if (p_buf == NULL)
+   {
+      return;
+   }
+
+   ix = pf_frame_pool_find (pool, p_buf);
+   if (ix < 0)
+   {
+      pnal_buf_free (p_buf);
+      return;
+   }
+
+   pf_frame_pool_lock (pool);
+   (void)atomic_fetch_sub (&pool->in_use, 1);
+   (void)atomic_fetch_or (
+      &pool->free_bits[ix / PF_FRAME_POOL_BITS_PER_WORD],
+      1U << (ix % PF_FRAME_POOL_BITS_PER_WORD));
+   pf_frame_pool_unlock (pool);
+}
+
+void pf_frame_pool_show (pnet_t * net)
+{
+   pf_frame_pool_t * pool = &net->frame_pool;
+
+   printf ("Frame buffer pool:\n");
+   printf (
+      "Buffers                      : %u of %u bytes\n",
+      (unsigned)pool->number_of_buffers,
+      (unsigned)PF_FRAME_BUFFER_SIZE);
+   printf (
+      "In use                       : %u\n",
+      (unsigned)atomic_fetch_add (&pool->in_use, 0));
+   printf (
+      "High watermark               : %u\n",
+      (unsigned)atomic_fetch_add (&pool->high_watermark, 0));
+   printf (
+      "Allocations outside pool     : %u\n",
+      (unsigned)atomic_fetch_add (&pool->fallback_allocations, 0));
+}
@@ -0,0 +1,79 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2021 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#ifndef PF_FRAME_POOL_H
+#define PF_FRAME_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the frame buffer pool.
+ *
+ * Allocates PF_FRAME_POOL_SIZE buffers of PF_FRAME_BUFFER_SIZE bytes
+ * from pnal. If the pool already is initialized, for example when the
+ * stack instance is initialized again, the buffers are kept and all
+ * of them are marked as free.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_frame_pool_init (pnet_t * net);
+
+/**
+ * Free the buffers of the frame buffer pool.
+ *
+ * No buffer from the pool may be in use.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_frame_pool_exit (pnet_t * net);
+
+/**
+ * Allocate a frame buffer.
+ *
+ * Takes a buffer from the pool if possible. Does not block, and may be
+ * called from any thread. Falls back to \a pnal_buf_alloc() if the pool
+ * is empty or a buffer larger than PF_FRAME_BUFFER_SIZE is requested.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param length           In:    Length, in bytes
+ * @return a buffer, or NULL at failure
+ */
+pnal_buf_t * pf_frame_buf_alloc (pnet_t * net, uint16_t length);
+
+/**
+ * Free a frame buffer.
+ *
+ * Buffers from the pool are returned to it. Other buffers, for example
+ * received frames, are freed by \a pnal_buf_free().
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_buf            In:    Buffer to free. May be NULL.
+ */
+void pf_frame_buf_free (pnet_t * net, pnal_buf_t * p_buf);
+
+/**
+ * Show frame buffer pool statistics.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_frame_pool_show (pnet_t * net);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PF_FRAME_POOL_H */
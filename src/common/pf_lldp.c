@@ -16,6 +16,7 @@
 #ifdef UNIT_TEST
 #define pnal_get_system_uptime_10ms mock_pnal_get_system_uptime_10ms
 #define pnal_get_interface_index    mock_pnal_get_interface_index
+#define pnal_buf_alloc              mock_pnal_buf_alloc
 #endif
 
 #define STRINGIFY(s)   STRINGIFIED (s)
@@ -462,6 +463,7 @@ void pf_lldp_invalidate_peer_info (pnet_t * net, int loc_port_num)
    pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
 
    os_mutex_lock (net->lldp_mutex);
+   p_port_data->lldp.is_rx_frame_valid = false;
    p_port_data->lldp.is_peer_info_received = false;
    p_port_data->lldp.peer_info.chassis_id.is_valid = false;
    p_port_data->lldp.peer_info.port_id.is_valid = false;
@@ -1047,7 +1049,53 @@ size_t pf_lldp_construct_frame (pnet_t * net, int loc_port_num, uint8_t buf[])
 }
 
 /**
- * Build and send a LLDP message on a specific port.
+ * @internal
+ * Compare two link statuses.
+ *
+ * @param p_a              In:    First link status.
+ * @param p_b              In:    Second link status.
+ * @return true if equal, false if not.
+ */
+static bool pf_lldp_is_link_status_equal (
+   const pf_lldp_link_status_t * p_a,
+   const pf_lldp_link_status_t * p_b)
+{
+   return (p_a->is_autonegotiation_supported ==
+           p_b->is_autonegotiation_supported) &&
+          (p_a->is_autonegotiation_enabled ==
+           p_b->is_autonegotiation_enabled) &&
+          (p_a->autonegotiation_advertised_capabilities ==
+           p_b->autonegotiation_advertised_capabilities) &&
+          (p_a->operational_mau_type == p_b->operational_mau_type) &&
+          (p_a->is_valid == p_b->is_valid);
+}
+
+void pf_lldp_invalidate_tx_frame (pnet_t * net, int loc_port_num)
+{
+   pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
+
+   p_port_data->lldp.is_tx_frame_valid = false;
+}
+
+void pf_lldp_invalidate_tx_frames (pnet_t * net)
+{
+   int port;
+   pf_port_iterator_t port_iterator;
+
+   pf_port_init_iterator_over_ports (net, &port_iterator);
+   port = pf_port_get_next (&port_iterator);
+   while (port != 0)
+   {
+      pf_lldp_invalidate_tx_frame (net, port);
+      port = pf_port_get_next (&port_iterator);
+   }
+}
+
+/**
+ * Send a LLDP message on a specific port.
+ *
+ * The frame is kept in a per-port buffer, and is only rebuilt when it has
+ * been invalidated or the link status has changed.
  *
  * @param net              InOut: The p-net stack instance
  * @param loc_port_num     In:    Local port number.
@@ -1055,22 +1103,45 @@ size_t pf_lldp_construct_frame (pnet_t * net, int loc_port_num, uint8_t buf[])
  */
 static void pf_lldp_send (pnet_t * net, int loc_port_num)
 {
-   /* FIXME: Buffer size should include Ethernet header (14 bytes) */
-   pnal_buf_t * p_buffer = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
+   pnal_buf_t * p_buffer = (pnal_buf_t *)p_port_data->lldp.p_tx_buffer;
+   pf_lldp_link_status_t link_status;
 
    if (p_buffer == NULL)
+   {
+      /* FIXME: Buffer size should include Ethernet header (14 bytes) */
+      p_buffer = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+      if (p_buffer == NULL)
+      {
+         return;
+      }
+      p_port_data->lldp.p_tx_buffer = p_buffer;
+      p_port_data->lldp.is_tx_frame_valid = false;
+   }
+
+   if (p_buffer->payload == NULL)
    {
       return;
    }
 
-   if (p_buffer->payload != NULL)
+   /* The link status is polled, so there is no event to invalidate on */
+   pf_lldp_get_link_status (net, loc_port_num, &link_status);
+   if (!pf_lldp_is_link_status_equal (
+          &link_status,
+          &p_port_data->lldp.tx_link_status))
+   {
+      p_port_data->lldp.is_tx_frame_valid = false;
+   }
+
+   if (p_port_data->lldp.is_tx_frame_valid == false)
    {
       p_buffer->len =
          pf_lldp_construct_frame (net, loc_port_num, p_buffer->payload);
-      (void)pf_eth_send_on_physical_port (net, loc_port_num, p_buffer);
+      p_port_data->lldp.tx_link_status = link_status;
+      p_port_data->lldp.is_tx_frame_valid = true;
    }
 
-   pnal_buf_free (p_buffer);
+   (void)pf_eth_send_on_physical_port (net, loc_port_num, p_buffer);
 }
 
 /**
@@ -1123,6 +1194,9 @@ static void pf_lldp_tx_restart (pnet_t * net, int loc_port_num, bool send)
 {
    pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
 
+   /* Port configuration might have been changed */
+   pf_lldp_invalidate_tx_frame (net, loc_port_num);
+
    if (
       pf_scheduler_restart (
          net,
@@ -1144,6 +1218,29 @@ static void pf_lldp_tx_restart (pnet_t * net, int loc_port_num, bool send)
    }
 }
 
+/**
+ * @internal
+ * Free the buffer holding the pre-encoded LLDP frame of a port.
+ *
+ * It is allocated again at next transmission.
+ *
+ * @param p_port_data      InOut: Port data
+ */
+static void pf_lldp_free_tx_buffer (pf_port_t * p_port_data)
+{
+   if (p_port_data->lldp.p_self != &p_port_data->lldp)
+   {
+      return;
+   }
+
+   if (p_port_data->lldp.p_tx_buffer != NULL)
+   {
+      pnal_buf_free ((pnal_buf_t *)p_port_data->lldp.p_tx_buffer);
+      p_port_data->lldp.p_tx_buffer = NULL;
+   }
+   p_port_data->lldp.is_tx_frame_valid = false;
+}
+
 void pf_lldp_init (pnet_t * net)
 {
    int port;
@@ -1156,7 +1253,9 @@ void pf_lldp_init (pnet_t * net)
    {
       p_port_data = pf_port_get_state (net, port);
 
+      pf_lldp_free_tx_buffer (p_port_data);
       memset (&p_port_data->lldp, 0, sizeof (p_port_data->lldp));
+      p_port_data->lldp.p_self = &p_port_data->lldp;
       pf_scheduler_init_handle (&p_port_data->lldp.rx_timeout, "lldp_rx");
       pf_scheduler_init_handle (&p_port_data->lldp.tx_timeout, "lldp_tx");
 
@@ -1167,6 +1266,28 @@ void pf_lldp_init (pnet_t * net)
    CC_ASSERT (net->lldp_mutex != NULL);
 }
 
+void pf_lldp_exit (pnet_t * net)
+{
+   int port;
+   pf_port_iterator_t port_iterator;
+   pf_port_t * p_port_data = NULL;
+
+   pf_port_init_iterator_over_ports (net, &port_iterator);
+   port = pf_port_get_next (&port_iterator);
+   while (port != 0)
+   {
+      p_port_data = pf_port_get_state (net, port);
+
+      if (p_port_data->lldp.p_self == &p_port_data->lldp)
+      {
+         pf_scheduler_remove_if_running (net, &p_port_data->lldp.tx_timeout);
+         pf_lldp_free_tx_buffer (p_port_data);
+      }
+
+      port = pf_port_get_next (&port_iterator);
+   }
+}
+
 void pf_lldp_send_enable (pnet_t * net, int loc_port_num)
 {
    LOG_DEBUG (
@@ -1187,6 +1308,7 @@ void pf_lldp_send_disable (pnet_t * net, int loc_port_num)
       __LINE__,
       loc_port_num);
    pf_scheduler_remove_if_running (net, &p_port_data->lldp.tx_timeout);
+   pf_lldp_free_tx_buffer (p_port_data);
 }
 
 /**
@@ -1957,6 +2079,37 @@ void pf_lldp_update_peer (
    pf_pdport_peer_indication (net, loc_port_num);
 }
 
+/**
+ * @internal
+ * Check if a received LLDP frame is identical to the last decoded frame
+ * on the port.
+ *
+ * The length is compared first, and the content only on a length match.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_port_data      In:    Port instance.
+ * @param buf              In:    Received TLV region.
+ * @param len              In:    Length of the received TLV region.
+ * @return true if the frame is unchanged, false if it must be decoded.
+ */
+static bool pf_lldp_is_frame_unchanged (
+   pnet_t * net,
+   const pf_port_t * p_port_data,
+   const uint8_t buf[],
+   uint16_t len)
+{
+   bool is_unchanged;
+
+   os_mutex_lock (net->lldp_mutex);
+   is_unchanged = p_port_data->lldp.is_rx_frame_valid &&
+                  p_port_data->lldp.is_peer_info_received &&
+                  (p_port_data->lldp.rx_frame_len == len) &&
+                  (memcmp (p_port_data->lldp.rx_frame, buf, len) == 0);
+   os_mutex_unlock (net->lldp_mutex);
+
+   return is_unchanged;
+}
+
 int pf_lldp_recv (
    pnet_t * net,
    int loc_port_num,
@@ -1966,8 +2119,26 @@ int pf_lldp_recv (
    uint8_t * buf = p_frame_buf->payload + offset;
    uint16_t buf_len = p_frame_buf->len - offset;
    pf_lldp_peer_info_t peer_data;
+   pf_port_t * p_port_data;
    int err = 0;
 
+   /* Fast path: Neighbours repeat the same frame, so only restart the
+      peer timeout if nothing has changed since the last decoded frame. */
+   if (pf_port_is_valid (net, loc_port_num))
+   {
+      p_port_data = pf_port_get_state (net, loc_port_num);
+      if (pf_lldp_is_frame_unchanged (net, p_port_data, buf, buf_len))
+      {
+         pf_lldp_restart_peer_timeout (
+            net,
+            loc_port_num,
+            p_port_data->lldp.peer_info.ttl);
+         pnal_buf_free (p_frame_buf);
+
+         return 1; /* Means: handled */
+      }
+   }
+
    err = pf_lldp_parse_packet (buf, buf_len, &peer_data);
 
    if (!err)
@@ -2019,6 +2190,17 @@ int pf_lldp_recv (
       if (pf_port_is_valid (net, loc_port_num))
       {
          pf_lldp_update_peer (net, loc_port_num, &peer_data);
+
+         p_port_data = pf_port_get_state (net, loc_port_num);
+         os_mutex_lock (net->lldp_mutex);
+         p_port_data->lldp.is_rx_frame_valid =
+            (buf_len <= sizeof (p_port_data->lldp.rx_frame));
+         if (p_port_data->lldp.is_rx_frame_valid)
+         {
+            p_port_data->lldp.rx_frame_len = buf_len;
+            memcpy (p_port_data->lldp.rx_frame, buf, buf_len);
+         }
+         os_mutex_unlock (net->lldp_mutex);
       }
       else
       {
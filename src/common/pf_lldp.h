@@ -593,6 +593,13 @@ void pf_lldp_mac_address_to_string (
  */
 void pf_lldp_init (pnet_t * net);
 
+/**
+ * Stop sending LLDP frames and free the LLDP transmission buffers.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_lldp_exit (pnet_t * net);
+
 /**
  * Start or restart a timer that monitors reception of LLDP frames from peer.
  *
@@ -626,6 +633,26 @@ void pf_lldp_stop_peer_timeout (pnet_t * net, int loc_port_num);
  */
 void pf_lldp_invalidate_peer_info (pnet_t * net, int loc_port_num);
 
+/**
+ * Mark the pre-encoded LLDP frame of a local port as invalid.
+ *
+ * The frame is rebuilt at next transmission.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param loc_port_num     In:    Local port number.
+ *                                Valid range: 1 .. num_physical_ports
+ */
+void pf_lldp_invalidate_tx_frame (pnet_t * net, int loc_port_num);
+
+/**
+ * Mark the pre-encoded LLDP frames of all local ports as invalid.
+ *
+ * Should be called when station name or IP address has been changed.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_lldp_invalidate_tx_frames (pnet_t * net);
+
 /**
  * Enable sending of LLDP frames on local port
  *
@@ -639,6 +666,8 @@ void pf_lldp_send_enable (pnet_t * net, int loc_port_num);
 /**
  * Disable sending of LLDP frames on local port
  *
+ * The buffer holding the pre-encoded LLDP frame is freed.
+ *
  * @param net              InOut: The p-net stack instance
  * @param loc_port_num     In:    Local port number.
  *                                Valid range: 1 .. num_physical_ports
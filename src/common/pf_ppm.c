@@ -37,6 +37,7 @@
 
 #ifdef UNIT_TEST
 #define os_get_current_time_us mock_os_get_current_time_us
+#define pnal_buf_alloc         mock_pnal_buf_alloc
 #endif
 
 #include "pf_includes.h"
@@ -44,9 +45,19 @@
 #include <string.h>
 #include <inttypes.h>
 
+/* Number of attempts to read a consistent copy of the statistics */
+#define PF_PPM_STATISTICS_READ_ATTEMPTS 100
+
 void pf_ppm_init (pnet_t * net)
 {
    net->ppm_instance_cnt = ATOMIC_VAR_INIT (0);
+#if !PNET_USE_ATOMICS
+   if (net->ppm_statistics_lock == NULL)
+   {
+      net->ppm_statistics_lock = os_mutex_create();
+      CC_ASSERT (net->ppm_statistics_lock != NULL);
+   }
+#endif
 
    LOG_DEBUG (PF_PPM_LOG, "PPM(%d): Init driver\n", __LINE__);
 
@@ -346,6 +357,38 @@ int pf_ppm_create (pnet_t * net, pf_ar_t * p_ar, uint32_t crep)
    return net->ppm_drv->create (net, p_ar, crep);
 }
 
+/**
+ * @internal
+ * Start updating the PPM statistics.
+ *
+ * Readers will retry until pf_ppm_statistics_end_write() is called.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ppm            InOut: The PPM instance.
+ */
+static void pf_ppm_statistics_begin_write (pnet_t * net, pf_ppm_t * p_ppm)
+{
+#if PNET_USE_ATOMICS
+   (void)atomic_fetch_add (&p_ppm->statistics_sequence, 1);
+#else
+   os_mutex_lock (net->ppm_statistics_lock);
+#endif
+}
+
+/**
+ * @internal
+ * Finish updating the PPM statistics.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ppm            InOut: The PPM instance.
+ */
+static void pf_ppm_statistics_end_write (pnet_t * net, pf_ppm_t * p_ppm)
+{
+#if PNET_USE_ATOMICS
+   (void)atomic_fetch_add (&p_ppm->statistics_sequence, 1);
+#else
+   os_mutex_unlock (net->ppm_statistics_lock);
+#endif
+}
+
 int pf_ppm_activate_req (pnet_t * net, pf_ar_t * p_ar, uint32_t crep)
 {
    int ret = -1;
@@ -364,6 +407,11 @@ int pf_ppm_activate_req (pnet_t * net, pf_ar_t * p_ar, uint32_t crep)
    p_ppm->next_exec = os_get_current_time_us();
    p_ppm->next_exec += p_ppm->control_interval;
 
+   /* Same thread as pf_ppm_statistics_update() */
+   pf_ppm_statistics_begin_write (net, p_ppm);
+   memset (&p_ppm->statistics, 0, sizeof (p_ppm->statistics));
+   pf_ppm_statistics_end_write (net, p_ppm);
+
    LOG_DEBUG (
       PF_PPM_LOG,
       "PPM(%d): Activate PPM. AREP %u "
@@ -1047,6 +1095,64 @@ uint16_t pf_ppm_calculate_next_cyclecounter (
           transmission_interval_in_timebases;
 }
 
+void pf_ppm_statistics_update (
+   pnet_t * net,
+   pf_ppm_t * p_ppm,
+   int32_t lateness)
+{
+   uint32_t lateness_us = (lateness > 0) ? (uint32_t)lateness : 0;
+
+   pf_ppm_statistics_begin_write (net, p_ppm);
+   p_ppm->statistics.frames_sent++;
+   p_ppm->statistics.send_lateness_last_us = lateness_us;
+   if (lateness_us > p_ppm->statistics.send_lateness_max_us)
+   {
+      p_ppm->statistics.send_lateness_max_us = lateness_us;
+   }
+   if (
+      (p_ppm->control_interval > 0) &&
+      (lateness_us >= p_ppm->control_interval))
+   {
+      p_ppm->statistics.frames_late++;
+   }
+   pf_ppm_statistics_end_write (net, p_ppm);
+}
+
+int pf_ppm_get_statistics (
+   pnet_t * net,
+   pf_ppm_t * p_ppm,
+   pnet_ppm_statistics_t * p_statistics)
+{
+#if PNET_USE_ATOMICS
+   uint32_t sequence_before;
+   uint32_t sequence_after;
+   uint16_t attempt;
+
+   for (attempt = 0; attempt < PF_PPM_STATISTICS_READ_ATTEMPTS; attempt++)
+   {
+      /* Adding zero gives a read with full memory ordering */
+      sequence_before = atomic_fetch_add (&p_ppm->statistics_sequence, 0);
+      if ((sequence_before & 1) == 0)
+      {
+         *p_statistics = p_ppm->statistics;
+         sequence_after = atomic_fetch_add (&p_ppm->statistics_sequence, 0);
+         if (sequence_after == sequence_before)
+         {
+            return 0;
+         }
+      }
+   }
+
+   return -1;
+#else
+   os_mutex_lock (net->ppm_statistics_lock);
+   *p_statistics = p_ppm->statistics;
+   os_mutex_unlock (net->ppm_statistics_lock);
+
+   return 0;
+#endif
+}
+
 /**************** Diagnostic strings *****************************************/
 
 void pf_ppm_show (const pf_ppm_t * p_ppm)
@@ -1061,6 +1167,15 @@ void pf_ppm_show (const pf_ppm_t * p_ppm)
       "   first_transmit               = %u\n",
       (unsigned)p_ppm->first_transmit);
    printf ("   trx_cnt                      = %u\n", (unsigned)p_ppm->trx_cnt);
+   printf (
+      "   send lateness last           = %u\n",
+      (unsigned)p_ppm->statistics.send_lateness_last_us);
+   printf (
+      "   send lateness max            = %u\n",
+      (unsigned)p_ppm->statistics.send_lateness_max_us);
+   printf (
+      "   frames late                  = %u\n",
+      (unsigned)p_ppm->statistics.frames_late);
    printf ("   p_send_buffer                = %p\n", p_ppm->p_send_buffer);
    printf (
       "   p_send_buffer->len           = %u\n",
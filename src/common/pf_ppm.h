@@ -260,6 +260,22 @@ void pf_ppm_set_problem_indicator (
    pf_ar_t * p_ar,
    bool problem_indicator);
 
+/**
+ * Read a consistent copy of the PPM statistics.
+ *
+ * Does not block the sending thread. May be called from any thread.
+ * Without atomics (PNET_USE_ATOMICS 0) a mutex is used.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ppm            InOut: The PPM instance.
+ * @param p_statistics     Out:   The PPM statistics.
+ * @return  0  if the operation succeeded.
+ *          -1 if the statistics were continuously being written.
+ */
+int pf_ppm_get_statistics (
+   pnet_t * net,
+   pf_ppm_t * p_ppm,
+   pnet_ppm_statistics_t * p_statistics);
+
 /**
  * Show information about a PPM instance.
  * @param p_ppm            In:   The PPM instance.
@@ -268,6 +284,21 @@ void pf_ppm_show (const pf_ppm_t * p_ppm);
 
 /************ Internal functions, used by PPM driver ************/
 
+/**
+ * Update the PPM statistics after a frame has been sent.
+ *
+ * Must be called from the thread sending the frames.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ppm            InOut: The PPM instance.
+ * @param lateness         In:    Time from the scheduled send time until the
+ *                                sending started, in microseconds. Negative
+ *                                if early.
+ */
+void pf_ppm_statistics_update (
+   pnet_t * net,
+   pf_ppm_t * p_ppm,
+   int32_t lateness);
+
 /**
  * Finalize a PPM transmit message in the send buffer.
  *
@@ -38,6 +38,7 @@ static void pf_ppm_drv_sw_send (pnet_t * net, void * arg, uint32_t current_time)
 {
    pf_iocr_t * p_arg = (pf_iocr_t *)arg;
    uint32_t delay = 0;
+   int32_t lateness = 0;
 
    pf_scheduler_reset_handle (&p_arg->ppm.ci_timeout);
    if (p_arg->ppm.ci_running == true)
@@ -50,6 +51,7 @@ static void pf_ppm_drv_sw_send (pnet_t * net, void * arg, uint32_t current_time)
       if (pf_eth_send_on_management_port (net, p_arg->ppm.p_send_buffer) > 0)
       {
          /* Schedule next execution */
+         lateness = (int32_t)(current_time - p_arg->ppm.next_exec);
          p_arg->ppm.next_exec += p_arg->ppm.control_interval;
          delay = p_arg->ppm.next_exec - current_time;
          if (
@@ -61,6 +63,7 @@ static void pf_ppm_drv_sw_send (pnet_t * net, void * arg, uint32_t current_time)
                &p_arg->ppm.ci_timeout) == 0)
          {
             p_arg->ppm.trx_cnt++;
+            pf_ppm_statistics_update (net, &p_arg->ppm, lateness);
             if (p_arg->ppm.first_transmit == false)
             {
                pf_ppm_state_ind (net, p_arg->p_ar, &p_arg->ppm, false);
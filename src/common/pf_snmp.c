@@ -41,6 +41,25 @@
 #define STRINGIFY(s)   STRINGIFIED (s)
 #define STRINGIFIED(s) #s
 
+/* Number of lock-free read attempts, before using the writer mutex */
+#define PF_SNMP_SNAPSHOT_READ_ATTEMPTS 10
+
+/*
+ * The SNMP server reads the stack state from a published snapshot,
+ * protected by a sequence number (seqlock):
+ *
+ * - The writer increments the sequence number before and after writing,
+ *   so it is odd while a write is in progress. Writers are serialized
+ *   by a mutex. The snapshot is written by the p-net thread, except the
+ *   writable system-MIB variables that are written by the SNMP thread.
+ * - The reader copies the value and retries if the sequence number was
+ *   odd or has changed during the copy. It never blocks the p-net thread.
+ *   Without atomics the reader instead locks the writer mutex.
+ *
+ * Other modules call pf_snmp_invalidate_snapshot() when a value might
+ * have changed. The snapshot is then published again by pf_snmp_periodic().
+ */
+
 /* The configurable constant PNET_MAX_FILENAME_SIZE should be at least
  * as large as the longest filename used, including termination.
  */
@@ -237,7 +256,206 @@ static void pf_snmp_encode_signal_delays (
    encoded->line_propagation_delay_ns = plain->cable_delay_local;
 }
 
-void pf_snmp_data_init (pnet_t * net)
+/**
+ * Start writing to the snapshot.
+ *
+ * Readers will retry until pf_snmp_snapshot_end_write() is called.
+ *
+ * @param snmp             InOut: SNMP data
+ */
+static void pf_snmp_snapshot_begin_write (pf_snmp_data_t * snmp)
+{
+   os_mutex_lock (snmp->snapshot_mutex);
+   (void)atomic_fetch_add (&snmp->snapshot_sequence, 1);
+}
+
+/**
+ * Finish writing to the snapshot.
+ *
+ * @param snmp             InOut: SNMP data
+ */
+static void pf_snmp_snapshot_end_write (pf_snmp_data_t * snmp)
+{
+   (void)atomic_fetch_add (&snmp->snapshot_sequence, 1);
+   os_mutex_unlock (snmp->snapshot_mutex);
+}
+
+/**
+ * Copy a consistent value from the snapshot.
+ *
+ * Does not block, unless the snapshot is continuously being written.
+ * Then the writer mutex is used, so that a reader is not starved by
+ * a preempted writer.
+ *
+ * Without atomics (PNET_USE_ATOMICS 0) the sequence number gives no
+ * memory ordering, so the writer mutex is always used.
+ *
+ * @param snmp             InOut: SNMP data
+ * @param p_dst            Out:   Destination buffer
+ * @param p_src            In:    Value in pf_snmp_data_t to copy
+ * @param size             In:    Size of value, in bytes
+ */
+static void pf_snmp_snapshot_read (
+   pf_snmp_data_t * snmp,
+   void * p_dst,
+   const void * p_src,
+   size_t size)
+{
+#if PNET_USE_ATOMICS
+   uint32_t sequence_before;
+   uint32_t sequence_after;
+   uint16_t attempt;
+
+   for (attempt = 0; attempt < PF_SNMP_SNAPSHOT_READ_ATTEMPTS; attempt++)
+   {
+      /* Adding zero gives a read with full memory ordering */
+      sequence_before = atomic_fetch_add (&snmp->snapshot_sequence, 0);
+      if ((sequence_before & 1) == 0)
+      {
+         memcpy (p_dst, p_src, size);
+         sequence_after = atomic_fetch_add (&snmp->snapshot_sequence, 0);
+         if (sequence_after == sequence_before)
+         {
+            return;
+         }
+      }
+   }
+#endif
+
+   os_mutex_lock (snmp->snapshot_mutex);
+   memcpy (p_dst, p_src, size);
+   os_mutex_unlock (snmp->snapshot_mutex);
+}
+
+/**
+ * Get snapshot of one port.
+ *
+ * @param net              In:    The p-net stack instance.
+ * @param loc_port_num     In:    Local port number.
+ *                                Valid range: 1 .. num_physical_ports
+ * @return Snapshot for the port.
+ */
+static const pf_snmp_port_snapshot_t * pf_snmp_get_port_snapshot (
+   const pnet_t * net,
+   int loc_port_num)
+{
+   CC_ASSERT (pf_port_is_valid (net, loc_port_num));
+
+   return &net->snmp_data.snapshot.port[loc_port_num - 1];
+}
+
+void pf_snmp_publish_snapshot (pnet_t * net)
+{
+   pf_snmp_data_t * snmp = &net->snmp_data;
+   pf_snmp_snapshot_t * p_snapshot = &snmp->snapshot;
+   pf_snmp_port_snapshot_t * p_port;
+   pf_port_iterator_t port_iterator;
+   int loc_port_num;
+   char station_name[PNET_STATION_NAME_MAX_SIZE]; /** Terminated */
+
+   pf_snmp_snapshot_begin_write (snmp);
+
+   (void)pf_lldp_get_system_description (
+      net,
+      p_snapshot->system_description.string,
+      sizeof (p_snapshot->system_description.string));
+   pf_lldp_get_chassis_id (net, &p_snapshot->chassis_id);
+   pf_lldp_get_management_address (net, &p_snapshot->management_address);
+
+   pf_cmina_get_station_name (net, station_name);
+   snprintf (
+      p_snapshot->station_name.string,
+      sizeof (p_snapshot->station_name.string),
+      "%s",
+      station_name);
+   p_snapshot->station_name.len = strlen (p_snapshot->station_name.string);
+
+   pf_port_init_iterator_over_ports (net, &port_iterator);
+   loc_port_num = pf_port_get_next (&port_iterator);
+   while (loc_port_num != 0)
+   {
+      p_port = &p_snapshot->port[loc_port_num - 1];
+
+      pf_lldp_get_port_id (net, loc_port_num, &p_port->port_id);
+      pf_lldp_get_port_description (
+         net,
+         loc_port_num,
+         &p_port->port_description);
+      pf_lldp_get_signal_delays (net, loc_port_num, &p_port->signal_delays);
+      pf_lldp_get_link_status (net, loc_port_num, &p_port->link_status);
+
+      p_port->peer_timestamp.is_valid =
+         pf_lldp_get_peer_timestamp (
+            net,
+            loc_port_num,
+            &p_port->peer_timestamp.timestamp_10ms) == 0;
+      p_port->peer_chassis_id.is_valid = pf_lldp_get_peer_chassis_id (
+                                            net,
+                                            loc_port_num,
+                                            &p_port->peer_chassis_id) == 0;
+      p_port->peer_port_id.is_valid =
+         pf_lldp_get_peer_port_id (net, loc_port_num, &p_port->peer_port_id) ==
+         0;
+      p_port->peer_port_description.is_valid =
+         pf_lldp_get_peer_port_description (
+            net,
+            loc_port_num,
+            &p_port->peer_port_description) == 0;
+      p_port->peer_management_address.is_valid =
+         pf_lldp_get_peer_management_address (
+            net,
+            loc_port_num,
+            &p_port->peer_management_address) == 0;
+      p_port->peer_station_name.is_valid =
+         pf_lldp_get_peer_station_name (
+            net,
+            loc_port_num,
+            &p_port->peer_station_name.station_name) == 0;
+      p_port->peer_signal_delays.is_valid =
+         pf_lldp_get_peer_signal_delays (
+            net,
+            loc_port_num,
+            &p_port->peer_signal_delays) == 0;
+      p_port->peer_link_status.is_valid =
+         pf_lldp_get_peer_link_status (
+            net,
+            loc_port_num,
+            &p_port->peer_link_status) == 0;
+
+      loc_port_num = pf_port_get_next (&port_iterator);
+   }
+
+   pf_snmp_snapshot_end_write (snmp);
+}
+
+void pf_snmp_invalidate_snapshot (pnet_t * net)
+{
+   (void)atomic_fetch_add (&net->snmp_data.snapshot_outdated, 1);
+}
+
+void pf_snmp_periodic (pnet_t * net)
+{
+   uint32_t outdated = net->snmp_data.snapshot_outdated;
+
+   if (outdated != 0)
+   {
+      (void)atomic_fetch_sub (&net->snmp_data.snapshot_outdated, outdated);
+      pf_snmp_publish_snapshot (net);
+   }
+}
+
+void pf_snmp_init (pnet_t * net)
+{
+   pf_snmp_data_t * snmp = &net->snmp_data;
+
+   if (snmp->snapshot_mutex == NULL)
+   {
+      snmp->snapshot_mutex = os_mutex_create();
+      CC_ASSERT (snmp->snapshot_mutex != NULL);
+   }
+}
+
+void pf_snmp_data_load (pnet_t * net)
 {
    const char * directory = pf_cmina_get_file_directory (net);
    pf_snmp_data_t * snmp = &net->snmp_data;
@@ -247,8 +465,12 @@ void pf_snmp_data_init (pnet_t * net)
    CC_STATIC_ASSERT (
       sizeof (snmp->system_name.string) >= PNAL_HOSTNAME_MAX_SIZE);
 
+   /* The SNMP server might already be running */
+   pf_snmp_snapshot_begin_write (snmp);
+
    /* sysContact */
    error = pf_file_load (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSCONTACT,
       &snmp->system_contact,
@@ -265,6 +487,7 @@ void pf_snmp_data_init (pnet_t * net)
 
    /* sysName */
    error = pf_file_load (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSNAME,
       &snmp->system_name,
@@ -282,6 +505,7 @@ void pf_snmp_data_init (pnet_t * net)
 
    /* sysLocation */
    error = pf_file_load (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSLOCATION,
       &snmp->system_location,
@@ -297,13 +521,23 @@ void pf_snmp_data_init (pnet_t * net)
       error,
       "sysLocation",
       snmp->system_location.string);
+
+   pf_snmp_snapshot_end_write (snmp);
+
+   pf_snmp_publish_snapshot (net);
 }
 
-void pf_snmp_remove_data_files (const char * file_directory)
+void pf_snmp_data_init (pnet_t * net)
+{
+   pf_snmp_init (net);
+   pf_snmp_data_load (net);
+}
+
+void pf_snmp_remove_data_files (pnet_t * net, const char * file_directory)
 {
-   pf_file_clear (file_directory, PF_FILENAME_SNMP_SYSCONTACT);
-   pf_file_clear (file_directory, PF_FILENAME_SNMP_SYSNAME);
-   pf_file_clear (file_directory, PF_FILENAME_SNMP_SYSLOCATION);
+   pf_file_clear (net, file_directory, PF_FILENAME_SNMP_SYSCONTACT);
+   pf_file_clear (net, file_directory, PF_FILENAME_SNMP_SYSNAME);
+   pf_file_clear (net, file_directory, PF_FILENAME_SNMP_SYSLOCATION);
 }
 
 void pf_snmp_data_clear (pnet_t * net)
@@ -312,8 +546,9 @@ void pf_snmp_data_clear (pnet_t * net)
    pf_snmp_data_t * snmp = &net->snmp_data;
 
    LOG_DEBUG (PF_SNMP_LOG, "SNMP(%d): Clearing SNMP data.\n", __LINE__);
-   pf_snmp_remove_data_files (p_file_directory);
+   pf_snmp_remove_data_files (net, p_file_directory);
 
+   pf_snmp_snapshot_begin_write (snmp);
    memset (
       snmp->system_contact.string,
       '\0',
@@ -323,6 +558,7 @@ void pf_snmp_data_clear (pnet_t * net)
       snmp->system_location.string,
       '\0',
       sizeof (snmp->system_location.string));
+   pf_snmp_snapshot_end_write (snmp);
 }
 
 void pf_snmp_fspm_im_location_ind (pnet_t * net)
@@ -334,12 +570,14 @@ void pf_snmp_fspm_im_location_ind (pnet_t * net)
     * I&M data and a file used by SNMP containing a larger version
     * of the device's location. The larger version has precedence
     * over the I&M version, so we need to delete the larger one */
-   pf_file_clear (p_file_directory, PF_FILENAME_SNMP_SYSLOCATION);
+   pf_file_clear (net, p_file_directory, PF_FILENAME_SNMP_SYSLOCATION);
 
    /* Use "IM_Tag_Location" from I&M1 */
+   pf_snmp_snapshot_begin_write (snmp);
    pf_fspm_get_im_location (net, snmp->system_location.string);
    snmp->system_location.string[sizeof (snmp->system_location.string) - 1] =
       '\0';
+   pf_snmp_snapshot_end_write (snmp);
 
    LOG_DEBUG (
       PF_SNMP_LOG,
@@ -350,13 +588,9 @@ void pf_snmp_fspm_im_location_ind (pnet_t * net)
 
 void pf_snmp_get_system_name (pnet_t * net, pf_snmp_system_name_t * name)
 {
-   const pf_snmp_data_t * snmp = &net->snmp_data;
+   pf_snmp_data_t * snmp = &net->snmp_data;
 
-   snprintf (
-      name->string,
-      sizeof (name->string),
-      "%s",
-      snmp->system_name.string);
+   pf_snmp_snapshot_read (snmp, name, &snmp->system_name, sizeof (*name));
 }
 
 int pf_snmp_set_system_name (pnet_t * net, const pf_snmp_system_name_t * name)
@@ -372,13 +606,16 @@ int pf_snmp_set_system_name (pnet_t * net, const pf_snmp_system_name_t * name)
     * across restarts.
     */
 
+   pf_snmp_snapshot_begin_write (snmp);
    snprintf (
       snmp->system_name.string,
       sizeof (snmp->system_name.string),
       "%s",
       name->string);
+   pf_snmp_snapshot_end_write (snmp);
 
    res = pf_file_save_if_modified (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSNAME,
       name,
@@ -393,13 +630,13 @@ void pf_snmp_get_system_contact (
    pnet_t * net,
    pf_snmp_system_contact_t * contact)
 {
-   const pf_snmp_data_t * snmp = &net->snmp_data;
+   pf_snmp_data_t * snmp = &net->snmp_data;
 
-   snprintf (
-      contact->string,
-      sizeof (contact->string),
-      "%s",
-      snmp->system_contact.string);
+   pf_snmp_snapshot_read (
+      snmp,
+      contact,
+      &snmp->system_contact,
+      sizeof (*contact));
 }
 
 int pf_snmp_set_system_contact (
@@ -411,13 +648,16 @@ int pf_snmp_set_system_contact (
    pf_snmp_system_contact_t temporary_buffer;
    int res;
 
+   pf_snmp_snapshot_begin_write (snmp);
    snprintf (
       snmp->system_contact.string,
       sizeof (snmp->system_contact.string),
       "%s",
       contact->string);
+   pf_snmp_snapshot_end_write (snmp);
 
    res = pf_file_save_if_modified (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSCONTACT,
       contact,
@@ -432,13 +672,13 @@ void pf_snmp_get_system_location (
    pnet_t * net,
    pf_snmp_system_location_t * location)
 {
-   const pf_snmp_data_t * snmp = &net->snmp_data;
+   pf_snmp_data_t * snmp = &net->snmp_data;
 
-   snprintf (
-      location->string,
-      sizeof (location->string),
-      "%s",
-      snmp->system_location.string);
+   pf_snmp_snapshot_read (
+      snmp,
+      location,
+      &snmp->system_location,
+      sizeof (*location));
 }
 
 int pf_snmp_set_system_location (
@@ -450,13 +690,16 @@ int pf_snmp_set_system_location (
    pf_snmp_system_location_t temporary_buffer;
    int res;
 
+   pf_snmp_snapshot_begin_write (snmp);
    snprintf (
       snmp->system_location.string,
       sizeof (snmp->system_location.string),
       "%s",
       location->string);
+   pf_snmp_snapshot_end_write (snmp);
 
    res = pf_file_save_if_modified (
+      net,
       directory,
       PF_FILENAME_SNMP_SYSLOCATION,
       location,
@@ -474,10 +717,13 @@ void pf_snmp_get_system_description (
    pnet_t * net,
    pf_snmp_system_description_t * description)
 {
-   (void)pf_lldp_get_system_description (
-      net,
-      description->string,
-      sizeof (description->string));
+   pf_snmp_data_t * snmp = &net->snmp_data;
+
+   pf_snmp_snapshot_read (
+      snmp,
+      description,
+      &snmp->snapshot.system_description,
+      sizeof (*description));
 }
 
 void pf_snmp_get_port_list (pnet_t * net, pf_lldp_port_list_t * p_list)
@@ -500,12 +746,27 @@ int pf_snmp_get_peer_timestamp (
    int loc_port_num,
    uint32_t * timestamp_10ms)
 {
-   return pf_lldp_get_peer_timestamp (net, loc_port_num, timestamp_10ms);
+   pf_snmp_peer_timestamp_t peer_timestamp;
+
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &peer_timestamp,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_timestamp,
+      sizeof (peer_timestamp));
+   *timestamp_10ms = peer_timestamp.timestamp_10ms;
+
+   return peer_timestamp.is_valid ? 0 : -1;
 }
 
 void pf_snmp_get_chassis_id (pnet_t * net, pf_lldp_chassis_id_t * p_chassis_id)
 {
-   pf_lldp_get_chassis_id (net, p_chassis_id);
+   pf_snmp_data_t * snmp = &net->snmp_data;
+
+   pf_snmp_snapshot_read (
+      snmp,
+      p_chassis_id,
+      &snmp->snapshot.chassis_id,
+      sizeof (*p_chassis_id));
 }
 
 int pf_snmp_get_peer_chassis_id (
@@ -513,7 +774,13 @@ int pf_snmp_get_peer_chassis_id (
    int loc_port_num,
    pf_lldp_chassis_id_t * p_chassis_id)
 {
-   return pf_lldp_get_peer_chassis_id (net, loc_port_num, p_chassis_id);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      p_chassis_id,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_chassis_id,
+      sizeof (*p_chassis_id));
+
+   return p_chassis_id->is_valid ? 0 : -1;
 }
 
 void pf_snmp_get_port_id (
@@ -521,7 +788,11 @@ void pf_snmp_get_port_id (
    int loc_port_num,
    pf_lldp_port_id_t * p_port_id)
 {
-   pf_lldp_get_port_id (net, loc_port_num, p_port_id);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      p_port_id,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->port_id,
+      sizeof (*p_port_id));
 }
 
 int pf_snmp_get_peer_port_id (
@@ -529,7 +800,13 @@ int pf_snmp_get_peer_port_id (
    int loc_port_num,
    pf_lldp_port_id_t * p_port_id)
 {
-   return pf_lldp_get_peer_port_id (net, loc_port_num, p_port_id);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      p_port_id,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_port_id,
+      sizeof (*p_port_id));
+
+   return p_port_id->is_valid ? 0 : -1;
 }
 
 void pf_snmp_get_port_description (
@@ -537,7 +814,11 @@ void pf_snmp_get_port_description (
    int loc_port_num,
    pf_lldp_port_description_t * p_port_descr)
 {
-   pf_lldp_get_port_description (net, loc_port_num, p_port_descr);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      p_port_descr,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->port_description,
+      sizeof (*p_port_descr));
 }
 
 int pf_snmp_get_peer_port_description (
@@ -545,16 +826,27 @@ int pf_snmp_get_peer_port_description (
    int loc_port_num,
    pf_lldp_port_description_t * p_port_desc)
 {
-   return pf_lldp_get_peer_port_description (net, loc_port_num, p_port_desc);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      p_port_desc,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_port_description,
+      sizeof (*p_port_desc));
+
+   return p_port_desc->is_valid ? 0 : -1;
 }
 
 void pf_snmp_get_management_address (
    pnet_t * net,
    pf_snmp_management_address_t * p_man_address)
 {
+   pf_snmp_data_t * snmp = &net->snmp_data;
    pf_lldp_management_address_t man_address;
 
-   pf_lldp_get_management_address (net, &man_address);
+   pf_snmp_snapshot_read (
+      snmp,
+      &man_address,
+      &snmp->snapshot.management_address,
+      sizeof (man_address));
    pf_snmp_encode_management_address (p_man_address, &man_address);
 }
 
@@ -564,26 +856,33 @@ int pf_snmp_get_peer_management_address (
    pf_snmp_management_address_t * p_man_address)
 {
    pf_lldp_management_address_t man_address;
-   int error;
 
-   error =
-      pf_lldp_get_peer_management_address (net, loc_port_num, &man_address);
-   if (error == 0)
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &man_address,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_management_address,
+      sizeof (man_address));
+   if (!man_address.is_valid)
    {
-      pf_snmp_encode_management_address (p_man_address, &man_address);
+      return -1;
    }
 
-   return error;
+   pf_snmp_encode_management_address (p_man_address, &man_address);
+
+   return 0;
 }
 
 void pf_snmp_get_management_port_index (
    pnet_t * net,
    pf_lldp_interface_number_t * p_man_port_index)
 {
-   pf_lldp_management_address_t man_address;
+   pf_snmp_data_t * snmp = &net->snmp_data;
 
-   pf_lldp_get_management_address (net, &man_address);
-   *p_man_port_index = man_address.interface_number;
+   pf_snmp_snapshot_read (
+      snmp,
+      p_man_port_index,
+      &snmp->snapshot.management_address.interface_number,
+      sizeof (*p_man_port_index));
 }
 
 int pf_snmp_get_peer_management_port_index (
@@ -591,36 +890,36 @@ int pf_snmp_get_peer_management_port_index (
    int loc_port_num,
    pf_lldp_interface_number_t * p_man_port_index)
 {
-   int error;
    pf_lldp_management_address_t man_address;
 
-   error =
-      pf_lldp_get_peer_management_address (net, loc_port_num, &man_address);
-   if (error == 0)
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &man_address,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_management_address,
+      sizeof (man_address));
+   if (!man_address.is_valid)
    {
-      *p_man_port_index = man_address.interface_number;
+      return -1;
    }
 
-   return error;
+   *p_man_port_index = man_address.interface_number;
+
+   return 0;
 }
 
 void pf_snmp_get_station_name (
    pnet_t * net,
    pf_lldp_station_name_t * p_station_name)
 {
-   char station_name[PNET_STATION_NAME_MAX_SIZE]; /** Terminated */
-
-   /* FIXME: Use of pf_cmina_get_station_name() is not thread-safe.
-    * Fix this, e.g. using a mutex.
-    */
-   pf_cmina_get_station_name (net, station_name);
+   pf_snmp_data_t * snmp = &net->snmp_data;
 
-   snprintf (
-      p_station_name->string,
-      sizeof (p_station_name->string),
-      "%s",
-      station_name);
-   p_station_name->len = strlen (p_station_name->string);
+   /* The station name is read from CMINA by the p-net thread, when
+    * publishing the snapshot */
+   pf_snmp_snapshot_read (
+      snmp,
+      p_station_name,
+      &snmp->snapshot.station_name,
+      sizeof (*p_station_name));
 }
 
 int pf_snmp_get_peer_station_name (
@@ -628,7 +927,21 @@ int pf_snmp_get_peer_station_name (
    int loc_port_num,
    pf_lldp_station_name_t * p_station_name)
 {
-   return pf_lldp_get_peer_station_name (net, loc_port_num, p_station_name);
+   pf_snmp_peer_station_name_t peer_station_name;
+
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &peer_station_name,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_station_name,
+      sizeof (peer_station_name));
+   if (!peer_station_name.is_valid)
+   {
+      return -1;
+   }
+
+   *p_station_name = peer_station_name.station_name;
+
+   return 0;
 }
 
 void pf_snmp_get_signal_delays (
@@ -638,7 +951,11 @@ void pf_snmp_get_signal_delays (
 {
    pf_lldp_signal_delay_t delays;
 
-   pf_lldp_get_signal_delays (net, loc_port_num, &delays);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &delays,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->signal_delays,
+      sizeof (delays));
    pf_snmp_encode_signal_delays (p_delays, &delays);
 }
 
@@ -648,15 +965,20 @@ int pf_snmp_get_peer_signal_delays (
    pf_snmp_signal_delay_t * p_delays)
 {
    pf_lldp_signal_delay_t delays;
-   int error;
 
-   error = pf_lldp_get_peer_signal_delays (net, loc_port_num, &delays);
-   if (error == 0)
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &delays,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_signal_delays,
+      sizeof (delays));
+   if (!delays.is_valid)
    {
-      pf_snmp_encode_signal_delays (p_delays, &delays);
+      return -1;
    }
 
-   return error;
+   pf_snmp_encode_signal_delays (p_delays, &delays);
+
+   return 0;
 }
 
 void pf_snmp_get_link_status (
@@ -666,7 +988,11 @@ void pf_snmp_get_link_status (
 {
    pf_lldp_link_status_t link_status;
 
-   pf_lldp_get_link_status (net, loc_port_num, &link_status);
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &link_status,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->link_status,
+      sizeof (link_status));
    pf_snmp_encode_link_status (p_link_status, &link_status);
 }
 
@@ -676,15 +1002,154 @@ int pf_snmp_get_peer_link_status (
    pf_snmp_link_status_t * p_link_status)
 {
    pf_lldp_link_status_t link_status;
-   int error;
 
-   error = pf_lldp_get_peer_link_status (net, loc_port_num, &link_status);
-   if (error == 0)
+   pf_snmp_snapshot_read (
+      &net->snmp_data,
+      &link_status,
+      &pf_snmp_get_port_snapshot (net, loc_port_num)->peer_link_status,
+      sizeof (link_status));
+   if (!link_status.is_valid)
+   {
+      return -1;
+   }
+
+   pf_snmp_encode_link_status (p_link_status, &link_status);
+
+   return 0;
+}
+
+/**
+ * Fill in a row in lldpLocPortTable.
+ *
+ * @param p_row            Out:   Row to fill in.
+ * @param loc_port_num     In:    Local port number.
+ * @param p_port           In:    Copy of the port snapshot.
+ */
+static void pf_snmp_fill_local_port_row (
+   pf_snmp_local_port_row_t * p_row,
+   int loc_port_num,
+   const pf_snmp_port_snapshot_t * p_port)
+{
+   p_row->loc_port_num = loc_port_num;
+   p_row->port_id = p_port->port_id;
+   p_row->port_description = p_port->port_description;
+   pf_snmp_encode_signal_delays (&p_row->signal_delays, &p_port->signal_delays);
+   pf_snmp_encode_link_status (&p_row->link_status, &p_port->link_status);
+}
+
+/**
+ * Fill in a row in lldpRemTable.
+ *
+ * @param p_row            Out:   Row to fill in.
+ * @param loc_port_num     In:    Local port number.
+ * @param p_port           In:    Copy of the port snapshot.
+ */
+static void pf_snmp_fill_remote_row (
+   pf_snmp_remote_row_t * p_row,
+   int loc_port_num,
+   const pf_snmp_port_snapshot_t * p_port)
+{
+   memset (p_row, 0, sizeof (*p_row));
+   p_row->loc_port_num = loc_port_num;
+   p_row->timestamp_10ms = p_port->peer_timestamp.timestamp_10ms;
+   p_row->chassis_id = p_port->peer_chassis_id;
+   p_row->port_id = p_port->peer_port_id;
+   p_row->port_description = p_port->peer_port_description;
+
+   p_row->is_management_address_valid =
+      p_port->peer_management_address.is_valid;
+   if (p_row->is_management_address_valid)
    {
-      pf_snmp_encode_link_status (p_link_status, &link_status);
+      pf_snmp_encode_management_address (
+         &p_row->management_address,
+         &p_port->peer_management_address);
+      p_row->management_port_index =
+         p_port->peer_management_address.interface_number;
+   }
+
+   p_row->is_station_name_valid = p_port->peer_station_name.is_valid;
+   p_row->station_name = p_port->peer_station_name.station_name;
+
+   p_row->is_signal_delays_valid = p_port->peer_signal_delays.is_valid;
+   pf_snmp_encode_signal_delays (
+      &p_row->signal_delays,
+      &p_port->peer_signal_delays);
+
+   p_row->is_link_status_valid = p_port->peer_link_status.is_valid;
+   pf_snmp_encode_link_status (&p_row->link_status, &p_port->peer_link_status);
+}
+
+int pf_snmp_get_local_port_rows (
+   pnet_t * net,
+   int first_loc_port_num,
+   pf_snmp_local_port_row_t * p_rows,
+   int max_rows)
+{
+   pf_port_iterator_t port_iterator;
+   pf_snmp_port_snapshot_t port;
+   int loc_port_num;
+   int number_of_rows = 0;
+
+   pf_port_init_iterator_over_ports (net, &port_iterator);
+   loc_port_num = pf_port_get_next (&port_iterator);
+   while (loc_port_num != 0 && number_of_rows < max_rows)
+   {
+      if (loc_port_num >= first_loc_port_num)
+      {
+         pf_snmp_snapshot_read (
+            &net->snmp_data,
+            &port,
+            pf_snmp_get_port_snapshot (net, loc_port_num),
+            sizeof (port));
+         pf_snmp_fill_local_port_row (
+            &p_rows[number_of_rows],
+            loc_port_num,
+            &port);
+         number_of_rows++;
+      }
+
+      loc_port_num = pf_port_get_next (&port_iterator);
+   }
+
+   return number_of_rows;
+}
+
+int pf_snmp_get_remote_rows (
+   pnet_t * net,
+   int first_loc_port_num,
+   pf_snmp_remote_row_t * p_rows,
+   int max_rows)
+{
+   pf_port_iterator_t port_iterator;
+   pf_snmp_port_snapshot_t port;
+   int loc_port_num;
+   int number_of_rows = 0;
+
+   pf_port_init_iterator_over_ports (net, &port_iterator);
+   loc_port_num = pf_port_get_next (&port_iterator);
+   while (loc_port_num != 0 && number_of_rows < max_rows)
+   {
+      if (loc_port_num >= first_loc_port_num)
+      {
+         pf_snmp_snapshot_read (
+            &net->snmp_data,
+            &port,
+            pf_snmp_get_port_snapshot (net, loc_port_num),
+            sizeof (port));
+         if (port.peer_timestamp.is_valid)
+         {
+            pf_snmp_fill_remote_row (
+               &p_rows[number_of_rows],
+               loc_port_num,
+               &port);
+            number_of_rows++;
+         }
+      }
+
+      loc_port_num = pf_port_get_next (&port_iterator);
    }
 
-   return error;
+   return number_of_rows;
 }
 
 void pf_snmp_show (pnet_t * net)
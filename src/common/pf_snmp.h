@@ -95,7 +95,11 @@
  * - lldpXdot3RemPortAutoNegAdvertisedCap
  * - lldpXdot3RemPortOperMauType
  *
- * All functions are thread-safe.
+ * For table walks (SNMP GetNext/GetBulk), functions returning all columns
+ * of lldpLocPortTable and lldpRemTable for a range of ports are provided.
+ *
+ * All functions are thread-safe. The getters read a snapshot published by
+ * the p-net stack, and never block the p-net thread.
  */
 
 #ifndef PF_SNMP_H
@@ -271,9 +275,79 @@ typedef struct pf_snmp_signal_delay
    uint32_t line_propagation_delay_ns;
 } pf_snmp_signal_delay_t;
 
+/**
+ * Row in lldpLocPortTable.
+ *
+ * Also contains the columns from the LLDP-EXT-DOT3-MIB and
+ * LLDP-EXT-PNO-MIB tables using the same index (lldpLocPortNum).
+ * Values are the same as returned by the corresponding getter functions.
+ *
+ * See pf_snmp_get_local_port_rows().
+ */
+typedef struct pf_snmp_local_port_row
+{
+   int loc_port_num; /* lldpLocPortNum */
+   pf_lldp_port_id_t port_id;
+   pf_lldp_port_description_t port_description;
+   pf_snmp_signal_delay_t signal_delays;
+   pf_snmp_link_status_t link_status;
+} pf_snmp_local_port_row_t;
+
+/**
+ * Row in lldpRemTable.
+ *
+ * Also contains the columns from lldpRemManAddrTable and from the
+ * LLDP-EXT-DOT3-MIB and LLDP-EXT-PNO-MIB tables using the same index
+ * (lldpRemLocalPortNum). Values are the same as returned by the
+ * corresponding getter functions.
+ *
+ * A value not received from the remote device is indicated by its
+ * is_valid field, or by the corresponding is_xxx_valid flag.
+ *
+ * See pf_snmp_get_remote_rows().
+ */
+typedef struct pf_snmp_remote_row
+{
+   int loc_port_num;        /* lldpRemLocalPortNum */
+   uint32_t timestamp_10ms; /* lldpRemTimeMark */
+   pf_lldp_chassis_id_t chassis_id;
+   pf_lldp_port_id_t port_id;
+   pf_lldp_port_description_t port_description;
+   bool is_management_address_valid;
+   pf_snmp_management_address_t management_address;
+   pf_lldp_interface_number_t management_port_index;
+   bool is_station_name_valid;
+   pf_lldp_station_name_t station_name;
+   bool is_signal_delays_valid;
+   pf_snmp_signal_delay_t signal_delays;
+   bool is_link_status_valid;
+   pf_snmp_link_status_t link_status;
+} pf_snmp_remote_row_t;
+
+/**
+ * Prepare SNMP related data for use by the SNMP server, without reading
+ * from file.
+ *
+ * Must be called before the SNMP server is started.
+ *
+ * @param net              InOut: The p-net stack instance.
+ */
+void pf_snmp_init (pnet_t * net);
+
+/**
+ * Read SNMP related data from file, and publish it to the SNMP server.
+ *
+ * May be called while the SNMP server is running.
+ *
+ * @param net              InOut: The p-net stack instance.
+ */
+void pf_snmp_data_load (pnet_t * net);
+
 /**
  * Initialize SNMP related data, by reading from file.
  *
+ * Calls pf_snmp_init() and pf_snmp_data_load().
+ *
  * @param net              InOut: The p-net stack instance.
  */
 void pf_snmp_data_init (pnet_t * net);
@@ -295,9 +369,10 @@ void pf_snmp_data_clear (pnet_t * net);
  *
  * Used by pf_snmp_data_clear() and other operations.
  *
- * @param net              InOut: The p-net stack instance.
+ * @param net              InOut: The p-net stack instance, or NULL.
+ * @param file_directory   In:    File directory
  */
-void pf_snmp_remove_data_files (const char * file_directory);
+void pf_snmp_remove_data_files (pnet_t * net, const char * file_directory);
 
 /**
  * Update SNMP SysLocation with the present I&M1 location value.
@@ -309,6 +384,35 @@ void pf_snmp_remove_data_files (const char * file_directory);
  */
 void pf_snmp_fspm_im_location_ind (pnet_t * net);
 
+/**
+ * Publish the current LLDP-MIB and system-MIB values to the SNMP server.
+ *
+ * Reads values from other modules, so it should be called by the
+ * p-net thread. Also called by pf_snmp_data_init().
+ *
+ * @param net              InOut: The p-net stack instance.
+ */
+void pf_snmp_publish_snapshot (pnet_t * net);
+
+/**
+ * Indicate that some value visible to the SNMP server might have changed.
+ *
+ * The snapshot will be published by the next call to pf_snmp_periodic().
+ * May be called from any thread.
+ *
+ * @param net              InOut: The p-net stack instance.
+ */
+void pf_snmp_invalidate_snapshot (pnet_t * net);
+
+/**
+ * Publish the snapshot again, if it has been invalidated.
+ *
+ * Called by the p-net thread from pnet_handle_periodic().
+ *
+ * @param net              InOut: The p-net stack instance.
+ */
+void pf_snmp_periodic (pnet_t * net);
+
 /**
  * Get system description.
  *
@@ -873,6 +977,86 @@ int pf_snmp_get_peer_link_status (
    int loc_port_num,
    pf_snmp_link_status_t * p_link_status);
 
+/**
+ * Get rows in lldpLocPortTable, for a range of local ports.
+ *
+ * All columns for each port are returned in a single call, which is
+ * intended for SNMP GetBulk and table walks. Each row is consistent,
+ * i.e. read from the same published snapshot.
+ *
+ * See IEEE 802.1AB-2005 (LLDPv1) ch. 12.2. Relevant fields:
+ * - lldpLocPortNum,
+ * - lldpLocPortId,
+ * - lldpLocPortIdSubtype,
+ * - lldpLocPortDesc,
+ * - lldpXPnoLocLPDValue,
+ * - lldpXPnoLocPortTxDValue,
+ * - lldpXPnoLocPortRxDValue,
+ * - lldpXdot3LocPortAutoNegSupported,
+ * - lldpXdot3LocPortAutoNegEnabled,
+ * - lldpXdot3LocPortAutoNegAdvertisedCap,
+ * - lldpXdot3LocPortOperMauType.
+ *
+ * @param net                 In:    The p-net stack instance.
+ * @param first_loc_port_num  In:    First local port number to return.
+ *                                   Use 1 to start from the first port,
+ *                                   or previous port number + 1 to
+ *                                   continue a walk.
+ * @param p_rows              Out:   Rows, in increasing port order.
+ * @param max_rows            In:    Number of elements in p_rows.
+ * @return Number of rows returned. 0 if no more ports are available.
+ */
+int pf_snmp_get_local_port_rows (
+   pnet_t * net,
+   int first_loc_port_num,
+   pf_snmp_local_port_row_t * p_rows,
+   int max_rows);
+
+/**
+ * Get rows in lldpRemTable, for a range of local ports.
+ *
+ * All columns for each remote device are returned in a single call,
+ * which is intended for SNMP GetBulk and table walks. Each row is
+ * consistent, i.e. read from the same published snapshot.
+ *
+ * Only ports where info from a remote device has been received have
+ * a row in the table.
+ *
+ * See IEEE 802.1AB-2005 (LLDPv1) ch. 12.2. Relevant fields:
+ * - lldpRemLocalPortNum,
+ * - lldpRemTimeMark,
+ * - lldpRemChassisId,
+ * - lldpRemChassisIdSubtype,
+ * - lldpRemPortId,
+ * - lldpRemPortIdSubtype,
+ * - lldpRemPortDesc,
+ * - lldpRemManAddr,
+ * - lldpRemManAddrSubtype,
+ * - lldpRemManAddrIfId,
+ * - lldpRemManAddrIfSubtype,
+ * - lldpXPnoRemLPDValue,
+ * - lldpXPnoRemPortTxDValue,
+ * - lldpXPnoRemPortRxDValue,
+ * - lldpXdot3RemPortAutoNegSupported,
+ * - lldpXdot3RemPortAutoNegEnabled,
+ * - lldpXdot3RemPortAutoNegAdvertisedCap,
+ * - lldpXdot3RemPortOperMauType.
+ *
+ * @param net                 In:    The p-net stack instance.
+ * @param first_loc_port_num  In:    First local port number to return.
+ *                                   Use 1 to start from the first port,
+ *                                   or previous port number + 1 to
+ *                                   continue a walk.
+ * @param p_rows              Out:   Rows, in increasing port order.
+ * @param max_rows            In:    Number of elements in p_rows.
+ * @return Number of rows returned. 0 if no more remote devices are known.
+ */
+int pf_snmp_get_remote_rows (
+   pnet_t * net,
+   int first_loc_port_num,
+   pf_snmp_remote_row_t * p_rows,
+   int max_rows);
+
 /**
  * Show SNMP details
  *
@@ -35,17 +35,37 @@
 #include "pf_includes.h"
 #include "pf_block_reader.h"
 
-void pf_get_mem (
-   pf_get_info_t * p_info,
-   uint16_t * p_pos,
-   uint16_t dest_size,
-   void * p_dest)
+/* Sizes of the fixed parts of some blocks, for pf_get_reserve() */
+#define PF_GET_BLOCK_HEADER_SIZE       6
+#define PF_GET_UUID_SIZE               16
+#define PF_GET_RPC_HEADER_SIZE         80
+#define PF_GET_IOCR_PARAM_SIZE         40
+#define PF_GET_FRAME_DESCRIPTOR_SIZE   6
+#define PF_GET_EXP_MODULE_SIZE         10
+#define PF_GET_EXP_SUBMODULE_SIZE      8
+#define PF_GET_DATA_DESCRIPTION_SIZE   6
+
+/**
+ * @internal
+ * Check that a number of bytes can be read from the buffer.
+ *
+ * This allows a fixed size part of a block to be bounds checked once,
+ * and then decoded with the pf_get_load_xxx() functions.
+ * Sets the result on failure.
+ * @param p_info           InOut: The parser state.
+ * @param pos              In:    Position in the buffer.
+ * @param size             In:    Number of bytes to read.
+ * @return  true  if the bytes are available.
+ *          false if an error occurred, now or earlier.
+ */
+static bool pf_get_reserve (pf_get_info_t * p_info, uint16_t pos, uint16_t size)
 {
    if (p_info->result != PF_PARSE_OK)
    {
       /* Preserve first error */
+      return false;
    }
-   else if (((*p_pos) + dest_size) > p_info->len)
+   else if (((uint32_t)pos + size) > p_info->len)
    {
       /*
        * Reached end of buffer
@@ -54,90 +74,151 @@ void pf_get_mem (
        */
       LOG_DEBUG (PNET_LOG, "BR(%d): Unexpected end of input data\n", __LINE__);
       p_info->result = PF_PARSE_END_OF_INPUT;
+      return false;
    }
    else if (p_info->p_buf == NULL)
    {
       p_info->result = PF_PARSE_NULL_POINTER;
+      return false;
    }
-   else
-   {
-      memcpy (p_dest, &p_info->p_buf[*p_pos], dest_size);
-      (*p_pos) += dest_size;
-   }
+
+   return true;
 }
 
-uint8_t pf_get_byte (pf_get_info_t * p_info, uint16_t * p_pos)
+/**
+ * @internal
+ * Read a byte without bounds check. See pf_get_reserve().
+ * @param p_info           In:    The parser state.
+ * @param p_pos            InOut: Position in the buffer.
+ * @return The value.
+ */
+static inline uint8_t pf_get_load_byte (
+   const pf_get_info_t * p_info,
+   uint16_t * p_pos)
+{
+   return p_info->p_buf[(*p_pos)++];
+}
+
+/**
+ * @internal
+ * Read a uint16_t without bounds check. See pf_get_reserve().
+ * @param p_info           In:    The parser state.
+ * @param p_pos            InOut: Position in the buffer.
+ * @return The value.
+ */
+static inline uint16_t pf_get_load_uint16 (
+   const pf_get_info_t * p_info,
+   uint16_t * p_pos)
 {
-   uint8_t res = 0;
+   const uint8_t * p = &p_info->p_buf[*p_pos];
 
-   if (p_info->result != PF_PARSE_OK)
+   (*p_pos) += 2;
+   if (p_info->is_big_endian)
    {
-      /* Preserve first error */
+      return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
    }
-   else if (*p_pos >= p_info->len)
+   return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/**
+ * @internal
+ * Read a uint32_t without bounds check. See pf_get_reserve().
+ * @param p_info           In:    The parser state.
+ * @param p_pos            InOut: Position in the buffer.
+ * @return The value.
+ */
+static inline uint32_t pf_get_load_uint32 (
+   const pf_get_info_t * p_info,
+   uint16_t * p_pos)
+{
+   const uint8_t * p = &p_info->p_buf[*p_pos];
+
+   (*p_pos) += 4;
+   if (p_info->is_big_endian)
    {
-      /* Reached end of buffer */
-      LOG_DEBUG (
-         PNET_LOG,
-         "BR(%d): End of buffer reached when looking for a byte\n",
-         __LINE__);
-      p_info->result = PF_PARSE_END_OF_INPUT;
+      return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+             ((uint32_t)p[2] << 8) | p[3];
    }
-   else if (p_info->p_buf == NULL)
+   return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+          ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @internal
+ * Read a memory area without bounds check. See pf_get_reserve().
+ * @param p_info           In:    The parser state.
+ * @param p_pos            InOut: Position in the buffer.
+ * @param dest_size        In:    Number of bytes to copy.
+ * @param p_dest           Out:   Destination buffer.
+ */
+static inline void pf_get_load_mem (
+   const pf_get_info_t * p_info,
+   uint16_t * p_pos,
+   uint16_t dest_size,
+   void * p_dest)
+{
+   memcpy (p_dest, &p_info->p_buf[*p_pos], dest_size);
+   (*p_pos) += dest_size;
+}
+
+void pf_get_mem (
+   pf_get_info_t * p_info,
+   uint16_t * p_pos,
+   uint16_t dest_size,
+   void * p_dest)
+{
+   if (pf_get_reserve (p_info, *p_pos, dest_size))
    {
-      p_info->result = PF_PARSE_NULL_POINTER;
+      pf_get_load_mem (p_info, p_pos, dest_size, p_dest);
    }
-   else
+}
+
+uint8_t pf_get_byte (pf_get_info_t * p_info, uint16_t * p_pos)
+{
+   if (pf_get_reserve (p_info, *p_pos, 1))
    {
-      res = p_info->p_buf[*p_pos];
-      (*p_pos)++;
+      return pf_get_load_byte (p_info, p_pos);
    }
 
-   return res;
+   return 0;
 }
 
 uint16_t pf_get_uint16 (pf_get_info_t * p_info, uint16_t * p_pos)
 {
-   uint16_t res = 0;
-
-   if (p_info->result != PF_PARSE_OK)
-   {
-      /* Keep first error */
-   }
-   else if (p_info->is_big_endian)
-   {
-      res = ((uint16_t)pf_get_byte (p_info, p_pos) << 8) +
-            (uint16_t)pf_get_byte (p_info, p_pos);
-   }
-   else
+   if (pf_get_reserve (p_info, *p_pos, 2))
    {
-      res = (uint16_t)pf_get_byte (p_info, p_pos) +
-            ((uint16_t)pf_get_byte (p_info, p_pos) << 8);
+      return pf_get_load_uint16 (p_info, p_pos);
    }
 
-   return res;
+   return 0;
 }
 
 uint32_t pf_get_uint32 (pf_get_info_t * p_info, uint16_t * p_pos)
 {
-   uint32_t res = 0;
-
-   if (p_info->is_big_endian)
+   if (pf_get_reserve (p_info, *p_pos, 4))
    {
-      res = ((uint32_t)pf_get_byte (p_info, p_pos) << 24) +
-            ((uint32_t)pf_get_byte (p_info, p_pos) << 16) +
-            ((uint32_t)pf_get_byte (p_info, p_pos) << 8) +
-            (uint32_t)pf_get_byte (p_info, p_pos);
-   }
-   else
-   {
-      res = (uint32_t)pf_get_byte (p_info, p_pos) +
-            ((uint32_t)pf_get_byte (p_info, p_pos) << 8) +
-            ((uint32_t)pf_get_byte (p_info, p_pos) << 16) +
-            ((uint32_t)pf_get_byte (p_info, p_pos) << 24);
+      return pf_get_load_uint32 (p_info, p_pos);
    }
 
-   return res;
+   return 0;
+}
+
+/**
+ * @internal
+ * Read a UUID without bounds check. See pf_get_reserve().
+ * @param p_info           In:    The parser state.
+ * @param p_pos            InOut: Position in the buffer.
+ * @param p_dest           Out:   Destination buffer.
+ */
+static inline void pf_get_load_uuid (
+   const pf_get_info_t * p_info,
+   uint16_t * p_pos,
+   pf_uuid_t * p_dest)
+{
+   p_dest->data1 = pf_get_load_uint32 (p_info, p_pos);
+   p_dest->data2 = pf_get_load_uint16 (p_info, p_pos);
+   p_dest->data3 = pf_get_load_uint16 (p_info, p_pos);
+   pf_get_load_mem (p_info, p_pos, sizeof (p_dest->data4), p_dest->data4);
 }
 
 /**
@@ -152,10 +233,10 @@ static void pf_get_uuid (
    uint16_t * p_pos,
    pf_uuid_t * p_dest)
 {
-   p_dest->data1 = pf_get_uint32 (p_info, p_pos);
-   p_dest->data2 = pf_get_uint16 (p_info, p_pos);
-   p_dest->data3 = pf_get_uint16 (p_info, p_pos);
-   pf_get_mem (p_info, p_pos, sizeof (p_dest->data4), p_dest->data4);
+   if (pf_get_reserve (p_info, *p_pos, PF_GET_UUID_SIZE))
+   {
+      pf_get_load_uuid (p_info, p_pos, p_dest);
+   }
 }
 
 /**
@@ -233,9 +314,12 @@ static void pf_get_frame_descriptor (
    uint16_t * p_pos,
    pf_frame_descriptor_t * p_fd)
 {
-   p_fd->slot_number = pf_get_uint16 (p_info, p_pos);
-   p_fd->subslot_number = pf_get_uint16 (p_info, p_pos);
-   p_fd->frame_offset = pf_get_uint16 (p_info, p_pos);
+   if (pf_get_reserve (p_info, *p_pos, PF_GET_FRAME_DESCRIPTOR_SIZE))
+   {
+      p_fd->slot_number = pf_get_load_uint16 (p_info, p_pos);
+      p_fd->subslot_number = pf_get_load_uint16 (p_info, p_pos);
+      p_fd->frame_offset = pf_get_load_uint16 (p_info, p_pos);
+   }
 }
 
 /**
@@ -290,11 +374,20 @@ static void pf_get_exp_submodule (
    pf_exp_submodule_t * submodule)
 {
    uint16_t temp_u16;
+   uint16_t ix;
+
+   if (!pf_get_reserve (
+          p_info,
+          *p_pos,
+          PF_GET_EXP_SUBMODULE_SIZE + PF_GET_DATA_DESCRIPTION_SIZE))
+   {
+      return;
+   }
 
-   submodule->subslot_number = pf_get_uint16 (p_info, p_pos);
-   submodule->ident_number = pf_get_uint32 (p_info, p_pos);
+   submodule->subslot_number = pf_get_load_uint16 (p_info, p_pos);
+   submodule->ident_number = pf_get_load_uint32 (p_info, p_pos);
    /* subslot_properties */
-   temp_u16 = pf_get_uint16 (p_info, p_pos);
+   temp_u16 = pf_get_load_uint16 (p_info, p_pos);
    submodule->properties.type = pf_get_bits (temp_u16, 0, 2);
    submodule->properties.sharedInput = (pf_get_bits (temp_u16, 2, 1) != 0);
    submodule->properties.reduce_input_submodule_data_length =
@@ -303,25 +396,32 @@ static void pf_get_exp_submodule (
       (pf_get_bits (temp_u16, 4, 1) != 0);
    submodule->properties.discard_ioxs = (pf_get_bits (temp_u16, 5, 1) != 0);
 
-   /* At least one submodule data descriptor */
-   submodule->data_descriptor[0].data_direction = pf_get_uint16 (p_info, p_pos);
-   submodule->data_descriptor[0].submodule_data_length =
-      pf_get_uint16 (p_info, p_pos);
-   submodule->data_descriptor[0].length_iocs = pf_get_byte (p_info, p_pos);
-   submodule->data_descriptor[0].length_iops = pf_get_byte (p_info, p_pos);
+   /* At least one submodule data descriptor. May have one more */
    submodule->nbr_data_descriptors = 1;
-   /* May have one more */
    if (submodule->properties.type == PNET_DIR_IO)
    {
-      submodule->data_descriptor[1].data_direction =
-         pf_get_uint16 (p_info, p_pos);
-      submodule->data_descriptor[1].submodule_data_length =
-         pf_get_uint16 (p_info, p_pos);
-      submodule->data_descriptor[1].length_iocs = pf_get_byte (p_info, p_pos);
-      submodule->data_descriptor[1].length_iops = pf_get_byte (p_info, p_pos);
+      if (!pf_get_reserve (
+             p_info,
+             *p_pos,
+             2 * PF_GET_DATA_DESCRIPTION_SIZE))
+      {
+         return;
+      }
       submodule->nbr_data_descriptors = 2;
    }
 
+   for (ix = 0; ix < submodule->nbr_data_descriptors; ix++)
+   {
+      submodule->data_descriptor[ix].data_direction =
+         pf_get_load_uint16 (p_info, p_pos);
+      submodule->data_descriptor[ix].submodule_data_length =
+         pf_get_load_uint16 (p_info, p_pos);
+      submodule->data_descriptor[ix].length_iocs =
+         pf_get_load_byte (p_info, p_pos);
+      submodule->data_descriptor[ix].length_iops =
+         pf_get_load_byte (p_info, p_pos);
+   }
+
    LOG_DEBUG (
       PNET_LOG,
       "BR(%d):   Subslot 0x%04x. Expected submodule 0x%" PRIx32
@@ -339,10 +439,17 @@ void pf_get_block_header (
    uint16_t * p_pos,
    pf_block_header_t * p_hdr)
 {
-   p_hdr->block_type = pf_get_uint16 (p_info, p_pos);
-   p_hdr->block_length = pf_get_uint16 (p_info, p_pos);
-   p_hdr->block_version_high = pf_get_byte (p_info, p_pos);
-   p_hdr->block_version_low = pf_get_byte (p_info, p_pos);
+   if (pf_get_reserve (p_info, *p_pos, PF_GET_BLOCK_HEADER_SIZE))
+   {
+      p_hdr->block_type = pf_get_load_uint16 (p_info, p_pos);
+      p_hdr->block_length = pf_get_load_uint16 (p_info, p_pos);
+      p_hdr->block_version_high = pf_get_load_byte (p_info, p_pos);
+      p_hdr->block_version_low = pf_get_load_byte (p_info, p_pos);
+   }
+   else
+   {
+      memset (p_hdr, 0, sizeof (*p_hdr));
+   }
 }
 
 void pf_get_ar_param (pf_get_info_t * p_info, uint16_t * p_pos, pf_ar_t * p_ar)
@@ -403,11 +510,16 @@ int pf_get_iocr_param (
    uint16_t temp_u16;
    uint16_t iy;
 
-   p_ar->iocrs[ix].param.iocr_type = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.iocr_reference = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.lt_field = pf_get_uint16 (p_info, p_pos);
+   if (!pf_get_reserve (p_info, *p_pos, PF_GET_IOCR_PARAM_SIZE))
+   {
+      return 0; /* Error is reported in p_info */
+   }
+
+   p_ar->iocrs[ix].param.iocr_type = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.iocr_reference = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.lt_field = pf_get_load_uint16 (p_info, p_pos);
    /* iocr_Properties */
-   temp_u32 = pf_get_uint32 (p_info, p_pos);
+   temp_u32 = pf_get_load_uint32 (p_info, p_pos);
    p_ar->iocrs[ix].param.iocr_properties.rt_class =
       pf_get_bits (temp_u32, 0, 4);
    p_ar->iocrs[ix].param.iocr_properties.reserved_1 =
@@ -417,29 +529,29 @@ int pf_get_iocr_param (
    p_ar->iocrs[ix].param.iocr_properties.reserved_3 =
       (pf_get_bits (temp_u32, 24, 8) != 0);
 
-   p_ar->iocrs[ix].param.c_sdu_length = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.frame_id = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.send_clock_factor = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.reduction_ratio = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.phase = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.sequence = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.frame_send_offset = pf_get_uint32 (p_info, p_pos);
-   p_ar->iocrs[ix].param.watchdog_factor = pf_get_uint16 (p_info, p_pos);
-   p_ar->iocrs[ix].param.data_hold_factor = pf_get_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.c_sdu_length = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.frame_id = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.send_clock_factor = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.reduction_ratio = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.phase = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.sequence = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.frame_send_offset = pf_get_load_uint32 (p_info, p_pos);
+   p_ar->iocrs[ix].param.watchdog_factor = pf_get_load_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.data_hold_factor = pf_get_load_uint16 (p_info, p_pos);
    /* iocr_tag_header */
-   temp_u16 = pf_get_uint16 (p_info, p_pos);
+   temp_u16 = pf_get_load_uint16 (p_info, p_pos);
    p_ar->iocrs[ix].param.iocr_tag_header.vlan_id =
       pf_get_bits (temp_u16, 0, 11);
    p_ar->iocrs[ix].param.iocr_tag_header.iocr_user_priority =
       pf_get_bits (temp_u16, 13, 3);
 
-   pf_get_mem (
+   pf_get_load_mem (
       p_info,
       p_pos,
       sizeof (p_ar->iocrs[ix].param.iocr_multicast_mac_add),
       &p_ar->iocrs[ix].param.iocr_multicast_mac_add);
 
-   p_ar->iocrs[ix].param.nbr_apis = pf_get_uint16 (p_info, p_pos);
+   p_ar->iocrs[ix].param.nbr_apis = pf_get_load_uint16 (p_info, p_pos);
    if (p_ar->iocrs[ix].param.nbr_apis > PNET_MAX_API)
    {
       return -1;
@@ -480,6 +592,10 @@ void pf_get_exp_api_module (
    {
       /* Get one module description */
       exp_api = pf_get_uint32 (p_info, p_pos);
+      if (p_info->result != PF_PARSE_OK)
+      {
+         return;
+      }
 
       /* Find the API if we are augmenting it */
       for (iy = 0; iy < p_ar->exp_ident.nbr_apis; iy++)
@@ -512,9 +628,13 @@ void pf_get_exp_api_module (
             "BR(%d): Out of expected API resources\n",
             __LINE__);
       }
+      else if (!pf_get_reserve (p_info, *p_pos, PF_GET_EXP_MODULE_SIZE))
+      {
+         return;
+      }
       else
       {
-         slot_number = pf_get_uint16 (p_info, p_pos);
+         slot_number = pf_get_load_uint16 (p_info, p_pos);
 
          /* Get a new module. */
          if (api->nbr_modules < PNET_MAX_SLOTS)
@@ -523,9 +643,9 @@ void pf_get_exp_api_module (
             api->nbr_modules++;
 
             module->slot_number = slot_number;
-            module->ident_number = pf_get_uint32 (p_info, p_pos);
-            module->properties = pf_get_uint16 (p_info, p_pos);
-            module->nbr_submodules = pf_get_uint16 (p_info, p_pos);
+            module->ident_number = pf_get_load_uint32 (p_info, p_pos);
+            module->properties = pf_get_load_uint16 (p_info, p_pos);
+            module->nbr_submodules = pf_get_load_uint16 (p_info, p_pos);
 
             LOG_DEBUG (
                PNET_LOG,
@@ -536,6 +656,19 @@ void pf_get_exp_api_module (
                module->ident_number,
                module->nbr_submodules);
 
+            if (module->nbr_submodules > PNET_MAX_SUBSLOTS)
+            {
+               /* This error condition is reported by caller. */
+               p_info->result = PF_PARSE_OUT_OF_EXP_SUBMODULE_RESOURCES;
+               LOG_ERROR (
+                  PNET_LOG,
+                  "BR(%d): Too many submodules in slot %u. Out of "
+                  "expected submodule resources.\n",
+                  __LINE__,
+                  module->slot_number);
+               return;
+            }
+
             for (iy = 0; iy < module->nbr_submodules; iy++)
             {
                pf_get_exp_submodule (p_info, p_pos, &module->submodule[iy]);
@@ -707,6 +840,98 @@ void pf_get_ar_vendor_request (
 }
 #endif
 
+#if PNET_OPTION_FAST_STARTUP
+void pf_get_ar_fsu_request (
+   pf_get_info_t * p_info,
+   uint16_t * p_pos,
+   uint16_t block_length,
+   pf_ar_t * p_ar)
+{
+   pf_block_header_t sub_header;
+   uint16_t end_pos;
+   uint16_t sub_end_pos;
+   uint32_t temp_u32;
+#if PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH
+   uint16_t data_len;
+#endif
+
+   memset (&p_ar->fast_startup_data, 0, sizeof (p_ar->fast_startup_data));
+   if (block_length < 4)
+   {
+      p_info->result = PF_PARSE_ERROR;
+      return;
+   }
+
+   /* The block length includes the block version */
+   end_pos = *p_pos + block_length - 2;
+
+   /* 2 padding bytes */
+   (void)pf_get_uint16 (p_info, p_pos);
+
+   while ((p_info->result == PF_PARSE_OK) &&
+          ((*p_pos + PF_GET_BLOCK_HEADER_SIZE) <= end_pos))
+   {
+      pf_get_block_header (p_info, p_pos, &sub_header);
+      sub_end_pos = *p_pos + sub_header.block_length - 2;
+      if (
+         (p_info->result == PF_PARSE_OK) &&
+         ((sub_header.block_length < 2) || (sub_end_pos > end_pos)))
+      {
+         p_info->result = PF_PARSE_ERROR;
+      }
+      if (p_info->result != PF_PARSE_OK)
+      {
+         break;
+      }
+
+      switch (sub_header.block_type)
+      {
+      case PF_BT_FS_PARAMETER:
+         /* 2 padding bytes */
+         (void)pf_get_uint16 (p_info, p_pos);
+         temp_u32 = pf_get_uint32 (p_info, p_pos);
+         p_ar->fast_startup_data.fs_parameter_block.fs_parameter_mode =
+            pf_get_bits (temp_u32, 0, 2);
+         pf_get_uuid (
+            p_info,
+            p_pos,
+            &p_ar->fast_startup_data.fs_parameter_block.fs_parameter_uuid);
+         break;
+#if PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH
+      case PF_BT_FAST_STARTUP:
+         /* 2 padding bytes */
+         (void)pf_get_uint16 (p_info, p_pos);
+         data_len = (*p_pos < sub_end_pos) ? sub_end_pos - *p_pos : 0;
+         if (data_len > PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH)
+         {
+            data_len = PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH;
+         }
+         p_ar->fast_startup_data
+            .length_manufacturer_specific_fast_startup_data = data_len;
+         pf_get_mem (
+            p_info,
+            p_pos,
+            data_len,
+            p_ar->fast_startup_data.manufacturer_specific_fast_startup_data);
+         break;
+#endif
+      default:
+         /* Ignore unknown sub-blocks */
+         break;
+      }
+
+      if (*p_pos > sub_end_pos)
+      {
+         p_info->result = PF_PARSE_ERROR;
+      }
+      *p_pos = sub_end_pos;
+   }
+
+   *p_pos = end_pos;
+   p_ar->fast_startup_data.valid = (p_info->result == PF_PARSE_OK);
+}
+#endif
+
 void pf_get_control (
    pf_get_info_t * p_info,
    uint16_t * p_pos,
@@ -743,13 +968,18 @@ void pf_get_dce_rpc_header (
 {
    uint8_t temp_uint8;
 
-   p_rpc->version = pf_get_byte (p_info, p_pos);
-   p_rpc->packet_type = pf_get_byte (p_info, p_pos) & 0x1f; /* Only 5 LSB
-                                                               according to spec
-                                                             */
+   if (!pf_get_reserve (p_info, *p_pos, PF_GET_RPC_HEADER_SIZE))
+   {
+      memset (p_rpc, 0, sizeof (*p_rpc));
+      return;
+   }
+
+   p_rpc->version = pf_get_load_byte (p_info, p_pos);
+   /* Only 5 LSB according to spec */
+   p_rpc->packet_type = pf_get_load_byte (p_info, p_pos) & 0x1f;
 
    /* flags */
-   temp_uint8 = pf_get_byte (p_info, p_pos);
+   temp_uint8 = pf_get_load_byte (p_info, p_pos);
    p_rpc->flags.last_fragment =
       pf_get_bits (temp_uint8, PF_RPC_F_LAST_FRAGMENT, 1);
    p_rpc->flags.fragment = pf_get_bits (temp_uint8, PF_RPC_F_FRAGMENT, 1);
@@ -759,36 +989,36 @@ void pf_get_dce_rpc_header (
    p_rpc->flags.broadcast = pf_get_bits (temp_uint8, PF_RPC_F_BROADCAST, 1);
 
    /* flags2 */
-   temp_uint8 = pf_get_byte (p_info, p_pos);
+   temp_uint8 = pf_get_load_byte (p_info, p_pos);
    p_rpc->flags2.cancel_pending =
       pf_get_bits (temp_uint8, PF_RPC_F2_CANCEL_PENDING, 1);
 
    /* Data repr */
-   temp_uint8 = pf_get_byte (p_info, p_pos);
+   temp_uint8 = pf_get_load_byte (p_info, p_pos);
    p_rpc->is_big_endian = (pf_get_bits (temp_uint8, 4, 4) == 0);
    p_info->is_big_endian = p_rpc->is_big_endian;
 
    /* Float repr  - Assume IEEE */
-   (void)pf_get_byte (p_info, p_pos);
+   (void)pf_get_load_byte (p_info, p_pos);
    p_rpc->float_repr = 0;
 
    /* Reserved */
-   p_rpc->reserved = pf_get_byte (p_info, p_pos);
-
-   p_rpc->serial_high = pf_get_byte (p_info, p_pos);
-   pf_get_uuid (p_info, p_pos, &p_rpc->object_uuid);
-   pf_get_uuid (p_info, p_pos, &p_rpc->interface_uuid);
-   pf_get_uuid (p_info, p_pos, &p_rpc->activity_uuid);
-   p_rpc->server_boot_time = pf_get_uint32 (p_info, p_pos);
-   p_rpc->interface_version = pf_get_uint32 (p_info, p_pos);
-   p_rpc->sequence_nmb = pf_get_uint32 (p_info, p_pos);
-   p_rpc->opnum = pf_get_uint16 (p_info, p_pos);
-   p_rpc->interface_hint = pf_get_uint16 (p_info, p_pos);
-   p_rpc->activity_hint = pf_get_uint16 (p_info, p_pos);
-   p_rpc->length_of_body = pf_get_uint16 (p_info, p_pos);
-   p_rpc->fragment_nmb = pf_get_uint16 (p_info, p_pos);
-   p_rpc->auth_protocol = pf_get_byte (p_info, p_pos);
-   p_rpc->serial_low = pf_get_byte (p_info, p_pos);
+   p_rpc->reserved = pf_get_load_byte (p_info, p_pos);
+
+   p_rpc->serial_high = pf_get_load_byte (p_info, p_pos);
+   pf_get_load_uuid (p_info, p_pos, &p_rpc->object_uuid);
+   pf_get_load_uuid (p_info, p_pos, &p_rpc->interface_uuid);
+   pf_get_load_uuid (p_info, p_pos, &p_rpc->activity_uuid);
+   p_rpc->server_boot_time = pf_get_load_uint32 (p_info, p_pos);
+   p_rpc->interface_version = pf_get_load_uint32 (p_info, p_pos);
+   p_rpc->sequence_nmb = pf_get_load_uint32 (p_info, p_pos);
+   p_rpc->opnum = pf_get_load_uint16 (p_info, p_pos);
+   p_rpc->interface_hint = pf_get_load_uint16 (p_info, p_pos);
+   p_rpc->activity_hint = pf_get_load_uint16 (p_info, p_pos);
+   p_rpc->length_of_body = pf_get_load_uint16 (p_info, p_pos);
+   p_rpc->fragment_nmb = pf_get_load_uint16 (p_info, p_pos);
+   p_rpc->auth_protocol = pf_get_load_byte (p_info, p_pos);
+   p_rpc->serial_low = pf_get_load_byte (p_info, p_pos);
 }
 
 void pf_get_read_request (
@@ -165,6 +165,25 @@ void pf_get_ar_vendor_request (
    pf_ar_t * p_ar);
 #endif
 
+#if PNET_OPTION_FAST_STARTUP
+/**
+ * Extract an AR FSU request block from a buffer.
+ *
+ * Contains an FSParameterBlock and optionally a FastStartUpBlock.
+ * Unknown sub-blocks are skipped.
+ * @param p_info           InOut: The parser state.
+ * @param p_pos            InOut: Position in the buffer, after the block
+ *                                header. Is moved to the end of the block.
+ * @param block_length     In:    Block length from the block header.
+ * @param p_ar             Out:   Contains the destination structure.
+ */
+void pf_get_ar_fsu_request (
+   pf_get_info_t * p_info,
+   uint16_t * p_pos,
+   uint16_t block_length,
+   pf_ar_t * p_ar);
+#endif
+
 #if PNET_OPTION_PARAMETER_SERVER
 /**
  * Extract a parameter server block from a buffer.
@@ -49,6 +49,86 @@
 #define STRINGIFY(s)   STRINGIFIED (s)
 #define STRINGIFIED(s) #s
 
+#define PF_PUT_BLOCK_HEADER_SIZE 6
+
+/**
+ * @internal
+ * Check that a number of bytes fit in the destination buffer.
+ * @param size             In:    Number of bytes to write.
+ * @param res_len          In:    Size of destination buffer.
+ * @param p_bytes          In:    Destination buffer.
+ * @param pos              In:    Position in destination buffer.
+ * @return  true  if the bytes fit.
+ *          false if the buffer is full or NULL.
+ */
+static inline bool pf_put_fits (
+   uint16_t size,
+   uint16_t res_len,
+   const uint8_t * p_bytes,
+   uint16_t pos)
+{
+   if (((uint32_t)pos + size) > res_len)
+   {
+      /* Reached end of buffer */
+      LOG_DEBUG (PNET_LOG, "BW(%d): Output buffer is full\n", __LINE__);
+      return false;
+   }
+
+   return p_bytes != NULL;
+}
+
+/**
+ * @internal
+ * Store a uint16_t without bounds check. See pf_put_fits().
+ * @param is_big_endian    In:    true if buffer is big-endian.
+ * @param val              In:    The value.
+ * @param p_dest           Out:   Destination.
+ */
+static inline void pf_put_store_uint16 (
+   bool is_big_endian,
+   uint16_t val,
+   uint8_t * p_dest)
+{
+   if (is_big_endian)
+   {
+      p_dest[0] = (uint8_t)(val >> 8);
+      p_dest[1] = (uint8_t)val;
+   }
+   else
+   {
+      p_dest[0] = (uint8_t)val;
+      p_dest[1] = (uint8_t)(val >> 8);
+   }
+}
+
+/**
+ * @internal
+ * Store a uint32_t without bounds check. See pf_put_fits().
+ * @param is_big_endian    In:    true if buffer is big-endian.
+ * @param val              In:    The value.
+ * @param p_dest           Out:   Destination.
+ */
+static inline void pf_put_store_uint32 (
+   bool is_big_endian,
+   uint32_t val,
+   uint8_t * p_dest)
+{
+   if (is_big_endian)
+   {
+      p_dest[0] = (uint8_t)(val >> 24);
+      p_dest[1] = (uint8_t)(val >> 16);
+      p_dest[2] = (uint8_t)(val >> 8);
+      p_dest[3] = (uint8_t)val;
+   }
+   else
+   {
+      p_dest[0] = (uint8_t)val;
+      p_dest[1] = (uint8_t)(val >> 8);
+      p_dest[2] = (uint8_t)(val >> 16);
+      p_dest[3] = (uint8_t)(val >> 24);
+   }
+}
+
 /**
  * @internal
  * Insert a block header into a buffer.
@@ -71,17 +151,52 @@ static void pf_put_block_header (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   uint16_t temp_u16 = (uint16_t)bh_type;
+   uint8_t * p_dest;
 
-   pf_put_uint16 (is_big_endian, temp_u16, res_len, p_bytes, p_pos);
-   pf_put_uint16 (
-      is_big_endian,
-      (bh_length + sizeof (pf_block_header_t)) - 4,
-      res_len,
-      p_bytes,
-      p_pos); /* Always (-4)!! */
-   pf_put_byte (bh_ver_high, res_len, p_bytes, p_pos);
-   pf_put_byte (bh_ver_low, res_len, p_bytes, p_pos);
+   if (pf_put_fits (PF_PUT_BLOCK_HEADER_SIZE, res_len, p_bytes, *p_pos))
+   {
+      p_dest = &p_bytes[*p_pos];
+      pf_put_store_uint16 (is_big_endian, (uint16_t)bh_type, &p_dest[0]);
+      pf_put_store_uint16 (
+         is_big_endian,
+         (bh_length + PF_PUT_BLOCK_HEADER_SIZE) - 4,
+         &p_dest[2]); /* Always (-4)!! */
+      p_dest[4] = bh_ver_high;
+      p_dest[5] = bh_ver_low;
+      (*p_pos) += PF_PUT_BLOCK_HEADER_SIZE;
+   }
+}
+
+/**
+ * @internal
+ * Insert the final block length into a block header.
+ *
+ * The block header is first inserted with a block length of 0, and is
+ * updated by this function when the block contents have been inserted.
+ * This way each block is written in a single pass.
+ * @param is_big_endian    In:    true if buffer is big-endian.
+ * @param block_pos        In:    Position of the block header.
+ * @param res_len          In:    Size of destination buffer.
+ * @param p_bytes          Out:   Destination buffer.
+ * @param p_pos            In:    Position after the block contents.
+ */
+static void pf_put_block_end (
+   bool is_big_endian,
+   uint16_t block_pos,
+   uint16_t res_len,
+   uint8_t * p_bytes,
+   const uint16_t * p_pos)
+{
+   uint16_t len_pos = block_pos + offsetof (pf_block_header_t, block_length);
+
+   /* The block length does not include the type and length fields */
+   if (pf_put_fits (sizeof (uint16_t), res_len, p_bytes, len_pos))
+   {
+      pf_put_store_uint16 (
+         is_big_endian,
+         *p_pos - (block_pos + 4),
+         &p_bytes[len_pos]);
+   }
 }
 
 /**
@@ -106,24 +221,17 @@ static void pf_put_str (
    uint16_t * p_pos)
 {
    uint16_t str_len = (uint16_t)strlen (p_src);
-   uint16_t ix;
-
-   if (((*p_pos) + src_size) > res_len)
-   {
-      /* Reached end of buffer */
-      LOG_DEBUG (PNET_LOG, "BW(%d): Output buffer is full\n", __LINE__);
-      p_bytes = NULL;
-   }
 
-   if (p_bytes != NULL)
+   if (pf_put_fits (src_size, res_len, p_bytes, *p_pos))
    {
       memcpy (&p_bytes[*p_pos], p_src, str_len);
       (*p_pos) += str_len;
       /* Pad with spaces - size also includes NUL-terminator. Do not write into
        * that pos. */
-      for (ix = str_len; ix < src_size - 1; ix++)
+      if (str_len < src_size - 1)
       {
-         pf_put_byte (' ', res_len, p_bytes, p_pos);
+         memset (&p_bytes[*p_pos], ' ', (src_size - 1) - str_len);
+         (*p_pos) += (src_size - 1) - str_len;
       }
    }
 }
@@ -186,14 +294,7 @@ void pf_put_mem (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   if (((*p_pos) + src_size) > res_len)
-   {
-      /* Reached end of buffer */
-      LOG_DEBUG (PNET_LOG, "BW(%d): Output buffer is full\n", __LINE__);
-      p_bytes = NULL;
-   }
-
-   if (p_bytes != NULL)
+   if (pf_put_fits (src_size, res_len, p_bytes, *p_pos))
    {
       memcpy (&p_bytes[*p_pos], p_src, src_size);
       (*p_pos) += src_size;
@@ -207,14 +308,7 @@ void pf_put_mem_overlapping (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   if (((*p_pos) + src_size) > res_len)
-   {
-      /* Reached end of buffer */
-      LOG_DEBUG (PNET_LOG, "BW(%d): Output buffer is full\n", __LINE__);
-      p_bytes = NULL;
-   }
-
-   if (p_bytes != NULL)
+   if (pf_put_fits (src_size, res_len, p_bytes, *p_pos))
    {
       memmove (&p_bytes[*p_pos], p_src, src_size);
       (*p_pos) += src_size;
@@ -227,14 +321,7 @@ void pf_put_byte (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   if (*p_pos + 1 > res_len)
-   {
-      /* Reached end of buffer */
-      LOG_DEBUG (PNET_LOG, "BW(%d): End of buffer reached\n", __LINE__);
-      p_bytes = NULL;
-   }
-
-   if (p_bytes != NULL)
+   if (pf_put_fits (1, res_len, p_bytes, *p_pos))
    {
       p_bytes[*p_pos] = val;
       (*p_pos)++;
@@ -248,15 +335,10 @@ void pf_put_uint16 (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   if (is_big_endian)
-   {
-      pf_put_byte ((val >> 8) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte (val & 0xff, res_len, p_bytes, p_pos);
-   }
-   else
+   if (pf_put_fits (sizeof (val), res_len, p_bytes, *p_pos))
    {
-      pf_put_byte (val & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 8) & 0xff, res_len, p_bytes, p_pos);
+      pf_put_store_uint16 (is_big_endian, val, &p_bytes[*p_pos]);
+      (*p_pos) += sizeof (val);
    }
 }
 
@@ -267,19 +349,10 @@ void pf_put_uint32 (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   if (is_big_endian)
-   {
-      pf_put_byte ((val >> 24) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 16) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 8) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte (val & 0xff, res_len, p_bytes, p_pos);
-   }
-   else
+   if (pf_put_fits (sizeof (val), res_len, p_bytes, *p_pos))
    {
-      pf_put_byte (val & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 8) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 16) & 0xff, res_len, p_bytes, p_pos);
-      pf_put_byte ((val >> 24) & 0xff, res_len, p_bytes, p_pos);
+      pf_put_store_uint32 (is_big_endian, val, &p_bytes[*p_pos]);
+      (*p_pos) += sizeof (val);
    }
 }
 
@@ -289,10 +362,10 @@ void pf_put_padding (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   uint16_t i;
-   for (i = 0; i < n_bytes; i++)
+   if (pf_put_fits (n_bytes, res_len, p_bytes, *p_pos))
    {
-      pf_put_byte (0, res_len, p_bytes, p_pos);
+      memset (&p_bytes[*p_pos], 0, n_bytes);
+      (*p_pos) += n_bytes;
    }
 }
 
@@ -303,9 +376,11 @@ void pf_put_padding_align (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   while (((*p_pos) - start_position) % align != 0)
+   uint16_t remainder = ((*p_pos) - start_position) % align;
+
+   if (remainder != 0)
    {
-      pf_put_byte (0, res_len, p_bytes, p_pos);
+      pf_put_padding (align - remainder, res_len, p_bytes, p_pos);
    }
 }
 
@@ -338,7 +413,6 @@ void pf_put_ar_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -378,10 +452,7 @@ void pf_put_ar_result (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_iocr_result (
@@ -393,7 +464,6 @@ void pf_put_iocr_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -425,10 +495,7 @@ void pf_put_iocr_result (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_alarm_cr_result (
@@ -439,7 +506,6 @@ void pf_put_alarm_cr_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -471,10 +537,7 @@ void pf_put_alarm_cr_result (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 /**
@@ -645,7 +708,6 @@ void pf_put_ar_diff (
    uint16_t * p_pos)
 {
    uint16_t block_pos;
-   uint16_t block_len;
    uint16_t i;
 
    if (p_ar != NULL)
@@ -655,12 +717,10 @@ void pf_put_ar_diff (
       if (ident->nbr_diff_apis > 0)
       {
          block_pos = *p_pos;
-         block_len = 0; /* Dont know block_len yet */
-
          pf_put_block_header (
             is_big_endian,
             PF_BT_MODULE_DIFF_BLOCK,
-            block_len,
+            0, /* Dont know block_len yet */
             PNET_BLOCK_VERSION_HIGH,
             PNET_BLOCK_VERSION_LOW,
             res_len,
@@ -685,9 +745,7 @@ void pf_put_ar_diff (
          }
 
          /* Finally insert the block length into the block header */
-         block_len = *p_pos - (block_pos + 4);
-         block_pos += offsetof (pf_block_header_t, block_length);
-         pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+         pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
       }
    }
 }
@@ -700,7 +758,6 @@ void pf_put_ar_rpc_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -720,10 +777,7 @@ void pf_put_ar_rpc_result (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_ar_server_result (
@@ -734,7 +788,6 @@ void pf_put_ar_server_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -763,10 +816,7 @@ void pf_put_ar_server_result (
    pf_put_padding_align (block_pos, 4, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 #if PNET_OPTION_AR_VENDOR_BLOCKS
@@ -779,7 +829,6 @@ void pf_put_ar_vendor_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -820,10 +869,7 @@ void pf_put_ar_vendor_result (
    pf_put_padding_align (block_pos, 4, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 #endif
 
@@ -927,6 +973,15 @@ static void pf_put_ar_vendor_block_res (
 #endif
 
 #if PNET_OPTION_FAST_STARTUP
+/**
+ * @internal
+ * Insert an ARFSUBlock into a buffer.
+ * @param is_big_endian    In:    Endianness of the destination buffer.
+ * @param p_ar             In:    The AR instance.
+ * @param res_len          In:    Size of destination buffer.
+ * @param p_bytes          Out:   Destination buffer.
+ * @param p_pos            InOut: Position in destination buffer.
+ */
 static void pf_put_fsu_data (
    bool is_big_endian,
    const pf_ar_t * p_ar,
@@ -934,7 +989,76 @@ static void pf_put_fsu_data (
    uint8_t * p_bytes,
    uint16_t * p_pos)
 {
-   /* ToDo: Not yet implemented */
+   uint16_t block_pos = *p_pos;
+   uint16_t sub_block_pos;
+
+   pf_put_block_header (
+      is_big_endian,
+      PF_BT_AR_FSU_BLOCK_REQ,
+      0, /* Dont know block_len yet */
+      PNET_BLOCK_VERSION_HIGH,
+      PNET_BLOCK_VERSION_LOW,
+      res_len,
+      p_bytes,
+      p_pos);
+   pf_put_padding (2, res_len, p_bytes, p_pos);
+
+   /* FSParameterBlock */
+   sub_block_pos = *p_pos;
+   pf_put_block_header (
+      is_big_endian,
+      PF_BT_FS_PARAMETER,
+      0, /* Dont know block_len yet */
+      PNET_BLOCK_VERSION_HIGH,
+      PNET_BLOCK_VERSION_LOW,
+      res_len,
+      p_bytes,
+      p_pos);
+   pf_put_padding (2, res_len, p_bytes, p_pos);
+   pf_put_uint32 (
+      is_big_endian,
+      p_ar->fast_startup_data.fs_parameter_block.fs_parameter_mode,
+      res_len,
+      p_bytes,
+      p_pos);
+   pf_put_uuid (
+      is_big_endian,
+      &p_ar->fast_startup_data.fs_parameter_block.fs_parameter_uuid,
+      res_len,
+      p_bytes,
+      p_pos);
+   pf_put_block_end (is_big_endian, sub_block_pos, res_len, p_bytes, p_pos);
+
+#if PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH
+   if (
+      p_ar->fast_startup_data.length_manufacturer_specific_fast_startup_data >
+      0)
+   {
+      /* FastStartUpBlock */
+      sub_block_pos = *p_pos;
+      pf_put_block_header (
+         is_big_endian,
+         PF_BT_FAST_STARTUP,
+         0, /* Dont know block_len yet */
+         PNET_BLOCK_VERSION_HIGH,
+         PNET_BLOCK_VERSION_LOW,
+         res_len,
+         p_bytes,
+         p_pos);
+      pf_put_padding (2, res_len, p_bytes, p_pos);
+      pf_put_mem (
+         p_ar->fast_startup_data.manufacturer_specific_fast_startup_data,
+         p_ar->fast_startup_data.length_manufacturer_specific_fast_startup_data,
+         res_len,
+         p_bytes,
+         p_pos);
+      pf_put_padding_align (sub_block_pos, 4, res_len, p_bytes, p_pos);
+      pf_put_block_end (is_big_endian, sub_block_pos, res_len, p_bytes, p_pos);
+   }
+#endif
+
+   /* Finally insert the block length into the block header */
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 #endif
 
@@ -1251,8 +1375,7 @@ void pf_put_ar_data (
    BlockHeader, NumberOfARs, (AR)*
    */
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
-   uint16_t data_pos;
+   uint16_t count_pos;
    pf_device_t * p_device = NULL;
    uint16_t cnt;
    uint16_t ix;
@@ -1268,43 +1391,13 @@ void pf_put_ar_data (
       p_bytes,
       p_pos);
 
-   data_pos = *p_pos;
+   /* The number of ARs is inserted when known */
+   count_pos = *p_pos;
+   cnt = 0;
+   pf_put_uint16 (is_big_endian, cnt, res_len, p_bytes, p_pos);
 
    if (pf_cmdev_get_device (net, &p_device) == 0)
    {
-      cnt = 0;
-      if (p_ar == NULL)
-      {
-         /* Count the number of ARs */
-         for (ix = 0; ix < PNET_MAX_AR; ix++)
-         {
-            p_ar_tmp = pf_ar_find_by_index (net, ix);
-            if (p_ar_tmp != NULL)
-            {
-               if (
-                  (p_ar_tmp->ar_param.ar_uuid.data1 != 0) &&
-                  (p_ar_tmp->ar_param.cm_initiator_object_uuid.data1 != 0))
-               {
-                  cnt++;
-               }
-            }
-         }
-      }
-      else
-      {
-         /* Count the number of ARs using this API */
-         for (ix = 0; ix < p_ar->exp_ident.nbr_apis; ix++)
-         {
-            if (p_ar->exp_ident.api[ix].api == api_id)
-            {
-               cnt++;
-            }
-         }
-      }
-      if (cnt > 0)
-      {
-         pf_put_uint16 (is_big_endian, cnt, res_len, p_bytes, p_pos);
-      }
       if (p_ar == NULL)
       {
          /* Insert the ARs */
@@ -1325,6 +1418,7 @@ void pf_put_ar_data (
                      res_len,
                      p_bytes,
                      p_pos);
+                  cnt++;
                }
             }
          }
@@ -1344,19 +1438,18 @@ void pf_put_ar_data (
                   res_len,
                   p_bytes,
                   p_pos);
+               cnt++;
             }
          }
       }
    }
 
-   if (data_pos < *p_pos)
+   if (cnt > 0)
    {
+      pf_put_uint16 (is_big_endian, cnt, res_len, p_bytes, &count_pos);
+
       /* Finally insert the block length into the block header */
-      block_len = *p_pos - (block_pos + 4);
-      block_pos += offsetof (pf_block_header_t, block_length); /* Point to
-                                                                  correct place
-                                                                */
-      pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+      pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
    }
    else
    {
@@ -1374,7 +1467,6 @@ void pf_put_control (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    pf_put_block_header (
       is_big_endian,
@@ -1413,10 +1505,7 @@ void pf_put_control (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pnet_status (
@@ -1554,7 +1643,6 @@ void pf_put_record_data_read (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -1570,10 +1658,7 @@ void pf_put_record_data_read (
    pf_put_mem (p_raw_data, raw_length, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_read_result (
@@ -1585,7 +1670,6 @@ void pf_put_read_result (
    uint16_t * p_data_length_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -1623,10 +1707,7 @@ void pf_put_read_result (
    pf_put_padding (NELEMENTS (p_res->rw_padding), res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 /**
@@ -1940,17 +2021,15 @@ void pf_put_real_ident_data (
    uint16_t * pos)
 {
    uint16_t block_pos;
-   uint16_t block_len;
    uint16_t data_pos;
    pf_device_t * device;
 
-   block_len = 0; /* Dont know block_len yet */
    block_pos = *pos;
    pf_put_block_header (
       big_endian,
       (scope == PF_RECORD_DATA_SCOPE_DEVICE) ? PF_BT_API_DATA
                                              : PF_BT_REAL_IDENTIFICATION_DATA,
-      block_len,
+      0, /* Dont know block_len yet */
       PNET_BLOCK_VERSION_HIGH,
       block_version_low,
       res_len,
@@ -1999,11 +2078,7 @@ void pf_put_real_ident_data (
    if (data_pos < *pos)
    {
       /* Finally insert the block length into the block header */
-      block_len = *pos - (block_pos + 4);
-      block_pos += offsetof (pf_block_header_t, block_length); /* Point to
-                                                                  correct place
-                                                                */
-      pf_put_uint16 (big_endian, block_len, res_len, bytes, &block_pos);
+      pf_put_block_end (big_endian, block_pos, res_len, bytes, pos);
    }
    else
    {
@@ -2140,19 +2215,17 @@ void pf_put_exp_ident_data (
    uint16_t * pos)
 {
    uint16_t block_pos;
-   uint16_t block_len;
    pf_exp_ident_t const * exp_ident;
    pf_exp_api_t const * exp_api;
    pf_exp_module_t const * exp_module;
    pf_exp_submodule_t const * exp_submodule;
    uint16_t i;
 
-   block_len = 0; /* Dont know block_len yet */
    block_pos = *pos;
    pf_put_block_header (
       big_endian,
       PF_BT_EXPECTED_IDENTIFICATION_DATA,
-      block_len,
+      0, /* Dont know block_len yet */
       PNET_BLOCK_VERSION_HIGH,
       block_version_low,
       res_len,
@@ -2234,9 +2307,7 @@ void pf_put_exp_ident_data (
    }
 
    /* Finally insert the block length into the block header */
-   block_len = *pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length);
-   pf_put_uint16 (big_endian, block_len, res_len, bytes, &block_pos);
+   pf_put_block_end (big_endian, block_pos, res_len, bytes, pos);
 }
 
 void pf_put_im_0_filter_data (
@@ -2247,7 +2318,6 @@ void pf_put_im_0_filter_data (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    pf_device_t * p_device = NULL;
 
    /* Insert block header for the read operation */
@@ -2281,10 +2351,7 @@ void pf_put_im_0_filter_data (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 
    /* I&M0FilterDataDevice - insert only the first submodule of the DAP. */
    block_pos = *p_pos;
@@ -2313,10 +2380,7 @@ void pf_put_im_0_filter_data (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_im_0 (
@@ -2327,7 +2391,6 @@ void pf_put_im_0 (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -2386,10 +2449,7 @@ void pf_put_im_0 (
    pf_put_uint16 (is_big_endian, p_im_0->im_supported, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_im_1 (
@@ -2400,7 +2460,6 @@ void pf_put_im_1 (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -2427,10 +2486,7 @@ void pf_put_im_1 (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_im_2 (
@@ -2441,7 +2497,6 @@ void pf_put_im_2 (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -2457,10 +2512,7 @@ void pf_put_im_2 (
    pf_put_str (p_im_2, sizeof (pnet_im_2_t), res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_im_3 (
@@ -2471,7 +2523,6 @@ void pf_put_im_3 (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -2487,10 +2538,7 @@ void pf_put_im_3 (
    pf_put_str (p_im_3, sizeof (pnet_im_3_t), res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_record_data_write (
@@ -2503,7 +2551,6 @@ void pf_put_record_data_write (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the read operation */
    pf_put_block_header (
@@ -2519,10 +2566,7 @@ void pf_put_record_data_write (
    pf_put_mem (p_raw_data, raw_length, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_write_result (
@@ -2533,7 +2577,6 @@ void pf_put_write_result (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the write operation */
    pf_put_block_header (
@@ -2577,10 +2620,7 @@ void pf_put_write_result (
    pf_put_padding (NELEMENTS (p_res->rw_padding), res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 
    if (*p_pos >= res_len)
    {
@@ -2600,7 +2640,6 @@ void pf_put_log_book_data (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint16_t ix;
    uint16_t cnt = 0;
 
@@ -2673,10 +2712,7 @@ void pf_put_log_book_data (
    }
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 /**
@@ -2858,7 +2894,6 @@ static void pf_put_diag_list (
    pf_diag_item_t * p_item = NULL;
    bool insert;
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint16_t data_pos;
 
    /* Walk the list to insert all items */
@@ -2967,9 +3002,7 @@ static void pf_put_diag_list (
       /* Finally insert the block length into the block header */
       if (*p_pos > data_pos)
       {
-         block_len = *p_pos - (block_pos + 4);
-         block_pos += offsetof (pf_block_header_t, block_length);
-         pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+         pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
       }
       else
       {
@@ -3451,7 +3484,6 @@ void pf_put_maint_status (
    uint16_t * p_pos)
 {
    uint16_t block_pos = 0;
-   uint16_t block_len = 0;
 
    pf_put_uint16 (is_big_endian, PF_USI_MAINTENANCE, res_len, p_bytes, p_pos);
 
@@ -3472,10 +3504,7 @@ void pf_put_maint_status (
    pf_put_uint32 (is_big_endian, maint_status, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   /* Point to correct place */
-   block_pos += offsetof (pf_block_header_t, block_length);
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_alarm_block (
@@ -3492,7 +3521,6 @@ void pf_put_alarm_block (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint32_t temp_u16;
    uint32_t temp_u32;
 
@@ -3626,10 +3654,7 @@ void pf_put_alarm_block (
    }
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_substitute_data (
@@ -3646,7 +3671,6 @@ void pf_put_substitute_data (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Now the substitution data - this is an inner block (ToDo: Make own
     * function) */
@@ -3666,10 +3690,7 @@ void pf_put_substitute_data (
    pf_put_mem (p_iops, iops_len, res_len, p_bytes, p_pos);
 
    /* Insert the block length into the substitution data block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_output_data (
@@ -3688,7 +3709,6 @@ void pf_put_output_data (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint16_t substitute_active_flag = sub_active ? 1 : 0;
 
    /* Insert block header for the output block */
@@ -3736,10 +3756,7 @@ void pf_put_output_data (
    /* -------------- */
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_input_data (
@@ -3755,7 +3772,6 @@ void pf_put_input_data (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Insert block header for the output block */
    pf_put_block_header (
@@ -3778,10 +3794,7 @@ void pf_put_input_data (
    pf_put_mem (p_data, data_len, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pdport_data_check (
@@ -3794,7 +3807,6 @@ void pf_put_pdport_data_check (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -3853,10 +3865,7 @@ void pf_put_pdport_data_check (
    pf_put_padding_align (block_pos, 4, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pdport_data_real (
@@ -3872,7 +3881,6 @@ void pf_put_pdport_data_real (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint16_t link_state = 0;
    uint8_t num_peers = p_port_data->lldp.is_peer_info_received ? 1 : 0;
    const pf_lldp_peer_info_t * p_peer_info = &p_port_data->lldp.peer_info;
@@ -3991,10 +3999,7 @@ void pf_put_pdport_data_real (
    pf_put_uint32 (is_big_endian, media_type, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pdport_statistics (
@@ -4005,7 +4010,6 @@ void pf_put_pdport_statistics (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -4058,10 +4062,7 @@ void pf_put_pdport_statistics (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pdinterface_data_real (
@@ -4076,7 +4077,6 @@ void pf_put_pdinterface_data_real (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -4116,10 +4116,7 @@ void pf_put_pdinterface_data_real (
    pf_put_uint32 (is_big_endian, gateway, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pd_multiblock_interface_and_statistics (
@@ -4136,7 +4133,6 @@ void pf_put_pd_multiblock_interface_and_statistics (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -4184,10 +4180,7 @@ void pf_put_pd_multiblock_interface_and_statistics (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pd_multiblock_port_and_statistics (
@@ -4205,7 +4198,6 @@ void pf_put_pd_multiblock_port_and_statistics (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -4249,10 +4241,7 @@ void pf_put_pd_multiblock_port_and_statistics (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 /**
@@ -4272,7 +4261,6 @@ void pf_put_peer_to_peer_boundary (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint32_t temp_u32 = 0;
 
    /* Block header first */
@@ -4321,10 +4309,7 @@ void pf_put_peer_to_peer_boundary (
    pf_put_padding (2, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pdport_data_adj (
@@ -4336,7 +4321,6 @@ void pf_put_pdport_data_adj (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
 
    /* Block header first */
    pf_put_block_header (
@@ -4364,10 +4348,7 @@ void pf_put_pdport_data_adj (
       p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 void pf_put_pd_interface_adj (
@@ -4379,7 +4360,6 @@ void pf_put_pd_interface_adj (
    uint16_t * p_pos)
 {
    uint16_t block_pos = *p_pos;
-   uint16_t block_len = 0;
    uint32_t temp_u32;
 
    /* Block header first */
@@ -4404,10 +4384,7 @@ void pf_put_pd_interface_adj (
    pf_put_padding_align (block_pos, 4, res_len, p_bytes, p_pos);
 
    /* Finally insert the block length into the block header */
-   block_len = *p_pos - (block_pos + 4);
-   block_pos += offsetof (pf_block_header_t, block_length); /* Point to correct
-                                                               place */
-   pf_put_uint16 (is_big_endian, block_len, res_len, p_bytes, &block_pos);
+   pf_put_block_end (is_big_endian, block_pos, res_len, p_bytes, p_pos);
 }
 
 /**
@@ -31,7 +31,8 @@
  */
 
 #ifdef UNIT_TEST
-
+#define os_get_current_time_us mock_os_get_current_time_us
+#define pf_alarm_send_pull     mock_pf_alarm_send_pull
 #endif
 
 #include <string.h>
@@ -150,9 +151,109 @@ int pf_cmdev_get_api (pnet_t * net, uint32_t api_id, pf_api_t ** pp_api)
    return -1;
 }
 
+/**
+ * @internal
+ * Find a number in a sorted lookup index, using binary search.
+ * @param p_numbers        In:    Sorted numbers.
+ * @param count            In:    Number of entries in p_numbers.
+ * @param number           In:    The number to search for.
+ * @param p_ix             Out:   Index of the number if found, otherwise
+ *                                the index where it should be inserted.
+ * @return  0  if the number was found.
+ *          -1 if the number was not found.
+ */
+int pf_cmdev_index_find (
+   const uint16_t * p_numbers,
+   uint16_t count,
+   uint16_t number,
+   uint16_t * p_ix)
+{
+   uint16_t low = 0;
+   uint16_t high = count;
+   uint16_t mid;
+
+   while (low < high)
+   {
+      mid = low + (high - low) / 2;
+      if (p_numbers[mid] < number)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+
+   *p_ix = low;
+   return ((low < count) && (p_numbers[low] == number)) ? 0 : -1;
+}
+
+int pf_cmdev_index_insert (
+   uint16_t * p_numbers,
+   uint16_t * p_positions,
+   uint16_t * p_count,
+   uint16_t max_count,
+   uint16_t number,
+   uint16_t position)
+{
+   uint16_t ix;
+
+   if (*p_count >= max_count)
+   {
+      return -1;
+   }
+   if (pf_cmdev_index_find (p_numbers, *p_count, number, &ix) == 0)
+   {
+      return -1;
+   }
+
+   memmove (
+      &p_numbers[ix + 1],
+      &p_numbers[ix],
+      (*p_count - ix) * sizeof (p_numbers[0]));
+   memmove (
+      &p_positions[ix + 1],
+      &p_positions[ix],
+      (*p_count - ix) * sizeof (p_positions[0]));
+   p_numbers[ix] = number;
+   p_positions[ix] = position;
+   (*p_count)++;
+
+   return 0;
+}
+
+int pf_cmdev_index_remove (
+   uint16_t * p_numbers,
+   uint16_t * p_positions,
+   uint16_t * p_count,
+   uint16_t number)
+{
+   uint16_t ix;
+
+   if (pf_cmdev_index_find (p_numbers, *p_count, number, &ix) != 0)
+   {
+      return -1;
+   }
+
+   (*p_count)--;
+   memmove (
+      &p_numbers[ix],
+      &p_numbers[ix + 1],
+      (*p_count - ix) * sizeof (p_numbers[0]));
+   memmove (
+      &p_positions[ix],
+      &p_positions[ix + 1],
+      (*p_count - ix) * sizeof (p_positions[0]));
+
+   return 0;
+}
+
 /**
  * @internal
  * Get an slot instance of an API.
+ *
+ * Uses the slot lookup index of the API.
  * @param p_api            InOut: The API instance.
  * @param slot_nbr         In:    The slot number (must be in_use)
  * @param pp_slot          Out:   The slot instance.
@@ -164,26 +265,22 @@ int pf_cmdev_get_slot (
    uint16_t slot_nbr,
    pf_slot_t ** pp_slot)
 {
-   pf_slot_t * this_slot;
-   uint16_t s;
+   uint16_t ix;
 
    if ((p_api == NULL) || (pp_slot == NULL))
    {
       LOG_ERROR (PNET_LOG, "CMDEV(%d): NULL pointer(s)\n", __LINE__);
       return -1;
    }
-   else
+   else if (
+      pf_cmdev_index_find (
+         p_api->slot_index_number,
+         p_api->slot_index_count,
+         slot_nbr,
+         &ix) == 0)
    {
-      for (s = 0; s < PNET_MAX_SLOTS; ++s)
-      {
-         this_slot = (pf_slot_t *)&p_api->slots[s];
-         if ((this_slot->in_use == true) &&
-             (this_slot->slot_number == slot_nbr))
-         {
-            *pp_slot = this_slot;
-            return 0;
-         }
-      }
+      *pp_slot = (pf_slot_t *)&p_api->slots[p_api->slot_index_pos[ix]];
+      return 0;
    }
    *pp_slot = NULL;
    return -1;
@@ -192,6 +289,8 @@ int pf_cmdev_get_slot (
 /**
  * @internal
  * Get an sub-slot instance of a slot instance.
+ *
+ * Uses the subslot lookup index of the slot.
  * @param p_slot           InOut: The slot instance.
  * @param subslot_nbr      In:    The sub-slot number (must be in_use).
  * @param pp_subslot       Out:   The sub-slot instance.
@@ -203,26 +302,23 @@ int pf_cmdev_get_subslot (
    uint16_t subslot_nbr,
    pf_subslot_t ** pp_subslot)
 {
-   pf_subslot_t * this_subslot;
-   uint16_t s;
+   uint16_t ix;
 
    if ((p_slot == NULL) || (pp_subslot == NULL))
    {
       LOG_ERROR (PNET_LOG, "CMDEV(%d): NULL pointer(s)\n", __LINE__);
       return -1;
    }
-   else
-   {
-      for (s = 0; s < PNET_MAX_SUBSLOTS; ++s)
-      {
-         this_subslot = (pf_subslot_t *)&p_slot->subslots[s];
-         if (this_subslot->in_use &&
-             (this_subslot->subslot_number == subslot_nbr))
-         {
-            *pp_subslot = this_subslot;
-            return 0;
-         }
-      }
+   else if (
+      pf_cmdev_index_find (
+         p_slot->subslot_index_number,
+         p_slot->subslot_index_count,
+         subslot_nbr,
+         &ix) == 0)
+   {
+      *pp_subslot =
+         (pf_subslot_t *)&p_slot->subslots[p_slot->subslot_index_pos[ix]];
+      return 0;
    }
    *pp_subslot = NULL;
    return -1;
@@ -504,6 +600,13 @@ static int pf_cmdev_new_slot (
          memset (p_slot, 0, sizeof (*p_slot));
          p_slot->slot_number = slot_nbr;
          p_slot->in_use = true;
+         (void)pf_cmdev_index_insert (
+            p_api->slot_index_number,
+            p_api->slot_index_pos,
+            &p_api->slot_index_count,
+            PNET_MAX_SLOTS,
+            slot_nbr,
+            ix);
 
          ret = 0;
       }
@@ -562,6 +665,13 @@ static int pf_cmdev_new_subslot (
          p_subslot->subslot_number = subslot_nbr;
          p_subslot->diag_list = PF_DIAG_IX_NULL;
          p_subslot->in_use = true;
+         (void)pf_cmdev_index_insert (
+            p_slot->subslot_index_number,
+            p_slot->subslot_index_pos,
+            &p_slot->subslot_index_count,
+            PNET_MAX_SUBSLOTS,
+            subslot_nbr,
+            ix);
 
          ret = 0;
       }
@@ -622,6 +732,7 @@ int pf_cmdev_plug_module (
    {
       /* Slot allocated */
       p_slot->ident_number = module_ident_nbr;
+      net->cmdev_device.real_ident_version++;
       ret = 0;
    }
 
@@ -668,6 +779,15 @@ int pf_cmdev_pull_submodule (
    else
    {
       p_subslot->in_use = false;
+      (void)pf_cmdev_index_remove (
+         p_slot->subslot_index_number,
+         p_slot->subslot_index_pos,
+         &p_slot->subslot_index_count,
+         subslot_nbr);
+      net->cmdev_device.real_ident_version++;
+#if PNET_OPTION_FAST_STARTUP
+      pf_fsu_pull_submodule_ind (net, api_id, slot_nbr, subslot_nbr);
+#endif
 
       if ((p_subslot->ownsm_state == PF_OWNSM_STATE_IOC) ||
           (p_subslot->ownsm_state == PF_OWNSM_STATE_IOS))
@@ -795,6 +915,10 @@ int pf_cmdev_plug_submodule (
       p_subslot->length_output = length_output;
       p_subslot->ownsm_state = PF_OWNSM_STATE_FREE;
       p_subslot->owner = NULL;
+      net->cmdev_device.real_ident_version++;
+#if PNET_OPTION_FAST_STARTUP
+      pf_fsu_plug_submodule_ind (net, p_api, p_slot, p_subslot);
+#endif
 
       ret = 0;
       exp_submodule = NULL;
@@ -849,75 +973,839 @@ int pf_cmdev_plug_submodule (
          (unsigned)slot_nbr,
          (unsigned)subslot_nbr);
    }
-   else
+   else
+   {
+      /* Out of resources */
+      LOG_ERROR (
+         PNET_LOG,
+         "CMDEV(%d): Out of subslot resources for api %u slot %u\n",
+         __LINE__,
+         (unsigned)api_id,
+         (unsigned)slot_nbr);
+   }
+
+   return ret;
+}
+
+int pf_cmdev_pull_module (pnet_t * net, uint32_t api_id, uint16_t slot_nbr)
+{
+   int ret = -1;
+   pf_api_t * p_api = NULL;
+   pf_slot_t * p_slot = NULL;
+   uint16_t ix;
+
+   /* Pull all submodules. Then pull the module */
+   if (pf_cmdev_get_api (net, api_id, &p_api) != 0)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "CMDEV(%d): API %u does not exist\n",
+         __LINE__,
+         (unsigned)api_id);
+   }
+   else if (pf_cmdev_get_slot (p_api, slot_nbr, &p_slot) != 0)
+   {
+      LOG_DEBUG (
+         PNET_LOG,
+         "CMDEV(%d): No module in slot %u\n",
+         __LINE__,
+         (unsigned)slot_nbr);
+   }
+   else
+   {
+      ret = 0; /* Assume all OK */
+      ix = 0;
+      while ((ix < PNET_MAX_SUBSLOTS) && (ret == 0))
+      {
+         if (
+            (p_slot->subslots[ix].in_use == true) &&
+            (pf_cmdev_pull_submodule (
+                net,
+                api_id,
+                slot_nbr,
+                p_slot->subslots[ix].subslot_number) != 0))
+         {
+            ret = -1;
+         }
+         ix++;
+      }
+
+      if (ret == 0)
+      {
+         p_slot->in_use = false;
+         (void)pf_cmdev_index_remove (
+            p_api->slot_index_number,
+            p_api->slot_index_pos,
+            &p_api->slot_index_count,
+            slot_nbr);
+         net->cmdev_device.real_ident_version++;
+      }
+      else
+      {
+         LOG_ERROR (
+            PNET_LOG,
+            "CMDEV(%d): Could not pull all submodules for api %u slot %u\n",
+            __LINE__,
+            (unsigned)api_id,
+            (unsigned)slot_nbr);
+      }
+   }
+
+   return ret;
+}
+
+/**
+ * @internal
+ * Check if two configuration changes refer to the same slot.
+ * @param p_a              In:    A configuration change.
+ * @param p_b              In:    Another configuration change.
+ * @return  true  if the API and slot numbers are equal.
+ *          false otherwise.
+ */
+static bool pf_cmdev_config_change_same_slot (
+   const pnet_config_change_t * p_a,
+   const pnet_config_change_t * p_b)
+{
+   return (p_a->api == p_b->api) && (p_a->slot == p_b->slot);
+}
+
+/**
+ * @internal
+ * Find the first configuration change of a type for a slot or sub-slot.
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes to search.
+ * @param p_change         In:    Change with the slot or sub-slot to find.
+ * @param type             In:    The change type to find.
+ * @param match_subslot    In:    true to also match the sub-slot number.
+ * @return  The index of the first matching change.
+ *          \a nbr_changes if there is no matching change.
+ */
+static uint16_t pf_cmdev_config_change_find (
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   const pnet_config_change_t * p_change,
+   pnet_config_change_type_t type,
+   bool match_subslot)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < nbr_changes; ix++)
+   {
+      if (
+         (p_changes[ix].type == type) &&
+         (pf_cmdev_config_change_same_slot (&p_changes[ix], p_change) ==
+          true) &&
+         ((match_subslot == false) ||
+          (p_changes[ix].subslot == p_change->subslot)))
+      {
+         break;
+      }
+   }
+
+   return ix;
+}
+
+/**
+ * @internal
+ * Find the first configuration change that plugs something into a slot.
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes to search.
+ * @param p_change         In:    Change with the slot to find.
+ * @return  The index of the first module or sub-module plug into the slot.
+ *          \a nbr_changes if there is no such change.
+ */
+static uint16_t pf_cmdev_config_change_find_plug (
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   const pnet_config_change_t * p_change)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < nbr_changes; ix++)
+   {
+      if (
+         ((p_changes[ix].type == PNET_CONFIG_CHANGE_PLUG_MODULE) ||
+          (p_changes[ix].type == PNET_CONFIG_CHANGE_PLUG_SUBMODULE)) &&
+         (pf_cmdev_config_change_same_slot (&p_changes[ix], p_change) == true))
+      {
+         break;
+      }
+   }
+
+   return ix;
+}
+
+/**
+ * @internal
+ * Check if a configuration change pulls the module in a slot.
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @param p_change         In:    Change with the slot to check.
+ * @return  true  if the module in the slot is pulled.
+ *          false otherwise.
+ */
+static bool pf_cmdev_config_changes_pull_slot (
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   const pnet_config_change_t * p_change)
+{
+   return pf_cmdev_config_change_find (
+             p_changes,
+             nbr_changes,
+             p_change,
+             PNET_CONFIG_CHANGE_PULL_MODULE,
+             false) < nbr_changes;
+}
+
+/**
+ * @internal
+ * Check if a configuration change pulls the sub-module in a sub-slot,
+ * explicitly or by pulling the module.
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @param p_change         In:    Change with the sub-slot to check.
+ * @return  true  if the sub-module in the sub-slot is pulled.
+ *          false otherwise.
+ */
+static bool pf_cmdev_config_changes_pull_subslot (
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   const pnet_config_change_t * p_change)
+{
+   return (pf_cmdev_config_changes_pull_slot (
+              p_changes,
+              nbr_changes,
+              p_change) == true) ||
+          (pf_cmdev_config_change_find (
+              p_changes,
+              nbr_changes,
+              p_change,
+              PNET_CONFIG_CHANGE_PULL_SUBMODULE,
+              true) < nbr_changes);
+}
+
+/**
+ * @internal
+ * Check one configuration change against the current configuration and
+ * against the other changes in the list.
+ * @param net              InOut: The p-net stack instance
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @param ix               In:    Index of the change to check.
+ * @return  0  if the change is valid.
+ *          -1 if an error occurred.
+ */
+static int pf_cmdev_check_config_change (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   uint16_t ix)
+{
+   int ret = -1;
+   const pnet_config_change_t * p_change = &p_changes[ix];
+   pf_api_t * p_api = NULL;
+   pf_slot_t * p_slot = NULL;
+   pf_subslot_t * p_subslot = NULL;
+   bool slot_pulled;
+   bool subslot_pulled;
+   uint16_t first_plug;
+
+   if (pf_cmdev_get_api (net, p_change->api, &p_api) != 0)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "CMDEV(%d): API %u does not exist\n",
+         __LINE__,
+         (unsigned)p_change->api);
+      return -1;
+   }
+
+   if (pf_cmdev_get_slot (p_api, p_change->slot, &p_slot) == 0)
+   {
+      (void)pf_cmdev_get_subslot (p_slot, p_change->subslot, &p_subslot);
+   }
+   slot_pulled =
+      pf_cmdev_config_changes_pull_slot (p_changes, nbr_changes, p_change);
+   subslot_pulled =
+      pf_cmdev_config_changes_pull_subslot (p_changes, nbr_changes, p_change);
+
+   switch (p_change->type)
+   {
+   case PNET_CONFIG_CHANGE_PULL_MODULE:
+      if (p_slot == NULL)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): No module in slot %u\n",
+            __LINE__,
+            (unsigned)p_change->slot);
+      }
+      else if (
+         pf_cmdev_config_change_find (
+            p_changes,
+            ix,
+            p_change,
+            PNET_CONFIG_CHANGE_PULL_MODULE,
+            false) < ix)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Module in slot %u pulled twice\n",
+            __LINE__,
+            (unsigned)p_change->slot);
+      }
+      else
+      {
+         ret = 0;
+      }
+      break;
+   case PNET_CONFIG_CHANGE_PULL_SUBMODULE:
+      if (p_subslot == NULL)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): No submodule in slot %u subslot %u\n",
+            __LINE__,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else if (slot_pulled == true)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Submodule in slot %u subslot %u is pulled with the "
+            "module\n",
+            __LINE__,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else if (
+         pf_cmdev_config_change_find (
+            p_changes,
+            ix,
+            p_change,
+            PNET_CONFIG_CHANGE_PULL_SUBMODULE,
+            true) < ix)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Submodule in slot %u subslot %u pulled twice\n",
+            __LINE__,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else
+      {
+         ret = 0;
+      }
+      break;
+   case PNET_CONFIG_CHANGE_PLUG_MODULE:
+      first_plug = pf_cmdev_config_change_find_plug (p_changes, ix, p_change);
+      if (
+         pf_cmdev_config_change_find (
+            p_changes,
+            ix,
+            p_change,
+            PNET_CONFIG_CHANGE_PLUG_MODULE,
+            false) < ix)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Module in slot %u plugged twice\n",
+            __LINE__,
+            (unsigned)p_change->slot);
+      }
+      else if (
+         ((p_slot != NULL) && (slot_pulled == false) &&
+          (p_slot->ident_number != p_change->module_ident)) ||
+         (((p_slot == NULL) || (slot_pulled == true)) && (first_plug < ix) &&
+          (p_changes[first_plug].module_ident != p_change->module_ident)))
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Wrong plugged module ident %u in api %u slot %u\n",
+            __LINE__,
+            (unsigned)p_change->module_ident,
+            (unsigned)p_change->api,
+            (unsigned)p_change->slot);
+      }
+      else
+      {
+         ret = 0;
+      }
+      break;
+   case PNET_CONFIG_CHANGE_PLUG_SUBMODULE:
+      /* The module ident of the slot is given by the plugged module, or
+       * by the first change plugging something into the slot. */
+      first_plug = pf_cmdev_config_change_find_plug (p_changes, ix, p_change);
+      if (
+         pf_cmdev_config_change_find (
+            p_changes,
+            ix,
+            p_change,
+            PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+            true) < ix)
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Submodule in slot %u subslot %u plugged twice\n",
+            __LINE__,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else if (
+         ((p_slot != NULL) && (slot_pulled == false) &&
+          (p_slot->ident_number != p_change->module_ident)) ||
+         (((p_slot == NULL) || (slot_pulled == true)) && (first_plug < ix) &&
+          (p_changes[first_plug].module_ident != p_change->module_ident)))
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Wrong module ident %u for submodule in api %u "
+            "slot %u subslot %u\n",
+            __LINE__,
+            (unsigned)p_change->module_ident,
+            (unsigned)p_change->api,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else if (
+         (p_subslot != NULL) && (subslot_pulled == false) &&
+         (p_subslot->ident_number != p_change->submodule_ident))
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "CMDEV(%d): Substitute submodule ident 0x%08x number in api %u "
+            "slot %u subslot %u\n",
+            __LINE__,
+            (unsigned)p_change->submodule_ident,
+            (unsigned)p_change->api,
+            (unsigned)p_change->slot,
+            (unsigned)p_change->subslot);
+      }
+      else
+      {
+         ret = 0;
+      }
+      break;
+   default:
+      LOG_ERROR (
+         PNET_LOG,
+         "CMDEV(%d): Unknown configuration change type %u\n",
+         __LINE__,
+         (unsigned)p_change->type);
+      break;
+   }
+
+   return ret;
+}
+
+/**
+ * @internal
+ * Calculate the number of sub-slots in use in a slot after the configuration
+ * changes have been applied.
+ * @param p_changes        In:    The configuration changes. Must be valid.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @param p_change         In:    Change with the slot to count.
+ * @param p_slot           In:    The slot instance, or NULL if not plugged.
+ * @return  The number of sub-slots in use.
+ */
+static uint32_t pf_cmdev_config_changes_subslot_count (
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   const pnet_config_change_t * p_change,
+   pf_slot_t * p_slot)
+{
+   uint32_t count = 0;
+   pf_subslot_t * p_subslot = NULL;
+   bool slot_pulled;
+   uint16_t ix;
+
+   slot_pulled =
+      pf_cmdev_config_changes_pull_slot (p_changes, nbr_changes, p_change);
+   if ((p_slot != NULL) && (slot_pulled == false))
+   {
+      count = p_slot->subslot_index_count;
+   }
+
+   for (ix = 0; ix < nbr_changes; ix++)
+   {
+      if (pf_cmdev_config_change_same_slot (&p_changes[ix], p_change) == false)
+      {
+         continue;
+      }
+
+      if (p_changes[ix].type == PNET_CONFIG_CHANGE_PULL_SUBMODULE)
+      {
+         count--;
+      }
+      else if (
+         (p_changes[ix].type == PNET_CONFIG_CHANGE_PLUG_SUBMODULE) &&
+         ((slot_pulled == true) || (p_slot == NULL) ||
+          (pf_cmdev_get_subslot (p_slot, p_changes[ix].subslot, &p_subslot) !=
+           0) ||
+          (pf_cmdev_config_changes_pull_subslot (
+              p_changes,
+              nbr_changes,
+              &p_changes[ix]) == true)))
+      {
+         count++;
+      }
+   }
+
+   return count;
+}
+
+/**
+ * @internal
+ * Check the configuration changes for one slot.
+ * @param net              InOut: The p-net stack instance
+ * @param p_changes        In:    The configuration changes for the slot.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @param p_nbr_slots      InOut: Number of slots in use in the API. Updated
+ *                                with the effect of the changes.
+ * @return  0  if the changes are valid.
+ *          -1 if an error occurred.
+ */
+static int pf_cmdev_check_config_slot_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes,
+   uint32_t * p_nbr_slots)
+{
+   const pnet_config_change_t * p_change = &p_changes[0];
+   pf_api_t * p_api = NULL;
+   pf_slot_t * p_slot = NULL;
+   bool slot_pulled;
+   uint16_t ix;
+
+   for (ix = 0; ix < nbr_changes; ix++)
+   {
+      if (pf_cmdev_check_config_change (net, p_changes, nbr_changes, ix) != 0)
+      {
+         return -1;
+      }
+   }
+
+   (void)pf_cmdev_get_api (net, p_change->api, &p_api);
+   if (pf_cmdev_get_slot (p_api, p_change->slot, &p_slot) != 0)
+   {
+      p_slot = NULL;
+   }
+   slot_pulled =
+      pf_cmdev_config_changes_pull_slot (p_changes, nbr_changes, p_change);
+
+   if (slot_pulled == true)
+   {
+      (*p_nbr_slots)--;
+   }
+   if (
+      (pf_cmdev_config_change_find_plug (p_changes, nbr_changes, p_change) <
+       nbr_changes) &&
+      ((p_slot == NULL) || (slot_pulled == true)))
+   {
+      (*p_nbr_slots)++;
+   }
+
+   if (
+      (pf_cmdev_config_change_find (
+          p_changes,
+          nbr_changes,
+          p_change,
+          PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+          false) < nbr_changes) &&
+      (pf_cmdev_config_changes_subslot_count (
+          p_changes,
+          nbr_changes,
+          p_change,
+          p_slot) > PNET_MAX_SUBSLOTS))
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "CMDEV(%d): Out of subslot resources for api %u slot %u\n",
+         __LINE__,
+         (unsigned)p_change->api,
+         (unsigned)p_change->slot);
+      return -1;
+   }
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Check a list of configuration changes against the current configuration.
+ *
+ * The list must be sorted by API and slot number, so all changes for a slot
+ * are adjacent and can be checked together. This keeps the check linear in
+ * the number of slots.
+ * @param net              InOut: The p-net stack instance
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @return  0  if the changes are valid and the result fits in the slot and
+ *             sub-slot resources.
+ *          -1 if an error occurred.
+ */
+static int pf_cmdev_check_config_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes)
+{
+   uint32_t nbr_slots[PNET_MAX_API];
+   const pnet_config_change_t * p_change;
+   pf_api_t * p_api = NULL;
+   uint16_t api_ix;
+   uint16_t first = 0;
+   uint16_t end;
+
+   for (api_ix = 0; api_ix < PNET_MAX_API; api_ix++)
+   {
+      nbr_slots[api_ix] = net->cmdev_device.real_ident.api[api_ix].in_use
+                             ? net->cmdev_device.real_ident.api[api_ix]
+                                  .slot_index_count
+                             : 0;
+   }
+
+   while (first < nbr_changes)
+   {
+      p_change = &p_changes[first];
+      if (pf_cmdev_get_api (net, p_change->api, &p_api) != 0)
+      {
+         LOG_ERROR (
+            PNET_LOG,
+            "CMDEV(%d): API %u does not exist\n",
+            __LINE__,
+            (unsigned)p_change->api);
+         return -1;
+      }
+      if (
+         (first > 0) &&
+         ((p_changes[first - 1].api > p_change->api) ||
+          ((p_changes[first - 1].api == p_change->api) &&
+           (p_changes[first - 1].slot >= p_change->slot))))
+      {
+         LOG_ERROR (
+            PNET_LOG,
+            "CMDEV(%d): Configuration changes not sorted by api and slot at "
+            "change %u\n",
+            __LINE__,
+            (unsigned)first);
+         return -1;
+      }
+
+      end = first + 1;
+      while (
+         (end < nbr_changes) &&
+         (pf_cmdev_config_change_same_slot (&p_changes[end], p_change) ==
+          true))
+      {
+         end++;
+      }
+
+      api_ix = (uint16_t)(p_api - net->cmdev_device.real_ident.api);
+      if (
+         pf_cmdev_check_config_slot_changes (
+            net,
+            p_change,
+            end - first,
+            &nbr_slots[api_ix]) != 0)
+      {
+         LOG_ERROR (
+            PNET_LOG,
+            "CMDEV(%d): Invalid configuration changes for api %u slot %u\n",
+            __LINE__,
+            (unsigned)p_change->api,
+            (unsigned)p_change->slot);
+         return -1;
+      }
+      first = end;
+   }
+
+   for (api_ix = 0; api_ix < PNET_MAX_API; api_ix++)
+   {
+      if (nbr_slots[api_ix] > PNET_MAX_SLOTS)
+      {
+         LOG_ERROR (
+            PNET_LOG,
+            "CMDEV(%d): Out of slot resources for api %u\n",
+            __LINE__,
+            (unsigned)net->cmdev_device.real_ident.api[api_ix].api_id);
+         return -1;
+      }
+   }
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Pull a module and all its sub-modules, with consolidated alarms.
+ *
+ * Each AR owning sub-modules in the slot gets one pull module alarm if it
+ * allows that. Other owners get one pull alarm per owned sub-module.
+ * @param net              InOut: The p-net stack instance
+ * @param p_api            InOut: The API instance.
+ * @param p_slot           InOut: The slot instance.
+ */
+static void pf_cmdev_pull_module_consolidated (
+   pnet_t * net,
+   pf_api_t * p_api,
+   pf_slot_t * p_slot)
+{
+   pf_ar_t * owners[PNET_MAX_AR];
+   pf_subslot_t * p_subslot;
+   pf_ar_t * p_ar;
+   uint16_t nbr_owners = 0;
+   uint16_t slot_nbr = p_slot->slot_number;
+   uint16_t ix;
+   uint16_t jx;
+
+   for (ix = 0; ix < PNET_MAX_SUBSLOTS; ix++)
+   {
+      p_subslot = &p_slot->subslots[ix];
+      if (p_subslot->in_use == false)
+      {
+         continue;
+      }
+
+      p_subslot->in_use = false;
+      (void)pf_cmdev_index_remove (
+         p_slot->subslot_index_number,
+         p_slot->subslot_index_pos,
+         &p_slot->subslot_index_count,
+         p_subslot->subslot_number);
+      net->cmdev_device.real_ident_version++;
+
+      if (
+         (p_subslot->ownsm_state != PF_OWNSM_STATE_IOC) &&
+         (p_subslot->ownsm_state != PF_OWNSM_STATE_IOS))
+      {
+         continue;
+      }
+
+      p_ar = p_subslot->owner;
+      if (p_ar->ar_param.ar_properties.pull_module_alarm_allowed == false)
+      {
+         (void)pf_alarm_send_pull (
+            net,
+            p_ar,
+            p_api->api_id,
+            slot_nbr,
+            p_subslot->subslot_number);
+         continue;
+      }
+
+      jx = 0;
+      while ((jx < nbr_owners) && (owners[jx] != p_ar))
+      {
+         jx++;
+      }
+      if ((jx == nbr_owners) && (nbr_owners < PNET_MAX_AR))
+      {
+         owners[nbr_owners++] = p_ar;
+      }
+   }
+
+   for (jx = 0; jx < nbr_owners; jx++)
    {
-      /* Out of resources */
-      LOG_ERROR (
-         PNET_LOG,
-         "CMDEV(%d): Out of subslot resources for api %u slot %u\n",
-         __LINE__,
-         (unsigned)api_id,
-         (unsigned)slot_nbr);
+      (void)pf_alarm_send_pull (net, owners[jx], p_api->api_id, slot_nbr, 0);
    }
 
-   return ret;
+   p_slot->in_use = false;
+   (void)pf_cmdev_index_remove (
+      p_api->slot_index_number,
+      p_api->slot_index_pos,
+      &p_api->slot_index_count,
+      slot_nbr);
+   net->cmdev_device.real_ident_version++;
 }
 
-int pf_cmdev_pull_module (pnet_t * net, uint32_t api_id, uint16_t slot_nbr)
+int pf_cmdev_apply_config_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes)
 {
-   int ret = -1;
+   int ret = 0;
+   const pnet_config_change_t * p_change;
    pf_api_t * p_api = NULL;
    pf_slot_t * p_slot = NULL;
    uint16_t ix;
 
-   /* Pull all submodules. Then pull the module */
-   if (pf_cmdev_get_api (net, api_id, &p_api) != 0)
+   if ((p_changes == NULL) && (nbr_changes > 0))
+   {
+      LOG_ERROR (PNET_LOG, "CMDEV(%d): NULL pointer\n", __LINE__);
+      return -1;
+   }
+
+   /* Check everything before changing anything */
+   if (pf_cmdev_check_config_changes (net, p_changes, nbr_changes) != 0)
    {
       LOG_ERROR (
          PNET_LOG,
-         "CMDEV(%d): API %u does not exist\n",
-         __LINE__,
-         (unsigned)api_id);
+         "CMDEV(%d): Configuration changes rejected. Nothing changed.\n",
+         __LINE__);
+      return -1;
    }
-   else if (pf_cmdev_get_slot (p_api, slot_nbr, &p_slot) != 0)
+
+   /* Pull sub-modules, then modules, then plug in list order */
+   for (ix = 0; ix < nbr_changes; ix++)
    {
-      LOG_DEBUG (
-         PNET_LOG,
-         "CMDEV(%d): No module in slot %u\n",
-         __LINE__,
-         (unsigned)slot_nbr);
+      p_change = &p_changes[ix];
+      if (p_change->type == PNET_CONFIG_CHANGE_PULL_SUBMODULE)
+      {
+         /* Returns -1 for sub-modules without owner */
+         (void)pf_cmdev_pull_submodule (
+            net,
+            p_change->api,
+            p_change->slot,
+            p_change->subslot);
+      }
    }
-   else
+
+   for (ix = 0; ix < nbr_changes; ix++)
    {
-      ret = 0; /* Assume all OK */
-      ix = 0;
-      while ((ix < PNET_MAX_SUBSLOTS) && (ret == 0))
+      p_change = &p_changes[ix];
+      if (
+         (p_change->type == PNET_CONFIG_CHANGE_PULL_MODULE) &&
+         (pf_cmdev_get_api (net, p_change->api, &p_api) == 0) &&
+         (pf_cmdev_get_slot (p_api, p_change->slot, &p_slot) == 0))
+      {
+         pf_cmdev_pull_module_consolidated (net, p_api, p_slot);
+      }
+   }
+
+   for (ix = 0; ix < nbr_changes; ix++)
+   {
+      p_change = &p_changes[ix];
+      if (p_change->type == PNET_CONFIG_CHANGE_PLUG_MODULE)
       {
          if (
-            (p_slot->subslots[ix].in_use == true) &&
-            (pf_cmdev_pull_submodule (
-                net,
-                api_id,
-                slot_nbr,
-                p_slot->subslots[ix].subslot_number) != 0))
+            pf_cmdev_plug_module (
+               net,
+               p_change->api,
+               p_change->slot,
+               p_change->module_ident) != 0)
          {
             ret = -1;
          }
-         ix++;
-      }
-
-      if (ret == 0)
-      {
-         p_slot->in_use = false;
       }
-      else
+      else if (p_change->type == PNET_CONFIG_CHANGE_PLUG_SUBMODULE)
       {
-         LOG_ERROR (
-            PNET_LOG,
-            "CMDEV(%d): Could not pull all submodules for api %u slot %u\n",
-            __LINE__,
-            (unsigned)api_id,
-            (unsigned)slot_nbr);
+         if (
+            pf_cmdev_plug_submodule (
+               net,
+               p_change->api,
+               p_change->slot,
+               p_change->subslot,
+               p_change->module_ident,
+               p_change->submodule_ident,
+               p_change->direction,
+               p_change->length_input,
+               p_change->length_output,
+               false) != 0)
+         {
+            ret = -1;
+         }
       }
    }
 
@@ -1132,11 +2020,115 @@ static const char * pf_cmdev_direction_to_string (pnet_submodule_dir_t direction
    return s;
 }
 
+const char * pf_cmdev_startup_phase_to_string (pnet_ar_startup_phase_t phase)
+{
+   const char * s = "unknown";
+
+   switch (phase)
+   {
+   case PNET_AR_STARTUP_CONNECT_RECEIVED:
+      s = "CONNECT_RECEIVED";
+      break;
+   case PNET_AR_STARTUP_CONNECT_PARSED:
+      s = "CONNECT_PARSED";
+      break;
+   case PNET_AR_STARTUP_CONNECT_CHECKED:
+      s = "CONNECT_CHECKED";
+      break;
+   case PNET_AR_STARTUP_CONNECT_IND_DONE:
+      s = "CONNECT_IND_DONE";
+      break;
+   case PNET_AR_STARTUP_CONNECT_RESPONSE:
+      s = "CONNECT_RESPONSE";
+      break;
+   case PNET_AR_STARTUP_PRMEND_RECEIVED:
+      s = "PRMEND_RECEIVED";
+      break;
+   case PNET_AR_STARTUP_PRMEND_RESPONSE:
+      s = "PRMEND_RESPONSE";
+      break;
+   case PNET_AR_STARTUP_APPLICATION_READY:
+      s = "APPLICATION_READY";
+      break;
+   case PNET_AR_STARTUP_CCONTROL_SENT:
+      s = "CCONTROL_SENT";
+      break;
+   case PNET_AR_STARTUP_CCONTROL_CONFIRMED:
+      s = "CCONTROL_CONFIRMED";
+      break;
+   case PNET_AR_STARTUP_DATA:
+      s = "DATA";
+      break;
+   default:
+      break;
+   }
+   return s;
+}
+
+void pf_cmdev_startup_phase_reached (
+   pf_ar_t * p_ar,
+   pnet_ar_startup_phase_t phase)
+{
+   if (phase < PNET_AR_STARTUP_NUMBER_OF_PHASES)
+   {
+      p_ar->startup_timeline.timestamp_us[phase] = os_get_current_time_us();
+      p_ar->startup_timeline.reached_phases |= BIT (phase);
+   }
+}
+
+int pf_cmdev_get_startup_timeline (
+   const pf_ar_t * p_ar,
+   pnet_ar_startup_timeline_t * p_timeline)
+{
+   if (p_ar == NULL || p_timeline == NULL)
+   {
+      return -1;
+   }
+
+   *p_timeline = p_ar->startup_timeline;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Show the startup timeline of an AR.
+ *
+ * Times are relative to the Connect request, and to the previously
+ * reached phase.
+ * @param p_timeline       In:    Startup timeline to show
+ */
+static void pf_cmdev_startup_timeline_show (
+   const pnet_ar_startup_timeline_t * p_timeline)
+{
+   uint16_t ix;
+   uint32_t start_us = p_timeline->timestamp_us[0];
+   uint32_t previous_us = start_us;
+
+   printf ("Startup timeline [us]  (since connect, since previous phase)\n");
+   for (ix = 0; ix < PNET_AR_STARTUP_NUMBER_OF_PHASES; ix++)
+   {
+      if ((p_timeline->reached_phases & BIT (ix)) != 0)
+      {
+         printf (
+            "  %-20s %10u %10u\n",
+            pf_cmdev_startup_phase_to_string ((pnet_ar_startup_phase_t)ix),
+            (unsigned)(p_timeline->timestamp_us[ix] - start_us),
+            (unsigned)(p_timeline->timestamp_us[ix] - previous_us));
+         previous_us = p_timeline->timestamp_us[ix];
+      }
+   }
+   printf (
+      "  Exp module call-backs %9u\n",
+      (unsigned)p_timeline->exp_module_callbacks_us);
+}
+
 void pf_cmdev_ar_show (const pf_ar_t * p_ar)
 {
    printf (
       "CMDEV state           = %s\n",
       pf_cmdev_state_to_string (p_ar->cmdev_state));
+   pf_cmdev_startup_timeline_show (&p_ar->startup_timeline);
 }
 
 /**
@@ -1350,6 +2342,79 @@ int pf_cmdev_get_state (const pf_ar_t * p_ar, pf_cmdev_state_values_t * p_state)
    return ret;
 }
 
+/**
+ * @internal
+ * Calculate the time between two startup phases.
+ * @param p_timeline       In:    Startup timeline.
+ * @param from             In:    Start phase.
+ * @param to               In:    End phase.
+ * @return  The time in microseconds, or 0 if any of the phases is not
+ *          reached.
+ */
+static uint32_t pf_cmdev_startup_time_between (
+   const pnet_ar_startup_timeline_t * p_timeline,
+   pnet_ar_startup_phase_t from,
+   pnet_ar_startup_phase_t to)
+{
+   uint32_t mask = BIT (from) | BIT (to);
+
+   if ((p_timeline->reached_phases & mask) != mask)
+   {
+      return 0;
+   }
+
+   return p_timeline->timestamp_us[to] - p_timeline->timestamp_us[from];
+}
+
+/**
+ * @internal
+ * Log a summary of the startup timeline of an AR.
+ * @param p_timeline       In:    Startup timeline.
+ * @param arep             In:    The AREP, for logging.
+ */
+static void pf_cmdev_startup_timeline_log (
+   const pnet_ar_startup_timeline_t * p_timeline,
+   uint16_t arep)
+{
+   LOG_INFO (
+      PNET_LOG,
+      "CMDEV(%d): Startup of AREP %u took %" PRIu32 " us. Connect %" PRIu32
+      " us (call-backs %" PRIu32 " us), parameterization %" PRIu32
+      " us, PrmEnd %" PRIu32 " us, application %" PRIu32
+      " us, application ready %" PRIu32 " us\n",
+      __LINE__,
+      arep,
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_CONNECT_RECEIVED,
+         PNET_AR_STARTUP_DATA),
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_CONNECT_RECEIVED,
+         PNET_AR_STARTUP_CONNECT_RESPONSE),
+      p_timeline->exp_module_callbacks_us +
+         pf_cmdev_startup_time_between (
+            p_timeline,
+            PNET_AR_STARTUP_CONNECT_CHECKED,
+            PNET_AR_STARTUP_CONNECT_IND_DONE),
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_CONNECT_RESPONSE,
+         PNET_AR_STARTUP_PRMEND_RECEIVED),
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_PRMEND_RECEIVED,
+         PNET_AR_STARTUP_PRMEND_RESPONSE),
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_PRMEND_RESPONSE,
+         PNET_AR_STARTUP_APPLICATION_READY),
+      pf_cmdev_startup_time_between (
+         p_timeline,
+         PNET_AR_STARTUP_APPLICATION_READY,
+         PNET_AR_STARTUP_DATA));
+}
+
 /**
  * @internal
  * Request a state transition of the specified AR.
@@ -1381,6 +2446,13 @@ static int pf_cmdev_set_state (
    case PF_CMDEV_STATE_ABORT:
       pf_cmdev_state_ind (net, p_ar, PNET_EVENT_ABORT);
       break;
+   case PF_CMDEV_STATE_DATA:
+      pf_cmdev_startup_phase_reached (p_ar, PNET_AR_STARTUP_DATA);
+      if (p_ar->ar_param.ar_properties.device_access == false)
+      {
+         pf_cmdev_startup_timeline_log (&p_ar->startup_timeline, p_ar->arep);
+      }
+      break;
    default:
       /* Nothing (yet) */
       break;
@@ -1417,6 +2489,9 @@ int pf_cmdev_state_ind (pnet_t * net, pf_ar_t * p_ar, pnet_event_values_t event)
       pf_cmwrr_cmdev_state_ind (net, p_ar, event);
       pf_cmsm_cmdev_state_ind (net, p_ar, event);
       pf_cmpbe_cmdev_state_ind (p_ar, event);
+#if PNET_OPTION_FAST_STARTUP
+      pf_fsu_cmdev_state_ind (net, p_ar, event);
+#endif
       pf_cmrpc_cmdev_state_ind (net, p_ar, event);
       if (event == PNET_EVENT_ABORT)
       {
@@ -2472,157 +3547,152 @@ int pf_cmdev_check_no_straddle (
 }
 
 /**
- * Check if a data_desc overlaps any previous data_desc in same iocrs[].
- * @param p_iocr           In:    The iocrs instance.
- * @param ix_this          In:    The data_desc index to verify.
+ * @internal
+ * Check if an area of the C_SDU is unused.
+ * @param p_used           In:    Bitmap with one bit per C_SDU byte.
+ * @param start            In:    The start of the area.
+ * @param length           In:    The length of the area.
+ * @return  true  if no byte of the area is used.
+ */
+static bool pf_cmdev_c_sdu_area_is_free (
+   const uint32_t * p_used,
+   uint16_t start,
+   uint16_t length)
+{
+   uint16_t ix;
+
+   for (ix = start; ix < start + length; ix++)
+   {
+      if ((p_used[ix / 32] & BIT (ix % 32)) != 0)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/**
+ * @internal
+ * Mark an area of the C_SDU as used.
+ * @param p_used           InOut: Bitmap with one bit per C_SDU byte.
+ * @param start            In:    The start of the area.
+ * @param length           In:    The length of the area.
+ */
+static void pf_cmdev_c_sdu_area_mark (
+   uint32_t * p_used,
+   uint16_t start,
+   uint16_t length)
+{
+   uint16_t ix;
+
+   for (ix = start; ix < start + length; ix++)
+   {
+      p_used[ix / 32] |= BIT (ix % 32);
+   }
+}
+
+/**
+ * Check the data_desc areas of an IOCR.
+ *
+ * The data, IOPS and IOCS areas of each data_desc must be within the C_SDU,
+ * and must not overlap the areas of any previous data_desc.
+ *
+ * The C_SDU bytes used so far are kept in a bitmap, so the check is
+ * linear in the number of data_desc and the C_SDU length.
+ *
+ * @param p_data_desc      In:    The data_desc array of the IOCR.
+ * @param nbr_data_desc    In:    Number of entries in p_data_desc.
+ * @param c_sdu_length     In:    The C_SDU length of the IOCR.
  * @param p_stat           Out:   Detailed error information if return != 0.
- * @return  0  If this area does not overlap any previously defined area.
- *          -1 If there is overlap.
+ * @return  0  If all areas are valid.
+ *          -1 If an area is outside the C_SDU or overlaps another area.
  */
-static int pf_cmdev_check_iocr_overlap (
-   pf_iocr_t * p_iocr,
-   uint16_t ix_this,
+int pf_cmdev_check_iocr_data_desc (
+   const pf_iodata_object_t * p_data_desc,
+   uint16_t nbr_data_desc,
+   uint16_t c_sdu_length,
    pnet_result_t * p_stat)
 {
-   /*
-    * If area io_this overlaps with any previous areas [0..(io_this-1)] then
-    * there is an overlap.
-    */
-   int ret = 0; /* Assume no overlap */
+   uint32_t used[(PF_CMDEV_MAX_C_SDU_LENGTH + 31) / 32];
+   uint16_t max_length = c_sdu_length;
    uint16_t ix;
-   uint16_t start;
-   uint16_t len;
+   const pf_iodata_object_t * p_desc;
+   uint8_t error_code_2 = 0;
 
-   for (ix = 0; ix < ix_this; ix++)
+   /* pf_cmdev_check_iocr_param() limits the C_SDU length of RT_CLASS_1,
+    * RT_CLASS_2, RT_CLASS_3 and RT_CLASS_UDP to this. Guards the bitmap
+    * for other RT classes. */
+   if (max_length > PF_CMDEV_MAX_C_SDU_LENGTH)
    {
-      /* Check data area against all previous data_desc */
-      start = p_iocr->data_desc[ix_this].data_offset;
-      len = p_iocr->data_desc[ix_this].data_length;
-      if (len > 0)
+      max_length = PF_CMDEV_MAX_C_SDU_LENGTH;
+   }
+   memset (used, 0, sizeof (used));
+
+   for (ix = 0; (ix < nbr_data_desc) && (error_code_2 == 0); ix++)
+   {
+      p_desc = &p_data_desc[ix];
+
+      /* Each area must be within the C_SDU */
+      if (
+         ((p_desc->data_offset + p_desc->data_length) > max_length) ||
+         ((p_desc->iops_offset + p_desc->iops_length) > max_length))
       {
-         if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].data_offset,
-               p_iocr->data_desc[ix].data_length) != 0)
-         {
-            ret = -1;
-         }
-         else if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].iocs_offset,
-               p_iocr->data_desc[ix].iocs_length) != 0)
-         {
-            ret = -1;
-         }
-         else if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].iops_offset,
-               p_iocr->data_desc[ix].iops_length) != 0)
-         {
-            ret = -1;
-         }
+         error_code_2 = 24;
       }
-      /* Check IOPS area against all previous data_desc */
-      start = p_iocr->data_desc[ix_this].iops_offset;
-      len = p_iocr->data_desc[ix_this].iops_length;
-      if (len > 0)
+      else if ((p_desc->iocs_offset + p_desc->iocs_length) > max_length)
       {
-         if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].data_offset,
-               p_iocr->data_desc[ix].data_length) != 0)
-         {
-            ret = -1;
-         }
-         else if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].iocs_offset,
-               p_iocr->data_desc[ix].iocs_length) != 0)
-         {
-            ret = -1;
-         }
-         else if (
-            pf_cmdev_check_no_straddle (
-               start,
-               len,
-               p_iocr->data_desc[ix].iops_offset,
-               p_iocr->data_desc[ix].iops_length) != 0)
-         {
-            ret = -1;
-         }
+         error_code_2 = 28;
+      }
+      /* Each area must not overlap any area of the previous data_desc */
+      else if (
+         !pf_cmdev_c_sdu_area_is_free (
+            used,
+            p_desc->data_offset,
+            p_desc->data_length) ||
+         !pf_cmdev_c_sdu_area_is_free (
+            used,
+            p_desc->iops_offset,
+            p_desc->iops_length))
+      {
+         error_code_2 = 24;
+      }
+      else if (!pf_cmdev_c_sdu_area_is_free (
+                  used,
+                  p_desc->iocs_offset,
+                  p_desc->iocs_length))
+      {
+         error_code_2 = 28;
+      }
+      else
+      {
+         pf_cmdev_c_sdu_area_mark (
+            used,
+            p_desc->data_offset,
+            p_desc->data_length);
+         pf_cmdev_c_sdu_area_mark (
+            used,
+            p_desc->iops_offset,
+            p_desc->iops_length);
+         pf_cmdev_c_sdu_area_mark (
+            used,
+            p_desc->iocs_offset,
+            p_desc->iocs_length);
       }
    }
 
-   if (ret != 0)
+   if (error_code_2 != 0)
    {
       pf_set_error (
          p_stat,
          PNET_ERROR_CODE_CONNECT,
          PNET_ERROR_DECODE_PNIO,
          PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ,
-         24);
-   }
-   else
-   {
-      for (ix = 0; ix < ix_this; ix++)
-      {
-         /* Check IOCS area against all previous data_desc */
-         start = p_iocr->data_desc[ix_this].iocs_offset;
-         len = p_iocr->data_desc[ix_this].iocs_length;
-         if (len > 0)
-         {
-            if (
-               pf_cmdev_check_no_straddle (
-                  start,
-                  len,
-                  p_iocr->data_desc[ix].data_offset,
-                  p_iocr->data_desc[ix].data_length) != 0)
-            {
-               ret = -1;
-            }
-            else if (
-               pf_cmdev_check_no_straddle (
-                  start,
-                  len,
-                  p_iocr->data_desc[ix].iocs_offset,
-                  p_iocr->data_desc[ix].iocs_length) != 0)
-            {
-               ret = -1;
-            }
-            else if (
-               pf_cmdev_check_no_straddle (
-                  start,
-                  len,
-                  p_iocr->data_desc[ix].iops_offset,
-                  p_iocr->data_desc[ix].iops_length) != 0)
-            {
-               ret = -1;
-            }
-         }
-      }
-
-      if (ret != 0)
-      {
-         pf_set_error (
-            p_stat,
-            PNET_ERROR_CODE_CONNECT,
-            PNET_ERROR_DECODE_PNIO,
-            PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ,
-            28);
-      }
+         error_code_2);
+      return -1;
    }
 
-   return ret;
+   return 0;
 }
 
 /**
@@ -2931,56 +4001,15 @@ static int pf_cmdev_check_iocr_apis (pf_ar_t * p_ar, pnet_result_t * p_stat)
          }
       }
 
-      for (io_ix = 0; io_ix < p_ar->iocrs[ix].nbr_data_desc; io_ix++)
-      {
-         if (ret == 0)
-         {
-            if (
-               (p_ar->iocrs[ix].data_desc[io_ix].data_offset +
-                p_ar->iocrs[ix].data_desc[io_ix].data_length) >
-               p_iocr_param->c_sdu_length)
-            {
-               pf_set_error (
-                  p_stat,
-                  PNET_ERROR_CODE_CONNECT,
-                  PNET_ERROR_DECODE_PNIO,
-                  PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ,
-                  24);
-               ret = -1;
-            }
-            else if (
-               (p_ar->iocrs[ix].data_desc[io_ix].iops_offset +
-                p_ar->iocrs[ix].data_desc[io_ix].iops_length) >
-               p_iocr_param->c_sdu_length)
-            {
-               pf_set_error (
-                  p_stat,
-                  PNET_ERROR_CODE_CONNECT,
-                  PNET_ERROR_DECODE_PNIO,
-                  PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ,
-                  24);
-               ret = -1;
-            }
-            else if (
-               (p_ar->iocrs[ix].data_desc[io_ix].iocs_offset +
-                p_ar->iocrs[ix].data_desc[io_ix].iocs_length) >
-               p_iocr_param->c_sdu_length)
-            {
-               pf_set_error (
-                  p_stat,
-                  PNET_ERROR_CODE_CONNECT,
-                  PNET_ERROR_DECODE_PNIO,
-                  PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ,
-                  28);
-               ret = -1;
-            }
-            else if (
-               pf_cmdev_check_iocr_overlap (&p_ar->iocrs[ix], io_ix, p_stat) !=
-               0)
-            {
-               ret = -1;
-            }
-         }
+      if (
+         (ret == 0) &&
+         (pf_cmdev_check_iocr_data_desc (
+             p_ar->iocrs[ix].data_desc,
+             p_ar->iocrs[ix].nbr_data_desc,
+             p_iocr_param->c_sdu_length,
+             p_stat) != 0))
+      {
+         ret = -1;
       }
 
       if (ret != 0)
@@ -3112,7 +4141,10 @@ static int pf_cmdev_check_iocr_param (
          ((p_iocr->iocr_properties.rt_class == PF_RT_CLASS_UDP) &&
           ((p_iocr->c_sdu_length < 12) || (p_iocr->c_sdu_length > 1440))) ||
          ((p_iocr->iocr_properties.rt_class == PF_RT_CLASS_1) &&
-          ((p_iocr->c_sdu_length < 40) || (p_iocr->c_sdu_length > 1440))))
+          ((p_iocr->c_sdu_length < 40) || (p_iocr->c_sdu_length > 1440))) ||
+         (((p_iocr->iocr_properties.rt_class == PF_RT_CLASS_2) ||
+           (p_iocr->iocr_properties.rt_class == PF_RT_CLASS_3)) &&
+          (p_iocr->c_sdu_length > 1440)))
       {
          pf_set_error (
             p_stat,
@@ -3395,6 +4427,7 @@ static int pf_cmdev_exp_submodule_configure (
    pf_api_entry_t * p_iocr_api;
    uint16_t i;
    pnet_data_cfg_t exp_data = {0};
+   uint32_t callback_start_us;
 
    ret = 0; /* Assume all goes well */
    for (sub_ix = 0; sub_ix < p_exp_mod->nbr_submodules; sub_ix++)
@@ -3426,6 +4459,7 @@ static int pf_cmdev_exp_submodule_configure (
          /*
           * Return code is not interesting here.
           */
+         callback_start_us = os_get_current_time_us();
          (void)pf_fspm_exp_submodule_ind (
             net,
             p_exp_api->api,
@@ -3434,6 +4468,8 @@ static int pf_cmdev_exp_submodule_configure (
             p_exp_mod->ident_number,
             p_exp_sub->ident_number,
             &exp_data);
+         p_ar->startup_timeline.exp_module_callbacks_us +=
+            os_get_current_time_us() - callback_start_us;
       }
       else
       {
@@ -3788,6 +4824,7 @@ static int pf_cmdev_exp_modules_configure (
    uint16_t slot;
    uint16_t cnt;
    uint16_t ix;
+   uint32_t callback_start_us;
 
    ret = 0; /* Assume all goes well */
    for (mod_ix = 0; mod_ix < p_exp_api->nbr_modules; mod_ix++)
@@ -3824,11 +4861,14 @@ static int pf_cmdev_exp_modules_configure (
             /*
              * Return code is not interesting here.
              */
+            callback_start_us = os_get_current_time_us();
             (void)pf_fspm_exp_module_ind (
                net,
                p_exp_api->api,
                p_exp_mod->slot_number,
                p_exp_mod->ident_number);
+            p_ar->startup_timeline.exp_module_callbacks_us +=
+               os_get_current_time_us() - callback_start_us;
          }
       }
 
@@ -4586,24 +5626,95 @@ int pf_cmdev_generate_submodule_diff (
    return 0;
 }
 
+/* First frame ID of each RT class range, index is pf_frame_id_pool_t */
+static const uint16_t pf_cmdev_frame_id_pool_start[] = {
+   0xC000, /* RT_CLASS_1 and RT_CLASS_UDP */
+   0x8000, /* RT_CLASS_2 */
+   0x0100, /* RT_CLASS_3 */
+};
+
 /**
  * @internal
- * Verify that the frame id is not already used by any AR.
+ * Mark a frame ID as used in the frame ID pools.
  *
- * Looks in all ARs, both in input CR and output CR.
+ * Frame IDs outside the pools are ignored.
  *
  * @param net              InOut: The p-net stack instance
- * @param p_ar             In:    The AR instance.
- * @param frame_id         In:    The frame id to check.
- * @return  true  if the frame_id is free to use.
- *          false if the frame id is already used.
+ * @param frame_id         In:    The frame ID.
+ */
+static void pf_cmdev_frame_id_pool_mark (pnet_t * net, uint16_t frame_id)
+{
+   uint16_t pool;
+   uint16_t offset;
+
+   for (pool = 0; pool < PF_FRAME_ID_POOL_NUMBER_OF_POOLS; pool++)
+   {
+      if (frame_id >= pf_cmdev_frame_id_pool_start[pool])
+      {
+         offset = frame_id - pf_cmdev_frame_id_pool_start[pool];
+         if (offset < PF_FRAME_ID_POOL_SIZE)
+         {
+            net->cmdev_device.frame_id_pool[pool][offset / 32] |=
+               BIT (offset % 32);
+            return;
+         }
+      }
+   }
+}
+
+/**
+ * @internal
+ * Allocate the lowest free frame ID in a frame ID pool.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param pool             In:    The frame ID pool.
+ * @param p_frame_id       Out:   The allocated frame ID.
+ * @return  0  if a frame ID was allocated.
+ *          -1 if the pool is full.
  */
-static bool pf_cmdev_verify_free_frame_id (pnet_t * net, uint16_t frame_id)
+static int pf_cmdev_frame_id_pool_allocate (
+   pnet_t * net,
+   pf_frame_id_pool_t pool,
+   uint16_t * p_frame_id)
+{
+   uint16_t word_ix;
+   uint16_t offset;
+   uint32_t * p_word;
+
+   for (word_ix = 0; word_ix < PF_FRAME_ID_POOL_WORDS; word_ix++)
+   {
+      p_word = &net->cmdev_device.frame_id_pool[pool][word_ix];
+      if (*p_word != 0xFFFFFFFF)
+      {
+         offset = word_ix * 32;
+         while ((*p_word & BIT (offset % 32)) != 0)
+         {
+            offset++;
+         }
+
+         if (offset < PF_FRAME_ID_POOL_SIZE)
+         {
+            *p_word |= BIT (offset % 32);
+            *p_frame_id = pf_cmdev_frame_id_pool_start[pool] + offset;
+            return 0;
+         }
+      }
+   }
+
+   return -1;
+}
+
+void pf_cmdev_update_frame_id_pool (pnet_t * net)
 {
-   int ix = 0;
-   int iy = 0;
+   uint16_t ix;
+   uint16_t iy;
    pf_ar_t * p_ar = NULL;
 
+   memset (
+      net->cmdev_device.frame_id_pool,
+      0,
+      sizeof (net->cmdev_device.frame_id_pool));
+
    for (ix = 0; ix < PNET_MAX_AR; ix++)
    {
       p_ar = pf_ar_find_by_index (net, ix);
@@ -4611,15 +5722,10 @@ static bool pf_cmdev_verify_free_frame_id (pnet_t * net, uint16_t frame_id)
       {
          for (iy = 0; iy < p_ar->nbr_iocrs; iy++)
          {
-            if (p_ar->iocrs[iy].param.frame_id == frame_id)
-            {
-               return false;
-            }
+            pf_cmdev_frame_id_pool_mark (net, p_ar->iocrs[iy].param.frame_id);
          }
       }
    }
-
-   return true;
 }
 
 /**
@@ -4627,6 +5733,10 @@ static bool pf_cmdev_verify_free_frame_id (pnet_t * net, uint16_t frame_id)
  * The controller may send 0xffff as the frame id for output CRs.
  * In that case we must supply a preferred frame id in the response.
  *
+ * The frame id is taken from the frame ID pool of the RT class, after
+ * marking the frame ids chosen by the controller for this AR as used.
+ * The pools are rebuilt when an AR is released.
+ *
  * @param net              InOut: The p-net stack instance
  * @param p_ar             InOut: The AR instance.
  */
@@ -4634,10 +5744,14 @@ static void pf_cmdev_fix_frame_id (pnet_t * net, pf_ar_t * p_ar)
 {
    uint16_t ix;
    pf_iocr_param_t * p_iocr_param;
-   uint16_t start;
-   uint16_t stop;
+   pf_frame_id_pool_t pool;
    uint16_t frame_id;
 
+   for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
+   {
+      pf_cmdev_frame_id_pool_mark (net, p_ar->iocrs[ix].param.frame_id);
+   }
+
    for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
    {
       p_iocr_param = &p_ar->iocrs[ix].param;
@@ -4648,36 +5762,24 @@ static void pf_cmdev_fix_frame_id (pnet_t * net, pf_ar_t * p_ar)
          switch (p_iocr_param->iocr_properties.rt_class)
          {
          case PF_RT_CLASS_1:
-            start = 0xC000;
-            stop = 0xF7FF;
+         case PF_RT_CLASS_UDP:
+            pool = PF_FRAME_ID_POOL_RT_CLASS_1;
             break;
          case PF_RT_CLASS_2:
-            start = 0x8000;
-            stop = 0xBBFF;
+            pool = PF_FRAME_ID_POOL_RT_CLASS_2;
             break;
          case PF_RT_CLASS_3:
-            start = 0x0100;
-            stop = 0x7FFF;
-            break;
-         case PF_RT_CLASS_UDP:
-            start = 0xC000;
-            stop = 0xF7FF;
+            pool = PF_FRAME_ID_POOL_RT_CLASS_3;
             break;
          default:
-            start = 0xFFFF;
-            stop = 0xFFFF;
+            pool = PF_FRAME_ID_POOL_NUMBER_OF_POOLS;
             LOG_ERROR (PNET_LOG, "CMDEV(%d): Invalid rt_class\n", __LINE__);
             break;
          }
 
-         frame_id = start;
-         while ((frame_id <= stop) &&
-                (pf_cmdev_verify_free_frame_id (net, frame_id) == false))
-         {
-            frame_id++;
-         }
-
-         if (frame_id <= stop)
+         if (
+            (pool < PF_FRAME_ID_POOL_NUMBER_OF_POOLS) &&
+            (pf_cmdev_frame_id_pool_allocate (net, pool, &frame_id) == 0))
          {
             p_iocr_param->frame_id = frame_id;
             LOG_DEBUG (
@@ -4815,6 +5917,588 @@ static void pf_cmdev_reset_observers (pnet_t * net)
    pf_pdport_reset_all (net);
 }
 
+/**
+ * @internal
+ * Update a digest with a value.
+ *
+ * This is 64-bit FNV-1a, but taking a whole value per step and folding the
+ * high half of the digest into the low half after each multiplication.
+ *
+ * @param digest           In:    Digest so far.
+ * @param value            In:    Value to add.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update (uint64_t digest, uint32_t value)
+{
+   digest ^= value;
+   digest *= 0x00000100000001B3ULL; /* FNV prime */
+   digest ^= digest >> 32;
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Update a digest with a byte array.
+ *
+ * @param digest           In:    Digest so far.
+ * @param p_data           In:    Bytes to add.
+ * @param len              In:    Number of bytes.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update_bytes (
+   uint64_t digest,
+   const uint8_t * p_data,
+   size_t len)
+{
+   size_t ix;
+
+   for (ix = 0; ix < len; ix++)
+   {
+      digest = pf_cmdev_digest_update (digest, p_data[ix]);
+   }
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Update a digest with a UUID.
+ *
+ * @param digest           In:    Digest so far.
+ * @param p_uuid           In:    UUID to add.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update_uuid (
+   uint64_t digest,
+   const pf_uuid_t * p_uuid)
+{
+   digest = pf_cmdev_digest_update (digest, p_uuid->data1);
+   digest = pf_cmdev_digest_update (digest, p_uuid->data2);
+   digest = pf_cmdev_digest_update (digest, p_uuid->data3);
+   return pf_cmdev_digest_update_bytes (
+      digest,
+      p_uuid->data4,
+      sizeof (p_uuid->data4));
+}
+
+/**
+ * @internal
+ * Update a digest with the IO data or IOCS frame descriptors of an API.
+ *
+ * @param digest           In:    Digest so far.
+ * @param p_desc           In:    Frame descriptors.
+ * @param nbr_desc         In:    Number of frame descriptors.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update_frame_desc (
+   uint64_t digest,
+   const pf_frame_descriptor_t * p_desc,
+   uint16_t nbr_desc)
+{
+   uint16_t ix;
+
+   digest = pf_cmdev_digest_update (digest, nbr_desc);
+   for (ix = 0; ix < nbr_desc; ix++)
+   {
+      digest = pf_cmdev_digest_update (digest, p_desc[ix].slot_number);
+      digest = pf_cmdev_digest_update (digest, p_desc[ix].subslot_number);
+      digest = pf_cmdev_digest_update (digest, p_desc[ix].frame_offset);
+   }
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Update a digest with the request part of an IOCR.
+ *
+ * @param digest           In:    Digest so far.
+ * @param p_param          In:    IOCR parameters, as parsed.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update_iocr_param (
+   uint64_t digest,
+   const pf_iocr_param_t * p_param)
+{
+   const pf_api_entry_t * p_api;
+   uint16_t a;
+
+   digest = pf_cmdev_digest_update (digest, p_param->iocr_type);
+   digest = pf_cmdev_digest_update (digest, p_param->iocr_reference);
+   digest = pf_cmdev_digest_update (digest, p_param->lt_field);
+   digest =
+      pf_cmdev_digest_update (digest, p_param->iocr_properties.rt_class);
+   digest =
+      pf_cmdev_digest_update (digest, p_param->iocr_properties.reserved_1);
+   digest =
+      pf_cmdev_digest_update (digest, p_param->iocr_properties.reserved_2);
+   digest =
+      pf_cmdev_digest_update (digest, p_param->iocr_properties.reserved_3);
+   digest = pf_cmdev_digest_update (digest, p_param->c_sdu_length);
+   digest = pf_cmdev_digest_update (digest, p_param->frame_id);
+   digest = pf_cmdev_digest_update (digest, p_param->send_clock_factor);
+   digest = pf_cmdev_digest_update (digest, p_param->reduction_ratio);
+   digest = pf_cmdev_digest_update (digest, p_param->phase);
+   digest = pf_cmdev_digest_update (digest, p_param->sequence);
+   digest = pf_cmdev_digest_update (digest, p_param->frame_send_offset);
+   digest = pf_cmdev_digest_update (digest, p_param->watchdog_factor);
+   digest = pf_cmdev_digest_update (digest, p_param->data_hold_factor);
+   digest =
+      pf_cmdev_digest_update (digest, p_param->iocr_tag_header.vlan_id);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_param->iocr_tag_header.iocr_user_priority);
+   digest = pf_cmdev_digest_update_bytes (
+      digest,
+      p_param->iocr_multicast_mac_add.addr,
+      sizeof (p_param->iocr_multicast_mac_add.addr));
+
+   digest = pf_cmdev_digest_update (digest, p_param->nbr_apis);
+   for (a = 0; a < p_param->nbr_apis; a++)
+   {
+      p_api = &p_param->apis[a];
+      digest = pf_cmdev_digest_update (digest, p_api->api);
+      digest = pf_cmdev_digest_update_frame_desc (
+         digest,
+         p_api->io_data,
+         p_api->nbr_io_data);
+      digest = pf_cmdev_digest_update_frame_desc (
+         digest,
+         p_api->iocs,
+         p_api->nbr_iocs);
+   }
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Update a digest with an expected submodule.
+ *
+ * The submodule state is left out, as it is an output of the module diff.
+ *
+ * @param digest           In:    Digest so far.
+ * @param p_sub            In:    Expected submodule, as parsed.
+ * @return the updated digest.
+ */
+static uint64_t pf_cmdev_digest_update_exp_submodule (
+   uint64_t digest,
+   const pf_exp_submodule_t * p_sub)
+{
+   const pf_data_descriptor_t * p_desc;
+   uint16_t ix;
+
+   digest = pf_cmdev_digest_update (digest, p_sub->subslot_number);
+   digest = pf_cmdev_digest_update (digest, p_sub->ident_number);
+   digest = pf_cmdev_digest_update (digest, p_sub->properties.type);
+   digest = pf_cmdev_digest_update (digest, p_sub->properties.sharedInput);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_sub->properties.reduce_input_submodule_data_length);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_sub->properties.reduce_output_submodule_data_length);
+   digest = pf_cmdev_digest_update (digest, p_sub->properties.discard_ioxs);
+
+   digest = pf_cmdev_digest_update (digest, p_sub->nbr_data_descriptors);
+   for (ix = 0; (ix < p_sub->nbr_data_descriptors) &&
+                (ix < NELEMENTS (p_sub->data_descriptor));
+        ix++)
+   {
+      p_desc = &p_sub->data_descriptor[ix];
+      digest = pf_cmdev_digest_update (digest, p_desc->data_direction);
+      digest = pf_cmdev_digest_update (digest, p_desc->submodule_data_length);
+      digest = pf_cmdev_digest_update (digest, p_desc->length_iops);
+      digest = pf_cmdev_digest_update (digest, p_desc->length_iocs);
+   }
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Calculate a digest of the parts of a connect request that decide the
+ * outcome of the connect checks and of the module diff.
+ *
+ * Each field is added by value, so padding and unused array elements do
+ * not take part. The AR UUID, the session key and the alarm reference
+ * change on every connect and are left out. So are the valid flags, which
+ * are set by the checks.
+ *
+ * @param p_ar             In:    The AR instance, as parsed.
+ * @return the digest.
+ */
+static uint64_t pf_cmdev_connect_digest (const pf_ar_t * p_ar)
+{
+   uint64_t digest = 0xCBF29CE484222325ULL; /* FNV offset basis */
+   const pf_ar_param_t * p_ar_param = &p_ar->ar_param;
+   const pf_ar_properties_t * p_ar_prop = &p_ar->ar_param.ar_properties;
+   const pf_alarm_cr_request_t * p_alarm_cr = &p_ar->alarm_cr_request;
+   const pf_exp_api_t * p_exp_api;
+   const pf_exp_module_t * p_exp_mod;
+   uint16_t ix;
+   uint16_t a;
+   uint16_t m;
+
+   digest = pf_cmdev_digest_update (digest, p_ar_param->ar_type);
+   digest = pf_cmdev_digest_update_bytes (
+      digest,
+      p_ar_param->cm_initiator_mac_add.addr,
+      sizeof (p_ar_param->cm_initiator_mac_add.addr));
+   digest = pf_cmdev_digest_update_uuid (
+      digest,
+      &p_ar_param->cm_initiator_object_uuid);
+   digest = pf_cmdev_digest_update (digest, p_ar_prop->state);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_ar_prop->supervisor_takeover_allowed);
+   digest =
+      pf_cmdev_digest_update (digest, p_ar_prop->parameterization_server);
+   digest = pf_cmdev_digest_update (digest, p_ar_prop->device_access);
+   digest = pf_cmdev_digest_update (digest, p_ar_prop->companion_ar);
+   digest =
+      pf_cmdev_digest_update (digest, p_ar_prop->acknowledge_companion_ar);
+   digest =
+      pf_cmdev_digest_update (digest, p_ar_prop->combined_object_container);
+   digest = pf_cmdev_digest_update (digest, p_ar_prop->startup_mode);
+   digest =
+      pf_cmdev_digest_update (digest, p_ar_prop->pull_module_alarm_allowed);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_ar_param->cm_initiator_activity_timeout_factor);
+   digest =
+      pf_cmdev_digest_update (digest, p_ar_param->cm_initiator_udp_rt_port);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_ar_param->cm_initiator_station_name_len);
+   if (
+      p_ar_param->cm_initiator_station_name_len <
+      sizeof (p_ar_param->cm_initiator_station_name))
+   {
+      digest = pf_cmdev_digest_update_bytes (
+         digest,
+         (const uint8_t *)p_ar_param->cm_initiator_station_name,
+         p_ar_param->cm_initiator_station_name_len);
+   }
+
+   digest = pf_cmdev_digest_update (digest, p_alarm_cr->alarm_cr_type);
+   digest = pf_cmdev_digest_update (digest, p_alarm_cr->lt_field);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_properties.priority);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_properties.transport_udp);
+   digest = pf_cmdev_digest_update (digest, p_alarm_cr->rta_timeout_factor);
+   digest = pf_cmdev_digest_update (digest, p_alarm_cr->rta_retries);
+   digest =
+      pf_cmdev_digest_update (digest, p_alarm_cr->max_alarm_data_length);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_tag_header_high.vlan_id);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_tag_header_high.alarm_user_priority);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_tag_header_low.vlan_id);
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_alarm_cr->alarm_cr_tag_header_low.alarm_user_priority);
+
+   digest = pf_cmdev_digest_update (
+      digest,
+      p_ar->ar_rpc_request.initiator_rpc_server_port);
+
+   digest = pf_cmdev_digest_update (digest, p_ar->nbr_iocrs);
+   for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
+   {
+      digest =
+         pf_cmdev_digest_update_iocr_param (digest, &p_ar->iocrs[ix].param);
+   }
+
+   digest = pf_cmdev_digest_update (digest, p_ar->exp_ident.nbr_apis);
+   for (a = 0; a < p_ar->exp_ident.nbr_apis; a++)
+   {
+      p_exp_api = &p_ar->exp_ident.api[a];
+      digest = pf_cmdev_digest_update (digest, p_exp_api->api);
+      digest = pf_cmdev_digest_update (digest, p_exp_api->nbr_modules);
+      for (m = 0; m < p_exp_api->nbr_modules; m++)
+      {
+         p_exp_mod = &p_exp_api->module[m];
+         digest = pf_cmdev_digest_update (digest, p_exp_mod->slot_number);
+         digest = pf_cmdev_digest_update (digest, p_exp_mod->ident_number);
+         digest = pf_cmdev_digest_update (digest, p_exp_mod->properties);
+         digest = pf_cmdev_digest_update (digest, p_exp_mod->nbr_submodules);
+         for (ix = 0; ix < p_exp_mod->nbr_submodules; ix++)
+         {
+            digest = pf_cmdev_digest_update_exp_submodule (
+               digest,
+               &p_exp_mod->submodule[ix]);
+         }
+      }
+   }
+
+   digest = pf_cmdev_digest_update (digest, p_ar->nbr_ar_param);
+   digest = pf_cmdev_digest_update (digest, p_ar->nbr_alarm_cr);
+   digest = pf_cmdev_digest_update (digest, p_ar->nbr_rpc_server);
+   digest = pf_cmdev_digest_update (digest, p_ar->input_cr_cnt);
+   digest = pf_cmdev_digest_update (digest, p_ar->output_cr_cnt);
+   digest = pf_cmdev_digest_update (digest, p_ar->mcr_cons_cnt);
+   digest = pf_cmdev_digest_update (digest, p_ar->rtc3_present);
+   digest = pf_cmdev_digest_update (digest, p_ar->ir_info.valid);
+#if PNET_OPTION_MC_CR
+   digest = pf_cmdev_digest_update (digest, p_ar->nbr_mcr);
+#endif
+
+   return digest;
+}
+
+/**
+ * @internal
+ * Find the cached connect request of a controller.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_mac            In:    MAC address of the controller.
+ * @return the cache entry, or NULL if the controller has none.
+ */
+static pf_cmdev_connect_cache_t * pf_cmdev_connect_cache_find (
+   pnet_t * net,
+   const pnet_ethaddr_t * p_mac)
+{
+   pf_cmdev_connect_cache_t * p_entry;
+   uint16_t ix;
+
+   for (ix = 0; ix < NELEMENTS (net->cmdev_device.connect_cache); ix++)
+   {
+      p_entry = &net->cmdev_device.connect_cache[ix];
+      if (
+         (p_entry->valid == true) &&
+         (memcmp (
+             p_entry->cm_initiator_mac_add.addr,
+             p_mac->addr,
+             sizeof (p_mac->addr)) == 0))
+      {
+         return p_entry;
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * @internal
+ * Reuse the outcome of an identical, previously accepted connect request.
+ *
+ * This replaces the APDU check and the module diff when the same controller
+ * sends the same request again and the real identification has not changed
+ * since. The expected submodules must all be plugged with the expected
+ * ident numbers, be free and have no diagnosis, as they were when the
+ * request was stored. Otherwise the full path must be taken.
+ *
+ * The IOCR parameter checks also depend on the device configuration, so
+ * they are run again. If they fail, the full path reports the error.
+ *
+ * On success the AR takes ownership of its submodules and the IOCR data
+ * descriptors and the (empty) module diff are set up.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             InOut: The AR instance.
+ * @param digest           In:    Digest of the connect request.
+ * @param p_stat           Out:   Detailed error information.
+ * @return  0  if the cached outcome was used.
+ *          -1 if the request must be checked.
+ */
+static int pf_cmdev_connect_cache_reuse (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   uint64_t digest,
+   pnet_result_t * p_stat)
+{
+   const pf_cmdev_connect_cache_t * p_entry;
+   pf_subslot_t * subslots[PNET_MAX_API * PNET_MAX_SLOTS * PNET_MAX_SUBSLOTS];
+   uint16_t nbr_subslots = 0;
+   pf_exp_api_t * p_exp_api;
+   pf_exp_module_t * p_exp_mod;
+   pf_exp_submodule_t * p_exp_sub;
+   pf_api_t * p_api;
+   pf_slot_t * p_slot;
+   pf_subslot_t * p_subslot;
+   pf_iocr_t * p_iocr;
+   uint16_t a;
+   uint16_t m;
+   uint16_t s;
+   uint16_t ix;
+
+   p_entry =
+      pf_cmdev_connect_cache_find (net, &p_ar->ar_param.cm_initiator_mac_add);
+   if (
+      (p_entry == NULL) || (p_entry->digest != digest) ||
+      (p_entry->real_ident_version != net->cmdev_device.real_ident_version) ||
+      (p_entry->nbr_iocrs != p_ar->nbr_iocrs) ||
+      (pf_cmdev_check_zero (
+          (uint8_t *)&p_ar->ar_param.ar_uuid,
+          sizeof (p_ar->ar_param.ar_uuid)) == 0))
+   {
+      return -1;
+   }
+
+   if (pf_cmdev_check_iocr_param (net, p_ar, p_stat) != 0)
+   {
+      return -1;
+   }
+
+   /* Ownership and diagnosis are not part of the real identification */
+   for (a = 0; a < p_ar->exp_ident.nbr_apis; a++)
+   {
+      p_exp_api = &p_ar->exp_ident.api[a];
+      if (pf_cmdev_get_api (net, p_exp_api->api, &p_api) != 0)
+      {
+         return -1;
+      }
+      for (m = 0; m < p_exp_api->nbr_modules; m++)
+      {
+         p_exp_mod = &p_exp_api->module[m];
+         if (
+            (pf_cmdev_get_slot (p_api, p_exp_mod->slot_number, &p_slot) != 0) ||
+            (p_slot->ident_number != p_exp_mod->ident_number))
+         {
+            return -1;
+         }
+         for (s = 0; s < p_exp_mod->nbr_submodules; s++)
+         {
+            p_exp_sub = &p_exp_mod->submodule[s];
+            if (
+               (pf_cmdev_get_subslot (
+                   p_slot,
+                   p_exp_sub->subslot_number,
+                   &p_subslot) != 0) ||
+               (p_subslot->ident_number != p_exp_sub->ident_number) ||
+               (p_subslot->ownsm_state != PF_OWNSM_STATE_FREE) ||
+               p_subslot->diag_summary.fault ||
+               p_subslot->diag_summary.maintenance_demanded ||
+               p_subslot->diag_summary.maintenance_required ||
+               (nbr_subslots >= NELEMENTS (subslots)))
+            {
+               return -1;
+            }
+            subslots[nbr_subslots++] = p_subslot;
+         }
+      }
+   }
+
+   /* The request is known to be good. Apply it. */
+   for (ix = 0; ix < nbr_subslots; ix++)
+   {
+      subslots[ix]->ownsm_state = PF_OWNSM_STATE_IOC;
+      subslots[ix]->owner = p_ar;
+   }
+
+   p_ar->exp_ident.nbr_diff_apis = 0;
+   for (a = 0; a < p_ar->exp_ident.nbr_apis; a++)
+   {
+      p_exp_api = &p_ar->exp_ident.api[a];
+      p_exp_api->valid = true;
+      p_exp_api->nbr_diff_modules = 0;
+      for (m = 0; m < p_exp_api->nbr_modules; m++)
+      {
+         p_exp_mod = &p_exp_api->module[m];
+         p_exp_mod->state = PF_MODULE_STATE_PROPER_MODULE;
+         p_exp_mod->nbr_diff_submodules = 0;
+         for (s = 0; s < p_exp_mod->nbr_submodules; s++)
+         {
+            p_exp_sub = &p_exp_mod->submodule[s];
+            memset (&p_exp_sub->state, 0, sizeof (p_exp_sub->state));
+            p_exp_sub->state.format_indicator = true;
+            p_exp_sub->state.ident_info = PF_IDENT_INFO_OK;
+            p_exp_sub->state.ar_info = PF_AR_INFO_OWN;
+         }
+      }
+   }
+
+   for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
+   {
+      p_iocr = &p_ar->iocrs[ix];
+      p_iocr->p_ar = p_ar;
+      p_iocr->crep = ix;
+      p_iocr->in_length = p_entry->iocrs[ix].in_length;
+      p_iocr->out_length = p_entry->iocrs[ix].out_length;
+      p_iocr->nbr_data_desc = p_entry->iocrs[ix].nbr_data_desc;
+      memcpy (
+         p_iocr->data_desc,
+         p_entry->iocrs[ix].data_desc,
+         p_iocr->nbr_data_desc * sizeof (p_iocr->data_desc[0]));
+      p_iocr->param.valid = true;
+   }
+
+   p_ar->ar_param.valid = true;
+   p_ar->alarm_cr_request.valid = (p_ar->nbr_alarm_cr > 0);
+   p_ar->ar_rpc_request.valid = (p_ar->nbr_rpc_server > 0);
+   net->cmdev_device.connect_cache_hits++;
+
+   return 0;
+}
+
+/**
+ * @internal
+ * Remember an accepted connect request, for pf_cmdev_connect_cache_reuse().
+ *
+ * Requests with a non-empty module diff are not stored, nor are requests
+ * during which the real identification was changed.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             In:    The AR instance.
+ * @param digest           In:    Digest of the connect request.
+ * @param real_ident_version In: Version of the real identification when
+ *                                the request was received.
+ */
+static void pf_cmdev_connect_cache_store (
+   pnet_t * net,
+   const pf_ar_t * p_ar,
+   uint64_t digest,
+   uint32_t real_ident_version)
+{
+   pf_cmdev_connect_cache_t * p_entry;
+   const pf_iocr_t * p_iocr;
+   uint16_t ix;
+
+   if (
+      (p_ar->exp_ident.nbr_diff_apis != 0) ||
+      (real_ident_version != net->cmdev_device.real_ident_version))
+   {
+      return;
+   }
+
+   p_entry =
+      pf_cmdev_connect_cache_find (net, &p_ar->ar_param.cm_initiator_mac_add);
+   if (p_entry == NULL)
+   {
+      p_entry = &net->cmdev_device
+                    .connect_cache[net->cmdev_device.connect_cache_next];
+      net->cmdev_device.connect_cache_next =
+         (net->cmdev_device.connect_cache_next + 1) %
+         NELEMENTS (net->cmdev_device.connect_cache);
+   }
+
+   p_entry->valid = true;
+   p_entry->cm_initiator_mac_add = p_ar->ar_param.cm_initiator_mac_add;
+   p_entry->digest = digest;
+   p_entry->real_ident_version = real_ident_version;
+   p_entry->nbr_iocrs = p_ar->nbr_iocrs;
+   for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
+   {
+      p_iocr = &p_ar->iocrs[ix];
+      p_entry->iocrs[ix].in_length = p_iocr->in_length;
+      p_entry->iocrs[ix].out_length = p_iocr->out_length;
+      p_entry->iocrs[ix].nbr_data_desc = p_iocr->nbr_data_desc;
+      memcpy (
+         p_entry->iocrs[ix].data_desc,
+         p_iocr->data_desc,
+         p_iocr->nbr_data_desc * sizeof (p_iocr->data_desc[0]));
+   }
+}
+
 /* ================================================
  *       Remote primitives
  */
@@ -4828,15 +6512,23 @@ int pf_cmdev_rm_connect_ind (
    uint16_t ix;
    char station_name[PNET_STATION_NAME_MAX_SIZE]; /** Terminated */
    const pnet_ethaddr_t * mac_address = pf_cmina_get_device_macaddr (net);
+   uint64_t digest = pf_cmdev_connect_digest (p_ar);
+   uint32_t real_ident_version = net->cmdev_device.real_ident_version;
+   bool reused;
 
    /* RM_Connect.ind */
-   if (pf_cmdev_check_apdu (net, p_ar, p_connect_result) == 0)
+   reused =
+      (pf_cmdev_connect_cache_reuse (net, p_ar, digest, p_connect_result) ==
+       0);
+   if (reused || (pf_cmdev_check_apdu (net, p_ar, p_connect_result) == 0))
    {
       pf_cmdev_reset_observers (net);
       pf_pdport_ar_connect_ind (net, p_ar);
 
-      if (pf_cmdev_generate_module_diff (net, p_ar) == 0)
+      if (reused || (pf_cmdev_generate_module_diff (net, p_ar) == 0))
       {
+         pf_cmdev_startup_phase_reached (p_ar, PNET_AR_STARTUP_CONNECT_CHECKED);
+
          /* Start building the response to the connect request. */
          memcpy (
             p_ar->ar_result.cm_responder_mac_add.addr,
@@ -4872,11 +6564,19 @@ int pf_cmdev_rm_connect_ind (
          p_ar->ready_4_data = false;
 
          ret = pf_fspm_cm_connect_ind (net, p_ar, p_connect_result);
+         pf_cmdev_startup_phase_reached (
+            p_ar,
+            PNET_AR_STARTUP_CONNECT_IND_DONE);
       }
    }
 
    if (ret == 0)
    {
+      if (reused == false)
+      {
+         pf_cmdev_connect_cache_store (net, p_ar, digest, real_ident_version);
+      }
+
       pf_cmdev_set_state (net, p_ar, PF_CMDEV_STATE_W_CRES);
 
       ret = pf_cmdev_cm_connect_rsp_pos (net, p_ar, p_connect_result);
@@ -4954,6 +6654,9 @@ int pf_cmdev_rm_dcontrol_ind (
       case PF_CMDEV_STATE_W_PEIND:
          if (p_control_io->control_command == BIT (PF_CONTROL_COMMAND_BIT_PRM_END))
          {
+            pf_cmdev_startup_phase_reached (
+               p_ar,
+               PNET_AR_STARTUP_PRMEND_RECEIVED);
             pf_cmdev_set_state (net, p_ar, PF_CMDEV_STATE_W_PERES);
             if (
                pf_fspm_cm_dcontrol_ind (
@@ -5044,6 +6747,9 @@ int pf_cmdev_rm_ccontrol_cnf (
              * PN-AL-protocol (Mar20) Figure A.7
              */
             pf_alarm_enable (p_ar);
+            pf_cmdev_startup_phase_reached (
+               p_ar,
+               PNET_AR_STARTUP_CCONTROL_CONFIRMED);
 
             if (p_ar->ready_4_data == true)
             {
@@ -5104,6 +6810,10 @@ int pf_cmdev_cm_ccontrol_req (pnet_t * net, pf_ar_t * p_ar)
       switch (p_ar->cmdev_state)
       {
       case PF_CMDEV_STATE_W_ARDY:
+         pf_cmdev_startup_phase_reached (
+            p_ar,
+            PNET_AR_STARTUP_APPLICATION_READY);
+
          /* Verify that appl has created input data for all PPM */
          for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
          {
@@ -5183,6 +6893,9 @@ int pf_cmdev_cm_ccontrol_req (pnet_t * net, pf_ar_t * p_ar)
             pf_cmdev_state_ind (net, p_ar, PNET_EVENT_APPLRDY);
             if (pf_cmrpc_rm_ccontrol_req (net, p_ar, PF_BT_APPRDY_REQ) == 0)
             {
+               pf_cmdev_startup_phase_reached (
+                  p_ar,
+                  PNET_AR_STARTUP_CCONTROL_SENT);
                ret = pf_cmdev_set_state (net, p_ar, PF_CMDEV_STATE_W_ARDYCNF);
             }
          }
@@ -65,6 +65,14 @@ void pf_cmdev_init (pnet_t * net);
  */
 void pf_cmdev_exit (pnet_t * net);
 
+/**
+ * Rebuild the frame ID pools from the frame IDs of all ARs in use.
+ *
+ * Called when an AR is released, to make its frame IDs available.
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_cmdev_update_frame_id_pool (pnet_t * net);
+
 /**
  * Traverse the device tree.
  * @param net              InOut: The p-net stack instance
@@ -152,6 +160,23 @@ int pf_cmdev_pull_submodule (
  */
 int pf_cmdev_pull_module (pnet_t * net, uint32_t api_id, uint16_t slot_nbr);
 
+/**
+ * Apply a list of module and sub-module plug and pull changes.
+ * The changes must be sorted by API and slot number.
+ * All changes are checked before any of them is applied. Pulls are applied
+ * before plugs. Pulling a module sends one pull module alarm per owning AR
+ * that allows it.
+ * @param net              InOut: The p-net stack instance
+ * @param p_changes        In:    The configuration changes.
+ * @param nbr_changes      In:    Number of configuration changes.
+ * @return  0  if operation succeeded.
+ *          -1 if an error occurred.
+ */
+int pf_cmdev_apply_config_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes);
+
 /**
  * Abort request from the application or from RPC.
  * @param net              InOut: The p-net stack instance
@@ -179,6 +204,58 @@ int pf_cmdev_get_device (pnet_t * net, pf_device_t ** pp_device);
  */
 int pf_cmdev_get_api (pnet_t * net, uint32_t api_id, pf_api_t ** pp_api);
 
+/**
+ * Find a number in a sorted lookup index.
+ *
+ * Used for finding slots and subslots by number, with binary search.
+ * @param p_numbers        In:    Sorted numbers.
+ * @param count            In:    Number of entries in p_numbers.
+ * @param number           In:    The number to search for.
+ * @param p_ix             Out:   Index of the number if found, otherwise
+ *                                the index where it should be inserted.
+ * @return  0  if the number was found.
+ *          -1 if the number was not found.
+ */
+int pf_cmdev_index_find (
+   const uint16_t * p_numbers,
+   uint16_t count,
+   uint16_t number,
+   uint16_t * p_ix);
+
+/**
+ * Insert a number into a sorted lookup index.
+ * @param p_numbers        InOut: Sorted numbers.
+ * @param p_positions      InOut: Array positions, in the same order.
+ * @param p_count          InOut: Number of entries in the index.
+ * @param max_count        In:    Size of the p_numbers and p_positions arrays.
+ * @param number           In:    The number to insert.
+ * @param position         In:    The array position for the number.
+ * @return  0  if operation succeeded.
+ *          -1 if the number already exists or the index is full.
+ */
+int pf_cmdev_index_insert (
+   uint16_t * p_numbers,
+   uint16_t * p_positions,
+   uint16_t * p_count,
+   uint16_t max_count,
+   uint16_t number,
+   uint16_t position);
+
+/**
+ * Remove a number from a sorted lookup index.
+ * @param p_numbers        InOut: Sorted numbers.
+ * @param p_positions      InOut: Array positions, in the same order.
+ * @param p_count          InOut: Number of entries in the index.
+ * @param number           In:    The number to remove.
+ * @return  0  if operation succeeded.
+ *          -1 if the number was not found.
+ */
+int pf_cmdev_index_remove (
+   uint16_t * p_numbers,
+   uint16_t * p_positions,
+   uint16_t * p_count,
+   uint16_t number);
+
 /**
  * Get a slot instance of an API instance by slot number.
  * @param p_api            In:  The API instance.
@@ -403,6 +480,35 @@ const char * pf_cmdev_submod_dir_to_string (pnet_submodule_dir_t direction);
  */
 const char * pf_cmdev_event_to_string (pnet_event_values_t event);
 
+/**
+ * Record that an AR has reached a startup phase.
+ *
+ * The current time is stored in the startup timeline of the AR.
+ * @param p_ar             InOut: The AR instance.
+ * @param phase            In:    The startup phase.
+ */
+void pf_cmdev_startup_phase_reached (
+   pf_ar_t * p_ar,
+   pnet_ar_startup_phase_t phase);
+
+/**
+ * Read the startup timeline of an AR.
+ * @param p_ar             In:    The AR instance.
+ * @param p_timeline       Out:   Startup timeline.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+int pf_cmdev_get_startup_timeline (
+   const pf_ar_t * p_ar,
+   pnet_ar_startup_timeline_t * p_timeline);
+
+/**
+ * Return a string representation of the specified AR startup phase.
+ * @param phase            In:    The startup phase.
+ * @return  A string representation of the startup phase.
+ */
+const char * pf_cmdev_startup_phase_to_string (pnet_ar_startup_phase_t phase);
+
 /**
  * Show CMDEV information of the AR.
  * @param p_ar             In:    The AR instance.
@@ -570,6 +676,15 @@ int pf_cmdev_check_no_straddle (
 
 int pf_cmdev_check_ar_type (uint16_t ar_type);
 
+/* Largest C_SDU length of any RT class */
+#define PF_CMDEV_MAX_C_SDU_LENGTH 1440
+
+int pf_cmdev_check_iocr_data_desc (
+   const pf_iodata_object_t * p_data_desc,
+   uint16_t nbr_data_desc,
+   uint16_t c_sdu_length,
+   pnet_result_t * p_stat);
+
 #ifdef __cplusplus
 }
 #endif
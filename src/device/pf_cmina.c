@@ -80,6 +80,24 @@ static void pf_cmina_send_hello (pnet_t * net, void * arg, uint32_t current_time
    }
 }
 
+/**
+ * @internal
+ * Invalidate cached frames and published data containing values from
+ * the DCP ASE.
+ *
+ * Should be called when the station name or IP suite might have changed.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+static void pf_cmina_invalidate_cached_data (pnet_t * net)
+{
+   pf_dcp_identify_cache_invalidate (net);
+   pf_lldp_invalidate_tx_frames (net);
+#if PNET_OPTION_SNMP
+   pf_snmp_invalidate_snapshot (net);
+#endif
+}
+
 void pf_cmina_save_ase (pnet_t * net, pf_cmina_dcp_ase_t * p_ase)
 {
    pf_cmina_dcp_ase_t ase_nvm;
@@ -106,6 +124,7 @@ void pf_cmina_save_ase (pnet_t * net, pf_cmina_dcp_ase_t * p_ase)
       gateway_string);
 
    res = pf_file_save_if_modified (
+      net,
       p_file_directory,
       PF_FILENAME_IP,
       p_ase,
@@ -201,6 +220,7 @@ int pf_cmina_set_default_cfg (pnet_t * net, uint16_t reset_mode)
          /* Read from file (nvm) */
          if (
             pf_file_load (
+               net,
                p_file_directory,
                PF_FILENAME_IP,
                &file_ase,
@@ -289,6 +309,11 @@ int pf_cmina_set_default_cfg (pnet_t * net, uint16_t reset_mode)
          /* Reset I&M data */
          (void)pf_fspm_clear_im_data (net);
 
+#if PNET_OPTION_FAST_STARTUP
+         /* The application parameters are no longer known */
+         pf_fsu_reset (net);
+#endif
+
 #if PNET_OPTION_SNMP
          /* According to section 8.4 "Behavior to ResetToFactory" in
           * "Test case specification: Behavior" the MIB data should be reset
@@ -327,11 +352,13 @@ int pf_cmina_set_default_cfg (pnet_t * net, uint16_t reset_mode)
             net->cmina_nonvolatile_dcp_ase.station_name,
             true);
 
-         pf_file_clear (p_file_directory, PF_FILENAME_IP);
-         pf_file_clear (p_file_directory, PF_FILENAME_DIAGNOSTICS);
+         pf_file_transaction_begin (net);
+         pf_file_clear (net, p_file_directory, PF_FILENAME_IP);
+         pf_file_clear (net, p_file_directory, PF_FILENAME_DIAGNOSTICS);
 #if PNET_OPTION_SNMP
          pf_snmp_data_clear (net);
 #endif
+         (void)pf_file_transaction_commit (net);
          pf_pdport_reset_all (net);
       }
 
@@ -367,6 +394,7 @@ int pf_cmina_set_default_cfg (pnet_t * net, uint16_t reset_mode)
 
       /* Init the current communication values */
       net->cmina_current_dcp_ase = net->cmina_nonvolatile_dcp_ase;
+      pf_cmina_invalidate_cached_data (net);
 
       ret = 0;
    }
@@ -382,6 +410,8 @@ void pf_cmina_dcp_set_commit (pnet_t * net)
    char gateway_string[PNAL_INET_ADDRSTR_SIZE] = {0}; /** Terminated string */
    bool permanent = true;
 
+   pf_cmina_invalidate_cached_data (net);
+
    if (net->cmina_commit_ip_suite == false)
    {
       LOG_INFO (
@@ -1092,6 +1122,9 @@ int pf_cmina_dcp_set_ind (
       net->cmina_state = PF_CMINA_STATE_W_CONNECT;
    }
 
+   /* Station name or IP suite might have been changed */
+   pf_cmina_invalidate_cached_data (net);
+
    if (reset_to_factory == true)
    {
       /* Handle reset to factory here */
@@ -1280,17 +1313,21 @@ const pnet_ethaddr_t * pf_cmina_get_device_macaddr (const pnet_t * net)
 
 /************************* Utilities ******************************************/
 
-int pf_cmina_remove_all_data_files (const char * file_directory)
+int pf_cmina_remove_all_data_files (pnet_t * net, const char * file_directory)
 {
-   pf_file_clear (file_directory, PF_FILENAME_IM);
-   pf_file_clear (file_directory, PF_FILENAME_IP);
-   pf_file_clear (file_directory, PF_FILENAME_DIAGNOSTICS);
+   pf_file_transaction_begin (net);
+   pf_file_clear (net, file_directory, PF_FILENAME_IM);
+   pf_file_clear (net, file_directory, PF_FILENAME_IP);
+   pf_file_clear (net, file_directory, PF_FILENAME_DIAGNOSTICS);
+#if PNET_OPTION_FAST_STARTUP
+   pf_fsu_remove_data_files (net, file_directory);
+#endif
 #if PNET_OPTION_SNMP
-   pf_snmp_remove_data_files (file_directory);
+   pf_snmp_remove_data_files (net, file_directory);
 #endif
-   pf_pdport_remove_data_files (file_directory);
+   pf_pdport_remove_data_files (net, file_directory);
 
-   return 0;
+   return pf_file_transaction_commit (net);
 }
 
 bool pf_cmina_has_timed_out (
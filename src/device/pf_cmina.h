@@ -36,11 +36,13 @@ int pf_cmina_init (pnet_t * net);
 /**
  * Remove the stack's data files.
  *
+ * @param net              InOut: The p-net stack instance. NULL if called
+ *                                without a running stack instance.
  * @param file_directory   In:    File directory
  * @return  0  if the operation succeeded.
  *          -1 if an error occurred.
  */
-int pf_cmina_remove_all_data_files (const char * file_directory);
+int pf_cmina_remove_all_data_files (pnet_t * net, const char * file_directory);
 
 /**
  * Show port statistics
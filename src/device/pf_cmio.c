@@ -33,6 +33,8 @@
 
 #include "pf_includes.h"
 
+#include <string.h>
+
 #define PF_CMIO_TIMER_PERIOD (100 * 1000) /* us */
 
 /*************** Diagnostic strings *****************************************/
@@ -379,3 +381,49 @@ int pf_cmio_cpm_new_data_ind (pf_ar_t * p_ar, uint16_t crep, bool new_data)
 
    return ret;
 }
+
+int pf_cmio_get_iocr_statistics (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   pnet_ar_iocr_statistics_t * p_statistics)
+{
+   int ret = 0;
+   uint16_t ix;
+   pf_iocr_t * p_iocr;
+   pnet_iocr_statistics_t * p_out;
+
+   memset (p_statistics, 0, sizeof (*p_statistics));
+   p_statistics->nbr_iocrs = p_ar->nbr_iocrs;
+   if (p_statistics->nbr_iocrs > NELEMENTS (p_statistics->iocr))
+   {
+      p_statistics->nbr_iocrs = NELEMENTS (p_statistics->iocr);
+   }
+   for (ix = 0; ix < p_statistics->nbr_iocrs; ix++)
+   {
+      p_iocr = &p_ar->iocrs[ix];
+      p_out = &p_statistics->iocr[ix];
+
+      p_out->frame_id = p_iocr->param.frame_id;
+      p_out->provider =
+         (p_iocr->param.iocr_type == PF_IOCR_TYPE_INPUT) ||
+         (p_iocr->param.iocr_type == PF_IOCR_TYPE_MC_PROVIDER);
+      if (p_out->provider)
+      {
+         p_out->control_interval_us = p_iocr->ppm.control_interval;
+         if (pf_ppm_get_statistics (net, &p_iocr->ppm, &p_out->ppm) != 0)
+         {
+            ret = -1;
+         }
+      }
+      else
+      {
+         p_out->control_interval_us = p_iocr->cpm.control_interval;
+         if (pf_cpm_get_statistics (net, &p_iocr->cpm, &p_out->cpm) != 0)
+         {
+            ret = -1;
+         }
+      }
+   }
+
+   return ret;
+}
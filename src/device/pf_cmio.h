@@ -66,6 +66,22 @@ int pf_cmio_cpm_state_ind (
  */
 int pf_cmio_cpm_new_data_ind (pf_ar_t * p_ar, uint16_t crep, bool new_data);
 
+/**
+ * Read cyclic data statistics for all IOCRs of an AR.
+ *
+ * Does not block the cyclic data exchange. May be called from any thread,
+ * as long as the AR is not released meanwhile.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             InOut: The AR instance.
+ * @param p_statistics     Out:   The IOCR statistics.
+ * @return  0  if the operation succeeded.
+ *          -1 if the statistics of an IOCR were continuously being written.
+ */
+int pf_cmio_get_iocr_statistics (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   pnet_ar_iocr_statistics_t * p_statistics);
+
 #ifdef __cplusplus
 }
 #endif
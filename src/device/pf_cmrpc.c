@@ -761,6 +761,8 @@ static void pf_ar_release (pnet_t * net, pf_ar_t * p_ar)
 
    if (p_ar != NULL)
    {
+      /* pnet_get_iocr_statistics() may read the AR from another thread */
+      os_mutex_lock (net->p_cmrpc_rpc_mutex);
       if (p_ar->in_use == true)
       {
          if (p_ar->arep > 0)
@@ -789,11 +791,13 @@ static void pf_ar_release (pnet_t * net, pf_ar_t * p_ar)
          }
          memset (p_ar, 0, sizeof (*p_ar));
          p_ar->in_use = false;
+         pf_cmdev_update_frame_id_pool (net);
       }
       else
       {
          LOG_ERROR (PNET_LOG, "CMRPC(%d): AR already released\n", __LINE__);
       }
+      os_mutex_unlock (net->p_cmrpc_rpc_mutex);
    }
    else
    {
@@ -1638,6 +1642,71 @@ static int pf_cmrpc_rm_connect_interpret_ind (
             }
             break;
 #endif
+#if PNET_OPTION_FAST_STARTUP
+         case PF_BT_AR_FSU_BLOCK_REQ:
+            pf_get_ar_fsu_request (
+               &p_sess->get_info,
+               p_pos,
+               block_header.block_length,
+               p_ar);
+
+            if (p_ar->ar_param.ar_properties.device_access == true)
+            {
+               pf_set_error (
+                  &p_sess->rpc_result,
+                  PNET_ERROR_CODE_CONNECT,
+                  PNET_ERROR_DECODE_PNIO,
+                  PNET_ERROR_CODE_1_CMRPC,
+                  PNET_ERROR_CODE_2_CMRPC_UNKNOWN_BLOCKS);
+               ret = -1;
+            }
+            else if (p_sess->get_info.result != PF_PARSE_OK)
+            {
+               /* Faulty sub-block length */
+               pf_set_error (
+                  &p_sess->rpc_result,
+                  PNET_ERROR_CODE_CONNECT,
+                  PNET_ERROR_DECODE_PNIO,
+                  PNET_ERROR_CODE_1_CONN_FAULTY_AR_FSU,
+                  PNET_ERROR_CODE_2_INVALID_BLOCK_LEN);
+               ret = -1;
+            }
+            else if (
+               (p_ar->fast_startup_data.fs_parameter_block.fs_parameter_mode !=
+                PF_FS_PARAMETER_MODE_ON) &&
+               (p_ar->fast_startup_data.fs_parameter_block.fs_parameter_mode !=
+                PF_FS_PARAMETER_MODE_OFF))
+            {
+               /* Missing FSParameterBlock or reserved FSParameterMode */
+               pf_set_error (
+                  &p_sess->rpc_result,
+                  PNET_ERROR_CODE_CONNECT,
+                  PNET_ERROR_DECODE_PNIO,
+                  PNET_ERROR_CODE_1_CONN_FAULTY_AR_FSU,
+                  PNET_ERROR_CODE_2_AR_FSU_FS_PARAMETER_MODE);
+               ret = -1;
+            }
+            else
+            {
+               ret = pf_check_block_header (
+                  (*p_pos - data_pos) + 2,
+                  &block_header,
+                  PNET_ERROR_CODE_1_CONN_FAULTY_AR_FSU,
+                  &p_sess->rpc_result);
+               if (ret == 0)
+               {
+                  LOG_DEBUG (
+                     PF_RPC_LOG,
+                     "CMRPC(%d): Fast startup. FSParameterMode: %s\n",
+                     __LINE__,
+                     (p_ar->fast_startup_data.fs_parameter_block
+                         .fs_parameter_mode == PF_FS_PARAMETER_MODE_ON)
+                        ? "ON"
+                        : "OFF");
+               }
+            }
+            break;
+#endif
 #if PNET_OPTION_IR
          case PF_BT_IR_INFO_BLOCK_REQ:
             pf_get_ir_info_request (&p_sess->get_info, p_pos, p_ar);
@@ -1996,9 +2065,12 @@ static int pf_cmrpc_rm_connect_ind (
    /* CheckResource */
    else if (pf_ar_allocate (net, &p_ar) == 0)
    {
+      pf_cmdev_startup_phase_reached (p_ar, PNET_AR_STARTUP_CONNECT_RECEIVED);
+
       /* Parse the Connect request - No support for ArSet (yet) */
       if (pf_cmrpc_rm_connect_interpret_ind (p_sess, &req_pos, p_ar) == 0)
       {
+         pf_cmdev_startup_phase_reached (p_ar, PNET_AR_STARTUP_CONNECT_PARSED);
          if (pf_ar_find_by_uuid (net, &p_ar->ar_param.ar_uuid, &p_ar_2) == 0)
          {
             p_sess->kill_session = true;
@@ -2104,6 +2176,7 @@ static int pf_cmrpc_rm_connect_ind (
    }
    else
    {
+      pf_cmdev_startup_phase_reached (p_ar, PNET_AR_STARTUP_CONNECT_RESPONSE);
       pf_pdport_lldp_restart_transmission (net);
    }
 
@@ -4772,6 +4845,9 @@ static int pf_cmrpc_dce_packet (
 
             if (set_state_paramend && p_sess->p_ar != NULL)
             {
+               pf_cmdev_startup_phase_reached (
+                  p_sess->p_ar,
+                  PNET_AR_STARTUP_PRMEND_RESPONSE);
                pf_cmdev_state_ind (net, p_sess->p_ar, PNET_EVENT_PRMEND);
             }
             break;
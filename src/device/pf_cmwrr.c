@@ -161,7 +161,7 @@ int pf_cmwrr_cmdev_state_ind (
  * Triggers the \a pnet_write_ind() user callback for some values.
  *
  * @param net              InOut: The p-net stack instance
- * @param p_ar             In:    The AR instance.
+ * @param p_ar             InOut: The AR instance.
  * @param p_write_request  In:    The IODWrite request.
  * @param p_req_buf        In:    The request buffer.
  * @param data_length      In:    Size of the data to write.
@@ -172,7 +172,7 @@ int pf_cmwrr_cmdev_state_ind (
  */
 static int pf_cmwrr_write (
    pnet_t * net,
-   const pf_ar_t * p_ar,
+   pf_ar_t * p_ar,
    const pf_iod_write_request_t * p_write_request,
    const uint8_t * p_req_buf,
    uint16_t data_length,
@@ -230,6 +230,13 @@ static int pf_cmwrr_write (
       p_result->pnio_status.error_code_1 = PNET_ERROR_CODE_1_ACC_ACCESS_DENIED;
       p_result->pnio_status.error_code_2 = 0;
    }
+#if PNET_OPTION_FAST_STARTUP
+   else if (pf_fsu_skip_write (net, p_ar, subslot, p_write_request))
+   {
+      /* Unchanged parameters, already known by the application */
+      ret = 0;
+   }
+#endif
    else if (p_write_request->index <= PF_IDX_USER_MAX)
    {
       /* User defined indexes */
@@ -195,6 +195,191 @@ void pf_fspm_option_show (const pnet_t * net)
       (uint32_t)sizeof (pnet_t));
 }
 
+/**
+ * @internal
+ * Get a string describing an initialization phase.
+ *
+ * @param phase            In:    The phase.
+ * @return  A string describing the phase.
+ */
+static const char * pf_fspm_init_phase_to_string (pnet_init_phase_t phase)
+{
+   const char * s = "<error>";
+
+   switch (phase)
+   {
+   case PNET_INIT_PHASE_FSPM:
+      s = "FSPM (configuration, I&M)";
+      break;
+   case PNET_INIT_PHASE_RT:
+      s = "Scheduler, CPM, PPM, alarms";
+      break;
+   case PNET_INIT_PHASE_ETH:
+      s = "Network interfaces";
+      break;
+   case PNET_INIT_PHASE_CMINA:
+      s = "CMINA (IP and name)";
+      break;
+   case PNET_INIT_PHASE_DCP:
+      s = "DCP, ports, LLDP";
+      break;
+   case PNET_INIT_PHASE_PDPORT:
+      s = "PDPort data";
+      break;
+   case PNET_INIT_PHASE_SNMP:
+      s = "SNMP";
+      break;
+   case PNET_INIT_PHASE_CMDEV:
+      s = "CMDEV, FSU, CMRPC";
+      break;
+   case PNET_INIT_PHASE_NUMBER_OF_PHASES:
+      break;
+   }
+
+   return s;
+}
+
+void pf_fspm_init_profile_start (pnet_t * net, bool deferred)
+{
+   memset (&net->fspm_init_profile, 0, sizeof (net->fspm_init_profile));
+   net->fspm_init_profile.deferred = deferred;
+   net->fspm_init_start_us = os_get_current_time_us();
+   net->fspm_init_phase_start_us = net->fspm_init_start_us;
+}
+
+void pf_fspm_init_phase_start (pnet_t * net)
+{
+   net->fspm_init_phase_start_us = os_get_current_time_us();
+}
+
+void pf_fspm_init_phase_done (pnet_t * net, pnet_init_phase_t phase)
+{
+   uint32_t now = os_get_current_time_us();
+
+   if (phase < PNET_INIT_PHASE_NUMBER_OF_PHASES)
+   {
+      net->fspm_init_profile.phase_us[phase] +=
+         now - net->fspm_init_phase_start_us;
+   }
+   net->fspm_init_phase_start_us = now;
+}
+
+/**
+ * @internal
+ * Log the time spent in each initialization phase.
+ *
+ * @param net              In:    The p-net stack instance
+ */
+static void pf_fspm_init_profile_log (const pnet_t * net)
+{
+   const pnet_init_profile_t * p_profile = &net->fspm_init_profile;
+   uint16_t ix;
+
+   for (ix = 0; ix < PNET_INIT_PHASE_NUMBER_OF_PHASES; ix++)
+   {
+      LOG_DEBUG (
+         PNET_LOG,
+         "FSPM(%d): Init phase %-28s %8" PRIu32 " us\n",
+         __LINE__,
+         pf_fspm_init_phase_to_string ((pnet_init_phase_t)ix),
+         p_profile->phase_us[ix]);
+   }
+}
+
+void pf_fspm_init_profile_done (pnet_t * net)
+{
+   net->fspm_init_profile.total_us =
+      os_get_current_time_us() - net->fspm_init_start_us;
+
+   LOG_INFO (
+      PNET_LOG,
+      "FSPM(%d): Initialization took %" PRIu32 " us.%s\n",
+      __LINE__,
+      net->fspm_init_profile.total_us,
+      net->fspm_init_profile.deferred ? " Non-critical parts deferred." : "");
+   pf_fspm_init_profile_log (net);
+}
+
+void pf_fspm_init_deferred_done (pnet_t * net)
+{
+   net->fspm_init_profile.deferred_done = true;
+   net->fspm_init_profile.deferred_done_us =
+      os_get_current_time_us() - net->fspm_init_start_us;
+
+   LOG_INFO (
+      PNET_LOG,
+      "FSPM(%d): Deferred initialization done %" PRIu32
+      " us after start of init.\n",
+      __LINE__,
+      net->fspm_init_profile.deferred_done_us);
+   pf_fspm_init_profile_log (net);
+}
+
+void pf_fspm_init_dcp_ready (pnet_t * net)
+{
+   if (net->fspm_init_profile.dcp_ready == false)
+   {
+      net->fspm_init_profile.dcp_ready = true;
+      net->fspm_init_profile.dcp_ready_us =
+         os_get_current_time_us() - net->fspm_init_start_us;
+
+      LOG_INFO (
+         PNET_LOG,
+         "FSPM(%d): Ready for DCP %" PRIu32 " us after start of init.\n",
+         __LINE__,
+         net->fspm_init_profile.dcp_ready_us);
+   }
+}
+
+bool pf_fspm_init_deferred_pending (const pnet_t * net)
+{
+   return (net->fspm_init_profile.deferred == true) &&
+          (net->fspm_init_profile.deferred_done == false);
+}
+
+int pf_fspm_get_init_profile (
+   const pnet_t * net,
+   pnet_init_profile_t * p_profile)
+{
+   if (p_profile == NULL)
+   {
+      return -1;
+   }
+
+   *p_profile = net->fspm_init_profile;
+
+   return 0;
+}
+
+void pf_fspm_init_profile_show (const pnet_t * net)
+{
+   const pnet_init_profile_t * p_profile = &net->fspm_init_profile;
+   uint16_t ix;
+
+   printf ("Init profile:\n");
+   for (ix = 0; ix < PNET_INIT_PHASE_NUMBER_OF_PHASES; ix++)
+   {
+      printf (
+         "%-32s : %" PRIu32 " us\n",
+         pf_fspm_init_phase_to_string ((pnet_init_phase_t)ix),
+         p_profile->phase_us[ix]);
+   }
+   printf ("%-32s : %" PRIu32 " us\n", "Total", p_profile->total_us);
+   printf (
+      "%-32s : %s %" PRIu32 " us after start\n",
+      "DCP ready",
+      p_profile->dcp_ready ? "yes" : "no",
+      p_profile->dcp_ready_us);
+   if (p_profile->deferred)
+   {
+      printf (
+         "%-32s : %s %" PRIu32 " us after start\n",
+         "Deferred init",
+         p_profile->deferred_done ? "done" : "pending",
+         p_profile->deferred_done_us);
+   }
+}
+
 /**
  * @internal
  * Validate the configuration from the user.
@@ -296,6 +481,7 @@ static void pf_fspm_load_im (pnet_t * net)
 
    if (
       pf_file_load (
+         net,
          p_file_directory,
          PF_FILENAME_IM,
          &file_im,
@@ -337,6 +523,7 @@ void pf_fspm_save_im (pnet_t * net)
    os_mutex_unlock (net->fspm_im_mutex);
 
    res = pf_file_save_if_modified (
+      net,
       p_file_directory,
       PF_FILENAME_IM,
       &output_im,
@@ -407,6 +407,87 @@ void pf_fspm_option_show (const pnet_t * net);
  */
 void pf_fspm_logbook_show (const pnet_t * net);
 
+/**
+ * Start measuring the time spent in pnet_init().
+ *
+ * Clears the init profile, so call it after the stack instance is cleared.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param deferred         In:    true if non-critical initialization is
+ *                                deferred to pnet_handle_periodic().
+ */
+void pf_fspm_init_profile_start (pnet_t * net, bool deferred);
+
+/**
+ * Start measuring an initialization phase.
+ *
+ * Only needed when work is done outside pnet_init(), as each
+ * pf_fspm_init_phase_done() also starts the next phase.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fspm_init_phase_start (pnet_t * net);
+
+/**
+ * Add the time since the phase started to an initialization phase, and
+ * start the next phase.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param phase            In:    The phase that is done.
+ */
+void pf_fspm_init_phase_done (pnet_t * net, pnet_init_phase_t phase);
+
+/**
+ * Stop measuring the time spent in pnet_init(), and log the profile.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fspm_init_profile_done (pnet_t * net);
+
+/**
+ * Note that the deferred initialization is done, and log the profile.
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fspm_init_deferred_done (pnet_t * net);
+
+/**
+ * Note that the device can answer DCP requests, if not already done.
+ *
+ * Call after the scheduler has run in pnet_handle_periodic().
+ *
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fspm_init_dcp_ready (pnet_t * net);
+
+/**
+ * Check if there is deferred initialization left to do.
+ *
+ * @param net              In:    The p-net stack instance
+ * @return  true  if the deferred initialization should be done.
+ *          false otherwise.
+ */
+bool pf_fspm_init_deferred_pending (const pnet_t * net);
+
+/**
+ * Read the time spent in the phases of pnet_init().
+ *
+ * @param net              In:    The p-net stack instance
+ * @param p_profile        Out:   Initialization profile.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+int pf_fspm_get_init_profile (
+   const pnet_t * net,
+   pnet_init_profile_t * p_profile);
+
+/**
+ * Show the time spent in the phases of pnet_init().
+ *
+ * @param net              In:    The p-net stack instance
+ */
+void pf_fspm_init_profile_show (const pnet_t * net);
+
 /************ Internal functions, made available for unit testing ************/
 
 int pf_fspm_validate_configuration (const pnet_cfg_t * p_cfg);
@@ -0,0 +1,537 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2018 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+/**
+ * @file
+ * @brief Fast startup (FSU) handling
+ *
+ * The controller sends an ARFSUBlockReq in the connect request, holding an
+ * FSParameterUUID that identifies the parameter set of the device.
+ *
+ * When an AR with FSParameterMode ON reaches the DATA state, the submodules
+ * owned by the AR are marked as parameterized with its UUID. Pulling a
+ * submodule clears the mark, as does an AR without fast startup.
+ *
+ * The UUID and the marks are stored in nvm, as a tool (for example at a
+ * tool changer) is typically power cycled between its ARs. A mark holds
+ * the API, slot and subslot together with the module and submodule ident
+ * numbers. As the application plugs its submodules after a restart, each
+ * stored mark is revalidated against the plugged submodule. Marks are
+ * dropped when the ident numbers differ, or when the submodule is pulled.
+ *
+ * When a later AR sends the same UUID, writes of user specific records to
+ * marked submodules are answered directly by the stack during startup,
+ * without calling the application. This is opt-in by the
+ * fsu_skip_unchanged_parameters configuration, as the application must keep
+ * its parameters between ARs.
+ */
+
+#ifdef UNIT_TEST
+#define pf_bg_worker_start_job mock_pf_bg_worker_start_job
+#endif
+
+#include "pf_includes.h"
+
+#include <string.h>
+
+#if PNET_OPTION_FAST_STARTUP
+
+/**
+ * @internal
+ * Check if a UUID is nil (all zeroes).
+ * @param p_uuid           In:    The UUID.
+ * @return  true if the UUID is nil.
+ */
+static bool pf_fsu_is_nil_uuid (const pf_uuid_t * p_uuid)
+{
+   const pf_uuid_t nil_uuid = {0};
+
+   return memcmp (p_uuid, &nil_uuid, sizeof (nil_uuid)) == 0;
+}
+
+/**
+ * @internal
+ * Check if an AR uses fast startup parameterization.
+ * @param p_ar             In:    The AR instance.
+ * @return  true if the AR has FSParameterMode ON and a FSParameterUUID.
+ */
+static bool pf_fsu_is_active (const pf_ar_t * p_ar)
+{
+   return (p_ar->fast_startup_data.valid == true) &&
+          (p_ar->fast_startup_data.fs_parameter_block.fs_parameter_mode ==
+           PF_FS_PARAMETER_MODE_ON) &&
+          !pf_fsu_is_nil_uuid (
+             &p_ar->fast_startup_data.fs_parameter_block.fs_parameter_uuid);
+}
+
+/**
+ * @internal
+ * Find the stored mark of a submodule.
+ * @param net              InOut: The p-net stack instance
+ * @param api_id           In:    API identifier.
+ * @param slot_nbr         In:    Slot number.
+ * @param subslot_nbr      In:    Subslot number.
+ * @return  the mark, or NULL if the submodule is not marked.
+ */
+static pf_fsu_mark_t * pf_fsu_find_mark (
+   pnet_t * net,
+   uint32_t api_id,
+   uint16_t slot_nbr,
+   uint16_t subslot_nbr)
+{
+   pf_fsu_nvm_t * p_nvm = &net->fsu_nonvolatile;
+   uint16_t ix;
+
+   for (ix = 0; ix < p_nvm->nbr_marks; ix++)
+   {
+      if (
+         (p_nvm->marks[ix].api_id == api_id) &&
+         (p_nvm->marks[ix].slot_nbr == slot_nbr) &&
+         (p_nvm->marks[ix].subslot_nbr == subslot_nbr))
+      {
+         return &p_nvm->marks[ix];
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * @internal
+ * Remove a stored mark.
+ *
+ * The last mark is moved into its place, and the freed entry is cleared so
+ * that the stored data does not depend on earlier contents.
+ * @param net              InOut: The p-net stack instance
+ * @param p_mark           InOut: The mark to remove.
+ */
+static void pf_fsu_remove_mark (pnet_t * net, pf_fsu_mark_t * p_mark)
+{
+   pf_fsu_nvm_t * p_nvm = &net->fsu_nonvolatile;
+   pf_fsu_mark_t * p_last = &p_nvm->marks[p_nvm->nbr_marks - 1];
+
+   *p_mark = *p_last;
+   memset (p_last, 0, sizeof (*p_last));
+   p_nvm->nbr_marks--;
+}
+
+/**
+ * @internal
+ * Set the parameterized mark of a submodule.
+ *
+ * Updates both the plugged submodule and the stored marks.
+ * Must be called with the FSU mutex locked.
+ * @param net              InOut: The p-net stack instance
+ * @param p_api            In:    The API of the submodule.
+ * @param p_slot           In:    The slot of the submodule.
+ * @param p_subslot        InOut: The plugged submodule.
+ * @param parameterized    In:    New value of the mark.
+ * @return  true if the stored marks were changed.
+ */
+static bool pf_fsu_set_mark (
+   pnet_t * net,
+   const pf_api_t * p_api,
+   const pf_slot_t * p_slot,
+   pf_subslot_t * p_subslot,
+   bool parameterized)
+{
+   pf_fsu_nvm_t * p_nvm = &net->fsu_nonvolatile;
+   pf_fsu_mark_t * p_mark = pf_fsu_find_mark (
+      net,
+      p_api->api_id,
+      p_slot->slot_number,
+      p_subslot->subslot_number);
+
+   p_subslot->fsu_parameterized = parameterized;
+
+   if (parameterized == false)
+   {
+      if (p_mark == NULL)
+      {
+         return false;
+      }
+      pf_fsu_remove_mark (net, p_mark);
+      return true;
+   }
+
+   if (p_mark == NULL)
+   {
+      CC_ASSERT (p_nvm->nbr_marks < NELEMENTS (p_nvm->marks));
+      p_mark = &p_nvm->marks[p_nvm->nbr_marks++];
+      p_mark->api_id = p_api->api_id;
+      p_mark->slot_nbr = p_slot->slot_number;
+      p_mark->subslot_nbr = p_subslot->subslot_number;
+   }
+   else if (
+      (p_mark->module_ident == p_slot->ident_number) &&
+      (p_mark->submodule_ident == p_subslot->ident_number))
+   {
+      return false;
+   }
+   p_mark->module_ident = p_slot->ident_number;
+   p_mark->submodule_ident = p_subslot->ident_number;
+
+   return true;
+}
+
+/**
+ * @internal
+ * Set the parameterized mark of submodules.
+ *
+ * Must be called with the FSU mutex locked.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             In:    Only submodules owned by this AR.
+ *                                Use NULL for all submodules.
+ * @param parameterized    In:    New value of the mark.
+ * @return  true if the stored marks were changed.
+ */
+static bool pf_fsu_mark_subslots (
+   pnet_t * net,
+   const pf_ar_t * p_ar,
+   bool parameterized)
+{
+   pf_api_t * p_api;
+   pf_slot_t * p_slot;
+   pf_subslot_t * p_subslot;
+   uint16_t api_ix;
+   uint16_t slot_ix;
+   uint16_t subslot_ix;
+   bool changed = false;
+
+   for (api_ix = 0; api_ix < PNET_MAX_API; api_ix++)
+   {
+      p_api = &net->cmdev_device.real_ident.api[api_ix];
+      for (slot_ix = 0; (p_api->in_use == true) && (slot_ix < PNET_MAX_SLOTS);
+           slot_ix++)
+      {
+         p_slot = &p_api->slots[slot_ix];
+         for (subslot_ix = 0;
+              (p_slot->in_use == true) && (subslot_ix < PNET_MAX_SUBSLOTS);
+              subslot_ix++)
+         {
+            p_subslot = &p_slot->subslots[subslot_ix];
+            if (
+               (p_subslot->in_use == true) &&
+               ((p_ar == NULL) || (p_subslot->owner == p_ar)))
+            {
+               if (pf_fsu_set_mark (
+                      net,
+                      p_api,
+                      p_slot,
+                      p_subslot,
+                      parameterized))
+               {
+                  changed = true;
+               }
+            }
+         }
+      }
+   }
+
+   return changed;
+}
+
+/**
+ * @internal
+ * Request the fast startup data to be saved to nvm.
+ *
+ * The saving is done by the background worker, see pf_fsu_save().
+ * @param net              InOut: The p-net stack instance
+ */
+static void pf_fsu_request_save (pnet_t * net)
+{
+   if (pf_bg_worker_start_job (net, PF_BGJOB_SAVE_FSU_NVM_DATA) != 0)
+   {
+      LOG_ERROR (
+         PNET_LOG,
+         "FSU(%d): Could not request saving of fast startup data.\n",
+         __LINE__);
+   }
+}
+
+void pf_fsu_init (pnet_t * net)
+{
+   const char * p_file_directory = pf_cmina_get_file_directory (net);
+   pf_fsu_nvm_t * p_nvm = &net->fsu_nonvolatile;
+
+   if (net->fsu_mutex == NULL)
+   {
+      net->fsu_mutex = os_mutex_create();
+      CC_ASSERT (net->fsu_mutex != NULL);
+   }
+
+   if (
+      (pf_file_load (
+          net,
+          p_file_directory,
+          PF_FILENAME_FSU,
+          p_nvm,
+          sizeof (*p_nvm)) == 0) &&
+      (p_nvm->nbr_marks <= NELEMENTS (p_nvm->marks)))
+   {
+      LOG_DEBUG (
+         PNET_LOG,
+         "FSU(%d): Did read fast startup data from nvm. %u marked "
+         "submodules.\n",
+         __LINE__,
+         p_nvm->nbr_marks);
+   }
+   else
+   {
+      memset (p_nvm, 0, sizeof (*p_nvm));
+   }
+}
+
+void pf_fsu_save (pnet_t * net)
+{
+   pf_fsu_nvm_t output_nvm;
+   pf_fsu_nvm_t temporary_buffer;
+   const char * p_file_directory = pf_cmina_get_file_directory (net);
+   int res;
+
+   os_mutex_lock (net->fsu_mutex);
+   output_nvm = net->fsu_nonvolatile;
+   os_mutex_unlock (net->fsu_mutex);
+
+   res = pf_file_save_if_modified (
+      net,
+      p_file_directory,
+      PF_FILENAME_FSU,
+      &output_nvm,
+      &temporary_buffer,
+      sizeof (output_nvm));
+   switch (res)
+   {
+   case 2:
+      LOG_INFO (
+         PNET_LOG,
+         "FSU(%d): First nvm saving of fast startup data.\n",
+         __LINE__);
+      break;
+   case 1:
+      LOG_INFO (
+         PNET_LOG,
+         "FSU(%d): Updating nvm stored fast startup data.\n",
+         __LINE__);
+      break;
+   case 0:
+      LOG_DEBUG (
+         PNET_LOG,
+         "FSU(%d): No storing of nvm fast startup data (no changes).\n",
+         __LINE__);
+      break;
+   default:
+   case -1:
+      LOG_ERROR (
+         PNET_LOG,
+         "FSU(%d): Failed to store nvm fast startup data.\n",
+         __LINE__);
+      break;
+   }
+}
+
+void pf_fsu_plug_submodule_ind (
+   pnet_t * net,
+   const pf_api_t * p_api,
+   const pf_slot_t * p_slot,
+   pf_subslot_t * p_subslot)
+{
+   pf_fsu_mark_t * p_mark = NULL;
+   bool changed = false;
+
+   os_mutex_lock (net->fsu_mutex);
+   p_mark = pf_fsu_find_mark (
+      net,
+      p_api->api_id,
+      p_slot->slot_number,
+      p_subslot->subslot_number);
+   if (p_mark != NULL)
+   {
+      if (
+         (p_mark->module_ident == p_slot->ident_number) &&
+         (p_mark->submodule_ident == p_subslot->ident_number))
+      {
+         /* Same submodule as at the latest parameterization */
+         p_subslot->fsu_parameterized = true;
+      }
+      else
+      {
+         LOG_DEBUG (
+            PNET_LOG,
+            "FSU(%d): Other submodule plugged in slot %u subslot 0x%04X. "
+            "Dropping its mark.\n",
+            __LINE__,
+            p_slot->slot_number,
+            p_subslot->subslot_number);
+         pf_fsu_remove_mark (net, p_mark);
+         changed = true;
+      }
+   }
+   os_mutex_unlock (net->fsu_mutex);
+
+   if (changed)
+   {
+      pf_fsu_request_save (net);
+   }
+}
+
+void pf_fsu_pull_submodule_ind (
+   pnet_t * net,
+   uint32_t api_id,
+   uint16_t slot_nbr,
+   uint16_t subslot_nbr)
+{
+   pf_fsu_mark_t * p_mark = NULL;
+
+   os_mutex_lock (net->fsu_mutex);
+   p_mark = pf_fsu_find_mark (net, api_id, slot_nbr, subslot_nbr);
+   if (p_mark != NULL)
+   {
+      pf_fsu_remove_mark (net, p_mark);
+   }
+   os_mutex_unlock (net->fsu_mutex);
+
+   if (p_mark != NULL)
+   {
+      pf_fsu_request_save (net);
+   }
+}
+
+int pf_fsu_cmdev_state_ind (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   pnet_event_values_t event)
+{
+   const pf_uuid_t * p_uuid =
+      &p_ar->fast_startup_data.fs_parameter_block.fs_parameter_uuid;
+   pf_fsu_nvm_t * p_nvm = &net->fsu_nonvolatile;
+   bool changed = false;
+
+   if (p_ar->ar_param.ar_properties.device_access == true)
+   {
+      return 0;
+   }
+
+   switch (event)
+   {
+   case PNET_EVENT_STARTUP:
+      p_ar->fast_startup_data.nbr_skipped_writes = 0;
+      os_mutex_lock (net->fsu_mutex);
+      p_ar->fast_startup_data.parameters_unchanged =
+         pf_fsu_is_active (p_ar) &&
+         (memcmp (p_uuid, &p_nvm->fs_parameter_uuid, sizeof (*p_uuid)) == 0);
+      os_mutex_unlock (net->fsu_mutex);
+      if (p_ar->fast_startup_data.parameters_unchanged == true)
+      {
+         LOG_INFO (
+            PNET_LOG,
+            "FSU(%d): Fast startup with unchanged parameters for AREP %u\n",
+            __LINE__,
+            p_ar->arep);
+      }
+      break;
+   case PNET_EVENT_DATA:
+      os_mutex_lock (net->fsu_mutex);
+      if (pf_fsu_is_active (p_ar))
+      {
+         if (
+            memcmp (p_uuid, &p_nvm->fs_parameter_uuid, sizeof (*p_uuid)) != 0)
+         {
+            /* Other submodules were parameterized with another UUID */
+            (void)pf_fsu_mark_subslots (net, NULL, false);
+            memset (p_nvm->marks, 0, sizeof (p_nvm->marks));
+            p_nvm->nbr_marks = 0;
+            p_nvm->fs_parameter_uuid = *p_uuid;
+            changed = true;
+         }
+         if (pf_fsu_mark_subslots (net, p_ar, true))
+         {
+            changed = true;
+         }
+      }
+      else
+      {
+         /* Parameters unknown to fast startup */
+         changed = pf_fsu_mark_subslots (net, p_ar, false);
+      }
+      os_mutex_unlock (net->fsu_mutex);
+
+      if (changed)
+      {
+         pf_fsu_request_save (net);
+      }
+
+      if (p_ar->fast_startup_data.nbr_skipped_writes > 0)
+      {
+         LOG_INFO (
+            PNET_LOG,
+            "FSU(%d): Skipped %u unchanged parameter writes for AREP %u\n",
+            __LINE__,
+            p_ar->fast_startup_data.nbr_skipped_writes,
+            p_ar->arep);
+      }
+      break;
+   default:
+      break;
+   }
+
+   return 0;
+}
+
+bool pf_fsu_skip_write (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   const pf_subslot_t * p_subslot,
+   const pf_iod_write_request_t * p_write_request)
+{
+   if (
+      (net->fspm_cfg.fsu_skip_unchanged_parameters == false) ||
+      (p_ar->fast_startup_data.parameters_unchanged == false) ||
+      (p_ar->cmdev_state != PF_CMDEV_STATE_W_PEIND) ||
+      (p_write_request->index > PF_IDX_USER_MAX) || (p_subslot == NULL) ||
+      (p_subslot->fsu_parameterized == false))
+   {
+      return false;
+   }
+
+   LOG_DEBUG (
+      PNET_LOG,
+      "FSU(%d): Skipping unchanged parameter write. Slot %u subslot 0x%04X "
+      "index 0x%04X for AREP %u\n",
+      __LINE__,
+      p_write_request->slot_number,
+      p_write_request->subslot_number,
+      p_write_request->index,
+      p_ar->arep);
+   p_ar->fast_startup_data.nbr_skipped_writes++;
+
+   return true;
+}
+
+void pf_fsu_reset (pnet_t * net)
+{
+   os_mutex_lock (net->fsu_mutex);
+   (void)pf_fsu_mark_subslots (net, NULL, false);
+   memset (&net->fsu_nonvolatile, 0, sizeof (net->fsu_nonvolatile));
+   os_mutex_unlock (net->fsu_mutex);
+   pf_fsu_remove_data_files (net, pf_cmina_get_file_directory (net));
+}
+
+void pf_fsu_remove_data_files (pnet_t * net, const char * file_directory)
+{
+   pf_file_clear (net, file_directory, PF_FILENAME_FSU);
+}
+
+#endif /* PNET_OPTION_FAST_STARTUP */
@@ -0,0 +1,134 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2018 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#ifndef PF_FSU_H
+#define PF_FSU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if PNET_OPTION_FAST_STARTUP
+
+/**
+ * Initialize fast startup handling.
+ *
+ * Loads the FSParameterUUID of the latest parameterization, and the marks
+ * of the submodules parameterized with it, from nvm. The marks are
+ * revalidated as the application plugs the submodules, see
+ * pf_fsu_plug_submodule_ind().
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fsu_init (pnet_t * net);
+
+/**
+ * Save the fast startup data to nvm, if modified.
+ *
+ * Runs in the background worker, see PF_BGJOB_SAVE_FSU_NVM_DATA.
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fsu_save (pnet_t * net);
+
+/**
+ * Revalidate the stored mark of a newly plugged submodule.
+ *
+ * The submodule is marked as parameterized if it has the same module and
+ * submodule ident numbers as at the latest parameterization. Otherwise the
+ * stored mark is dropped.
+ * @param net              InOut: The p-net stack instance
+ * @param p_api            In:    The API of the submodule.
+ * @param p_slot           In:    The slot of the submodule.
+ * @param p_subslot        InOut: The plugged submodule.
+ */
+void pf_fsu_plug_submodule_ind (
+   pnet_t * net,
+   const pf_api_t * p_api,
+   const pf_slot_t * p_slot,
+   pf_subslot_t * p_subslot);
+
+/**
+ * Drop the stored mark of a pulled submodule.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param api_id           In:    API identifier.
+ * @param slot_nbr         In:    Slot number.
+ * @param subslot_nbr      In:    Subslot number.
+ */
+void pf_fsu_pull_submodule_ind (
+   pnet_t * net,
+   uint32_t api_id,
+   uint16_t slot_nbr,
+   uint16_t subslot_nbr);
+
+/**
+ * Handle incoming CMDEV events.
+ *
+ * At PNET_EVENT_STARTUP it is decided whether the parameters of the AR are
+ * unchanged since the latest parameterization.
+ * At PNET_EVENT_DATA the submodules owned by the AR are marked as
+ * parameterized (or not). The FSParameterUUID and the marks are saved to
+ * nvm by the background worker.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             InOut: The AR instance.
+ * @param event            In:    The CMDEV event.
+ * @return  0  always.
+ */
+int pf_fsu_cmdev_state_ind (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   pnet_event_values_t event);
+
+/**
+ * Check if a write of a user specific record can be skipped.
+ *
+ * This is the case during startup of an AR with an unchanged FSParameterUUID,
+ * for submodules that have not been pulled since the latest
+ * parameterization. Only enabled if fsu_skip_unchanged_parameters is set in
+ * the configuration.
+ * @param net              InOut: The p-net stack instance
+ * @param p_ar             InOut: The AR instance.
+ * @param p_subslot        In:    The subslot to write to, or NULL.
+ * @param p_write_request  In:    The IODWrite request.
+ * @return  true if the write should be skipped.
+ */
+bool pf_fsu_skip_write (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   const pf_subslot_t * p_subslot,
+   const pf_iod_write_request_t * p_write_request);
+
+/**
+ * Forget the latest parameterization, also in nvm.
+ *
+ * Used when the application parameters are reset.
+ * @param net              InOut: The p-net stack instance
+ */
+void pf_fsu_reset (pnet_t * net);
+
+/**
+ * Remove the fast startup data file.
+ *
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @param file_directory   In:    File directory
+ */
+void pf_fsu_remove_data_files (pnet_t * net, const char * file_directory);
+
+#endif /* PNET_OPTION_FAST_STARTUP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PF_FSU_H */
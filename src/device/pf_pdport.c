@@ -14,9 +14,10 @@
  ********************************************************************/
 
 #ifdef UNIT_TEST
-#define pnal_eth_get_status      mock_pnal_eth_get_status
-#define pnal_get_port_statistics mock_pnal_get_port_statistics
-#define pf_bg_worker_start_job   mock_pf_bg_worker_start_job
+#define pnal_eth_get_status        mock_pnal_eth_get_status
+#define pnal_eth_link_monitor_init mock_pnal_eth_link_monitor_init
+#define pnal_get_port_statistics   mock_pnal_get_port_statistics
+#define pf_bg_worker_start_job     mock_pf_bg_worker_start_job
 #endif
 
 #include "pf_includes.h"
@@ -84,6 +85,7 @@ static int pf_pdport_load (pnet_t * net, int loc_port_num)
 
    if (
       pf_file_load (
+         net,
          p_file_directory,
          pf_pdport_get_filename (loc_port_num),
          &pdport_config,
@@ -182,6 +184,7 @@ static int pf_pdport_save (pnet_t * net, int loc_port_num)
    os_mutex_unlock (net->pf_interface.port_mutex);
 
    save_result = pf_file_save_if_modified (
+      net,
       p_file_directory,
       pf_pdport_get_filename (loc_port_num),
       &pdport_config,
@@ -363,6 +366,7 @@ int pf_pdport_init (pnet_t * net)
 {
    int port;
    pf_port_iterator_t port_iterator;
+   bool missing = false;
 
    pf_port_init_iterator_over_ports (net, &port_iterator);
    port = pf_port_get_next (&port_iterator);
@@ -370,12 +374,17 @@ int pf_pdport_init (pnet_t * net)
    {
       if (pf_pdport_load (net, port) != 0)
       {
-         /* Create file if missing */
-         (void)pf_pdport_save (net, port);
+         missing = true;
       }
 
       port = pf_port_get_next (&port_iterator);
    }
+
+   if (missing)
+   {
+      /* Create the missing files without blocking the caller */
+      (void)pf_bg_worker_start_job (net, PF_BGJOB_SAVE_PDPORT_NVM_DATA);
+   }
    return 0;
 }
 
@@ -401,14 +410,14 @@ int pf_pdport_reset_all (pnet_t * net)
    return 0;
 }
 
-void pf_pdport_remove_data_files (const char * file_directory)
+void pf_pdport_remove_data_files (pnet_t * net, const char * file_directory)
 {
    int port;
 
-   /* Do not use port iterator as net is not available */
+   /* Do not use port iterator as net might not be available */
    for (port = PNET_PORT_1; port <= PNET_MAX_PHYSICAL_PORTS; port++)
    {
-      pf_file_clear (file_directory, pf_pdport_get_filename (port));
+      pf_file_clear (net, file_directory, pf_pdport_get_filename (port));
    }
 }
 
@@ -1091,8 +1100,46 @@ static void pf_lldp_trigger_linkmonitor (
    }
 }
 
+/**
+ * @internal
+ * Handle a link change reported by pnal.
+ *
+ * This is a callback for pnal, and is called from the pnal link monitor
+ * thread. Arguments should fulfill pnal_eth_link_callback_t
+ *
+ * Reading the link status might block, so it is done by the background
+ * worker. The stack thread reacts on the new status in pf_pdport_periodic().
+ *
+ * @param interface_name   In:    Ethernet interface name. Not used.
+ * @param arg              InOut: The p-net stack instance
+ */
+static void pf_pdport_link_change_ind (const char * interface_name, void * arg)
+{
+   pnet_t * net = (pnet_t *)arg;
+
+   (void)pf_bg_worker_start_job (net, PF_BGJOB_UPDATE_PORTS_STATUS);
+}
+
 void pf_pdport_start_linkmonitor (pnet_t * net)
 {
+   if (
+      pnal_eth_link_monitor_init (
+         &net->fspm_cfg.pnal_cfg,
+         pf_pdport_link_change_ind,
+         net) == 0)
+   {
+      LOG_INFO (
+         PNET_LOG,
+         "PDPORT(%d): Using event driven Ethernet link monitoring.\n",
+         __LINE__);
+      net->pf_interface.is_link_monitor_event_driven = true;
+
+      /* Read the initial link status */
+      (void)pf_bg_worker_start_job (net, PF_BGJOB_UPDATE_PORTS_STATUS);
+      return;
+   }
+
+   net->pf_interface.is_link_monitor_event_driven = false;
    if (
       pf_scheduler_add (
          net,
@@ -1113,6 +1160,14 @@ void pf_pdport_periodic (pnet_t * net)
    int port;
    pf_port_iterator_t port_iterator;
    pf_port_t * p_port_data = NULL;
+   uint32_t link_change_pending = net->pf_interface.link_change_pending;
+
+   if (link_change_pending != 0)
+   {
+      (void)atomic_fetch_sub (
+         &net->pf_interface.link_change_pending,
+         link_change_pending);
+   }
 
    pf_port_init_iterator_over_ports (net, &port_iterator);
    port = pf_port_get_next (&port_iterator);
@@ -1121,6 +1176,15 @@ void pf_pdport_periodic (pnet_t * net)
    {
       p_port_data = pf_port_get_state (net, port);
 
+      /* React immediately on link changes detected by the background
+       * worker, instead of waiting for the port's turn in the
+       * periodic link check.
+       */
+      if (link_change_pending != 0)
+      {
+         pf_pdport_monitor_link (net, port);
+      }
+
       if (p_port_data->pdport.lldp_peer_info_updated)
       {
          p_port_data->pdport.lldp_peer_info_updated = false;
@@ -1435,6 +1499,10 @@ void pf_pdport_peer_indication (pnet_t * net, int loc_port_num)
 {
    pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
    p_port_data->pdport.lldp_peer_info_updated = true;
+
+#if PNET_OPTION_SNMP
+   pf_snmp_invalidate_snapshot (net);
+#endif
 }
 
 void pf_pdport_update_eth_status (pnet_t * net)
@@ -1443,6 +1511,8 @@ void pf_pdport_update_eth_status (pnet_t * net)
    pf_port_iterator_t port_iterator;
    pf_port_t * p_port_data = NULL;
    pnal_eth_status_t eth_status;
+   bool is_link_changed = false;
+   bool is_status_changed = false;
 
    if (net->pf_interface.port_mutex == NULL)
    {
@@ -1466,11 +1536,40 @@ void pf_pdport_update_eth_status (pnet_t * net)
             loc_port_num);
       }
       os_mutex_lock (net->pf_interface.port_mutex);
+      if (p_port_data->eth_status.running != eth_status.running)
+      {
+         is_link_changed = true;
+      }
+      if (
+         p_port_data->eth_status.running != eth_status.running ||
+         p_port_data->eth_status.operational_mau_type !=
+            eth_status.operational_mau_type ||
+         p_port_data->eth_status.is_autonegotiation_supported !=
+            eth_status.is_autonegotiation_supported ||
+         p_port_data->eth_status.is_autonegotiation_enabled !=
+            eth_status.is_autonegotiation_enabled ||
+         p_port_data->eth_status.autonegotiation_advertised_capabilities !=
+            eth_status.autonegotiation_advertised_capabilities)
+      {
+         is_status_changed = true;
+      }
       p_port_data->eth_status = eth_status;
       os_mutex_unlock (net->pf_interface.port_mutex);
 
       loc_port_num = pf_port_get_next (&port_iterator);
    }
+
+   if (is_link_changed)
+   {
+      (void)atomic_fetch_add (&net->pf_interface.link_change_pending, 1);
+   }
+
+#if PNET_OPTION_SNMP
+   if (is_status_changed)
+   {
+      pf_snmp_invalidate_snapshot (net);
+   }
+#endif
 }
 
 /**
@@ -24,7 +24,8 @@ extern "C" {
 
 /**
  * Initialize PDPort.
- * Load PDPortport configuration from nvm.
+ * Load PDPortport configuration from nvm. Missing files are created by
+ * the background worker.
  *
  * @param net              InOut: The p-net stack instance
  * @return  0  if the operation succeeded.
@@ -46,9 +47,10 @@ int pf_pdport_reset_all (pnet_t * net);
 /**
  * Remove configuration files for all ports.
  *
- * @param  * @param file_directory   In:    File directory
+ * @param net              InOut: The p-net stack instance, or NULL
+ * @param file_directory   In:    File directory
  */
-void pf_pdport_remove_data_files (const char * file_directory);
+void pf_pdport_remove_data_files (pnet_t * net, const char * file_directory);
 
 /**
  * Notify PDPort that a new AR has been set up.
@@ -138,6 +140,9 @@ void pf_pdport_peer_indication (pnet_t * net, int loc_port_num);
 /**
  * Start Ethernet link monitoring
  *
+ * Uses link change events from pnal if supported by the platform,
+ * otherwise the link status is polled periodically.
+ *
  * @param net              InOut: The p-net stack instance
  */
 void pf_pdport_start_linkmonitor (pnet_t * net);
@@ -145,6 +150,7 @@ void pf_pdport_start_linkmonitor (pnet_t * net);
 /**
  * Run PDPort observers.
  * Run enabled checks and set diagnoses.
+ * Handle Ethernet link changes reported by the background worker.
  *
  * @param net              InOut: The p-net stack instance
  */
@@ -182,6 +188,9 @@ bool pf_pdport_is_a_fast_port_in_use (pnet_t * net);
  * This function is intended to be executed in a background task,
  * as the system calls to read the ethernet status may be blocking.
  *
+ * If the link state of any port has changed, pf_pdport_periodic()
+ * will handle the change on its next invocation.
+ *
  * @param net              InOut: The p-net stack instance
  */
 void pf_pdport_update_eth_status (pnet_t * net);
@@ -190,7 +199,7 @@ void pf_pdport_update_eth_status (pnet_t * net);
  * Get current ethernet status for local port.
  * This is a non-blocking function reading from mutex-protected memory.
  * The status values are updated by the background worker task
- * in a periodic job executing the pf_pdport_update_eth_status() function.
+ * in a job executing the pf_pdport_update_eth_status() function.
  *
  * @param net              InOut: The p-net stack instance
  * @param loc_port_num     In:    Local port number.
@@ -203,7 +212,7 @@ pnal_eth_status_t pf_pdport_get_eth_status (pnet_t * net, int loc_port_num);
  * Get current ethernet status for local port.
  * This is a non-blocking function reading from mutex-protected memory.
  * The status values are updated by the background worker task
- * in a periodic job executing the pf_pdport_update_eth_status() function.
+ * in a job executing the pf_pdport_update_eth_status() function.
  *
  * The MAU type value in the resulting \a pnal_eth_status_t struct
  * will be replaced by the default MAU type from the configuration
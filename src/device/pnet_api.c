@@ -14,8 +14,9 @@
  ********************************************************************/
 
 #ifdef UNIT_TEST
-#define pnal_snmp_init    mock_pnal_snmp_init
-#define pf_bg_worker_init mock_pf_bg_worker_init
+#define pnal_snmp_init     mock_pnal_snmp_init
+#define pf_bg_worker_init  mock_pf_bg_worker_init
+#define pf_bg_worker_flush mock_pf_bg_worker_flush
 #endif
 
 #include <inttypes.h>
@@ -37,13 +38,24 @@
 
 int pnet_init_only (pnet_t * net, const pnet_cfg_t * p_cfg)
 {
+   pf_frame_pool_t frame_pool;
+
+   /* Keep the frame buffers, if the instance is initialized again */
+   frame_pool = net->frame_pool;
    memset (net, 0, sizeof (*net));
+   net->frame_pool = frame_pool;
+
+   pf_fspm_init_profile_start (net, p_cfg->defer_noncritical_init);
+
+   pf_file_init (net);
+   pf_frame_pool_init (net);
 
    /* Initialize configuration */
    if (pf_fspm_init (net, p_cfg) != 0)
    {
       return -1;
    }
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_FSPM);
 
    net->cmdev_initialized = false; /* TODO How to handle that pf_cmdev_exit()
                                       is used before pf_cmdev_init()? */
@@ -60,6 +72,7 @@ int pnet_init_only (pnet_t * net, const pnet_cfg_t * p_cfg)
    pf_cpm_init (net);
    pf_ppm_init (net);
    pf_alarm_init (net);
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_RT);
 
    if (pf_eth_init (net, p_cfg) != 0)
    {
@@ -69,33 +82,55 @@ int pnet_init_only (pnet_t * net, const pnet_cfg_t * p_cfg)
          __LINE__);
       return -1;
    }
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_ETH);
 
    pf_bg_worker_init (net);
    pf_cmina_init (net); /* Read from permanent pool */
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_CMINA);
 
    pf_dcp_exit (net); /* Prepare for re-init. */
    pf_dcp_init (net); /* Start DCP */
    pf_port_init (net);
    pf_port_main_interface_init (net);
    pf_lldp_init (net);
-   pf_pdport_init (net);
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_DCP);
+
+   /* Port and SNMP data are not needed to answer DCP */
+   if (p_cfg->defer_noncritical_init == false)
+   {
+      pf_pdport_init (net);
+      pf_fspm_init_phase_done (net, PNET_INIT_PHASE_PDPORT);
+   }
 
    /* Configure SNMP server if enabled */
 #if PNET_OPTION_SNMP
-   pf_snmp_data_init (net);
+   if (p_cfg->defer_noncritical_init)
+   {
+      pf_snmp_init (net);
+   }
+   else
+   {
+      pf_snmp_data_init (net);
+   }
    if (pnal_snmp_init (net, &p_cfg->pnal_cfg) != 0)
    {
       LOG_ERROR (PNET_LOG, "API(%d): Failed to configure SNMP\n", __LINE__);
       return -1;
    }
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_SNMP);
 #endif
 
    pf_cmdev_exit (net); /* Prepare for re-init */
    pf_cmdev_init (net);
+#if PNET_OPTION_FAST_STARTUP
+   pf_fsu_init (net);
+#endif
 
    pf_cmrpc_init (net);
+   pf_fspm_init_phase_done (net, PNET_INIT_PHASE_CMDEV);
 
    net->timestamp_handle_periodic_us = os_get_current_time_us();
+   pf_fspm_init_profile_done (net);
 
    return 0;
 }
@@ -116,9 +151,12 @@ pnet_t * pnet_init (const pnet_cfg_t * p_cfg)
          sizeof (*net));
       return NULL;
    }
+   memset (net, 0, sizeof (*net));
 
    if (pnet_init_only (net, p_cfg) != 0)
    {
+      pf_lldp_exit (net);
+      pf_frame_pool_exit (net);
       free (net);
       return NULL;
    }
@@ -128,6 +166,7 @@ pnet_t * pnet_init (const pnet_cfg_t * p_cfg)
 
 void pnet_handle_periodic (pnet_t * net)
 {
+   bool deferred;
 #if LOG_DEBUG_ENABLED(PNET_LOG)
    uint32_t start_time_us = os_get_current_time_us();
    uint32_t end_time_us = 0;
@@ -147,14 +186,37 @@ void pnet_handle_periodic (pnet_t * net)
    }
 #endif
 
-   pf_cmrpc_periodic (net);
+   /* RPC requests may use the deferred data. They wait in the socket
+    * until the next call. */
+   deferred = pf_fspm_init_deferred_pending (net);
+   if (deferred == false)
+   {
+      pf_cmrpc_periodic (net);
+   }
    pf_alarm_periodic (net);
 
-   /* Handle expired timeout events */
+   /* Handle expired timeout events. Sends the DCP responses. */
    pf_scheduler_tick (net);
+   pf_fspm_init_dcp_ready (net);
+
+   if (deferred)
+   {
+      pf_fspm_init_phase_start (net);
+      pf_pdport_init (net);
+      pf_fspm_init_phase_done (net, PNET_INIT_PHASE_PDPORT);
+#if PNET_OPTION_SNMP
+      pf_snmp_data_load (net);
+      pf_fspm_init_phase_done (net, PNET_INIT_PHASE_SNMP);
+#endif
+      pf_fspm_init_deferred_done (net);
+   }
 
    pf_pdport_periodic (net);
 
+#if PNET_OPTION_SNMP
+   pf_snmp_periodic (net);
+#endif
+
 #if LOG_DEBUG_ENABLED(PNET_LOG)
    end_time_us = os_get_current_time_us();
    if (pf_cmina_has_timed_out (
@@ -181,6 +243,7 @@ void pnet_show (pnet_t * net, unsigned level)
       if (level & 0x0010)
       {
          pf_fspm_option_show (net);
+         pf_fspm_init_profile_show (net);
       }
 
       if (level & 0x0020)
@@ -204,11 +267,14 @@ void pnet_show (pnet_t * net, unsigned level)
       {
          printf ("\n\n");
          pf_cmina_show (net);
+         pf_dcp_show (net);
       }
       if (level & 0x4000)
       {
          printf ("\n\n");
          pf_scheduler_show (net);
+         printf ("\n\n");
+         pf_frame_pool_show (net);
       }
       if (level & 0x8000)
       {
@@ -360,6 +426,14 @@ int pnet_pull_submodule (
    return pf_cmdev_pull_submodule (net, api, slot, subslot);
 }
 
+int pnet_apply_config_changes (
+   pnet_t * net,
+   const pnet_config_change_t * p_changes,
+   uint16_t nbr_changes)
+{
+   return pf_cmdev_apply_config_changes (net, p_changes, nbr_changes);
+}
+
 int pnet_set_primary_state (pnet_t * net, bool primary)
 {
    int ret = 0; /* Assume all goes well */
@@ -526,9 +600,22 @@ int pnet_factory_reset (pnet_t * net)
    (void)pf_cmina_set_default_cfg (net, 99);
    pf_cmina_dcp_set_commit (net);
 
+   /* Do not leave the reset values waiting in a debounce window */
+   pf_bg_worker_flush (net);
+
    return 0;
 }
 
+void pnet_flush_data_files (pnet_t * net)
+{
+   LOG_DEBUG (
+      PNET_LOG,
+      "API(%d): Application saves pending data to files.\n",
+      __LINE__);
+
+   pf_bg_worker_flush (net);
+}
+
 int pnet_remove_data_files (const char * file_directory)
 {
    LOG_DEBUG (
@@ -537,7 +624,7 @@ int pnet_remove_data_files (const char * file_directory)
       __LINE__,
       file_directory);
 
-   return pf_cmina_remove_all_data_files (file_directory);
+   return pf_cmina_remove_all_data_files (NULL, file_directory);
 }
 
 int pnet_get_ar_error_codes (
@@ -614,6 +701,62 @@ int pnet_alarm_send_ack (
    return ret;
 }
 
+int pnet_get_alarm_statistics (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_alarm_statistics_t * p_statistics)
+{
+   int ret = -1;
+   pf_ar_t * p_ar = NULL;
+
+   if (pf_ar_find_by_arep (net, arep, &p_ar) == 0)
+   {
+      ret = pf_alarm_get_statistics (p_ar, p_statistics);
+   }
+
+   return ret;
+}
+
+int pnet_get_ar_startup_timeline (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_ar_startup_timeline_t * p_timeline)
+{
+   int ret = -1;
+   pf_ar_t * p_ar = NULL;
+
+   if (pf_ar_find_by_arep (net, arep, &p_ar) == 0)
+   {
+      ret = pf_cmdev_get_startup_timeline (p_ar, p_timeline);
+   }
+
+   return ret;
+}
+
+int pnet_get_init_profile (pnet_t * net, pnet_init_profile_t * p_profile)
+{
+   return pf_fspm_get_init_profile (net, p_profile);
+}
+
+int pnet_get_iocr_statistics (
+   pnet_t * net,
+   uint32_t arep,
+   pnet_ar_iocr_statistics_t * p_statistics)
+{
+   int ret = -1;
+   pf_ar_t * p_ar = NULL;
+
+   /* Keep the AR from being released while it is read */
+   os_mutex_lock (net->p_cmrpc_rpc_mutex);
+   if (pf_ar_find_by_arep (net, arep, &p_ar) == 0)
+   {
+      ret = pf_cmio_get_iocr_statistics (net, p_ar, p_statistics);
+   }
+   os_mutex_unlock (net->p_cmrpc_rpc_mutex);
+
+   return ret;
+}
+
 /************************** Low-level diagnosis functions ******************/
 
 int pnet_diag_add (
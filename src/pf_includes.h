@@ -42,6 +42,7 @@ extern "C" {
 #include "pf_dcp.h"
 #include "pf_eth.h"
 #include "pf_file.h"
+#include "pf_frame_pool.h"
 #include "pf_lldp.h"
 #include "pf_ppm.h"
 #include "pf_ppm_driver_sw.h"
@@ -65,6 +66,7 @@ extern "C" {
 #include "pf_cmwrr.h"
 #include "pf_diag.h"
 #include "pf_fspm.h"
+#include "pf_fsu.h"
 #include "pf_pdport.h"
 #include "pf_port.h"
 #include "pf_plugsm.h"
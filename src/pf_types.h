@@ -57,6 +57,26 @@ static inline uint32_t atomic_fetch_sub (atomic_int * p, uint32_t v)
 
    return prev;
 }
+#ifdef atomic_fetch_or
+#undef atomic_fetch_or
+#endif
+static inline uint32_t atomic_fetch_or (atomic_int * p, uint32_t v)
+{
+   uint32_t prev = *p;
+   *p |= v;
+
+   return prev;
+}
+#ifdef atomic_fetch_and
+#undef atomic_fetch_and
+#endif
+static inline uint32_t atomic_fetch_and (atomic_int * p, uint32_t v)
+{
+   uint32_t prev = *p;
+   *p &= v;
+
+   return prev;
+}
 #endif
 
 #define PF_RPC_SERVER_PORT             0x8894 /* PROFInet Context Manager */
@@ -68,6 +88,17 @@ static inline uint32_t atomic_fetch_sub (atomic_int * p, uint32_t v)
 
 #define PF_FRAME_BUFFER_SIZE 1500
 
+/* Number of pre-allocated frame buffers, see pf_frame_pool.c */
+#ifndef PF_FRAME_POOL_SIZE
+#define PF_FRAME_POOL_SIZE 16
+#endif
+
+/* Each word in the frame pool bitmap tracks this many buffers */
+#define PF_FRAME_POOL_BITS_PER_WORD 16
+#define PF_FRAME_POOL_WORDS                                                    \
+   ((PF_FRAME_POOL_SIZE + PF_FRAME_POOL_BITS_PER_WORD - 1) /                   \
+    PF_FRAME_POOL_BITS_PER_WORD)
+
 /** This should be smaller than PF_FRAME_BUFFER_SIZE with the maximum size of
  * IP- and UDP headers, and some margin. Linux will fragment frames if this is
  * larger than 1464. */
@@ -571,6 +602,13 @@ typedef enum pf_block_type_values
 
    PF_BT_MULTIPLEBLOCK_HEADER = 0x0400,
 
+   PF_BT_FS_HELLO = 0x0600,
+   PF_BT_FS_PARAMETER = 0x0601,
+   PF_BT_FAST_STARTUP = 0x0602,
+   /* Reserved 0x0603-0x0607 */
+   PF_BT_PDINTF_FSU_DATA_ADJUST = 0x0608,
+   PF_BT_AR_FSU_DATA_ADJUST = 0x0609,
+
    PF_BT_MAINTENANCE_ITEM = 0x0f00,
 
    /* Output from a PROFINET device */
@@ -1011,6 +1049,9 @@ typedef struct pf_alarm_data
    pnet_alarm_spec_t alarm_specifier; /* Booleans for diagnosis alarms. */
    uint16_t sequence_number;
 
+   /* When the alarm was put in the send queue. For statistics only. */
+   uint32_t timestamp_queued_us;
+
    /*
     * pf_alarm_data_t may be followed by alarm_payload:
     *    RTA-SDU = alarm_noftification_pdu | alarm_ack_pdu
@@ -1066,6 +1107,26 @@ typedef struct pf_alarm_receive_queue
 #define PF_LLDP_SEND_INTERVAL (5 * 1000) /* milliseconds */
 #define PF_LLDP_TTL           20         /* seconds */
 
+/**
+ * Rate limiting of incoming DCP IDENTIFY and GET/SET requests.
+ *
+ * Each source MAC address has a token bucket holding at most
+ * PF_DCP_RATE_LIMIT_BURST tokens, refilled with one token per
+ * PF_DCP_RATE_LIMIT_INTERVAL. Requests arriving with an empty bucket
+ * are dropped. The least recently seen source is replaced when
+ * all PF_DCP_RATE_LIMIT_SOURCES entries are in use.
+ *
+ * As a flood from rotating source MAC addresses would get a full bucket
+ * for each new address, all requests also take a token from a global
+ * bucket, holding at most PF_DCP_RATE_LIMIT_GLOBAL_BURST tokens and
+ * refilled with one token per PF_DCP_RATE_LIMIT_GLOBAL_INTERVAL.
+ */
+#define PF_DCP_RATE_LIMIT_SOURCES         8
+#define PF_DCP_RATE_LIMIT_BURST           10
+#define PF_DCP_RATE_LIMIT_INTERVAL        (100 * 1000) /* microseconds */
+#define PF_DCP_RATE_LIMIT_GLOBAL_BURST    40
+#define PF_DCP_RATE_LIMIT_GLOBAL_INTERVAL (10 * 1000) /* microseconds */
+
 typedef enum pf_cmina_state_values
 {
    PF_CMINA_STATE_SETUP,
@@ -1152,6 +1213,32 @@ typedef struct pf_eth_frame_id_map
    void * p_arg;
 } pf_eth_frame_id_map_t;
 
+/** Token bucket for DCP rate limiting */
+typedef struct pf_dcp_token_bucket
+{
+   uint16_t tokens;
+   uint32_t timestamp_refill_us;
+} pf_dcp_token_bucket_t;
+
+/** Token bucket for one remote DCP source */
+typedef struct pf_dcp_rate_limit_source
+{
+   bool in_use;
+   pnet_ethaddr_t mac_address;
+   pf_dcp_token_bucket_t bucket;
+   uint32_t timestamp_last_frame_us;
+   uint32_t dropped;
+} pf_dcp_rate_limit_source_t;
+
+typedef struct pf_dcp_statistics
+{
+   uint32_t identify_received;
+   uint32_t identify_prefiltered; /* Not for us, dropped before parsing */
+   uint32_t get_set_received;
+   uint32_t rate_limited; /* Dropped by the token bucket of the source */
+   uint32_t rate_limited_global; /* Dropped by the global token bucket */
+} pf_dcp_statistics_t;
+
 /*
  * Each struct in pf_cmina_dcp_ase_t is carefully laid out in order to use
  * strncmp/memcmp in the DCP identity request and strncpy/memcpy in the
@@ -1294,8 +1381,8 @@ typedef enum pf_rs_alarm_transport_mode_values
 
 typedef enum pf_fs_parameter_mode_values
 {
-   PF_FS_PARAMETER_MODE_ON,
-   PF_FS_PARAMETER_MODE__OFF
+   PF_FS_PARAMETER_MODE_ON = 1,
+   PF_FS_PARAMETER_MODE_OFF = 2
 } pf_fs_parameter_mode_values_t;
 
 typedef enum pf_ar_state_values
@@ -1652,7 +1739,7 @@ typedef struct pf_ar_fsu
    bool valid;
    struct
    {
-      uint32_t fs_parameter_mode; /** Range 0..1 (ON, OFF) */
+      uint32_t fs_parameter_mode; /** pf_fs_parameter_mode_values_t */
       pf_uuid_t fs_parameter_uuid;
    } fs_parameter_block;
 #if PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH
@@ -1660,8 +1747,33 @@ typedef struct pf_ar_fsu
    uint8_t manufacturer_specific_fast_startup_data
       [PNET_MAX_MAN_SPECIFIC_FAST_STARTUP_DATA_LENGTH];
 #endif
+
+   /* Run-time information, see pf_fsu.c */
+   bool parameters_unchanged; /* FSParameterUUID equals the stored one */
+   uint16_t nbr_skipped_writes;
 } pf_ar_fsu_t;
 
+/* Submodule parameterized with the stored FSParameterUUID, see pf_fsu.c */
+typedef struct pf_fsu_mark
+{
+   uint32_t api_id;
+   uint16_t slot_nbr;
+   uint16_t subslot_nbr;
+   uint32_t module_ident;
+   uint32_t submodule_ident;
+} pf_fsu_mark_t;
+
+#define PF_FSU_MAX_MARKS (PNET_MAX_API * PNET_MAX_SLOTS * PNET_MAX_SUBSLOTS)
+
+/* Fast startup data stored in NVM, see pf_fsu.c */
+typedef struct pf_fsu_nvm
+{
+   /* FSParameterUUID of the latest parameterization. Nil if none. */
+   pf_uuid_t fs_parameter_uuid;
+   uint16_t nbr_marks;
+   pf_fsu_mark_t marks[PF_FSU_MAX_MARKS];
+} pf_fsu_nvm_t;
+
 typedef struct pf_ar_server
 {
    uint16_t length_cm_responder_station_name;
@@ -1778,6 +1890,11 @@ typedef struct pf_ppm
 
    uint32_t trx_cnt; /* Number of frames sent */
 
+   /* Statistics, see pnet_get_iocr_statistics(). Written by the sending
+    * thread, between two increments of statistics_sequence. */
+   pnet_ppm_statistics_t statistics;
+   atomic_int statistics_sequence; /* Odd while being written */
+
    uint16_t send_clock_factor; /* Resolution: 31.25us, Allowed: 1..128, Default:
                                   32 */
    uint16_t reduction_ratio;   /* Allowed: 1..512 */
@@ -1801,6 +1918,13 @@ typedef struct pf_cpm
    uint32_t recv_cnt;
    uint32_t free_cnt;
 
+   /* Statistics, see pnet_get_iocr_statistics(). Written by the frame
+    * handler, between two increments of statistics_sequence. The dht_max
+    * field is written by pf_cpm_control_interval_expired(). */
+   pnet_cpm_statistics_t statistics;
+   atomic_int statistics_sequence; /* Odd while being written */
+   atomic_int statistics_reset;    /* Set to clear at the next write */
+
    pnet_ethaddr_t sa; /* Mac of the controller */
 
    uint16_t nbr_frame_id; /* 1 or 2 */
@@ -1969,6 +2093,12 @@ typedef struct pf_apmx
    pf_scheduler_handle_t resend_timeout; /* Scheduler handle for Alarm
                                             retransmission */
    uint32_t resend_counter;
+
+   /* Latency measurement for the alarm currently waiting for ACK */
+   uint32_t timestamp_alarm_sent_us;
+   uint16_t alarm_retransmissions;
+
+   pnet_alarm_latency_statistics_t statistics;
 } pf_apmx_t;
 
 typedef enum pf_alpmr_state_values
@@ -2125,6 +2255,8 @@ typedef struct pf_ar
                                   the CControl session. */
 
    pf_cmdev_state_values_t cmdev_state; /* pf_cmdev_state_values_t */
+   /* Time of each startup phase. See pnet_get_ar_startup_timeline() */
+   pnet_ar_startup_timeline_t startup_timeline;
    pnet_ethaddr_t src_addr;             /* Connect client MAC address */
 
    uint16_t nbr_ar_param;
@@ -2150,6 +2282,13 @@ typedef struct pf_ar
     * (1) prio. */
    pf_alarm_send_queue_t alarm_send_q[PF_ALARM_NUMBER_OF_PRIORITY_LEVELS];
 
+   /* Doorbell for the alarm periodic handling. Incremented when an incoming
+    * alarm frame or an outgoing alarm is put in any of the alarm queues
+    * (from the Ethernet receive thread or from the application).
+    * Zero means that there is no alarm work to do for this AR.
+    * Without atomics it is protected by the low prio send queue mutex. */
+   atomic_int alarm_work_pending;
+
    uint16_t nbr_ar_rpc;
    pf_ar_rpc_request_t ar_rpc_request; /* From connect.req */
    pf_ar_rpc_result_t ar_rpc_result;   /* From connect.ind */
@@ -2305,6 +2444,11 @@ typedef struct pf_subslot
 
    /* Run-time information */
    pf_submod_diag_summary_t diag_summary;
+#if PNET_OPTION_FAST_STARTUP
+   /* Parameterized by an AR with the stored FSParameterUUID, see pf_fsu.c.
+    * Also stored in nvm, see pf_fsu_mark_t. */
+   bool fsu_parameterized;
+#endif
 
    /* The following members shall be protected by the device.diag_mutex. */
    /*
@@ -2323,6 +2467,12 @@ typedef struct pf_slot
    uint16_t slot_number;
    uint32_t ident_number;
    pf_subslot_t subslots[PNET_MAX_SUBSLOTS];
+
+   /* Lookup index of the subslots in use, sorted by subslot number.
+    * Each entry holds a subslot number and its position in subslots[]. */
+   uint16_t subslot_index_count;
+   uint16_t subslot_index_number[PNET_MAX_SUBSLOTS];
+   uint16_t subslot_index_pos[PNET_MAX_SUBSLOTS];
 } pf_slot_t;
 
 /* Real identification, API level. */
@@ -2331,6 +2481,12 @@ typedef struct pf_api
    bool in_use;
    uint32_t api_id;
    pf_slot_t slots[PNET_MAX_SLOTS];
+
+   /* Lookup index of the slots in use, sorted by slot number.
+    * Each entry holds a slot number and its position in slots[]. */
+   uint16_t slot_index_count;
+   uint16_t slot_index_number[PNET_MAX_SLOTS];
+   uint16_t slot_index_pos[PNET_MAX_SLOTS];
 } pf_api_t;
 
 /* Real identification. */
@@ -2339,6 +2495,60 @@ typedef struct pf_real_ident
    pf_api_t api[PNET_MAX_API];
 } pf_real_ident_t;
 
+/* Number of accepted connect requests remembered for fast reconnect,
+ * see pf_cmdev_rm_connect_ind().
+ *
+ * Each entry holds the data descriptors of all IOCRs, which is
+ * PNET_MAX_CR * PNET_MAX_API * PNET_MAX_SLOTS * PNET_MAX_SUBSLOTS
+ * pf_iodata_object_t. With 2 CRs, 1 API, 5 slots, 4 subslots and
+ * PNET_MAX_DFP_IOCR 2 that is about 1.3 kB per entry.
+ */
+#ifndef PF_CMDEV_CONNECT_CACHE_SIZE
+#define PF_CMDEV_CONNECT_CACHE_SIZE PNET_MAX_AR
+#endif
+
+/* Data descriptors computed for one IOCR of an accepted connect request */
+typedef struct pf_cmdev_connect_cache_iocr
+{
+   uint16_t in_length;
+   uint16_t out_length;
+   uint16_t nbr_data_desc;
+   pf_iodata_object_t
+      data_desc[PNET_MAX_API * PNET_MAX_SLOTS * PNET_MAX_SUBSLOTS];
+} pf_cmdev_connect_cache_iocr_t;
+
+/*
+ * An accepted connect request, identified by the controller MAC address
+ * and a digest of the AR parameters, IOCR parameters and expected
+ * configuration. Only requests that gave an empty module diff are stored.
+ */
+typedef struct pf_cmdev_connect_cache
+{
+   bool valid;
+   pnet_ethaddr_t cm_initiator_mac_add;
+   uint64_t digest;
+   uint32_t real_ident_version; /* Of the real identification when stored */
+   uint16_t nbr_iocrs;
+   pf_cmdev_connect_cache_iocr_t iocrs[PNET_MAX_CR];
+} pf_cmdev_connect_cache_t;
+
+/*
+ * Frame IDs for output CRs are handed out by the device from the first
+ * PF_FRAME_ID_POOL_SIZE frame IDs of each RT class range, see
+ * pf_cmdev_fix_frame_id(). No more frame IDs than this can be in use at the
+ * same time, so there is always a free one.
+ */
+#define PF_FRAME_ID_POOL_SIZE  ((PNET_MAX_AR) * (PNET_MAX_CR))
+#define PF_FRAME_ID_POOL_WORDS ((PF_FRAME_ID_POOL_SIZE + 31) / 32)
+
+typedef enum pf_frame_id_pool
+{
+   PF_FRAME_ID_POOL_RT_CLASS_1 = 0, /* Also used by RT_CLASS_UDP */
+   PF_FRAME_ID_POOL_RT_CLASS_2,
+   PF_FRAME_ID_POOL_RT_CLASS_3,
+   PF_FRAME_ID_POOL_NUMBER_OF_POOLS
+} pf_frame_id_pool_t;
+
 /*
  * The device struct contains information about the configured API's.
  * The api member contains a hierarchy which may be traversed using
@@ -2358,6 +2568,18 @@ typedef struct pf_device
    os_mutex_t * diag_mutex; /* Protect the diag items */
    pf_diag_item_t diag_items[PNET_MAX_DIAG_ITEMS];
    uint16_t diag_items_free; /* Head of the unused list */
+
+   /* Incremented whenever a module or submodule is plugged or pulled */
+   uint32_t real_ident_version;
+
+   pf_cmdev_connect_cache_t connect_cache[PF_CMDEV_CONNECT_CACHE_SIZE];
+   uint16_t connect_cache_next; /* Entry to replace when the cache is full */
+   uint32_t connect_cache_hits;
+
+   /* Frame IDs used by any AR. Bit n in a pool is the frame ID at offset n
+    * from the start of the RT class range. */
+   uint32_t frame_id_pool[PF_FRAME_ID_POOL_NUMBER_OF_POOLS]
+                         [PF_FRAME_ID_POOL_WORDS];
 } pf_device_t;
 
 /*
@@ -2880,6 +3102,31 @@ typedef struct pf_lldp_port
    /* Scheduler handle for periodic LLDP sending */
    pf_scheduler_handle_t tx_timeout;
 
+   /* Buffer (pnal_buf_t) holding the pre-encoded LLDP frame to send.
+    *
+    * Allocated at first transmission and kept until the transmission is
+    * disabled. The frame is rebuilt when is_tx_frame_valid is false, or
+    * when the link status differs from tx_link_status.
+    */
+   void * p_tx_buffer;
+
+   /* Points to this struct once initialized. Used to know whether
+    * p_tx_buffer is valid when the stack instance is initialized again.
+    */
+   const struct pf_lldp_port * p_self;
+   bool is_tx_frame_valid;
+   pf_lldp_link_status_t tx_link_status;
+
+   /* Length and content of the TLV region of the last decoded LLDP frame.
+    *
+    * Used to skip decoding of received frames identical to the last one.
+    * Only valid when is_rx_frame_valid is true.
+    * Protected by LLDP mutex.
+    */
+   uint16_t rx_frame_len;
+   uint8_t rx_frame[PF_FRAME_BUFFER_SIZE];
+   bool is_rx_frame_valid;
+
    /* Is information about peer device received?
     *
     * Information is received in LLDP packets.
@@ -2916,27 +3163,252 @@ typedef struct pf_port
    pnal_eth_status_t eth_status; /* Updated by background task */
 } pf_port_t;
 
+typedef struct pf_snmp_peer_timestamp
+{
+   uint32_t timestamp_10ms;
+   bool is_valid;
+} pf_snmp_peer_timestamp_t;
+
+typedef struct pf_snmp_peer_station_name
+{
+   pf_lldp_station_name_t station_name;
+   bool is_valid;
+} pf_snmp_peer_station_name_t;
+
+/**
+ * LLDP-MIB values for one port, as published to the SNMP server.
+ *
+ * Values for the remote device are copied together with their validity,
+ * so the SNMP getters can return the same error codes as the LLDP getters.
+ */
+typedef struct pf_snmp_port_snapshot
+{
+   pf_lldp_port_id_t port_id;
+   pf_lldp_port_description_t port_description;
+   pf_lldp_signal_delay_t signal_delays;
+   pf_lldp_link_status_t link_status;
+
+   pf_snmp_peer_timestamp_t peer_timestamp;
+   pf_lldp_chassis_id_t peer_chassis_id;
+   pf_lldp_port_id_t peer_port_id;
+   pf_lldp_port_description_t peer_port_description;
+   pf_lldp_management_address_t peer_management_address;
+   pf_snmp_peer_station_name_t peer_station_name;
+   pf_lldp_signal_delay_t peer_signal_delays;
+   pf_lldp_link_status_t peer_link_status;
+} pf_snmp_port_snapshot_t;
+
+/**
+ * LLDP-MIB and system-MIB values read from other modules, as published
+ * to the SNMP server.
+ */
+typedef struct pf_snmp_snapshot
+{
+   pf_snmp_system_description_t system_description;
+   pf_lldp_chassis_id_t chassis_id;
+   pf_lldp_management_address_t management_address;
+   pf_lldp_station_name_t station_name;
+   pf_snmp_port_snapshot_t port[PNET_MAX_PHYSICAL_PORTS];
+} pf_snmp_snapshot_t;
+
 typedef struct pf_snmp_data
 {
+   /* Writable variables. Written only inside a snapshot write section,
+    * see pf_snmp.c */
    pf_snmp_system_contact_t system_contact;
    pf_snmp_system_name_t system_name;
    pf_snmp_system_location_t system_location;
+
+   /* Values published by the stack, read lock-free by the SNMP server */
+   pf_snmp_snapshot_t snapshot;
+
+   /* Incremented before and after each write. Odd during write. */
+   atomic_int snapshot_sequence;
+
+   /* Non-zero if the snapshot should be published again */
+   atomic_int snapshot_outdated;
+
+   /* Serializes writers. Readers only use it as a fallback. */
+   os_mutex_t * snapshot_mutex;
 } pf_snmp_data_t;
 
+/* Number of background worker jobs, see pf_bg_job_t */
+#define PF_BG_WORKER_NUMBER_OF_JOBS 5
+
+/* Pending request for a background worker job */
+typedef struct pf_bg_job_request
+{
+   bool is_pending;
+   uint32_t first_request_us; /* Time of first request since last run */
+   uint32_t last_request_us;  /* Time of latest request */
+} pf_bg_job_request_t;
+
+/* Max number of jobs waiting in the background worker queue */
+#ifndef PF_BG_WORKER_MAX_QUEUED_JOBS
+#define PF_BG_WORKER_MAX_QUEUED_JOBS 16
+#endif
+
+/* Max size of the payload of a queued job, in bytes */
+#ifndef PF_BG_WORKER_MAX_PAYLOAD_SIZE
+#define PF_BG_WORKER_MAX_PAYLOAD_SIZE 64
+#endif
+
+/* Number of background worker threads. Built-in jobs are run by the
+ * first thread, queued jobs by any of them.
+ */
+#ifndef PF_BG_WORKER_NUMBER_OF_THREADS
+#define PF_BG_WORKER_NUMBER_OF_THREADS 1
+#endif
+
+/* Number of priority levels for queued jobs, see pf_bg_job_priority_t */
+#define PF_BG_WORKER_NUMBER_OF_PRIORITIES 3
+
+/* Index used for end of list in the background worker queue */
+#define PF_BG_WORKER_QUEUE_END UINT16_MAX
+
+/**
+ * Function to run a queued background job.
+ *
+ * Runs in a background worker thread.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_payload        InOut: Copy of the payload given when queueing
+ *                                the job. Aligned for any type.
+ * @param payload_size     In:    Size of payload, in bytes
+ */
+typedef void (*pf_bg_job_callback_t) (
+   pnet_t * net,
+   void * p_payload,
+   uint16_t payload_size);
+
+/* Job in the background worker queue */
+typedef struct pf_bg_queued_job
+{
+   pf_bg_job_callback_t callback;
+   uint16_t next; /* Next job in same list, or PF_BG_WORKER_QUEUE_END */
+   uint16_t payload_size;
+   union
+   {
+      uint8_t bytes[PF_BG_WORKER_MAX_PAYLOAD_SIZE];
+      uint64_t align_integer;
+      void * align_pointer;
+      double align_floating;
+   } payload;
+} pf_bg_queued_job_t;
+
+/* Max number of files handled by pf_file. IP, I&M, diagnostics, FSU,
+ * three SNMP files and one per physical port.
+ */
+#define PF_FILE_MAX_FILES (7 + PNET_MAX_PHYSICAL_PORTS)
+
+/* Checksum of the contents last written to (or read from) a file */
+typedef struct pf_file_cache_entry
+{
+   bool in_use;
+   bool is_uncommitted; /* Updated in a transaction not yet committed */
+   char path[PNET_MAX_FILE_FULLPATH_SIZE]; /* Terminated string */
+   size_t size;
+   uint32_t crc;
+} pf_file_cache_entry_t;
+
+/* Object stored in a journal file */
+typedef struct pf_file_journal_object
+{
+   bool in_use;
+   char name[PNET_MAX_FILENAME_SIZE]; /* Terminated string */
+   uint32_t offset;                   /* Position of data in journal file */
+   uint16_t size;
+} pf_file_journal_object_t;
+
+/* Write position in the active journal file */
+typedef struct pf_file_journal_file
+{
+   uint16_t ix; /* 0 or 1 */
+   uint32_t generation;
+   uint32_t sequence;   /* Sequence number of last committed transaction */
+   uint32_t end_offset; /* 0 if the file not yet is created */
+
+   /* The CRC of the latest record is written together with the next one */
+   bool has_pending_crc;
+   uint32_t pending_crc;
+} pf_file_journal_file_t;
+
+typedef struct pf_file_journal
+{
+   bool is_open;
+   char directory[PNET_MAX_DIRECTORYPATH_SIZE]; /* Terminated string */
+   pf_file_journal_file_t file;
+
+   /* Set if the file has data after the last commit, for example after a
+    * power loss. It must then be compacted before anything is appended.
+    */
+   bool is_compaction_needed;
+
+   /* Set if writing to the active file has failed. The file might then
+    * end with a partially written record, so it is not appended to again.
+    * Instead the objects are compacted into the other file.
+    */
+   bool is_append_failed;
+
+   uint16_t transaction_depth;
+   uint16_t uncommitted_records;
+   bool is_transaction_failed;
+
+   /* Committed and uncommitted objects */
+   pf_file_journal_object_t objects[PF_FILE_MAX_FILES];
+} pf_file_journal_t;
+
+/* Pre-allocated frame buffers, see pf_frame_pool.c */
+typedef struct pf_frame_pool
+{
+   /* Points to the pool itself once initialized. Used to keep the
+    * buffers when the stack instance is initialized again.
+    */
+   const struct pf_frame_pool * p_self;
+
+   pnal_buf_t * buffers[PF_FRAME_POOL_SIZE];
+   uint16_t number_of_buffers; /* Number of buffers actually allocated */
+
+   /* One bit per buffer, set if the buffer is free */
+   atomic_int free_bits[PF_FRAME_POOL_WORDS];
+
+#if !PNET_USE_ATOMICS
+   /* Protects the bits and statistics, as there are no atomics */
+   os_mutex_t * mutex;
+#endif
+
+   /* Statistics */
+   atomic_int in_use;
+   atomic_int high_watermark; /* Approximate if several threads race */
+   atomic_int fallback_allocations; /* Pool empty, or too large buffer */
+} pf_frame_pool_t;
+
 struct pnet
 {
    uint32_t pnal_buf_alloc_cnt;
+
+   /********** Frame buffers **********/
+
+   pf_frame_pool_t frame_pool;
    bool global_alarm_enable;
 
    /********** CPM **********/
 
    os_mutex_t * cpm_buf_lock;
    atomic_int cpm_instance_cnt;
+#if !PNET_USE_ATOMICS
+   /* Protects the statistics, as there are no atomics */
+   os_mutex_t * cpm_statistics_lock;
+#endif
 
    /********** PPM **********/
 
    os_mutex_t * ppm_buf_lock;
    atomic_int ppm_instance_cnt;
+#if !PNET_USE_ATOMICS
+   /* Protects the statistics, as there are no atomics */
+   os_mutex_t * ppm_statistics_lock;
+#endif
 
    /********** DCP **********/
 
@@ -2948,6 +3420,16 @@ struct pnet
    /** A response to DCP IDENTIFY is waiting to be sent */
    bool dcp_delayed_response_waiting;
 
+   /** Encoded blocks of the DCP IDENTIFY response (without alias block).
+       Rebuilt on first use after the DCP ASE has been changed. */
+   uint8_t dcp_identresp_cache[PF_FRAME_BUFFER_SIZE];
+   uint16_t dcp_identresp_cache_len;
+   bool dcp_identresp_cache_valid;
+
+   pf_dcp_rate_limit_source_t dcp_rate_limit[PF_DCP_RATE_LIMIT_SOURCES];
+   pf_dcp_token_bucket_t dcp_rate_limit_global;
+   pf_dcp_statistics_t dcp_statistics;
+
    pf_scheduler_handle_t dcp_led_timeout;
    pf_scheduler_handle_t dcp_sam_timeout;
    pf_scheduler_handle_t dcp_identresp_timeout;
@@ -2968,6 +3450,14 @@ struct pnet
    /** APIs and diag items */
    pf_device_t cmdev_device;
 
+#if PNET_OPTION_FAST_STARTUP
+   /********** FSU **********/
+
+   /** Reflects what is stored in NVM, see pf_fsu.c */
+   pf_fsu_nvm_t fsu_nonvolatile;
+   os_mutex_t * fsu_mutex; /* Protects fsu_nonvolatile */
+#endif
+
    /********** CMINA **********/
 
    /** Reflects what is/should be stored in NVM */
@@ -3027,6 +3517,11 @@ struct pnet
    /** Last \a time pnet_handle_periodic() was invoked */
    uint32_t timestamp_handle_periodic_us;
 
+   /** Time spent in the phases of pnet_init() */
+   pnet_init_profile_t fspm_init_profile;
+   uint32_t fspm_init_start_us;
+   uint32_t fspm_init_phase_start_us;
+
    /* Mutex for protecting access to writable I&M data.
     *
     * Note I&M may be both read and written by SNMP, which executes from
@@ -3064,13 +3559,55 @@ struct pnet
 
       /* Scheduler handle for Ethernet link monitoring */
       pf_scheduler_handle_t link_monitor_timeout;
+
+      /* True if link changes are reported by pnal, so that periodic
+       * polling of the link status is not needed.
+       */
+      bool is_link_monitor_event_driven;
+
+      /* Incremented by the background worker when the link state of
+       * any port has changed. Handled in pf_pdport_periodic().
+       */
+      atomic_int link_change_pending;
    } pf_interface;
 
    struct
    {
       os_event_t * events;
+
+      /* Protects the job requests and the queue */
+      os_mutex_t * request_mutex;
+
+      /* Held while a job runs, so that a flush does not run a job in
+       * parallel with the background worker task.
+       */
+      os_mutex_t * job_mutex;
+
+      pf_bg_job_request_t requests[PF_BG_WORKER_NUMBER_OF_JOBS];
+
+      /* Queued jobs. Each priority level has a list of jobs, in the
+       * order they were queued. Unused entries are in the free list.
+       */
+      pf_bg_queued_job_t queue[PF_BG_WORKER_MAX_QUEUED_JOBS];
+      uint16_t queue_head[PF_BG_WORKER_NUMBER_OF_PRIORITIES];
+      uint16_t queue_tail[PF_BG_WORKER_NUMBER_OF_PRIORITIES];
+      uint16_t queue_free;
    } pf_bg_worker;
 
+   /********** FILE **********/
+
+   /* Known contents of persisted files, see pf_file.c */
+   pf_file_cache_entry_t file_cache[PF_FILE_MAX_FILES];
+   uint16_t file_cache_next_replaced;
+
+   /* Journal file with all persisted objects */
+   pf_file_journal_t file_journal;
+
+   /* Serializes file access, so that the cache and the journal match
+    * the files. Held during transactions.
+    */
+   os_mutex_t * file_mutex;
+
    const pf_ppm_driver_t * ppm_drv;
    const pf_cpm_driver_t * cpm_drv;
 
@@ -3086,6 +3623,9 @@ struct pnet
  * @internal
  * Initialise a pnet_t structure into already allocated memory.
  *
+ * If the structure has been initialised before, its frame buffer pool
+ * is reused.
+ *
  * @param net              InOut: The p-net stack instance to be initialised.
  * @param p_cfg            In:    Profinet configuration. These values are used
  *                                at first startup and at factory reset.
@@ -254,6 +254,52 @@ int pnal_save_file (
  */
 void pnal_clear_file (const char * fullpath);
 
+/**
+ * Read part of a binary file.
+ *
+ * Used by the p-net file journal, so it must be implemented by all
+ * platform ports.
+ *
+ * @param fullpath         In:    Full path to the file
+ * @param offset           In:    Position in file to read from
+ * @param p_buf            Out:   Buffer for the data
+ * @param size             In:    Number of bytes to read
+ * @return  Number of bytes read. Less than \a size at end of file.
+ *          -1 if not found or an error occurred.
+ */
+int pnal_read_file (
+   const char * fullpath,
+   size_t offset,
+   void * p_buf,
+   size_t size);
+
+/**
+ * Append to a binary file. The file is created if it does not exist.
+ *
+ * Can handle two input buffers, which are written in order.
+ *
+ * Used by the p-net file journal, so it must be implemented by all
+ * platform ports. The data should be written to non-volatile storage
+ * before returning. If an error is returned, part of the data might
+ * have been written. The p-net stack then stops appending to the file.
+ *
+ * @param fullpath         In:    Full path to the file
+ * @param object_1         In:    Data to append, or NULL. Mandatory if
+ *                                size_1 > 0
+ * @param size_1           In:    Size of object_1.
+ * @param object_2         In:    Data to append, or NULL. Mandatory if
+ *                                size_2 > 0
+ * @param size_2           In:    Size of object_2.
+ * @return  0  if the operation succeeded.
+ *          -1 if an error occurred.
+ */
+int pnal_append_file (
+   const char * fullpath,
+   const void * object_1,
+   size_t size_1,
+   const void * object_2,
+   size_t size_2);
+
 /*
  */
 
@@ -312,6 +358,42 @@ int pnal_eth_get_status (
    const char * interface_name,
    pnal_eth_status_t * status);
 
+/**
+ * The prototype of the link change callback.
+ *
+ * Called from the link monitor thread of the pnal implementation, not from
+ * the p-net stack thread. The callback should not block. Read the new
+ * status with pnal_eth_get_status().
+ *
+ * @param interface_name   In:    Ethernet interface name, for example eth0
+ * @param arg              InOut: User argument passed at init
+ */
+typedef void (pnal_eth_link_callback_t) (
+   const char * interface_name,
+   void * arg);
+
+/**
+ * Start event driven monitoring of Ethernet link changes
+ *
+ * The callback is called whenever the operational state of an Ethernet
+ * interface changes, for example when a cable is connected or removed.
+ * On Linux this is implemented by subscribing to RTMGRP_LINK
+ * notifications on an rtnetlink socket.
+ *
+ * If not supported by the platform, the p-net stack will instead poll the
+ * link status periodically.
+ *
+ * @param pnal_cfg         In:    Operating system dependent configuration
+ * @param callback         In:    Callback for link changes
+ * @param arg              InOut: User argument passed to the callback
+ * @return  0 if event driven link monitoring was started.
+ *         -1 if not supported or if an error occurred.
+ */
+int pnal_eth_link_monitor_init (
+   const pnal_cfg_t * pnal_cfg,
+   pnal_eth_link_callback_t * callback,
+   void * arg);
+
 /**
  * Get network interface index
  *
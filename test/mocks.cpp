@@ -35,6 +35,7 @@ mock_os_data_t mock_os_data;
 mock_lldp_data_t mock_lldp_data;
 mock_file_data_t mock_file_data;
 mock_fspm_data_t mock_fspm_data;
+mock_alarm_data_t mock_alarm_data;
 pnal_eth_handle_t mock_eth_handle;
 
 void mock_clear (void)
@@ -43,6 +44,7 @@ void mock_clear (void)
    memset (&mock_lldp_data, 0, sizeof (mock_lldp_data));
    memset (&mock_file_data, 0, sizeof (mock_file_data));
    memset (&mock_fspm_data, 0, sizeof (mock_fspm_data));
+   memset (&mock_alarm_data, 0, sizeof (mock_alarm_data));
    mock_os_data.eth_status[1].operational_mau_type =
       PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX;
    mock_os_data.eth_status[1].running = true;
@@ -64,6 +66,12 @@ uint32_t mock_pnal_get_system_uptime_10ms (void)
    return mock_os_data.system_uptime_10ms;
 }
 
+pnal_buf_t * mock_pnal_buf_alloc (uint16_t length)
+{
+   mock_os_data.buf_alloc_count++;
+   return pnal_buf_alloc (length);
+}
+
 pnal_eth_handle_t * mock_pnal_eth_init (
    const char * if_name,
    const pnal_cfg_t * pnal_cfg,
@@ -93,6 +101,23 @@ int mock_pnal_eth_get_status (
    return 0;
 }
 
+int mock_pnal_eth_link_monitor_init (
+   const pnal_cfg_t * pnal_cfg,
+   pnal_eth_link_callback_t * callback,
+   void * arg)
+{
+   if (mock_os_data.is_link_monitor_supported == false)
+   {
+      /* Use periodic polling of link status */
+      return -1;
+   }
+
+   mock_os_data.link_callback = callback;
+   mock_os_data.link_callback_arg = arg;
+
+   return 0;
+}
+
 int mock_pnal_get_port_statistics (
    const char * interface_name,
    pnal_port_stats_t * port_stats)
@@ -168,6 +193,7 @@ int mock_pnal_udp_sendto (
    const uint8_t * data,
    int size)
 {
+   memcpy (mock_os_data.udp_sendto_copy, data, size);
    mock_os_data.udp_sendto_len = size;
    mock_os_data.udp_sendto_count++;
 
@@ -217,6 +243,89 @@ int mock_pnal_get_interface_index (const char * interface_name)
    return mock_os_data.interface_index;
 }
 
+mock_file_t * mock_get_file (const char * fullpath)
+{
+   uint16_t ix;
+
+   for (ix = 0; ix < MOCK_MAX_FILES; ix++)
+   {
+      if (
+         mock_os_data.files[ix].fullpath[0] != '\0' &&
+         strcmp (mock_os_data.files[ix].fullpath, fullpath) == 0)
+      {
+         return &mock_os_data.files[ix];
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * Find a mocked file, or create an empty one.
+ *
+ * @param fullpath         In:    Full path to the file
+ * @return  the file, or NULL if there is no room for more files.
+ */
+static mock_file_t * mock_get_or_create_file (const char * fullpath)
+{
+   mock_file_t * p_file = mock_get_file (fullpath);
+   uint16_t ix;
+
+   if (strlen (fullpath) >= sizeof (p_file->fullpath))
+   {
+      return NULL;
+   }
+
+   for (ix = 0; p_file == NULL && ix < MOCK_MAX_FILES; ix++)
+   {
+      if (mock_os_data.files[ix].fullpath[0] == '\0')
+      {
+         p_file = &mock_os_data.files[ix];
+         strcpy (p_file->fullpath, fullpath);
+         p_file->size = 0;
+      }
+   }
+
+   return p_file;
+}
+
+/**
+ * Append data to a mocked file.
+ *
+ * @param p_file           InOut: File
+ * @param object_1         In:    Data to append, or NULL
+ * @param size_1           In:    Size of object_1.
+ * @param object_2         In:    Data to append, or NULL
+ * @param size_2           In:    Size of object_2.
+ * @return  0  if the operation succeeded.
+ *          -1 if the file would be too large.
+ */
+static int mock_file_append (
+   mock_file_t * p_file,
+   const void * object_1,
+   size_t size_1,
+   const void * object_2,
+   size_t size_2)
+{
+   if (p_file->size + size_1 + size_2 > sizeof (p_file->content))
+   {
+      return -1;
+   }
+
+   if (size_1 > 0)
+   {
+      memcpy (&p_file->content[p_file->size], object_1, size_1);
+      p_file->size += size_1;
+   }
+   if (size_2 > 0)
+   {
+      memcpy (&p_file->content[p_file->size], object_2, size_2);
+      p_file->size += size_2;
+   }
+
+   return 0;
+}
+
 int mock_pnal_save_file (
    const char * fullpath,
    const void * object_1,
@@ -224,39 +333,58 @@ int mock_pnal_save_file (
    const void * object_2,
    size_t size_2)
 {
-   int pos = 0;
+   mock_file_t * p_file = NULL;
 
-   if (size_1 + size_2 > sizeof (mock_os_data.file_content))
+   mock_os_data.file_save_count++;
+
+   if (size_1 + size_2 > MOCK_FILE_CONTENT_SIZE)
    {
       return -1;
    }
-   if (strlen (fullpath) > sizeof (mock_os_data.file_fullpath))
+   p_file = mock_get_or_create_file (fullpath);
+   if (p_file == NULL)
    {
       return -1;
    }
 
-   strcpy (mock_os_data.file_fullpath, fullpath);
-   mock_os_data.file_size = size_1 + size_2;
+   p_file->size = 0;
+   return mock_file_append (p_file, object_1, size_1, object_2, size_2);
+}
 
-   if (size_1 > 0)
+int mock_pnal_append_file (
+   const char * fullpath,
+   const void * object_1,
+   size_t size_1,
+   const void * object_2,
+   size_t size_2)
+{
+   mock_file_t * p_file = NULL;
+
+   mock_os_data.file_save_count++;
+
+   p_file = mock_get_or_create_file (fullpath);
+   if (p_file == NULL)
    {
-      memcpy (&mock_os_data.file_content[pos], object_1, size_1);
-      pos += size_1;
+      return -1;
    }
-   if (size_2 > 0)
+
+   if (mock_os_data.is_append_failing)
    {
-      memcpy (&mock_os_data.file_content[pos], object_2, size_2);
+      /* Partially written */
+      (void)mock_file_append (p_file, object_1, size_1, NULL, 0);
+      return -1;
    }
 
-   return 0;
+   return mock_file_append (p_file, object_1, size_1, object_2, size_2);
 }
 
 void mock_pnal_clear_file (const char * fullpath)
 {
-   if (strcmp (fullpath, mock_os_data.file_fullpath) == 0)
+   mock_file_t * p_file = mock_get_file (fullpath);
+
+   if (p_file != NULL)
    {
-      strcpy (mock_os_data.file_fullpath, "");
-      mock_os_data.file_size = 0;
+      memset (p_file, 0, sizeof (*p_file));
    }
 }
 
@@ -267,31 +395,56 @@ int mock_pnal_load_file (
    void * object_2,
    size_t size_2)
 {
+   mock_file_t * p_file = mock_get_file (fullpath);
    int pos = 0;
 
-   if (size_1 + size_2 > mock_os_data.file_size)
-   {
-      return -1;
-   }
+   mock_os_data.file_load_count++;
 
-   if (strcmp (fullpath, mock_os_data.file_fullpath) != 0)
+   if (p_file == NULL || size_1 + size_2 > p_file->size)
    {
       return -1;
    }
 
    if (size_1 > 0)
    {
-      memcpy (object_1, &mock_os_data.file_content[pos], size_1);
+      memcpy (object_1, &p_file->content[pos], size_1);
       pos += size_1;
    }
    if (size_2 > 0)
    {
-      memcpy (object_2, &mock_os_data.file_content[pos], size_2);
+      memcpy (object_2, &p_file->content[pos], size_2);
    }
 
    return 0;
 }
 
+int mock_pnal_read_file (
+   const char * fullpath,
+   size_t offset,
+   void * p_buf,
+   size_t size)
+{
+   mock_file_t * p_file = mock_get_file (fullpath);
+
+   mock_os_data.file_load_count++;
+
+   if (p_file == NULL)
+   {
+      return -1;
+   }
+   if (offset >= p_file->size)
+   {
+      return 0;
+   }
+   if (size > p_file->size - offset)
+   {
+      size = p_file->size - offset;
+   }
+
+   memcpy (p_buf, &p_file->content[offset], size);
+   return (int)size;
+}
+
 int mock_pf_alarm_send_diagnosis (
    pf_ar_t * p_ar,
    uint32_t api_id,
@@ -302,6 +455,26 @@ int mock_pf_alarm_send_diagnosis (
    return 0;
 }
 
+int mock_pf_alarm_send_pull (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   uint32_t api_id,
+   uint16_t slot_nbr,
+   uint16_t subslot_nbr)
+{
+   uint16_t ix = mock_alarm_data.pull_count;
+
+   if (ix < MOCK_MAX_PULL_ALARMS)
+   {
+      mock_alarm_data.pull_ar[ix] = p_ar;
+      mock_alarm_data.pull_slot[ix] = slot_nbr;
+      mock_alarm_data.pull_subslot[ix] = subslot_nbr;
+   }
+   mock_alarm_data.pull_count++;
+
+   return 0;
+}
+
 void mock_pf_generate_uuid (
    uint32_t timestamp,
    uint32_t session_number,
@@ -360,6 +533,7 @@ int mock_pnal_snmp_init (pnet_t * pnet, const pnal_cfg_t * pnal_cfg)
 }
 
 int mock_pf_file_save_if_modified (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
@@ -408,10 +582,15 @@ int mock_pf_file_save_if_modified (
    strcpy (mock_file_data.filename, filename);
    mock_file_data.size = size;
    memcpy (mock_file_data.object, p_object, size);
+   if (result != 0)
+   {
+      mock_file_data.save_count++;
+   }
    return result;
 }
 
 int mock_pf_file_save (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
@@ -441,10 +620,14 @@ int mock_pf_file_save (
    strcpy (mock_file_data.filename, filename);
    mock_file_data.size = size;
    memcpy (mock_file_data.object, p_object, size);
+   mock_file_data.save_count++;
    return 0;
 }
 
-void mock_pf_file_clear (const char * directory, const char * filename)
+void mock_pf_file_clear (
+   pnet_t * net,
+   const char * directory,
+   const char * filename)
 {
    if (strcmp (filename, mock_file_data.filename) == 0)
    {
@@ -454,6 +637,7 @@ void mock_pf_file_clear (const char * directory, const char * filename)
 }
 
 int mock_pf_file_load (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    void * p_object,
@@ -508,5 +692,21 @@ void mock_pf_bg_worker_init (pnet_t * net)
 
 int mock_pf_bg_worker_start_job (pnet_t * net, pf_bg_job_t job_id)
 {
+   mock_os_data.bg_job_start_count[job_id]++;
    return 0;
 }
+
+void mock_pf_bg_worker_flush (pnet_t * net)
+{
+   return;
+}
+
+os_thread_t * mock_os_thread_create (
+   const char * name,
+   uint32_t priority,
+   size_t stacksize,
+   void (*entry) (void * arg),
+   void * arg)
+{
+   return NULL;
+}
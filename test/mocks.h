@@ -27,11 +27,22 @@ extern "C" {
 #include "pf_includes.h"
 #include "osal.h"
 
+#define MOCK_MAX_FILES         4
+#define MOCK_FILE_CONTENT_SIZE 8000
+
+typedef struct mock_file
+{
+   char fullpath[100]; /* Terminated string. Empty if not used */
+   uint16_t size;
+   uint8_t content[MOCK_FILE_CONTENT_SIZE];
+} mock_file_t;
+
 typedef struct mock_os_data_obj
 {
    uint8_t eth_send_copy[PF_FRAME_BUFFER_SIZE];
    uint16_t eth_send_len;
    uint16_t eth_send_count;
+   uint16_t buf_alloc_count; /* Frame buffers allocated from pnal by stack */
 
    /* Per port Ethernet link status.
     * Note that port numbers start at 1. To simplify test cases, we add a
@@ -40,6 +51,7 @@ typedef struct mock_os_data_obj
    pnal_eth_status_t eth_status[PNET_MAX_PHYSICAL_PORTS + 1];
    pnal_port_stats_t port_statistics[PNET_MAX_PHYSICAL_PORTS + 1];
 
+   uint8_t udp_sendto_copy[PF_FRAME_BUFFER_SIZE];
    uint16_t udp_sendto_len;
    uint16_t udp_sendto_count;
 
@@ -55,9 +67,17 @@ typedef struct mock_os_data_obj
    int interface_index;
    pnal_eth_handle_t * eth_if_handle;
 
-   char file_fullpath[100]; /* Full file path at latest save operation */
-   uint16_t file_size;
-   uint8_t file_content[2000];
+   mock_file_t files[MOCK_MAX_FILES];
+   uint16_t file_load_count; /* Number of load and read operations */
+   uint16_t file_save_count; /* Number of save and append operations */
+   bool is_append_failing; /* Used for injecting error. Writes object_1 */
+
+   /* Event driven link monitoring. Not supported unless enabled by test */
+   bool is_link_monitor_supported;
+   pnal_eth_link_callback_t * link_callback;
+   void * link_callback_arg;
+
+   uint16_t bg_job_start_count[PF_BG_WORKER_NUMBER_OF_JOBS];
 
 } mock_os_data_t;
 
@@ -76,6 +96,7 @@ typedef struct mock_file_data
    char filename[PNET_MAX_FILENAME_SIZE];
    uint8_t object[300];
    size_t size;
+   uint16_t save_count;  /* Number of saves that changed the file */
    bool is_save_failing; /* Used for injecting error */
    bool is_load_failing; /* Used for injecting error */
 
@@ -86,14 +107,29 @@ typedef struct mock_fspm_data
    char im_location[PNET_LOCATION_MAX_SIZE];
 } mock_fspm_data_t;
 
+#define MOCK_MAX_PULL_ALARMS 8
+
+typedef struct mock_alarm_data
+{
+   /* Pull alarms sent by CMDEV, in order. Subslot 0 is a pull module
+    * alarm if the AR allows it. */
+   uint16_t pull_count;
+   pf_ar_t * pull_ar[MOCK_MAX_PULL_ALARMS];
+   uint16_t pull_slot[MOCK_MAX_PULL_ALARMS];
+   uint16_t pull_subslot[MOCK_MAX_PULL_ALARMS];
+} mock_alarm_data_t;
+
 extern mock_os_data_t mock_os_data;
 extern mock_lldp_data_t mock_lldp_data;
 extern mock_file_data_t mock_file_data;
 extern mock_fspm_data_t mock_fspm_data;
+extern mock_alarm_data_t mock_alarm_data;
 
 uint32_t mock_os_get_current_time_us (void);
 uint32_t mock_pnal_get_system_uptime_10ms (void);
 
+pnal_buf_t * mock_pnal_buf_alloc (uint16_t length);
+
 void mock_init (void);
 void mock_clear (void);
 void mock_set_pnal_udp_recvfrom_buffer (uint8_t * p_src, uint16_t len);
@@ -110,6 +146,10 @@ int mock_pnal_get_macaddress (
 int mock_pnal_eth_get_status (
    const char * interface_name,
    pnal_eth_status_t * status);
+int mock_pnal_eth_link_monitor_init (
+   const pnal_cfg_t * pnal_cfg,
+   pnal_eth_link_callback_t * callback,
+   void * arg);
 int mock_pnal_get_port_statistics (
    const char * interface_name,
    pnal_port_stats_t * port_stats);
@@ -154,6 +194,27 @@ int mock_pnal_load_file (
    void * object_2,
    size_t size_2);
 
+int mock_pnal_read_file (
+   const char * fullpath,
+   size_t offset,
+   void * p_buf,
+   size_t size);
+
+int mock_pnal_append_file (
+   const char * fullpath,
+   const void * object_1,
+   size_t size_1,
+   const void * object_2,
+   size_t size_2);
+
+/**
+ * Find a mocked file.
+ *
+ * @param fullpath         In:    Full path to the file
+ * @return  the file, or NULL if it does not exist.
+ */
+mock_file_t * mock_get_file (const char * fullpath);
+
 int mock_pf_alarm_send_diagnosis (
    pf_ar_t * p_ar,
    uint32_t api_id,
@@ -161,6 +222,13 @@ int mock_pf_alarm_send_diagnosis (
    uint16_t subslot_nbr,
    pf_diag_item_t * p_item);
 
+int mock_pf_alarm_send_pull (
+   pnet_t * net,
+   pf_ar_t * p_ar,
+   uint32_t api_id,
+   uint16_t slot_nbr,
+   uint16_t subslot_nbr);
+
 void mock_pf_generate_uuid (
    uint32_t timestamp,
    uint32_t session_number,
@@ -189,6 +257,7 @@ int mock_pf_lldp_get_peer_link_status (
 int mock_pnal_snmp_init (pnet_t * pnet, const pnal_cfg_t * pnal_cfg);
 
 int mock_pf_file_save_if_modified (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
@@ -196,14 +265,19 @@ int mock_pf_file_save_if_modified (
    size_t size);
 
 int mock_pf_file_save (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    const void * p_object,
    size_t size);
 
-void mock_pf_file_clear (const char * directory, const char * filename);
+void mock_pf_file_clear (
+   pnet_t * net,
+   const char * directory,
+   const char * filename);
 
 int mock_pf_file_load (
+   pnet_t * net,
    const char * directory,
    const char * filename,
    void * p_object,
@@ -217,6 +291,15 @@ void mock_pf_bg_worker_init (pnet_t * net);
 
 int mock_pf_bg_worker_start_job (pnet_t * net, pf_bg_job_t job_id);
 
+void mock_pf_bg_worker_flush (pnet_t * net);
+
+os_thread_t * mock_os_thread_create (
+   const char * name,
+   uint32_t priority,
+   size_t stacksize,
+   void (*entry) (void * arg),
+   void * arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 class AlarmTest : public PnetIntegrationTest
 {
 };
@@ -386,6 +389,92 @@ TEST_F (AlarmUnitTest, AlarmCheckSendQueueHandling)
    EXPECT_EQ (err, -1);
 }
 
+TEST_F (AlarmUnitTest, AlarmCheckHistogramIndex)
+{
+   EXPECT_EQ (pf_alarm_histogram_index (0), 0);
+   EXPECT_EQ (pf_alarm_histogram_index (999), 0);
+   EXPECT_EQ (pf_alarm_histogram_index (1000), 1);
+   EXPECT_EQ (pf_alarm_histogram_index (1999), 1);
+   EXPECT_EQ (pf_alarm_histogram_index (2000), 2);
+   EXPECT_EQ (pf_alarm_histogram_index (5000), 3);
+   EXPECT_EQ (pf_alarm_histogram_index (10000), 4);
+   EXPECT_EQ (pf_alarm_histogram_index (20000), 5);
+   EXPECT_EQ (pf_alarm_histogram_index (50000), 6);
+   EXPECT_EQ (pf_alarm_histogram_index (99999), 6);
+   EXPECT_EQ (
+      pf_alarm_histogram_index (100000),
+      PNET_ALARM_HISTOGRAM_BUCKETS - 1);
+   EXPECT_EQ (
+      pf_alarm_histogram_index (UINT32_MAX),
+      PNET_ALARM_HISTOGRAM_BUCKETS - 1);
+}
+
+TEST_F (AlarmUnitTest, AlarmCheckGetStatistics)
+{
+   pf_ar_t ar;
+   pnet_alarm_statistics_t statistics;
+
+   memset (&ar, 0, sizeof (ar));
+   memset (&statistics, 0, sizeof (statistics));
+   ar.apmx[0].statistics.queued = 3;
+   ar.apmx[0].statistics.ack_time_histogram[2] = 4;
+   ar.apmx[1].statistics.retransmissions = 5;
+   ar.apmx[1].statistics.queue_time_max_us = 6;
+
+   EXPECT_EQ (pf_alarm_get_statistics (&ar, &statistics), 0);
+   EXPECT_EQ (statistics.low_prio.queued, 3UL);
+   EXPECT_EQ (statistics.low_prio.ack_time_histogram[2], 4UL);
+   EXPECT_EQ (statistics.high_prio.queued, 0UL);
+   EXPECT_EQ (statistics.high_prio.retransmissions, 5UL);
+   EXPECT_EQ (statistics.high_prio.queue_time_max_us, 6UL);
+
+   EXPECT_EQ (pf_alarm_get_statistics (&ar, NULL), -1);
+   EXPECT_EQ (pf_alarm_get_statistics (NULL, &statistics), -1);
+}
+
+TEST_F (AlarmUnitTest, AlarmCheckDoorbell)
+{
+   pf_ar_t ar;
+   pf_alarm_data_t alarm_data;
+   pf_apmr_msg_t frame;
+   int err = 0;
+
+   memset (&ar, 0, sizeof (ar));
+   memset (&alarm_data, 0, sizeof (alarm_data));
+   memset (&frame, 0, sizeof (frame));
+
+   /* Non-initialized queues are considered empty */
+   EXPECT_FALSE (pf_alarm_has_queued_work (&ar));
+   EXPECT_EQ ((uint32_t)ar.alarm_work_pending, 0U);
+
+   pf_alarm_ring_doorbell (&ar);
+   pf_alarm_ring_doorbell (&ar);
+   EXPECT_EQ ((uint32_t)ar.alarm_work_pending, 2U);
+
+   pf_alarm_queue_mutex_create (&ar.alarm_send_q[1].accountant);
+   pf_alarm_queue_mutex_create (&ar.apmx[0].alarm_receive_q.accountant);
+   EXPECT_FALSE (pf_alarm_has_queued_work (&ar));
+
+   /* Outgoing alarm */
+   err = pf_alarm_send_queue_post (&ar.alarm_send_q[1], &alarm_data);
+   EXPECT_EQ (err, 0);
+   EXPECT_TRUE (pf_alarm_has_queued_work (&ar));
+   err = pf_alarm_send_queue_fetch (&ar.alarm_send_q[1], &alarm_data);
+   EXPECT_EQ (err, 0);
+   EXPECT_FALSE (pf_alarm_has_queued_work (&ar));
+
+   /* Incoming alarm frame */
+   err = pf_alarm_receive_queue_post (&ar.apmx[0].alarm_receive_q, &frame);
+   EXPECT_EQ (err, 0);
+   EXPECT_TRUE (pf_alarm_has_queued_work (&ar));
+   err = pf_alarm_receive_queue_fetch (&ar.apmx[0].alarm_receive_q, &frame);
+   EXPECT_EQ (err, 0);
+   EXPECT_FALSE (pf_alarm_has_queued_work (&ar));
+
+   pf_alarm_queue_mutex_destroy (&ar.alarm_send_q[1].accountant);
+   pf_alarm_queue_mutex_destroy (&ar.apmx[0].alarm_receive_q.accountant);
+}
+
 TEST_F (AlarmUnitTest, AlarmCheckReceiveQueueHandling)
 {
    pf_alarm_receive_queue_t queue;
@@ -487,3 +576,77 @@ TEST_F (AlarmUnitTest, AlarmCheckReceiveQueueHandling)
    err = pf_alarm_receive_queue_fetch (&queue, &fetch_frame);
    EXPECT_EQ (err, -1);
 }
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (AlarmTest, DISABLED_AlarmPeriodicBenchmark)
+{
+   const uint16_t nbr_ars[] = {1, PNET_MAX_AR};
+   const uint32_t nbr_calls = 100000;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds idle;
+   std::chrono::nanoseconds polled;
+   pf_ar_t * p_ar;
+   uint16_t ix;
+   uint16_t iy;
+   uint16_t prio;
+   uint32_t call;
+
+   for (ix = 0; ix < NELEMENTS (nbr_ars); ix++)
+   {
+      /* Open ARs with empty alarm queues */
+      for (iy = 0; iy < nbr_ars[ix]; iy++)
+      {
+         p_ar = pf_ar_find_by_index (net, iy);
+         memset (p_ar, 0, sizeof (*p_ar));
+         p_ar->in_use = true;
+         p_ar->alarm_enable = true;
+         for (prio = 0; prio < PF_ALARM_NUMBER_OF_PRIORITY_LEVELS; prio++)
+         {
+            p_ar->apmx[prio].apmr_state = PF_APMR_STATE_OPEN;
+            p_ar->apmx[prio].p_alpmx = &p_ar->alpmx[prio];
+            p_ar->alpmx[prio].alpmi_state = PF_ALPMI_STATE_W_ALARM;
+            pf_alarm_queue_mutex_create (
+               &p_ar->apmx[prio].alarm_receive_q.accountant);
+            pf_alarm_queue_mutex_create (&p_ar->alarm_send_q[prio].accountant);
+         }
+      }
+
+      /* No queued alarm work, so the ARs are skipped */
+      start = std::chrono::steady_clock::now();
+      for (call = 0; call < nbr_calls; call++)
+      {
+         (void)pf_alarm_periodic (net);
+      }
+      idle = std::chrono::steady_clock::now() - start;
+
+      /* Ring the doorbells, so that all queues are polled as before */
+      start = std::chrono::steady_clock::now();
+      for (call = 0; call < nbr_calls; call++)
+      {
+         for (iy = 0; iy < nbr_ars[ix]; iy++)
+         {
+            pf_alarm_ring_doorbell (pf_ar_find_by_index (net, iy));
+         }
+         (void)pf_alarm_periodic (net);
+      }
+      polled = std::chrono::steady_clock::now() - start;
+
+      std::cout << "Alarm periodic with " << nbr_ars[ix]
+                << " AR(s): average " << idle.count() / nbr_calls
+                << " ns skipped, " << polled.count() / nbr_calls
+                << " ns polled\n";
+
+      for (iy = 0; iy < nbr_ars[ix]; iy++)
+      {
+         p_ar = pf_ar_find_by_index (net, iy);
+         for (prio = 0; prio < PF_ALARM_NUMBER_OF_PRIORITY_LEVELS; prio++)
+         {
+            pf_alarm_queue_mutex_destroy (
+               &p_ar->apmx[prio].alarm_receive_q.accountant);
+            pf_alarm_queue_mutex_destroy (
+               &p_ar->alarm_send_q[prio].accountant);
+         }
+         p_ar->in_use = false;
+      }
+   }
+}
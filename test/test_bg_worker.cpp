@@ -0,0 +1,304 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2021 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#include "utils_for_testing.h"
+#include "mocks.h"
+
+#include "pf_includes.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+typedef struct test_bg_job_log
+{
+   uint16_t number_of_runs;
+   char order[PF_BG_WORKER_MAX_QUEUED_JOBS + 1];
+} test_bg_job_log_t;
+
+static test_bg_job_log_t test_bg_job_log;
+
+static void test_bg_job_callback (
+   pnet_t * net,
+   void * p_payload,
+   uint16_t payload_size)
+{
+   test_bg_job_log.order[test_bg_job_log.number_of_runs] =
+      payload_size > 0 ? *(char *)p_payload : '-';
+   test_bg_job_log.number_of_runs++;
+}
+
+class BgWorkerTest : public PnetIntegrationTest
+{
+ protected:
+   virtual void SetUp() override
+   {
+      PnetIntegrationTest::SetUp();
+
+      /* The worker thread is not started. Jobs are run by the test. */
+      pf_bg_worker_init (net);
+      memset (&test_bg_job_log, 0, sizeof (test_bg_job_log));
+   };
+
+   /** Simulate that the application or an engineering tool changes
+    *  an I&M record, which is saved by the background worker.
+    */
+   void write_im_record (char value)
+   {
+      net->fspm_cfg.im_1_data.im_tag_function[0] = value;
+      pf_bg_worker_start_job (net, PF_BGJOB_SAVE_IM_NVM_DATA);
+   };
+
+   void advance_time_ms (uint32_t ms)
+   {
+      mock_os_data.current_time_us += ms * 1000;
+   };
+};
+
+TEST_F (BgWorkerTest, BgWorkerCollapsesBurstOfSaves)
+{
+   uint32_t delay_us;
+   int i;
+
+   mock_os_data.current_time_us = 1000000;
+
+   /* Burst of writes, 10 ms apart */
+   for (i = 0; i < 20; i++)
+   {
+      write_im_record ('a' + i);
+      advance_time_ms (10);
+      delay_us = pf_bg_worker_run_due_jobs (net, mock_os_data.current_time_us);
+      EXPECT_EQ (delay_us, (PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS - 10) * 1000);
+   }
+   EXPECT_EQ (mock_file_data.save_count, 0);
+
+   /* Saved once after the debounce window */
+   advance_time_ms (PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS - 10);
+   delay_us = pf_bg_worker_run_due_jobs (net, mock_os_data.current_time_us);
+   EXPECT_EQ (delay_us, UINT32_MAX);
+   EXPECT_EQ (mock_file_data.save_count, 1);
+   EXPECT_EQ (mock_file_data.object[0], 'a' + 19);
+
+   /* Nothing more to save */
+   advance_time_ms (PF_BG_WORKER_MAX_SAVE_DELAY_MS);
+   delay_us = pf_bg_worker_run_due_jobs (net, mock_os_data.current_time_us);
+   EXPECT_EQ (delay_us, UINT32_MAX);
+   EXPECT_EQ (mock_file_data.save_count, 1);
+}
+
+TEST_F (BgWorkerTest, BgWorkerLimitsSaveDelay)
+{
+   const uint32_t interval_ms = PF_BG_WORKER_SAVE_IM_DEBOUNCE_MS / 2;
+   uint32_t start_us;
+   uint32_t elapsed_ms = 0;
+
+   mock_os_data.current_time_us = 1000000;
+   start_us = mock_os_data.current_time_us;
+
+   /* Continuous writes, each within the debounce window */
+   while (mock_file_data.save_count == 0)
+   {
+      write_im_record ('a' + (elapsed_ms / interval_ms) % 20);
+      advance_time_ms (interval_ms);
+      elapsed_ms += interval_ms;
+      (void)pf_bg_worker_run_due_jobs (net, mock_os_data.current_time_us);
+      ASSERT_LE (elapsed_ms, PF_BG_WORKER_MAX_SAVE_DELAY_MS + interval_ms);
+   }
+
+   /* Saved when max delay has passed since the first write */
+   EXPECT_GE (
+      mock_os_data.current_time_us - start_us,
+      PF_BG_WORKER_MAX_SAVE_DELAY_MS * 1000);
+   EXPECT_EQ (mock_file_data.save_count, 1);
+}
+
+TEST_F (BgWorkerTest, BgWorkerFlush)
+{
+   uint32_t delay_us;
+
+   write_im_record ('x');
+   EXPECT_EQ (mock_file_data.save_count, 0);
+
+   /* For example at shutdown */
+   pf_bg_worker_flush (net);
+   EXPECT_EQ (mock_file_data.save_count, 1);
+   EXPECT_EQ (mock_file_data.object[0], 'x');
+
+   /* Nothing left to save */
+   advance_time_ms (PF_BG_WORKER_MAX_SAVE_DELAY_MS);
+   delay_us = pf_bg_worker_run_due_jobs (net, mock_os_data.current_time_us);
+   EXPECT_EQ (delay_us, UINT32_MAX);
+   EXPECT_EQ (mock_file_data.save_count, 1);
+}
+
+TEST_F (BgWorkerTest, BgWorkerRunsQueuedJobsInPriorityOrder)
+{
+   const char payloads[] = "abcdef";
+   int res;
+
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_LOW,
+      test_bg_job_callback,
+      &payloads[0],
+      1);
+   EXPECT_EQ (res, 0);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_NORMAL,
+      test_bg_job_callback,
+      &payloads[1],
+      1);
+   EXPECT_EQ (res, 0);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_HIGH,
+      test_bg_job_callback,
+      &payloads[2],
+      1);
+   EXPECT_EQ (res, 0);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_NORMAL,
+      test_bg_job_callback,
+      &payloads[3],
+      1);
+   EXPECT_EQ (res, 0);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_LOW,
+      test_bg_job_callback,
+      NULL,
+      0);
+   EXPECT_EQ (res, 0);
+
+   while (pf_bg_worker_run_queued_job (net) == 0)
+   {
+   }
+   EXPECT_EQ (test_bg_job_log.number_of_runs, 5);
+   EXPECT_STREQ (test_bg_job_log.order, "cbda-");
+
+   /* Invalid arguments */
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_LOW,
+      NULL,
+      &payloads[0],
+      1);
+   EXPECT_EQ (res, -1);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_LOW,
+      test_bg_job_callback,
+      &payloads[0],
+      PF_BG_WORKER_MAX_PAYLOAD_SIZE + 1);
+   EXPECT_EQ (res, -1);
+   res = pf_bg_worker_queue_job (
+      net,
+      (pf_bg_job_priority_t)PF_BG_WORKER_NUMBER_OF_PRIORITIES,
+      test_bg_job_callback,
+      &payloads[0],
+      1);
+   EXPECT_EQ (res, -1);
+}
+
+TEST_F (BgWorkerTest, BgWorkerQueueIsBounded)
+{
+   const char payload = 'q';
+   uint16_t ix;
+   int res;
+
+   for (ix = 0; ix < PF_BG_WORKER_MAX_QUEUED_JOBS; ix++)
+   {
+      res = pf_bg_worker_queue_job (
+         net,
+         (pf_bg_job_priority_t)(ix % PF_BG_WORKER_NUMBER_OF_PRIORITIES),
+         test_bg_job_callback,
+         &payload,
+         sizeof (payload));
+      EXPECT_EQ (res, 0);
+   }
+
+   /* Queue full */
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_HIGH,
+      test_bg_job_callback,
+      &payload,
+      sizeof (payload));
+   EXPECT_EQ (res, -1);
+
+   /* Room again after running a job */
+   EXPECT_EQ (pf_bg_worker_run_queued_job (net), 0);
+   res = pf_bg_worker_queue_job (
+      net,
+      PF_BG_JOB_PRIORITY_HIGH,
+      test_bg_job_callback,
+      &payload,
+      sizeof (payload));
+   EXPECT_EQ (res, 0);
+
+   while (pf_bg_worker_run_queued_job (net) == 0)
+   {
+   }
+   EXPECT_EQ (test_bg_job_log.number_of_runs, PF_BG_WORKER_MAX_QUEUED_JOBS + 1);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (BgWorkerTest, DISABLED_BgWorkerEnqueueBenchmark)
+{
+   uint8_t payload[PF_BG_WORKER_MAX_PAYLOAD_SIZE] = {0};
+   const int rounds = 1000;
+   std::chrono::nanoseconds total (0);
+   std::chrono::nanoseconds worst (0);
+   std::chrono::nanoseconds elapsed;
+   uint16_t ix;
+   int round;
+   int res;
+
+   /* Queue jobs the way the cyclic context would, and measure the time
+    * spent in each call. The queue is emptied between the rounds.
+    */
+   for (round = 0; round < rounds; round++)
+   {
+      for (ix = 0; ix < PF_BG_WORKER_MAX_QUEUED_JOBS; ix++)
+      {
+         auto start = std::chrono::steady_clock::now();
+         res = pf_bg_worker_queue_job (
+            net,
+            PF_BG_JOB_PRIORITY_NORMAL,
+            test_bg_job_callback,
+            payload,
+            sizeof (payload));
+         elapsed = std::chrono::steady_clock::now() - start;
+         ASSERT_EQ (res, 0);
+
+         total += elapsed;
+         if (elapsed > worst)
+         {
+            worst = elapsed;
+         }
+      }
+      while (pf_bg_worker_run_queued_job (net) == 0)
+      {
+      }
+      test_bg_job_log.number_of_runs = 0;
+   }
+
+   std::cout << "Enqueue latency: average "
+             << total.count() / (rounds * PF_BG_WORKER_MAX_QUEUED_JOBS)
+             << " ns, worst " << worst.count() << " ns\n";
+}
@@ -21,6 +21,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 class BlockReaderUnitTest : public PnetUnitTest
 {
 };
@@ -111,3 +114,278 @@ TEST_F (BlockReaderUnitTest, BlockReaderTestGetBits)
    EXPECT_EQ (0ul, pf_get_bits (0x80000000, 32, 3)); /* Illegal position */
    EXPECT_EQ (0ul, pf_get_bits (0x80000000, 33, 3)); /* Illegal position */
 }
+
+TEST_F (BlockReaderUnitTest, BlockReaderTestGetUint)
+{
+   const uint8_t buffer[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+   pf_get_info_t get_info;
+   uint16_t pos = 0;
+
+   get_info.result = PF_PARSE_OK;
+   get_info.is_big_endian = true;
+   get_info.p_buf = buffer;
+   get_info.len = sizeof (buffer);
+
+   EXPECT_EQ (pf_get_uint16 (&get_info, &pos), 0x0102);
+   EXPECT_EQ (pf_get_uint32 (&get_info, &pos), 0x03040506ul);
+   EXPECT_EQ (pos, 6);
+   EXPECT_EQ (get_info.result, PF_PARSE_OK);
+
+   pos = 0;
+   get_info.is_big_endian = false;
+   EXPECT_EQ (pf_get_uint16 (&get_info, &pos), 0x0201);
+   EXPECT_EQ (pf_get_uint32 (&get_info, &pos), 0x06050403ul);
+   EXPECT_EQ (pos, 6);
+   EXPECT_EQ (get_info.result, PF_PARSE_OK);
+
+   /* Not enough data left */
+   EXPECT_EQ (pf_get_uint16 (&get_info, &pos), 0);
+   EXPECT_EQ (get_info.result, PF_PARSE_END_OF_INPUT);
+
+   /* Keep first error */
+   pos = 0;
+   EXPECT_EQ (pf_get_uint32 (&get_info, &pos), 0ul);
+   EXPECT_EQ (get_info.result, PF_PARSE_END_OF_INPUT);
+
+   pos = 4;
+   get_info.result = PF_PARSE_OK;
+   EXPECT_EQ (pf_get_uint32 (&get_info, &pos), 0ul);
+   EXPECT_EQ (get_info.result, PF_PARSE_END_OF_INPUT);
+}
+
+/**
+ * Write an ExpectedSubmoduleBlock with one module and
+ * PNET_MAX_SUBSLOTS input submodules.
+ *
+ * @param p_buf            Out:   Buffer to write to.
+ * @param slot             In:    Slot number.
+ * @return Number of bytes written.
+ */
+static uint16_t put_exp_submodule_block (uint8_t * p_buf, uint16_t slot)
+{
+   uint16_t pos = 0;
+   uint16_t ix;
+
+   p_buf[pos++] = 0x01; /* Block type ExpectedSubmoduleBlockReq */
+   p_buf[pos++] = 0x04;
+   pos += 2;            /* Block length, filled in below */
+   p_buf[pos++] = 0x01; /* Block version */
+   p_buf[pos++] = 0x00;
+   p_buf[pos++] = 0x00; /* Number of APIs */
+   p_buf[pos++] = 0x01;
+   memset (&p_buf[pos], 0, 4); /* API */
+   pos += 4;
+   p_buf[pos++] = slot >> 8;
+   p_buf[pos++] = slot & 0xFF;
+   memcpy (&p_buf[pos], "\x00\x00\x00\x32", 4); /* Module ident */
+   pos += 4;
+   p_buf[pos++] = 0x00; /* Module properties */
+   p_buf[pos++] = 0x00;
+   p_buf[pos++] = 0x00; /* Number of submodules */
+   p_buf[pos++] = PNET_MAX_SUBSLOTS;
+   for (ix = 0; ix < PNET_MAX_SUBSLOTS; ix++)
+   {
+      p_buf[pos++] = 0x00; /* Subslot */
+      p_buf[pos++] = ix + 1;
+      memcpy (&p_buf[pos], "\x00\x00\x01\x32", 4); /* Submodule ident */
+      pos += 4;
+      p_buf[pos++] = 0x00; /* Submodule properties: Input */
+      p_buf[pos++] = PNET_DIR_INPUT;
+      p_buf[pos++] = 0x00; /* Data description: Input */
+      p_buf[pos++] = 0x01;
+      p_buf[pos++] = 0x00; /* Data length */
+      p_buf[pos++] = 0x08;
+      p_buf[pos++] = 0x01; /* Length IOCS */
+      p_buf[pos++] = 0x01; /* Length IOPS */
+   }
+   p_buf[2] = (pos - 4) >> 8;
+   p_buf[3] = (pos - 4) & 0xFF;
+
+   return pos;
+}
+
+TEST_F (BlockReaderUnitTest, BlockReaderExpectedSubmoduleBlocks)
+{
+   const uint16_t nbr_blocks = 500;
+   static uint8_t buffer[60000];
+   static pf_ar_t ar;
+   pf_get_info_t get_info;
+   pf_block_header_t block_header;
+   uint16_t len = 0;
+   uint16_t pos = 0;
+   uint16_t ix;
+   uint32_t nbr_parsed = 0;
+
+   for (ix = 0; ix < nbr_blocks; ix++)
+   {
+      len += put_exp_submodule_block (&buffer[len], 1 + ix % 4);
+   }
+   ASSERT_LE (len, sizeof (buffer));
+
+   get_info.is_big_endian = true;
+   get_info.p_buf = buffer;
+   get_info.len = len;
+   get_info.result = PF_PARSE_OK;
+
+   while ((pos < len) && (get_info.result == PF_PARSE_OK))
+   {
+      pf_get_block_header (&get_info, &pos, &block_header);
+      memset (&ar.exp_ident, 0, sizeof (ar.exp_ident));
+      pf_get_exp_api_module (&get_info, &pos, &ar);
+      nbr_parsed++;
+   }
+
+   EXPECT_EQ (get_info.result, PF_PARSE_OK);
+   EXPECT_EQ (pos, len);
+   EXPECT_EQ (nbr_parsed, nbr_blocks);
+   EXPECT_EQ (ar.exp_ident.nbr_apis, 1);
+   EXPECT_EQ (ar.exp_ident.api[0].nbr_modules, 1);
+   EXPECT_EQ (ar.exp_ident.api[0].module[0].slot_number, 4);
+   EXPECT_EQ (ar.exp_ident.api[0].module[0].ident_number, 0x32ul);
+   EXPECT_EQ (ar.exp_ident.api[0].module[0].nbr_submodules, PNET_MAX_SUBSLOTS);
+   EXPECT_EQ (
+      ar.exp_ident.api[0].module[0].submodule[PNET_MAX_SUBSLOTS - 1]
+         .subslot_number,
+      PNET_MAX_SUBSLOTS);
+   EXPECT_EQ (
+      ar.exp_ident.api[0]
+         .module[0]
+         .submodule[0]
+         .data_descriptor[0]
+         .submodule_data_length,
+      8);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (BlockReaderUnitTest, DISABLED_BlockReaderExpectedSubmoduleBenchmark)
+{
+   /* A large Connect request body with hundreds of ExpectedSubmoduleBlocks */
+   const uint16_t nbr_blocks = 500;
+   const uint32_t rounds = 100;
+   static uint8_t buffer[60000];
+   static pf_ar_t ar;
+   pf_get_info_t get_info;
+   pf_block_header_t block_header;
+   uint16_t len = 0;
+   uint16_t pos;
+   uint16_t ix;
+   uint32_t round;
+   uint32_t nbr_parsed = 0;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration;
+
+   for (ix = 0; ix < nbr_blocks; ix++)
+   {
+      len += put_exp_submodule_block (&buffer[len], 1 + ix % 4);
+   }
+   ASSERT_LE (len, sizeof (buffer));
+
+   get_info.is_big_endian = true;
+   get_info.p_buf = buffer;
+   get_info.len = len;
+
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      get_info.result = PF_PARSE_OK;
+      pos = 0;
+      while ((pos < len) && (get_info.result == PF_PARSE_OK))
+      {
+         pf_get_block_header (&get_info, &pos, &block_header);
+         memset (&ar.exp_ident, 0, sizeof (ar.exp_ident));
+         pf_get_exp_api_module (&get_info, &pos, &ar);
+         nbr_parsed++;
+      }
+   }
+   duration = std::chrono::steady_clock::now() - start;
+
+   EXPECT_EQ (get_info.result, PF_PARSE_OK);
+   EXPECT_EQ (nbr_parsed, rounds * nbr_blocks);
+
+   std::cout << "ExpectedSubmoduleBlock parse time: average "
+             << duration.count() / nbr_parsed << " ns\n";
+}
+
+TEST_F (BlockReaderUnitTest, BlockReaderExpectedSubmoduleErrors)
+{
+   static uint8_t buffer[200];
+   static pf_ar_t ar;
+   pf_get_info_t get_info;
+   pf_block_header_t block_header;
+   uint16_t len;
+   uint16_t pos;
+
+   len = put_exp_submodule_block (buffer, 1);
+   get_info.is_big_endian = true;
+   get_info.p_buf = buffer;
+
+   /* Truncated block */
+   for (get_info.len = 0; get_info.len < len; get_info.len++)
+   {
+      get_info.result = PF_PARSE_OK;
+      pos = 0;
+      memset (&ar.exp_ident, 0, sizeof (ar.exp_ident));
+      pf_get_block_header (&get_info, &pos, &block_header);
+      pf_get_exp_api_module (&get_info, &pos, &ar);
+      EXPECT_EQ (get_info.result, PF_PARSE_END_OF_INPUT);
+   }
+
+   /* Too many submodules */
+   buffer[21] = PNET_MAX_SUBSLOTS + 1;
+   get_info.result = PF_PARSE_OK;
+   pos = 0;
+   memset (&ar.exp_ident, 0, sizeof (ar.exp_ident));
+   pf_get_block_header (&get_info, &pos, &block_header);
+   pf_get_exp_api_module (&get_info, &pos, &ar);
+   EXPECT_EQ (get_info.result, PF_PARSE_OUT_OF_EXP_SUBMODULE_RESOURCES);
+}
+
+#if PNET_OPTION_FAST_STARTUP
+TEST_F (BlockReaderUnitTest, BlockReaderArFsuRequest)
+{
+   uint8_t buffer[] = {
+      0x01, 0x0B, 0x00, 0x28, 0x01, 0x00, /* ARFSUBlockReq header */
+      0x00, 0x00,                         /* Padding */
+      0x06, 0x01, 0x00, 0x18, 0x01, 0x00, /* FSParameterBlock header */
+      0x00, 0x00,                         /* Padding */
+      0x00, 0x00, 0x00, 0x01,             /* FSParameterMode ON */
+      0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, /* FSParameterUUID */
+      0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00,
+      0x06, 0x07, 0x00, 0x04, 0x01, 0x00, /* Unknown sub-block header */
+      0x00, 0x00,                         /* Unknown sub-block data */
+   };
+   static pf_ar_t ar;
+   pf_get_info_t get_info;
+   pf_block_header_t block_header;
+   uint16_t pos = 0;
+
+   get_info.result = PF_PARSE_OK;
+   get_info.is_big_endian = true;
+   get_info.p_buf = buffer;
+   get_info.len = sizeof (buffer);
+
+   pf_get_block_header (&get_info, &pos, &block_header);
+   pf_get_ar_fsu_request (&get_info, &pos, block_header.block_length, &ar);
+   EXPECT_EQ (get_info.result, PF_PARSE_OK);
+   EXPECT_EQ (pos, sizeof (buffer));
+   EXPECT_TRUE (ar.fast_startup_data.valid);
+   EXPECT_EQ (
+      ar.fast_startup_data.fs_parameter_block.fs_parameter_mode,
+      (uint32_t)PF_FS_PARAMETER_MODE_ON);
+   EXPECT_EQ (
+      ar.fast_startup_data.fs_parameter_block.fs_parameter_uuid.data1,
+      0x11223344ul);
+   EXPECT_EQ (
+      ar.fast_startup_data.fs_parameter_block.fs_parameter_uuid.data4[7],
+      0x00);
+
+   /* Sub-block longer than the block */
+   buffer[11] = 0x30;
+   get_info.result = PF_PARSE_OK;
+   pos = 0;
+   pf_get_block_header (&get_info, &pos, &block_header);
+   pf_get_ar_fsu_request (&get_info, &pos, block_header.block_length, &ar);
+   EXPECT_EQ (get_info.result, PF_PARSE_ERROR);
+   EXPECT_FALSE (ar.fast_startup_data.valid);
+}
+#endif
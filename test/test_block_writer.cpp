@@ -0,0 +1,243 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2021 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#include "utils_for_testing.h"
+#include "mocks.h"
+
+#include "pf_block_writer.h"
+#include "pf_includes.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+class BlockWriterUnitTest : public PnetUnitTest
+{
+};
+
+class BlockWriterTest : public PnetIntegrationTest
+{
+};
+
+/**
+ * Fill in expected identification where all submodules differ from
+ * the real identification.
+ *
+ * @param p_ar             Out:   AR with expected identification.
+ */
+static void set_module_diff (pf_ar_t * p_ar)
+{
+   pf_exp_api_t * p_api = &p_ar->exp_ident.api[0];
+   pf_exp_module_t * p_module;
+   uint16_t slot;
+   uint16_t subslot;
+
+   memset (&p_ar->exp_ident, 0, sizeof (p_ar->exp_ident));
+   p_ar->exp_ident.nbr_apis = 1;
+   p_ar->exp_ident.nbr_diff_apis = 1;
+   p_api->valid = true;
+   p_api->nbr_modules = PNET_MAX_SLOTS;
+   p_api->nbr_diff_modules = PNET_MAX_SLOTS;
+   for (slot = 0; slot < PNET_MAX_SLOTS; slot++)
+   {
+      p_module = &p_api->module[slot];
+      p_module->slot_number = slot;
+      p_module->ident_number = 0x30 + slot;
+      p_module->state = PF_MODULE_STATE_PROPER_MODULE;
+      p_module->nbr_submodules = PNET_MAX_SUBSLOTS;
+      p_module->nbr_diff_submodules = PNET_MAX_SUBSLOTS;
+      p_api->diff_module[slot] = slot;
+      for (subslot = 0; subslot < PNET_MAX_SUBSLOTS; subslot++)
+      {
+         p_module->submodule[subslot].subslot_number = subslot + 1;
+         p_module->submodule[subslot].ident_number = 0x130 + subslot;
+         p_module->submodule[subslot].state.ident_info = PF_IDENT_INFO_WRONG;
+         p_module->diff_submodule[subslot] = subslot;
+      }
+   }
+}
+
+TEST_F (BlockWriterUnitTest, BlockWriterPutUint)
+{
+   uint8_t buffer[7];
+   uint16_t pos = 0;
+
+   memset (buffer, 0xAA, sizeof (buffer));
+   pf_put_uint16 (true, 0x0102, sizeof (buffer), buffer, &pos);
+   pf_put_uint32 (false, 0x03040506, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, 6);
+   EXPECT_EQ (buffer[0], 0x01);
+   EXPECT_EQ (buffer[1], 0x02);
+   EXPECT_EQ (buffer[2], 0x06);
+   EXPECT_EQ (buffer[3], 0x05);
+   EXPECT_EQ (buffer[4], 0x04);
+   EXPECT_EQ (buffer[5], 0x03);
+
+   /* Does not fit. Nothing is written. */
+   pf_put_uint16 (true, 0x0708, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, 6);
+   EXPECT_EQ (buffer[6], 0xAA);
+
+   pf_put_padding (1, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, 7);
+   EXPECT_EQ (buffer[6], 0x00);
+
+   pos = 0;
+   pf_put_uint32 (true, 0x01020304, sizeof (buffer), NULL, &pos);
+   EXPECT_EQ (pos, 0);
+
+   pos = 1;
+   pf_put_padding_align (0, 4, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, 4);
+   pf_put_padding_align (0, 4, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, 4);
+}
+
+TEST_F (BlockWriterUnitTest, BlockWriterModuleDiffBlockLength)
+{
+   static pf_ar_t ar;
+   uint8_t buffer[PNET_MAX_SESSION_BUFFER_SIZE];
+   uint16_t pos = 0;
+   uint16_t expected_len;
+
+   set_module_diff (&ar);
+   expected_len = 6 + 2 + 4 + 2 +
+                  PNET_MAX_SLOTS * (2 + 4 + 2 + 2 + PNET_MAX_SUBSLOTS * 8);
+
+   pf_put_ar_diff (true, &ar, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, expected_len);
+   EXPECT_EQ (buffer[0], 0x81); /* ModuleDiffBlock */
+   EXPECT_EQ (buffer[1], 0x04);
+   EXPECT_EQ (buffer[2], (expected_len - 4) >> 8);
+   EXPECT_EQ (buffer[3], (expected_len - 4) & 0xFF);
+
+   pos = 0;
+   pf_put_ar_diff (false, &ar, sizeof (buffer), buffer, &pos);
+   EXPECT_EQ (pos, expected_len);
+   EXPECT_EQ (buffer[0], 0x04);
+   EXPECT_EQ (buffer[1], 0x81);
+   EXPECT_EQ (buffer[2], (expected_len - 4) & 0xFF);
+   EXPECT_EQ (buffer[3], (expected_len - 4) >> 8);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (BlockWriterTest, DISABLED_BlockWriterEncodeBenchmark)
+{
+   const uint32_t rounds = 10000;
+   static pf_ar_t ar;
+   static pf_port_t port_data;
+   static pf_lldp_station_name_t station_name;
+   static pf_lldp_port_name_t port_name;
+   static pnal_eth_status_t eth_status;
+   static pnal_port_stats_t port_statistics;
+   static uint8_t buffer[PNET_MAX_SESSION_BUFFER_SIZE];
+   uint16_t pos;
+   uint16_t slot;
+   uint16_t subslot;
+   uint32_t round;
+   uint32_t total_bytes;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration;
+
+   set_module_diff (&ar);
+   for (slot = 1; slot < PNET_MAX_SLOTS; slot++)
+   {
+      for (subslot = 1; subslot <= PNET_MAX_SUBSLOTS; subslot++)
+      {
+         EXPECT_EQ (
+            pf_cmdev_plug_submodule (
+               net,
+               0,
+               slot,
+               subslot,
+               TEST_MOD_8_8_IDENT,
+               0x100 + subslot,
+               PNET_DIR_IO,
+               1,
+               1,
+               false),
+            0);
+      }
+   }
+
+   /* ModuleDiffBlock */
+   total_bytes = 0;
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      pos = 0;
+      pf_put_ar_diff (true, &ar, sizeof (buffer), buffer, &pos);
+      total_bytes += pos;
+   }
+   duration = std::chrono::steady_clock::now() - start;
+   EXPECT_GT (pos, 0);
+   std::cout << "ModuleDiffBlock encode: " << pos << " bytes, average "
+             << duration.count() / rounds << " ns, "
+             << (total_bytes * 1000) / duration.count() << " MB/s\n";
+
+   /* RealIdentificationData */
+   total_bytes = 0;
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      pos = 0;
+      pf_put_real_ident_data (
+         net,
+         true,
+         PNET_BLOCK_VERSION_LOW_1,
+         PF_RECORD_DATA_SCOPE_API,
+         NULL,
+         0,
+         0,
+         0,
+         sizeof (buffer),
+         buffer,
+         &pos);
+      total_bytes += pos;
+   }
+   duration = std::chrono::steady_clock::now() - start;
+   EXPECT_GT (pos, 0);
+   std::cout << "RealIdentificationData encode: " << pos << " bytes, average "
+             << duration.count() / rounds << " ns, "
+             << (total_bytes * 1000) / duration.count() << " MB/s\n";
+
+   /* PDPort multiblock */
+   total_bytes = 0;
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      pos = 0;
+      pf_put_pd_multiblock_port_and_statistics (
+         true,
+         0,
+         PNET_SUBSLOT_DAP_INTERFACE_1_PORT_1_IDENT,
+         &station_name,
+         &port_name,
+         &port_data,
+         PF_PD_MEDIATYPE_COPPER,
+         &eth_status,
+         &port_statistics,
+         sizeof (buffer),
+         buffer,
+         &pos);
+      total_bytes += pos;
+   }
+   duration = std::chrono::steady_clock::now() - start;
+   EXPECT_GT (pos, 0);
+   std::cout << "PDPort multiblock encode: " << pos << " bytes, average "
+             << duration.count() / rounds << " ns, "
+             << (total_bytes * 1000) / duration.count() << " MB/s\n";
+}
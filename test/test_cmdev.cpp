@@ -26,10 +26,18 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <vector>
+
 class CmdevUnitTest : public PnetUnitTest
 {
 };
 
+class CmdevTest : public PnetIntegrationTest
+{
+};
+
 TEST_F (CmdevUnitTest, CmdevCalculateDatadirectionInDescriptor)
 {
    pf_data_direction_values_t resulting_direction;
@@ -385,6 +393,91 @@ TEST_F (CmdevUnitTest, CmdevCheckNoStraddle)
       pf_cmdev_check_no_straddle (0xFFFF, length_b, start_a, length_a));
 }
 
+TEST_F (CmdevUnitTest, CmdevCheckIocrDataDesc)
+{
+   pf_iodata_object_t data_desc[3];
+   pnet_result_t stat;
+
+   /* Submodule with inputs, submodule with outputs and a DAP submodule */
+   memset (data_desc, 0, sizeof (data_desc));
+   data_desc[0].data_offset = 0;
+   data_desc[0].data_length = 4;
+   data_desc[0].iops_offset = 4;
+   data_desc[0].iops_length = 1;
+   data_desc[1].iocs_offset = 5;
+   data_desc[1].iocs_length = 1;
+   data_desc[2].data_offset = 6;
+   data_desc[2].iops_offset = 6;
+   data_desc[2].iops_length = 1;
+   memset (&stat, 0, sizeof (stat));
+   EXPECT_EQ (pf_cmdev_check_iocr_data_desc (data_desc, 3, 40, &stat), 0);
+   EXPECT_EQ (stat.pnio_status.error_code_2, 0);
+
+   /* Outside the C_SDU */
+   EXPECT_EQ (pf_cmdev_check_iocr_data_desc (data_desc, 3, 6, &stat), -1);
+   EXPECT_EQ (
+      stat.pnio_status.error_code_1,
+      PNET_ERROR_CODE_1_CONN_FAULTY_IOCR_BLOCK_REQ);
+   EXPECT_EQ (stat.pnio_status.error_code_2, 24);
+   EXPECT_EQ (pf_cmdev_check_iocr_data_desc (data_desc, 2, 5, &stat), -1);
+   EXPECT_EQ (stat.pnio_status.error_code_2, 28);
+
+   /* Data overlaps the IOPS of a previous data_desc */
+   data_desc[2].data_offset = 4;
+   data_desc[2].data_length = 1;
+   EXPECT_EQ (pf_cmdev_check_iocr_data_desc (data_desc, 3, 40, &stat), -1);
+   EXPECT_EQ (stat.pnio_status.error_code_2, 24);
+
+   /* IOCS overlaps the data of a previous data_desc */
+   data_desc[2].data_length = 0;
+   data_desc[1].iocs_offset = 3;
+   EXPECT_EQ (pf_cmdev_check_iocr_data_desc (data_desc, 3, 40, &stat), -1);
+   EXPECT_EQ (stat.pnio_status.error_code_2, 28);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (CmdevUnitTest, DISABLED_CmdevCheckIocrDataDescBenchmark)
+{
+   const uint16_t nbr_data_desc[] = {16, 128, 512};
+   const uint32_t rounds = 200;
+   static pf_iodata_object_t data_desc[512];
+   pnet_result_t stat;
+   uint16_t ix;
+   uint16_t iy;
+   uint32_t round;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration;
+
+   /* One byte of data and one IOPS byte per submodule */
+   for (ix = 0; ix < NELEMENTS (data_desc); ix++)
+   {
+      data_desc[ix].data_offset = 2 * ix;
+      data_desc[ix].data_length = 1;
+      data_desc[ix].iops_offset = 2 * ix + 1;
+      data_desc[ix].iops_length = 1;
+   }
+
+   for (iy = 0; iy < NELEMENTS (nbr_data_desc); iy++)
+   {
+      start = std::chrono::steady_clock::now();
+      for (round = 0; round < rounds; round++)
+      {
+         ASSERT_EQ (
+            pf_cmdev_check_iocr_data_desc (
+               data_desc,
+               nbr_data_desc[iy],
+               PF_CMDEV_MAX_C_SDU_LENGTH,
+               &stat),
+            0);
+      }
+      duration = std::chrono::steady_clock::now() - start;
+
+      std::cout << "IOCR check with " << nbr_data_desc[iy]
+                << " data_desc: average " << duration.count() / rounds
+                << " ns\n";
+   }
+}
+
 TEST_F (CmdevUnitTest, CmdevCheckArType)
 {
    int ret;
@@ -406,3 +499,549 @@ TEST_F (CmdevUnitTest, CmdevCheckArType)
    ret = pf_cmdev_check_ar_type (0xFFFF);
    EXPECT_EQ (-1, ret);
 }
+
+TEST_F (CmdevUnitTest, CmdevLookupIndex)
+{
+   uint16_t numbers[8];
+   uint16_t positions[8];
+   uint16_t count = 0;
+   uint16_t ix;
+   int ret;
+
+   ret = pf_cmdev_index_find (numbers, count, 3, &ix);
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (ix, 0);
+
+   /* Insert in any order */
+   EXPECT_EQ (pf_cmdev_index_insert (numbers, positions, &count, 8, 30, 0), 0);
+   EXPECT_EQ (pf_cmdev_index_insert (numbers, positions, &count, 8, 10, 1), 0);
+   EXPECT_EQ (pf_cmdev_index_insert (numbers, positions, &count, 8, 20, 2), 0);
+   EXPECT_EQ (
+      pf_cmdev_index_insert (numbers, positions, &count, 8, 0x8001, 3),
+      0);
+   EXPECT_EQ (count, 4);
+   EXPECT_EQ (numbers[0], 10);
+   EXPECT_EQ (numbers[1], 20);
+   EXPECT_EQ (numbers[2], 30);
+   EXPECT_EQ (numbers[3], 0x8001);
+
+   /* Duplicate */
+   EXPECT_EQ (pf_cmdev_index_insert (numbers, positions, &count, 8, 20, 4), -1);
+   EXPECT_EQ (count, 4);
+
+   ret = pf_cmdev_index_find (numbers, count, 20, &ix);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (positions[ix], 2);
+   ret = pf_cmdev_index_find (numbers, count, 0x8001, &ix);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (positions[ix], 3);
+   ret = pf_cmdev_index_find (numbers, count, 25, &ix);
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (ix, 2);
+
+   /* Remove */
+   EXPECT_EQ (pf_cmdev_index_remove (numbers, positions, &count, 20), 0);
+   EXPECT_EQ (pf_cmdev_index_remove (numbers, positions, &count, 20), -1);
+   EXPECT_EQ (count, 3);
+   EXPECT_EQ (pf_cmdev_index_find (numbers, count, 20, &ix), -1);
+   EXPECT_EQ (pf_cmdev_index_find (numbers, count, 30, &ix), 0);
+   EXPECT_EQ (positions[ix], 0);
+
+   /* Full */
+   count = 0;
+   for (ix = 0; ix < 8; ix++)
+   {
+      EXPECT_EQ (
+         pf_cmdev_index_insert (numbers, positions, &count, 8, 100 - ix, ix),
+         0);
+   }
+   EXPECT_EQ (pf_cmdev_index_insert (numbers, positions, &count, 8, 1, 0), -1);
+   EXPECT_EQ (count, 8);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (CmdevUnitTest, DISABLED_CmdevLookupIndexBenchmark)
+{
+   /* A device with 64 slots, each with 32 subslots */
+   const uint16_t nbr_slots = 64;
+   const uint16_t nbr_subslots = 32;
+   const uint32_t rounds = 200;
+   static uint16_t slot_numbers[64];
+   static uint16_t slot_positions[64];
+   static uint16_t subslot_numbers[64][32];
+   static uint16_t subslot_positions[64][32];
+   uint16_t slot_count = 0;
+   uint16_t subslot_count[64] = {0};
+   uint16_t slot;
+   uint16_t subslot;
+   uint16_t ix;
+   uint16_t jx;
+   uint32_t round;
+   uint32_t found = 0;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration;
+
+   for (slot = 0; slot < nbr_slots; slot++)
+   {
+      ASSERT_EQ (
+         pf_cmdev_index_insert (
+            slot_numbers,
+            slot_positions,
+            &slot_count,
+            nbr_slots,
+            nbr_slots - 1 - slot,
+            slot),
+         0);
+      for (subslot = 0; subslot < nbr_subslots; subslot++)
+      {
+         ASSERT_EQ (
+            pf_cmdev_index_insert (
+               subslot_numbers[slot],
+               subslot_positions[slot],
+               &subslot_count[slot],
+               nbr_subslots,
+               0x8000 + subslot,
+               subslot),
+            0);
+      }
+   }
+
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      for (slot = 0; slot < nbr_slots; slot++)
+      {
+         for (subslot = 0; subslot < nbr_subslots; subslot++)
+         {
+            if (
+               (pf_cmdev_index_find (
+                   slot_numbers,
+                   slot_count,
+                   slot,
+                   &ix) == 0) &&
+               (pf_cmdev_index_find (
+                   subslot_numbers[slot_positions[ix]],
+                   subslot_count[slot_positions[ix]],
+                   0x8000 + subslot,
+                   &jx) == 0))
+            {
+               found++;
+            }
+         }
+      }
+   }
+   duration = std::chrono::steady_clock::now() - start;
+
+   EXPECT_EQ (found, rounds * nbr_slots * nbr_subslots);
+   std::cout << "Subslot lookup time: average "
+             << duration.count() / found << " ns\n";
+}
+
+TEST_F (CmdevTest, CmdevPlugPullLookup)
+{
+   pf_api_t * p_api = NULL;
+   pf_slot_t * p_slot = NULL;
+   pf_subslot_t * p_subslot = NULL;
+   int ret;
+
+   ret = pf_cmdev_get_api (net, TEST_API_IDENT, &p_api);
+   ASSERT_EQ (ret, 0);
+
+   /* Plug in descending slot and subslot order */
+   ret = pf_cmdev_plug_submodule (
+      net,
+      TEST_API_IDENT,
+      3,
+      2,
+      TEST_MOD_8_8_IDENT,
+      0x00000222,
+      PNET_DIR_IO,
+      1,
+      1,
+      false);
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_plug_submodule (
+      net,
+      TEST_API_IDENT,
+      3,
+      1,
+      TEST_MOD_8_8_IDENT,
+      0x00000111,
+      PNET_DIR_IO,
+      1,
+      1,
+      false);
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_plug_module (net, TEST_API_IDENT, 2, TEST_MOD_8_0_IDENT);
+   EXPECT_EQ (ret, 0);
+
+   ret = pf_cmdev_get_slot (p_api, 2, &p_slot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_slot->ident_number, TEST_MOD_8_0_IDENT);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 1, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x00000111u);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 2, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x00000222u);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 3, &p_subslot);
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (p_subslot, nullptr);
+
+   /* Pull and plug again */
+   (void)pf_cmdev_pull_submodule (net, TEST_API_IDENT, 3, 1);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 1, &p_subslot);
+   EXPECT_EQ (ret, -1);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 2, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x00000222u);
+
+   ret = pf_cmdev_plug_submodule (
+      net,
+      TEST_API_IDENT,
+      3,
+      1,
+      TEST_MOD_8_8_IDENT,
+      0x00000333,
+      PNET_DIR_IO,
+      1,
+      1,
+      false);
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 3, 1, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x00000333u);
+
+   ret = pf_cmdev_pull_module (net, TEST_API_IDENT, 2);
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_slot (p_api, 2, &p_slot);
+   EXPECT_EQ (ret, -1);
+   ret = pf_cmdev_get_slot (p_api, 3, &p_slot);
+   EXPECT_EQ (ret, 0);
+}
+
+static pnet_config_change_t config_change (
+   pnet_config_change_type_t type,
+   uint16_t slot,
+   uint16_t subslot,
+   uint32_t module_ident,
+   uint32_t submodule_ident)
+{
+   pnet_config_change_t change;
+
+   memset (&change, 0, sizeof (change));
+   change.type = type;
+   change.api = TEST_API_IDENT;
+   change.slot = slot;
+   change.subslot = subslot;
+   change.module_ident = module_ident;
+   change.submodule_ident = submodule_ident;
+   change.direction = PNET_DIR_IO;
+   change.length_input = 1;
+   change.length_output = 1;
+
+   return change;
+}
+
+TEST_F (CmdevTest, CmdevApplyConfigChanges)
+{
+   pf_api_t * p_api = NULL;
+   pf_slot_t * p_slot = NULL;
+   pf_subslot_t * p_subslot = NULL;
+   std::vector<pnet_config_change_t> changes;
+   uint32_t version;
+   uint16_t ix;
+   int ret;
+
+   ret = pf_cmdev_get_api (net, TEST_API_IDENT, &p_api);
+   ASSERT_EQ (ret, 0);
+
+   /* Plug, with auto-plug of the module in slot 2 */
+   changes = {
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_MODULE,
+         1,
+         0,
+         TEST_MOD_8_8_IDENT,
+         0),
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         1,
+         1,
+         TEST_MOD_8_8_IDENT,
+         0x111),
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         1,
+         2,
+         TEST_MOD_8_8_IDENT,
+         0x112),
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         2,
+         1,
+         TEST_MOD_8_0_IDENT,
+         0x211),
+   };
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_slot (p_api, 2, &p_slot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_slot->ident_number, TEST_MOD_8_0_IDENT);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 2, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x112u);
+
+   /* Invalid entry in the middle. Nothing is changed */
+   version = net->cmdev_device.real_ident_version;
+   changes = {
+      config_change (PNET_CONFIG_CHANGE_PULL_MODULE, 1, 0, 0, 0),
+      config_change (PNET_CONFIG_CHANGE_PULL_SUBMODULE, 2, 9, 0, 0),
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         3,
+         1,
+         TEST_MOD_8_8_IDENT,
+         0x311),
+   };
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (net->cmdev_device.real_ident_version, version);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 1, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_slot (p_api, 3, &p_slot);
+   EXPECT_EQ (ret, -1);
+
+   /* Sub-module pulled together with its module */
+   changes[1] = config_change (PNET_CONFIG_CHANGE_PULL_SUBMODULE, 1, 1, 0, 0);
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+
+   /* Wrong ident for a sub-module that stays plugged */
+   changes[1] = config_change (
+      PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+      2,
+      1,
+      TEST_MOD_8_0_IDENT,
+      0x999);
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+
+   /* Wrong module ident for a sub-module in a plugged module */
+   changes[1] = config_change (
+      PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+      2,
+      2,
+      TEST_MOD_8_8_IDENT,
+      0x212);
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+
+   /* Wrong module ident for a sub-module in a module plugged by the same
+    * configuration change list */
+   changes[1] = config_change (
+      PNET_CONFIG_CHANGE_PLUG_MODULE,
+      3,
+      0,
+      TEST_MOD_8_0_IDENT,
+      0);
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (net->cmdev_device.real_ident_version, version);
+
+   /* Not sorted by slot */
+   changes[1] = changes[0];
+   changes[0] = changes[2];
+   changes.pop_back();
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+   EXPECT_EQ (net->cmdev_device.real_ident_version, version);
+
+   /* Replace the module in slot 1. Pulls are done before plugs */
+   changes = {
+      config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         1,
+         1,
+         TEST_MOD_0_8_IDENT,
+         0x121),
+      config_change (PNET_CONFIG_CHANGE_PULL_MODULE, 1, 0, 0, 0),
+      config_change (PNET_CONFIG_CHANGE_PULL_SUBMODULE, 2, 1, 0, 0),
+   };
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_slot (p_api, 1, &p_slot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_slot->ident_number, TEST_MOD_0_8_IDENT);
+   EXPECT_EQ (p_slot->subslot_index_count, 1);
+   ret = pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 1, &p_subslot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_subslot->ident_number, 0x121u);
+   ret = pf_cmdev_get_slot (p_api, 2, &p_slot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_slot->subslot_index_count, 0);
+
+   /* Out of slot resources */
+   changes.clear();
+   for (ix = 0; ix < PNET_MAX_SLOTS; ix++)
+   {
+      changes.push_back (config_change (
+         PNET_CONFIG_CHANGE_PLUG_MODULE,
+         100 + ix,
+         0,
+         TEST_MOD_8_8_IDENT,
+         0));
+   }
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+   ret = pf_cmdev_get_slot (p_api, 100, &p_slot);
+   EXPECT_EQ (ret, -1);
+
+   /* Out of subslot resources */
+   changes.clear();
+   for (ix = 0; ix <= PNET_MAX_SUBSLOTS; ix++)
+   {
+      changes.push_back (config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         2,
+         1 + ix,
+         TEST_MOD_8_0_IDENT,
+         0x211));
+   }
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, -1);
+   changes.pop_back();
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, 0);
+   ret = pf_cmdev_get_slot (p_api, 2, &p_slot);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_slot->subslot_index_count, PNET_MAX_SUBSLOTS);
+}
+
+TEST_F (CmdevTest, CmdevApplyConfigChangesPullAlarms)
+{
+   pf_ar_t ar_module_alarm;
+   pf_ar_t ar_submodule_alarms;
+   pf_subslot_t * p_subslot = NULL;
+   std::vector<pnet_config_change_t> changes;
+   uint16_t subslot;
+   int ret;
+
+   memset (&ar_module_alarm, 0, sizeof (ar_module_alarm));
+   memset (&ar_submodule_alarms, 0, sizeof (ar_submodule_alarms));
+   ar_module_alarm.ar_param.ar_properties.pull_module_alarm_allowed = true;
+   ar_submodule_alarms.ar_param.ar_properties.pull_module_alarm_allowed =
+      false;
+
+   for (subslot = 1; subslot <= 3; subslot++)
+   {
+      changes.push_back (config_change (
+         PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+         1,
+         subslot,
+         TEST_MOD_8_8_IDENT,
+         0x110 + subslot));
+   }
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   ASSERT_EQ (ret, 0);
+
+   /* Sub-slots 1 and 2 belong to an AR that allows pull module alarms,
+    * sub-slot 3 to an AR that does not. */
+   for (subslot = 1; subslot <= 3; subslot++)
+   {
+      ret = pf_cmdev_get_subslot_full (
+         net,
+         TEST_API_IDENT,
+         1,
+         subslot,
+         &p_subslot);
+      ASSERT_EQ (ret, 0);
+      p_subslot->ownsm_state = PF_OWNSM_STATE_IOC;
+      p_subslot->owner =
+         (subslot <= 2) ? &ar_module_alarm : &ar_submodule_alarms;
+   }
+
+   changes = {config_change (PNET_CONFIG_CHANGE_PULL_MODULE, 1, 0, 0, 0)};
+   ret = pnet_apply_config_changes (net, changes.data(), changes.size());
+   EXPECT_EQ (ret, 0);
+
+   ASSERT_EQ (mock_alarm_data.pull_count, 2);
+   EXPECT_EQ (mock_alarm_data.pull_ar[0], &ar_submodule_alarms);
+   EXPECT_EQ (mock_alarm_data.pull_slot[0], 1);
+   EXPECT_EQ (mock_alarm_data.pull_subslot[0], 3);
+   EXPECT_EQ (mock_alarm_data.pull_ar[1], &ar_module_alarm);
+   EXPECT_EQ (mock_alarm_data.pull_slot[1], 1);
+   EXPECT_EQ (mock_alarm_data.pull_subslot[1], 0);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (CmdevTest, DISABLED_CmdevApplyConfigChangesBenchmark)
+{
+   const uint16_t nbr_slots = PNET_MAX_SLOTS - 1; /* Slot 0 holds the DAP */
+   const uint16_t rounds = 100;
+   std::vector<pnet_config_change_t> plug;
+   std::vector<pnet_config_change_t> pull;
+   std::chrono::nanoseconds individual (0);
+   std::chrono::nanoseconds bulk (0);
+   std::chrono::steady_clock::time_point start;
+   uint16_t round;
+   uint16_t slot;
+   uint16_t subslot;
+
+   for (slot = 1; slot <= nbr_slots; slot++)
+   {
+      pull.push_back (
+         config_change (PNET_CONFIG_CHANGE_PULL_MODULE, slot, 0, 0, 0));
+      for (subslot = 1; subslot <= PNET_MAX_SUBSLOTS; subslot++)
+      {
+         plug.push_back (config_change (
+            PNET_CONFIG_CHANGE_PLUG_SUBMODULE,
+            slot,
+            subslot,
+            TEST_MOD_8_8_IDENT,
+            0x100 + subslot));
+      }
+   }
+
+   for (round = 0; round < rounds; round++)
+   {
+      start = std::chrono::steady_clock::now();
+      for (const pnet_config_change_t & change : plug)
+      {
+         (void)pnet_plug_submodule (
+            net,
+            change.api,
+            change.slot,
+            change.subslot,
+            change.module_ident,
+            change.submodule_ident,
+            change.direction,
+            change.length_input,
+            change.length_output);
+      }
+      for (const pnet_config_change_t & change : plug)
+      {
+         /* Returns -1 for sub-modules without owner */
+         (void)pnet_pull_submodule (
+            net,
+            change.api,
+            change.slot,
+            change.subslot);
+      }
+      for (const pnet_config_change_t & change : pull)
+      {
+         EXPECT_EQ (pnet_pull_module (net, change.api, change.slot), 0);
+      }
+      individual += std::chrono::steady_clock::now() - start;
+
+      start = std::chrono::steady_clock::now();
+      EXPECT_EQ (pnet_apply_config_changes (net, plug.data(), plug.size()), 0);
+      EXPECT_EQ (pnet_apply_config_changes (net, pull.data(), pull.size()), 0);
+      bulk += std::chrono::steady_clock::now() - start;
+   }
+
+   std::cout << "Individual plug/pull of " << nbr_slots
+             << " slots: average " << individual.count() / rounds << " ns\n";
+   std::cout << "Bulk plug/pull of " << nbr_slots << " slots: average "
+             << bulk.count() / rounds << " ns\n";
+}
@@ -24,6 +24,7 @@
  *  Timeout in CPM
  *  Fragmented connect
  *  ConnectReleaseIOSAR_DA ?
+ *  Reconnect with an identical connect request
  */
 
 #include "utils_for_testing.h"
@@ -33,6 +34,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 class CmrpcUnitTest : public PnetUnitTest
 {
 };
@@ -421,6 +425,89 @@ TEST_F (CmrpcTest, CmrpcConnectReleaseTest)
    EXPECT_EQ (mock_os_data.udp_sendto_len, 132);
 }
 
+TEST_F (CmrpcTest, CmrpcFrameIdAllocationTest)
+{
+   pf_ar_t * p_ar = NULL;
+   uint32_t * p_pool =
+      net->cmdev_device.frame_id_pool[PF_FRAME_ID_POOL_RT_CLASS_2];
+
+   /* The controller uses 0x8001 for the input CR, and lets the device
+      choose the frame ID for the output CR */
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   ASSERT_EQ (pf_ar_find_by_arep (net, appdata.main_arep, &p_ar), 0);
+   ASSERT_EQ (p_ar->nbr_iocrs, 2);
+   EXPECT_EQ (p_ar->iocrs[0].param.frame_id, 0x8001);
+   EXPECT_EQ (p_ar->iocrs[1].param.frame_id, 0x8000);
+   EXPECT_EQ (p_ar->iocrs[1].result.frame_id, 0x8000);
+   EXPECT_EQ (p_pool[0], 0x00000003u);
+
+   /* Frame IDs are returned to the pool when the AR is released */
+   mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+   EXPECT_EQ (p_pool[0], 0x00000000u);
+
+   /* The same frame ID is used again */
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   ASSERT_EQ (pf_ar_find_by_arep (net, appdata.main_arep, &p_ar), 0);
+   EXPECT_EQ (p_ar->iocrs[1].param.frame_id, 0x8000);
+   EXPECT_EQ (p_pool[0], 0x00000003u);
+}
+
+TEST_F (CmrpcTest, CmrpcStartupTimelineTest)
+{
+   pnet_ar_startup_timeline_t timeline;
+   uint32_t ix;
+
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (
+      pnet_get_ar_startup_timeline (net, appdata.main_arep, &timeline),
+      0);
+   EXPECT_EQ (
+      timeline.reached_phases,
+      BIT (PNET_AR_STARTUP_CONNECT_RECEIVED) |
+         BIT (PNET_AR_STARTUP_CONNECT_PARSED) |
+         BIT (PNET_AR_STARTUP_CONNECT_CHECKED) |
+         BIT (PNET_AR_STARTUP_CONNECT_IND_DONE) |
+         BIT (PNET_AR_STARTUP_CONNECT_RESPONSE));
+
+   mock_set_pnal_udp_recvfrom_buffer (write_req, sizeof (write_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (prm_end_req, sizeof (prm_end_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (pnet_application_ready (net, appdata.main_arep), 0);
+   mock_set_pnal_udp_recvfrom_buffer (appl_rdy_rsp, sizeof (appl_rdy_rsp));
+   run_stack (TEST_UDP_DELAY);
+   for (ix = 0; ix < 100; ix++)
+   {
+      send_data (data_packet, sizeof (data_packet));
+      run_stack (TEST_DATA_DELAY);
+   }
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+
+   EXPECT_EQ (
+      pnet_get_ar_startup_timeline (net, appdata.main_arep, &timeline),
+      0);
+   EXPECT_EQ (
+      timeline.reached_phases,
+      BIT (PNET_AR_STARTUP_NUMBER_OF_PHASES) - 1);
+   for (ix = 1; ix < PNET_AR_STARTUP_NUMBER_OF_PHASES; ix++)
+   {
+      EXPECT_GE (timeline.timestamp_us[ix], timeline.timestamp_us[ix - 1]);
+   }
+
+   /* The write request is handled between connect response and PrmEnd */
+   EXPECT_GE (
+      timeline.timestamp_us[PNET_AR_STARTUP_PRMEND_RECEIVED] -
+         timeline.timestamp_us[PNET_AR_STARTUP_CONNECT_RESPONSE],
+      (uint32_t)TEST_UDP_DELAY);
+
+   EXPECT_EQ (pnet_get_ar_startup_timeline (net, 0x1234, &timeline), -1);
+}
+
 TEST_F (CmrpcTest, CmrpcConnectionTimeoutTest)
 {
    int ret;
@@ -672,6 +759,179 @@ TEST_F (CmrpcTest, CmrpcConnectReleaseIOSAR_DA)
    EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
 }
 
+/* Outcome of a connect request, for comparing the full and the cached path */
+typedef struct connect_outcome
+{
+   uint16_t nbr_iocrs;
+   uint16_t in_length[PNET_MAX_CR];
+   uint16_t out_length[PNET_MAX_CR];
+   uint16_t nbr_data_desc[PNET_MAX_CR];
+   pf_iodata_object_t
+      data_desc[PNET_MAX_CR][PNET_MAX_API * PNET_MAX_SLOTS * PNET_MAX_SUBSLOTS];
+   uint8_t response[PF_FRAME_BUFFER_SIZE];
+   uint16_t response_len;
+} connect_outcome_t;
+
+static void get_connect_outcome (
+   pnet_t * net,
+   uint32_t arep,
+   connect_outcome_t * p_outcome)
+{
+   pf_ar_t * p_ar = NULL;
+   uint16_t ix;
+
+   memset (p_outcome, 0, sizeof (*p_outcome));
+   ASSERT_EQ (pf_ar_find_by_arep (net, arep, &p_ar), 0);
+   p_outcome->nbr_iocrs = p_ar->nbr_iocrs;
+   for (ix = 0; ix < p_ar->nbr_iocrs; ix++)
+   {
+      p_outcome->in_length[ix] = p_ar->iocrs[ix].in_length;
+      p_outcome->out_length[ix] = p_ar->iocrs[ix].out_length;
+      p_outcome->nbr_data_desc[ix] = p_ar->iocrs[ix].nbr_data_desc;
+      memcpy (
+         p_outcome->data_desc[ix],
+         p_ar->iocrs[ix].data_desc,
+         sizeof (p_outcome->data_desc[ix]));
+   }
+   memcpy (
+      p_outcome->response,
+      mock_os_data.udp_sendto_copy,
+      mock_os_data.udp_sendto_len);
+   p_outcome->response_len = mock_os_data.udp_sendto_len;
+}
+
+static void verify_same_connect_outcome (
+   const connect_outcome_t * p_full,
+   const connect_outcome_t * p_cached)
+{
+   const pf_iodata_object_t * p_a;
+   const pf_iodata_object_t * p_b;
+   uint16_t ix;
+   uint16_t jx;
+
+   ASSERT_EQ (p_cached->nbr_iocrs, p_full->nbr_iocrs);
+   for (ix = 0; ix < p_full->nbr_iocrs; ix++)
+   {
+      EXPECT_EQ (p_cached->in_length[ix], p_full->in_length[ix]);
+      EXPECT_EQ (p_cached->out_length[ix], p_full->out_length[ix]);
+      ASSERT_EQ (p_cached->nbr_data_desc[ix], p_full->nbr_data_desc[ix]);
+      for (jx = 0; jx < p_full->nbr_data_desc[ix]; jx++)
+      {
+         p_a = &p_full->data_desc[ix][jx];
+         p_b = &p_cached->data_desc[ix][jx];
+         EXPECT_EQ (p_b->in_use, p_a->in_use);
+         EXPECT_EQ (p_b->api_id, p_a->api_id);
+         EXPECT_EQ (p_b->slot_nbr, p_a->slot_nbr);
+         EXPECT_EQ (p_b->subslot_nbr, p_a->subslot_nbr);
+         EXPECT_EQ (p_b->data_offset, p_a->data_offset);
+         EXPECT_EQ (p_b->data_length, p_a->data_length);
+         EXPECT_EQ (p_b->iops_offset, p_a->iops_offset);
+         EXPECT_EQ (p_b->iops_length, p_a->iops_length);
+         EXPECT_EQ (p_b->iocs_offset, p_a->iocs_offset);
+         EXPECT_EQ (p_b->iocs_length, p_a->iocs_length);
+      }
+   }
+
+   ASSERT_EQ (p_cached->response_len, p_full->response_len);
+   EXPECT_EQ (
+      memcmp (p_cached->response, p_full->response, p_full->response_len),
+      0);
+}
+
+TEST_F (CmrpcTest, CmrpcReconnectTest)
+{
+   const uint16_t nbr_connects = 4;
+   connect_outcome_t full;
+   connect_outcome_t cached;
+   uint16_t min_device_interval = net->fspm_cfg.min_device_interval;
+   uint16_t ix;
+
+   for (ix = 0; ix < nbr_connects; ix++)
+   {
+      TEST_TRACE ("\nGenerating mock connection request\n");
+      mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+      run_stack (TEST_TICK_INTERVAL_US);
+      EXPECT_EQ (appdata.call_counters.connect_calls, ix + 1);
+      EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_STARTUP);
+
+      /* The first connect lets the application plug the submodules, so
+       * the second is the first one to be stored. */
+      if (ix == 1)
+      {
+         get_connect_outcome (net, appdata.main_arep, &full);
+         EXPECT_EQ (net->cmdev_device.connect_cache_hits, 0u);
+      }
+      else if (ix == 2)
+      {
+         get_connect_outcome (net, appdata.main_arep, &cached);
+         EXPECT_EQ (net->cmdev_device.connect_cache_hits, 1u);
+         verify_same_connect_outcome (&full, &cached);
+      }
+
+      run_stack (TEST_UDP_DELAY);
+
+      TEST_TRACE ("\nGenerating mock release request\n");
+      mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+      run_stack (TEST_UDP_DELAY);
+      EXPECT_EQ (appdata.call_counters.release_calls, ix + 1);
+      EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+   }
+   EXPECT_EQ (net->cmdev_device.connect_cache_hits, nbr_connects - 2u);
+
+   TEST_TRACE ("\nRaise the minimum device interval above the request\n");
+   net->fspm_cfg.min_device_interval = 0x1000;
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.call_counters.connect_calls, nbr_connects);
+   EXPECT_EQ (net->cmdev_device.connect_cache_hits, nbr_connects - 2u);
+   net->fspm_cfg.min_device_interval = min_device_interval;
+
+   TEST_TRACE ("\nPull a submodule, so the next connect must be checked\n");
+   (void)pnet_pull_submodule (net, TEST_API_IDENT, 1, 1);
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.call_counters.connect_calls, nbr_connects + 1);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_STARTUP);
+   EXPECT_EQ (net->cmdev_device.connect_cache_hits, nbr_connects - 2u);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (CmrpcTest, DISABLED_CmrpcReconnectBenchmark)
+{
+   const uint16_t nbr_connects = 20;
+   std::chrono::nanoseconds first_duration{0};
+   std::chrono::nanoseconds reconnect_duration{0};
+   uint16_t ix;
+
+   for (ix = 0; ix < nbr_connects; ix++)
+   {
+      mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+      auto start = std::chrono::steady_clock::now();
+      run_stack (TEST_TICK_INTERVAL_US);
+      auto duration = std::chrono::steady_clock::now() - start;
+
+      /* The first two connects are checked in full */
+      if (ix < 2)
+      {
+         first_duration += duration;
+      }
+      else
+      {
+         reconnect_duration += duration;
+      }
+
+      run_stack (TEST_UDP_DELAY);
+      mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+      run_stack (TEST_UDP_DELAY);
+   }
+   EXPECT_EQ (net->cmdev_device.connect_cache_hits, nbr_connects - 2u);
+
+   std::cout << "Connect without cache: average "
+             << first_duration.count() / 2 << " ns\n";
+   std::cout << "Reconnect from cache: average "
+             << reconnect_duration.count() / (nbr_connects - 2) << " ns\n";
+}
+
 TEST_F (CmrpcUnitTest, CmrpcCheckGenerateUuid)
 {
    uint32_t timestamp;
@@ -104,3 +104,28 @@ TEST_F (CpmUnitTest, CpmCheckCycle)
    EXPECT_EQ (0, pf_cpm_check_cycle (0x0010, 0x0011));
    EXPECT_EQ (0, pf_cpm_check_cycle (0x0010, 0x0012));
 }
+
+TEST_F (CpmUnitTest, CpmFramesMissed)
+{
+   /* No previous frame */
+   EXPECT_EQ (0u, pf_cpm_frames_missed (-1, 0x0020, 32));
+
+   /* One step, with and without jitter */
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0x1000, 0x1020, 32));
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0x1000, 0x1021, 32));
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0x1000, 0x102F, 32));
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0x1000, 0x1001, 32));
+
+   /* Missing frames */
+   EXPECT_EQ (1u, pf_cpm_frames_missed (0x1000, 0x1040, 32));
+   EXPECT_EQ (1u, pf_cpm_frames_missed (0x1000, 0x1030, 32));
+   EXPECT_EQ (3u, pf_cpm_frames_missed (0x1000, 0x1080, 32));
+   EXPECT_EQ (9u, pf_cpm_frames_missed (0x1000, 0x100A, 1));
+
+   /* Wrap-around */
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0xFFF0, 0x0010, 32));
+   EXPECT_EQ (1u, pf_cpm_frames_missed (0xFFE0, 0x0020, 32));
+
+   /* Step larger than the cycle counter range */
+   EXPECT_EQ (0u, pf_cpm_frames_missed (0x1000, 0x1000, 65536));
+}
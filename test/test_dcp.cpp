@@ -37,6 +37,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 class DcpTest : public PnetIntegrationTest
 {
 };
@@ -241,6 +244,198 @@ TEST_F (DcpTest, DcpRunTest)
    EXPECT_EQ (appdata.call_counters.write_calls, 0);
 }
 
+TEST_F (DcpTest, DcpIdentifyCacheTest)
+{
+   pnal_buf_t * p_buf;
+   int ret;
+   uint8_t first_response[PF_FRAME_BUFFER_SIZE];
+   uint16_t first_response_len;
+
+   TEST_TRACE ("\nGenerating mock set name request\n");
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, set_name_req, sizeof (set_name_req));
+   p_buf->len = sizeof (set_name_req);
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+   EXPECT_FALSE (net->dcp_identresp_cache_valid);
+
+   TEST_TRACE ("\nGenerating mock ident request\n");
+   mock_clear();
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, ident_req, sizeof (ident_req));
+   p_buf->len = sizeof (ident_req);
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+   EXPECT_TRUE (net->dcp_identresp_cache_valid);
+   run_stack (TEST_SCHEDULER_RUNTIME);
+   EXPECT_EQ (mock_os_data.eth_send_count, 1);
+   first_response_len = mock_os_data.eth_send_len;
+   memcpy (first_response, mock_os_data.eth_send_copy, first_response_len);
+
+   TEST_TRACE ("\nRepeating mock ident request, using cached response\n");
+   mock_clear();
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, ident_req, sizeof (ident_req));
+   p_buf->len = sizeof (ident_req);
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+   run_stack (TEST_SCHEDULER_RUNTIME);
+   EXPECT_EQ (mock_os_data.eth_send_count, 1);
+   EXPECT_EQ (mock_os_data.eth_send_len, first_response_len);
+   EXPECT_EQ (
+      memcmp (mock_os_data.eth_send_copy, first_response, first_response_len),
+      0);
+
+   TEST_TRACE ("\nGenerating mock set IP request\n");
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, set_ip_req, sizeof (set_ip_req));
+   p_buf->len = sizeof (set_ip_req);
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+   EXPECT_FALSE (net->dcp_identresp_cache_valid);
+
+   TEST_TRACE ("\nRepeating mock ident request, with new IP address\n");
+   mock_clear();
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, ident_req, sizeof (ident_req));
+   p_buf->len = sizeof (ident_req);
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+   EXPECT_TRUE (net->dcp_identresp_cache_valid);
+   run_stack (TEST_SCHEDULER_RUNTIME);
+   EXPECT_EQ (mock_os_data.eth_send_count, 1);
+   EXPECT_EQ (mock_os_data.eth_send_len, first_response_len);
+   EXPECT_NE (
+      memcmp (mock_os_data.eth_send_copy, first_response, first_response_len),
+      0);
+}
+
+static void send_ident_req (pnet_t * net, uint8_t last_mac_byte, char name_char)
+{
+   pnal_buf_t * p_buf;
+   int ret;
+
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, ident_req, sizeof (ident_req));
+   p_buf->len = sizeof (ident_req);
+   ((uint8_t *)p_buf->payload)[11] = last_mac_byte;
+   ((uint8_t *)p_buf->payload)[30] = (uint8_t)name_char;
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+}
+
+TEST_F (DcpTest, DcpIdentifyRateLimitTest)
+{
+   pnal_buf_t * p_buf;
+   uint32_t received;
+   uint16_t ix;
+
+   TEST_TRACE ("\nGenerating mock set name request\n");
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, set_name_req, sizeof (set_name_req));
+   p_buf->len = sizeof (set_name_req);
+   EXPECT_EQ (pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf), 1);
+
+   /* Fill all token buckets */
+   mock_os_data.current_time_us +=
+      PF_DCP_RATE_LIMIT_BURST * PF_DCP_RATE_LIMIT_INTERVAL;
+
+   TEST_TRACE ("\nIdentify request for other station name\n");
+   received = net->dcp_statistics.identify_received;
+   send_ident_req (net, 0xdf, 'x');
+   EXPECT_EQ (net->dcp_statistics.identify_received, received + 1);
+   EXPECT_EQ (net->dcp_statistics.identify_prefiltered, 1U);
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 0U);
+
+   TEST_TRACE ("\nIdentify requests from one source\n");
+   for (ix = 0; ix < PF_DCP_RATE_LIMIT_BURST; ix++)
+   {
+      send_ident_req (net, 0xdf, 'r');
+   }
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 0U);
+   send_ident_req (net, 0xdf, 'r');
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 1U);
+
+   /* Pre-filtered requests do not use any tokens */
+   send_ident_req (net, 0xdf, 'x');
+   EXPECT_EQ (net->dcp_statistics.identify_prefiltered, 2U);
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 1U);
+
+   TEST_TRACE ("\nOne token is added per interval\n");
+   mock_os_data.current_time_us += PF_DCP_RATE_LIMIT_INTERVAL;
+   send_ident_req (net, 0xdf, 'r');
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 1U);
+   send_ident_req (net, 0xdf, 'r');
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 2U);
+   EXPECT_EQ (net->dcp_statistics.rate_limited_global, 0U);
+
+   TEST_TRACE ("\nIdentify requests from rotating sources\n");
+   mock_os_data.current_time_us +=
+      PF_DCP_RATE_LIMIT_BURST * PF_DCP_RATE_LIMIT_INTERVAL;
+   for (ix = 0; ix < PF_DCP_RATE_LIMIT_GLOBAL_BURST + 5; ix++)
+   {
+      send_ident_req (net, (uint8_t)ix, 'r');
+   }
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 2U);
+   EXPECT_EQ (net->dcp_statistics.rate_limited_global, 5U);
+
+   mock_os_data.current_time_us += PF_DCP_RATE_LIMIT_GLOBAL_INTERVAL;
+   send_ident_req (net, 0xf0, 'r');
+   EXPECT_EQ (net->dcp_statistics.rate_limited_global, 5U);
+   send_ident_req (net, 0xf1, 'r');
+   EXPECT_EQ (net->dcp_statistics.rate_limited_global, 6U);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (DcpTest, DISABLED_DcpIdentifyBenchmark)
+{
+   const uint32_t nbr_requests = 1000;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration[2];
+   pnal_buf_t * p_buf;
+   uint32_t ix;
+   uint16_t cached;
+
+   /* The request filters on this station name */
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, set_name_req, sizeof (set_name_req));
+   p_buf->len = sizeof (set_name_req);
+   (void)pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   mock_clear();
+
+   for (cached = 0; cached < 2; cached++)
+   {
+      duration[cached] = std::chrono::nanoseconds (0);
+      for (ix = 0; ix < nbr_requests; ix++)
+      {
+         if (cached == 0)
+         {
+            pf_dcp_identify_cache_invalidate (net);
+         }
+
+         /* Stay within the rate limit */
+         mock_os_data.current_time_us += PF_DCP_RATE_LIMIT_INTERVAL;
+
+         p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+         memcpy (p_buf->payload, ident_req, sizeof (ident_req));
+         p_buf->len = sizeof (ident_req);
+         start = std::chrono::steady_clock::now();
+         (void)pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+         duration[cached] += std::chrono::steady_clock::now() - start;
+
+         /* Send the response */
+         run_stack (TEST_SCHEDULER_RUNTIME);
+      }
+   }
+   EXPECT_EQ (net->dcp_statistics.rate_limited, 0U);
+   EXPECT_GE (mock_os_data.eth_send_count, 2 * nbr_requests);
+
+   std::cout << "DCP identify: average " << duration[0].count() / nbr_requests
+             << " ns encoding the response, "
+             << duration[1].count() / nbr_requests
+             << " ns using the cached response\n";
+}
+
 TEST_F (DcpUnitTest, DcpCalculateDelay)
 {
    pnet_ethaddr_t mac_address = {0};
@@ -378,3 +573,52 @@ TEST_F (DcpUnitTest, DcpCheckDestinationAddress)
          &multicast_mac_address),
       false);
 }
+
+TEST_F (DcpUnitTest, DcpRateLimit)
+{
+   pf_dcp_rate_limit_source_t sources[2];
+   pnet_ethaddr_t mac_a = {{0x12, 0x34, 0x00, 0x78, 0x90, 0xab}};
+   pnet_ethaddr_t mac_b = {{0x12, 0x34, 0x00, 0x78, 0x90, 0xac}};
+   pnet_ethaddr_t mac_c = {{0x12, 0x34, 0x00, 0x78, 0x90, 0xad}};
+   uint32_t now = 1000;
+   uint16_t ix;
+
+   memset (sources, 0, sizeof (sources));
+
+   /* Burst is allowed, then requests are dropped */
+   for (ix = 0; ix < PF_DCP_RATE_LIMIT_BURST; ix++)
+   {
+      EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   }
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_EQ (sources[0].dropped, 2U);
+
+   /* Other sources have their own bucket */
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_b, now));
+
+   /* One token per interval */
+   now += PF_DCP_RATE_LIMIT_INTERVAL - 1;
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   now += 1;
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   now += 3 * PF_DCP_RATE_LIMIT_INTERVAL;
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+
+   /* The bucket is not filled above the burst size */
+   now += 100 * PF_DCP_RATE_LIMIT_INTERVAL;
+   for (ix = 0; ix < PF_DCP_RATE_LIMIT_BURST; ix++)
+   {
+      EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+   }
+   EXPECT_FALSE (pf_dcp_rate_limit_check (sources, 2, &mac_a, now));
+
+   /* New source replaces the least recently seen (mac_b) */
+   EXPECT_TRUE (pf_dcp_rate_limit_check (sources, 2, &mac_c, now));
+   EXPECT_EQ (memcmp (&sources[1].mac_address, &mac_c, sizeof (mac_c)), 0);
+   EXPECT_EQ (memcmp (&sources[0].mac_address, &mac_a, sizeof (mac_a)), 0);
+}
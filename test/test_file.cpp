@@ -27,6 +27,16 @@
 
 class FileUnitTest : public PnetUnitTest
 {
+ protected:
+   pnet_t the_net;
+   pnet_t * net = &the_net;
+
+   virtual void SetUp() override
+   {
+      mock_clear();
+      memset (net, 0, sizeof (*net));
+      pf_file_init (net);
+   };
 };
 
 TEST_F (FileUnitTest, FileJoinDirectoryFilename)
@@ -215,30 +225,36 @@ TEST_F (FileUnitTest, FileCheckMagicAndVersion)
    uint8_t testdata[TEST_FILE_DATA_SIZE] =
       {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
    uint8_t retrieved[TEST_FILE_DATA_SIZE] = {0};
+   uint8_t too_large[MOCK_FILE_CONTENT_SIZE] = {0};
+   mock_file_t * p_journal_file = NULL;
    uint8_t temporary_byte;
    int res = 0;
    int i;
 
-   /* Save data together with file version information */
+   /* Save data to the journal, which has file version information */
    res = pf_file_save (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
       TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, 0);
-   EXPECT_EQ (mock_os_data.file_size, TEST_FILE_DATA_SIZE + 8); /* Implementation
-                                                                   detail, but
-                                                                   verifies mock
-                                                                   functionality
-                                                                 */
+   p_journal_file = mock_get_file (TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_1);
+   ASSERT_TRUE (p_journal_file != NULL);
+   EXPECT_GT (p_journal_file->size, TEST_FILE_DATA_SIZE);
 
    /* Save: Validate mock (protection of max mocked file size) */
-   res =
-      pf_file_save (TEST_FILE_DIRECTORY, TEST_FILE_FILENAME, &testdata, 10000);
+   res = pf_file_save (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &too_large,
+      sizeof (too_large));
    EXPECT_EQ (res, -1);
 
    /* Load: Non-existent file */
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       "unknown_filename",
       &retrieved,
@@ -247,6 +263,7 @@ TEST_F (FileUnitTest, FileCheckMagicAndVersion)
 
    /* Retrieve data */
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
@@ -257,48 +274,61 @@ TEST_F (FileUnitTest, FileCheckMagicAndVersion)
       EXPECT_EQ (testdata[i], retrieved[i]);
    }
 
-   /* Invalid magic bytes in simulated file */
-   temporary_byte = mock_os_data.file_content[0];
-   mock_os_data.file_content[0] = 'A';
+   /* Invalid magic bytes in simulated journal, read at next startup */
+   temporary_byte = p_journal_file->content[0];
+   p_journal_file->content[0] = 'A';
+   pf_file_init (net);
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
       TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, -1);
-   mock_os_data.file_content[0] = temporary_byte; /* Reset to initial value */
+   p_journal_file->content[0] = temporary_byte; /* Reset to initial value */
 
-   /* Invalid file version in simulated file */
-   temporary_byte = mock_os_data.file_content[4];
-   mock_os_data.file_content[4] = 200;
+   /* Invalid file version in simulated journal */
+   temporary_byte = p_journal_file->content[4];
+   p_journal_file->content[4] = 200;
+   pf_file_init (net);
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
       TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, -1);
-   mock_os_data.file_content[4] = temporary_byte; /* Reset to initial value */
+   p_journal_file->content[4] = temporary_byte; /* Reset to initial value */
+   pf_file_init (net);
 
-   /* Verify that mock does not delete file for other name */
-   pf_file_clear (TEST_FILE_DIRECTORY, "nonexistent file");
-   EXPECT_GT (mock_os_data.file_size, 1);
+   /* Verify that other objects are not deleted */
+   pf_file_clear (net, TEST_FILE_DIRECTORY, "nonexistent file");
 
-   /* Clear: Invalid directory */
-   pf_file_clear (NULL, TEST_FILE_FILENAME);
-   pf_file_clear ("", TEST_FILE_FILENAME);
+   /* Clear: Other directory */
+   pf_file_clear (net, NULL, TEST_FILE_FILENAME);
+   pf_file_clear (net, "", TEST_FILE_FILENAME);
 
    /* Check that it is OK when we use correct sample data again */
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
       TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, 0);
 
-   /* Verify that the mock can delete file entry */
-   pf_file_clear (TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
-   EXPECT_EQ (mock_os_data.file_size, 0); /* Verifies mock functionality */
+   /* Delete object, also after next startup */
+   pf_file_clear (net, TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, -1);
+   pf_file_init (net);
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
@@ -306,36 +336,132 @@ TEST_F (FileUnitTest, FileCheckMagicAndVersion)
    EXPECT_EQ (res, -1);
 
    /* Save to current directory */
-   res =
-      pf_file_save (NULL, TEST_FILE_FILENAME, &testdata, TEST_FILE_DATA_SIZE);
+   res = pf_file_save (
+      net,
+      NULL,
+      TEST_FILE_FILENAME,
+      &testdata,
+      TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, 0);
-   EXPECT_EQ (mock_os_data.file_size, TEST_FILE_DATA_SIZE + 8); /* Implementation
-                                                                   detail, but
-                                                                   verifies mock
-                                                                   functionality
-                                                                 */
+   EXPECT_TRUE (mock_get_file (PF_FILENAME_JOURNAL_1) != NULL);
 
    /* Retrieve data from current directory */
-   res =
-      pf_file_load (NULL, TEST_FILE_FILENAME, &retrieved, TEST_FILE_DATA_SIZE);
+   res = pf_file_load (
+      net,
+      NULL,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, 0);
    for (i = 0; i < TEST_FILE_DATA_SIZE; i++)
    {
       EXPECT_EQ (testdata[i], retrieved[i]);
    }
 
-   res = pf_file_load ("", TEST_FILE_FILENAME, &retrieved, TEST_FILE_DATA_SIZE);
+   res = pf_file_load (
+      net,
+      "",
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, 0);
    for (i = 0; i < TEST_FILE_DATA_SIZE; i++)
    {
       EXPECT_EQ (testdata[i], retrieved[i]);
    }
 
-   /* Delete file in current directory */
-   pf_file_clear (NULL, TEST_FILE_FILENAME);
-   EXPECT_EQ (mock_os_data.file_size, 0); /* Verifies mock functionality */
-   res =
-      pf_file_load (NULL, TEST_FILE_FILENAME, &retrieved, TEST_FILE_DATA_SIZE);
+   /* Delete object in current directory */
+   pf_file_clear (net, NULL, TEST_FILE_FILENAME);
+   res = pf_file_load (
+      net,
+      NULL,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, -1);
+}
+
+TEST_F (FileUnitTest, FileLoadFromEarlierVersion)
+{
+   const uint8_t header[] = {'P', 'N', 'E', 'T', 0x00, 0x00, 0x00, 0x01};
+   uint8_t testdata[TEST_FILE_DATA_SIZE] =
+      {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
+   uint8_t retrieved[TEST_FILE_DATA_SIZE] = {0};
+   mock_file_t * p_file = NULL;
+   int res = 0;
+   int i;
+
+   /* Separate file written by an earlier version */
+   mock_pnal_save_file (
+      TEST_FILE_DIRECTORY TEST_FILE_FILENAME,
+      header,
+      sizeof (header),
+      testdata,
+      TEST_FILE_DATA_SIZE);
+   p_file = mock_get_file (TEST_FILE_DIRECTORY TEST_FILE_FILENAME);
+   ASSERT_TRUE (p_file != NULL);
+
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   for (i = 0; i < TEST_FILE_DATA_SIZE; i++)
+   {
+      EXPECT_EQ (testdata[i], retrieved[i]);
+   }
+
+   /* Invalid magic bytes */
+   p_file->content[0] = 'A';
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, -1);
+   p_file->content[0] = header[0];
+
+   /* Invalid file version */
+   p_file->content[7] = 200;
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, -1);
+   p_file->content[7] = header[7];
+
+   /* Objects in the journal take precedence */
+   testdata[0] = 's';
+   res = pf_file_save (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (retrieved[0], 's');
+
+   /* Clearing removes also the old file */
+   pf_file_clear (net, TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
+   EXPECT_EQ (p_file->size, 0);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
    EXPECT_EQ (res, -1);
 }
 
@@ -348,10 +474,11 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
    int res = 0;
    int i;
 
-   pf_file_clear (TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
+   pf_file_clear (net, TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
 
    /* First saving */
    res = pf_file_save_if_modified (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
@@ -361,6 +488,7 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
 
    /* No update */
    res = pf_file_save_if_modified (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
@@ -369,6 +497,7 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
    EXPECT_EQ (res, 0);
 
    res = pf_file_save_if_modified (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
@@ -379,6 +508,7 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
    /* Updated data */
    testdata[0] = 's';
    res = pf_file_save_if_modified (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
@@ -387,6 +517,7 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
    EXPECT_EQ (res, 1);
 
    res = pf_file_save_if_modified (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &testdata,
@@ -396,6 +527,7 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
 
    /* Verify updated data */
    res = pf_file_load (
+      net,
       TEST_FILE_DIRECTORY,
       TEST_FILE_FILENAME,
       &retrieved,
@@ -408,3 +540,362 @@ TEST_F (FileUnitTest, FileCheckSaveIfModified)
       EXPECT_EQ (retrieved[i], testdata[i]);
    }
 }
+
+TEST_F (FileUnitTest, FileSaveIfModifiedUsesKnownContents)
+{
+   uint8_t testdata[TEST_FILE_DATA_SIZE] =
+      {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
+   uint8_t tempobject[TEST_FILE_DATA_SIZE];
+   uint16_t load_count;
+   uint16_t save_count;
+   int res = 0;
+
+   pf_file_clear (net, TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
+
+   /* First saving. File content is unknown, so it is read. */
+   load_count = mock_os_data.file_load_count;
+   save_count = mock_os_data.file_save_count;
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 2);
+   EXPECT_GT (mock_os_data.file_load_count, load_count);
+   EXPECT_GT (mock_os_data.file_save_count, save_count);
+
+   /* No update. Neither read nor written. */
+   load_count = mock_os_data.file_load_count;
+   save_count = mock_os_data.file_save_count;
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (mock_os_data.file_load_count, load_count);
+   EXPECT_EQ (mock_os_data.file_save_count, save_count);
+
+   /* Updated data. Written without reading. */
+   testdata[0] = 's';
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 1);
+   EXPECT_EQ (mock_os_data.file_load_count, load_count);
+   EXPECT_GT (mock_os_data.file_save_count, save_count);
+
+   /* Clearing the file forgets the content */
+   pf_file_clear (net, TEST_FILE_DIRECTORY, TEST_FILE_FILENAME);
+   load_count = mock_os_data.file_load_count;
+   save_count = mock_os_data.file_save_count;
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 2);
+   EXPECT_GT (mock_os_data.file_load_count, load_count);
+   EXPECT_GT (mock_os_data.file_save_count, save_count);
+
+   /* Content known after an explicit load */
+   pf_file_init (net);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   load_count = mock_os_data.file_load_count;
+   save_count = mock_os_data.file_save_count;
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &testdata,
+      &tempobject,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (mock_os_data.file_load_count, load_count);
+   EXPECT_EQ (mock_os_data.file_save_count, save_count);
+}
+
+TEST_F (FileUnitTest, FileJournalSurvivesPowerLoss)
+{
+   const char * journal_path = TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_1;
+   uint8_t journal[MOCK_FILE_CONTENT_SIZE];
+   uint16_t journal_size;
+   uint16_t commit_size[5];
+   const uint8_t expected_a[5] = {1, 1, 2, 0, 3}; /* 0 = Not stored */
+   const uint8_t expected_b[5] = {0, 1, 2, 2, 2};
+   uint8_t object[TEST_FILE_DATA_SIZE];
+   uint8_t retrieved[TEST_FILE_DATA_SIZE];
+   uint16_t truncated_size;
+   int commits;
+   int res;
+
+   /* Write the commits, and remember the journal size after each */
+   memset (object, 1, sizeof (object));
+   pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   commit_size[0] = mock_get_file (journal_path)->size;
+   pf_file_save (net, TEST_FILE_DIRECTORY, "b.bin", object, sizeof (object));
+   commit_size[1] = mock_get_file (journal_path)->size;
+
+   memset (object, 2, sizeof (object));
+   pf_file_transaction_begin (net);
+   pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   pf_file_save (net, TEST_FILE_DIRECTORY, "b.bin", object, sizeof (object));
+   EXPECT_EQ (pf_file_transaction_commit (net), 0);
+   commit_size[2] = mock_get_file (journal_path)->size;
+
+   pf_file_clear (net, TEST_FILE_DIRECTORY, "a.bin");
+   commit_size[3] = mock_get_file (journal_path)->size;
+
+   memset (object, 3, sizeof (object));
+   pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   commit_size[4] = mock_get_file (journal_path)->size;
+
+   journal_size = mock_get_file (journal_path)->size;
+   memcpy (journal, mock_get_file (journal_path)->content, journal_size);
+
+   /* Cut the power after every possible number of written bytes */
+   for (truncated_size = 0; truncated_size <= journal_size; truncated_size++)
+   {
+      mock_clear();
+      mock_pnal_save_file (journal_path, journal, truncated_size, NULL, 0);
+      pf_file_init (net);
+
+      commits = 0;
+      while (commits < 5 && commit_size[commits] <= truncated_size)
+      {
+         commits++;
+      }
+
+      res = pf_file_load (
+         net,
+         TEST_FILE_DIRECTORY,
+         "a.bin",
+         retrieved,
+         sizeof (retrieved));
+      if (commits == 0 || expected_a[commits - 1] == 0)
+      {
+         EXPECT_EQ (res, -1) << "Truncated at " << truncated_size;
+      }
+      else
+      {
+         EXPECT_EQ (res, 0) << "Truncated at " << truncated_size;
+         EXPECT_EQ (retrieved[0], expected_a[commits - 1]);
+      }
+
+      res = pf_file_load (
+         net,
+         TEST_FILE_DIRECTORY,
+         "b.bin",
+         retrieved,
+         sizeof (retrieved));
+      if (commits == 0 || expected_b[commits - 1] == 0)
+      {
+         EXPECT_EQ (res, -1) << "Truncated at " << truncated_size;
+      }
+      else
+      {
+         EXPECT_EQ (res, 0) << "Truncated at " << truncated_size;
+         EXPECT_EQ (retrieved[0], expected_b[commits - 1]);
+      }
+
+      /* The journal is usable after the power loss */
+      memset (object, 4, sizeof (object));
+      res = pf_file_save (
+         net,
+         TEST_FILE_DIRECTORY,
+         "a.bin",
+         object,
+         sizeof (object));
+      EXPECT_EQ (res, 0);
+      pf_file_init (net);
+      res = pf_file_load (
+         net,
+         TEST_FILE_DIRECTORY,
+         "a.bin",
+         retrieved,
+         sizeof (retrieved));
+      EXPECT_EQ (res, 0) << "Truncated at " << truncated_size;
+      EXPECT_EQ (retrieved[0], 4);
+   }
+}
+
+TEST_F (FileUnitTest, FileJournalIsCompactedAfterFailedAppend)
+{
+   uint8_t object[TEST_FILE_DATA_SIZE];
+   uint8_t retrieved[TEST_FILE_DATA_SIZE] = {0};
+   int res;
+
+   memset (object, 1, sizeof (object));
+   res =
+      pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   EXPECT_EQ (res, 0);
+
+   /* Only the record header is written */
+   mock_os_data.is_append_failing = true;
+   memset (object, 2, sizeof (object));
+   res =
+      pf_file_save (net, TEST_FILE_DIRECTORY, "b.bin", object, sizeof (object));
+   EXPECT_EQ (res, -1);
+   mock_os_data.is_append_failing = false;
+
+   /* Next write goes to the other journal file */
+   memset (object, 3, sizeof (object));
+   res =
+      pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   EXPECT_EQ (res, 0);
+   EXPECT_TRUE (
+      mock_get_file (TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_2) != NULL);
+   EXPECT_TRUE (
+      mock_get_file (TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_1) == NULL);
+
+   /* Also after a restart */
+   pf_file_init (net);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      "a.bin",
+      retrieved,
+      sizeof (retrieved));
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (retrieved[0], 3);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      "b.bin",
+      retrieved,
+      sizeof (retrieved));
+   EXPECT_EQ (res, -1);
+}
+
+TEST_F (FileUnitTest, FileSaveIfModifiedAfterFailedTransaction)
+{
+   uint8_t object[TEST_FILE_DATA_SIZE];
+   uint8_t tempobject[TEST_FILE_DATA_SIZE];
+   uint8_t retrieved[TEST_FILE_DATA_SIZE] = {0};
+   int res;
+
+   memset (object, 1, sizeof (object));
+   res =
+      pf_file_save (net, TEST_FILE_DIRECTORY, "a.bin", object, sizeof (object));
+   EXPECT_EQ (res, 0);
+
+   /* The transaction fails after a.bin is written */
+   memset (object, 2, sizeof (object));
+   pf_file_transaction_begin (net);
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      "a.bin",
+      object,
+      tempobject,
+      sizeof (object));
+   EXPECT_EQ (res, 1);
+   mock_os_data.is_append_failing = true;
+   res =
+      pf_file_save (net, TEST_FILE_DIRECTORY, "b.bin", object, sizeof (object));
+   EXPECT_EQ (res, -1);
+   mock_os_data.is_append_failing = false;
+   EXPECT_EQ (pf_file_transaction_commit (net), -1);
+
+   /* Same data again. Must be written, as it was never committed */
+   res = pf_file_save_if_modified (
+      net,
+      TEST_FILE_DIRECTORY,
+      "a.bin",
+      object,
+      tempobject,
+      sizeof (object));
+   EXPECT_EQ (res, 1);
+
+   pf_file_init (net);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      "a.bin",
+      retrieved,
+      sizeof (retrieved));
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (retrieved[0], 2);
+}
+
+TEST_F (FileUnitTest, FileJournalIsCompacted)
+{
+   uint8_t testdata[TEST_FILE_DATA_SIZE] =
+      {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
+   uint8_t retrieved[TEST_FILE_DATA_SIZE] = {0};
+   const mock_file_t * p_file_1 = NULL;
+   const mock_file_t * p_file_2 = NULL;
+   bool is_compacted = false;
+   uint16_t i;
+   int res;
+
+   res = pf_file_save (
+      net,
+      TEST_FILE_DIRECTORY,
+      "other.bin",
+      &testdata,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+
+   for (i = 0; i < 1000; i++)
+   {
+      testdata[0] = (uint8_t)i;
+      res = pf_file_save (
+         net,
+         TEST_FILE_DIRECTORY,
+         TEST_FILE_FILENAME,
+         &testdata,
+         TEST_FILE_DATA_SIZE);
+      EXPECT_EQ (res, 0);
+
+      /* Only one journal file is in use between the saves */
+      p_file_1 = mock_get_file (TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_1);
+      p_file_2 = mock_get_file (TEST_FILE_DIRECTORY PF_FILENAME_JOURNAL_2);
+      EXPECT_TRUE ((p_file_1 == NULL) != (p_file_2 == NULL));
+      if (p_file_2 != NULL)
+      {
+         is_compacted = true;
+         EXPECT_LE (p_file_2->size, PF_FILE_JOURNAL_COMPACTION_SIZE + 100);
+      }
+      if (p_file_1 != NULL)
+      {
+         EXPECT_LE (p_file_1->size, PF_FILE_JOURNAL_COMPACTION_SIZE + 100);
+      }
+   }
+   EXPECT_TRUE (is_compacted);
+
+   /* All objects survive a restart */
+   pf_file_init (net);
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      TEST_FILE_FILENAME,
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (retrieved[0], (uint8_t)(i - 1));
+   res = pf_file_load (
+      net,
+      TEST_FILE_DIRECTORY,
+      "other.bin",
+      &retrieved,
+      TEST_FILE_DATA_SIZE);
+   EXPECT_EQ (res, 0);
+   EXPECT_EQ (retrieved[0], 'a');
+}
@@ -0,0 +1,103 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2021 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#include "utils_for_testing.h"
+#include "mocks.h"
+
+#include "pf_includes.h"
+
+#include <gtest/gtest.h>
+
+class FramePoolTest : public PnetIntegrationTest
+{
+};
+
+TEST_F (FramePoolTest, FramePoolAllocFree)
+{
+   pnal_buf_t * buffers[PF_FRAME_POOL_SIZE];
+   pnal_buf_t * p_extra;
+   pnal_buf_t * p_again;
+   uint16_t ix;
+
+   EXPECT_EQ (net->frame_pool.number_of_buffers, PF_FRAME_POOL_SIZE);
+   EXPECT_EQ (net->frame_pool.in_use, 0);
+
+   /* Use all buffers. No heap allocation. */
+   for (ix = 0; ix < PF_FRAME_POOL_SIZE; ix++)
+   {
+      buffers[ix] = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
+      ASSERT_TRUE (buffers[ix] != NULL);
+      EXPECT_EQ (buffers[ix]->len, PF_FRAME_BUFFER_SIZE);
+   }
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 0);
+   EXPECT_EQ (net->frame_pool.in_use, PF_FRAME_POOL_SIZE);
+   EXPECT_EQ (net->frame_pool.high_watermark, PF_FRAME_POOL_SIZE);
+   EXPECT_EQ (net->frame_pool.fallback_allocations, 0);
+
+   /* Empty pool. Allocated from pnal instead. */
+   p_extra = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
+   ASSERT_TRUE (p_extra != NULL);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 1);
+   EXPECT_EQ (net->frame_pool.fallback_allocations, 1);
+   pf_frame_buf_free (net, p_extra);
+
+   /* A returned buffer is reused */
+   buffers[3]->len = 17;
+   pf_frame_buf_free (net, buffers[3]);
+   EXPECT_EQ (net->frame_pool.in_use, PF_FRAME_POOL_SIZE - 1);
+   p_again = pf_frame_buf_alloc (net, 100);
+   EXPECT_EQ (p_again, buffers[3]);
+   EXPECT_EQ (p_again->len, 100);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 1);
+
+   for (ix = 0; ix < PF_FRAME_POOL_SIZE; ix++)
+   {
+      pf_frame_buf_free (net, buffers[ix]);
+   }
+   EXPECT_EQ (net->frame_pool.in_use, 0);
+   EXPECT_EQ (net->frame_pool.high_watermark, PF_FRAME_POOL_SIZE);
+
+   /* Too large for the pool */
+   p_extra = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE + 1);
+   ASSERT_TRUE (p_extra != NULL);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 2);
+   EXPECT_EQ (net->frame_pool.in_use, 0);
+   pf_frame_buf_free (net, p_extra);
+
+   pf_frame_buf_free (net, NULL);
+}
+
+TEST_F (FramePoolTest, FramePoolIsKeptAtReinit)
+{
+   pnal_buf_t * first_buffer = net->frame_pool.buffers[0];
+   pnal_buf_t * p_buf;
+
+   p_buf = pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE);
+   ASSERT_TRUE (p_buf != NULL);
+   EXPECT_EQ (net->frame_pool.in_use, 1);
+
+   /* No new buffers, and all buffers are free again */
+   pf_frame_pool_init (net);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 0);
+   EXPECT_EQ (net->frame_pool.number_of_buffers, PF_FRAME_POOL_SIZE);
+   EXPECT_EQ (net->frame_pool.buffers[0], first_buffer);
+   EXPECT_EQ (net->frame_pool.in_use, 0);
+   EXPECT_EQ (pf_frame_buf_alloc (net, PF_FRAME_BUFFER_SIZE), p_buf);
+   pf_frame_buf_free (net, p_buf);
+
+   /* Also when initializing the whole stack instance */
+   pnet_init_only (net, &pnet_default_cfg);
+   EXPECT_EQ (net->frame_pool.buffers[0], first_buffer);
+}
@@ -0,0 +1,252 @@
+/*********************************************************************
+ *        _       _         _
+ *  _ __ | |_  _ | |  __ _ | |__   ___
+ * | '__|| __|(_)| | / _` || '_ \ / __|
+ * | |   | |_  _ | || (_| || |_) |\__ \
+ * |_|    \__|(_)|_| \__,_||_.__/ |___/
+ *
+ * www.rt-labs.com
+ * Copyright 2018 rt-labs AB, Sweden.
+ *
+ * This software is dual-licensed under GPLv3 and a commercial
+ * license. See the file LICENSE.md distributed with this software for
+ * full license information.
+ ********************************************************************/
+
+#include "utils_for_testing.h"
+#include "mocks.h"
+
+#include "pf_includes.h"
+
+#include <gtest/gtest.h>
+
+#if PNET_OPTION_FAST_STARTUP
+
+class FsuTest : public PnetIntegrationTest
+{
+ protected:
+   pf_ar_t ar;
+   pf_iod_write_request_t write_request;
+   pf_subslot_t * p_subslot;
+
+   virtual void SetUp() override
+   {
+      PnetIntegrationTest::SetUp();
+
+      net->fspm_cfg.fsu_skip_unchanged_parameters = true;
+      ASSERT_EQ (
+         pnet_plug_module (net, TEST_API_IDENT, 1, TEST_MOD_8_0_IDENT),
+         0);
+      ASSERT_EQ (
+         pnet_plug_submodule (
+            net,
+            TEST_API_IDENT,
+            1,
+            1,
+            TEST_MOD_8_0_IDENT,
+            TEST_SUBMOD_CUSTOM_IDENT,
+            PNET_DIR_INPUT,
+            1,
+            0),
+         0);
+      ASSERT_EQ (
+         pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 1, &p_subslot),
+         0);
+
+      memset (&write_request, 0, sizeof (write_request));
+      write_request.api = TEST_API_IDENT;
+      write_request.slot_number = 1;
+      write_request.subslot_number = 1;
+      write_request.index = 0x0123;
+   }
+
+   /* Simulate the startup of an AR owning the submodule */
+   void start_ar (uint32_t mode, uint32_t uuid_data1)
+   {
+      memset (&ar, 0, sizeof (ar));
+      ar.arep = 1;
+      ar.fast_startup_data.valid = true;
+      ar.fast_startup_data.fs_parameter_block.fs_parameter_mode = mode;
+      ar.fast_startup_data.fs_parameter_block.fs_parameter_uuid.data1 =
+         uuid_data1;
+      p_subslot->owner = &ar;
+      pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_STARTUP);
+      ar.cmdev_state = PF_CMDEV_STATE_W_PEIND;
+   }
+};
+
+TEST_F (FsuTest, FsuSkipUnchangedParametersTest)
+{
+   /* First AR parameterizes the submodule */
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   EXPECT_FALSE (ar.fast_startup_data.parameters_unchanged);
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_TRUE (p_subslot->fsu_parameterized);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0x1234u);
+
+   /* Same UUID. Writes of user records are skipped during startup */
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   EXPECT_TRUE (ar.fast_startup_data.parameters_unchanged);
+   EXPECT_TRUE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, NULL, &write_request));
+   write_request.index = PF_IDX_SUB_IM_1;
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   write_request.index = 0x0123;
+   net->fspm_cfg.fsu_skip_unchanged_parameters = false;
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   net->fspm_cfg.fsu_skip_unchanged_parameters = true;
+   ar.cmdev_state = PF_CMDEV_STATE_DATA;
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   EXPECT_EQ (ar.fast_startup_data.nbr_skipped_writes, 1);
+
+   /* Mode OFF */
+   start_ar (PF_FS_PARAMETER_MODE_OFF, 0x1234);
+   EXPECT_FALSE (ar.fast_startup_data.parameters_unchanged);
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_FALSE (p_subslot->fsu_parameterized);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0x1234u);
+
+   EXPECT_EQ (net->fsu_nonvolatile.nbr_marks, 0);
+   EXPECT_EQ (
+      mock_os_data.bg_job_start_count[PF_BGJOB_SAVE_FSU_NVM_DATA],
+      2);
+}
+
+TEST_F (FsuTest, FsuRestartTest)
+{
+   pf_subslot_t * p_subslot_2 = NULL;
+
+   ASSERT_EQ (
+      pnet_plug_submodule (
+         net,
+         TEST_API_IDENT,
+         1,
+         2,
+         TEST_MOD_8_0_IDENT,
+         TEST_SUBMOD_CUSTOM_IDENT,
+         PNET_DIR_INPUT,
+         1,
+         0),
+      0);
+   ASSERT_EQ (
+      pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 2, &p_subslot_2),
+      0);
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   p_subslot_2->owner = &ar;
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_EQ (net->fsu_nonvolatile.nbr_marks, 2);
+   EXPECT_EQ (
+      mock_os_data.bg_job_start_count[PF_BGJOB_SAVE_FSU_NVM_DATA],
+      1);
+   pf_fsu_save (net);
+
+   /* Power cycle. The tool is plugged with another submodule in
+    * subslot 2. */
+   pnet_default_cfg.fsu_skip_unchanged_parameters = true;
+   ASSERT_EQ (pnet_init_only (net, &pnet_default_cfg), 0);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0x1234u);
+   EXPECT_EQ (net->fsu_nonvolatile.nbr_marks, 2);
+   mock_os_data.bg_job_start_count[PF_BGJOB_SAVE_FSU_NVM_DATA] = 0;
+
+   ASSERT_EQ (
+      pnet_plug_module (net, TEST_API_IDENT, 1, TEST_MOD_8_0_IDENT),
+      0);
+   ASSERT_EQ (
+      pnet_plug_submodule (
+         net,
+         TEST_API_IDENT,
+         1,
+         1,
+         TEST_MOD_8_0_IDENT,
+         TEST_SUBMOD_CUSTOM_IDENT,
+         PNET_DIR_INPUT,
+         1,
+         0),
+      0);
+   ASSERT_EQ (
+      pnet_plug_submodule (
+         net,
+         TEST_API_IDENT,
+         1,
+         2,
+         TEST_MOD_8_0_IDENT,
+         TEST_SUBMOD_CUSTOM_IDENT + 1,
+         PNET_DIR_INPUT,
+         1,
+         0),
+      0);
+   ASSERT_EQ (
+      pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 1, &p_subslot),
+      0);
+   ASSERT_EQ (
+      pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 2, &p_subslot_2),
+      0);
+   EXPECT_TRUE (p_subslot->fsu_parameterized);
+   EXPECT_FALSE (p_subslot_2->fsu_parameterized);
+   EXPECT_EQ (net->fsu_nonvolatile.nbr_marks, 1);
+   EXPECT_EQ (net->fsu_nonvolatile.marks[0].subslot_nbr, 1);
+   EXPECT_EQ (
+      mock_os_data.bg_job_start_count[PF_BGJOB_SAVE_FSU_NVM_DATA],
+      1);
+
+   /* Only the unchanged submodule skips its parameters */
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   EXPECT_TRUE (ar.fast_startup_data.parameters_unchanged);
+   EXPECT_TRUE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   write_request.subslot_number = 2;
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot_2, &write_request));
+
+   /* Reset of application parameters also removes the file */
+   pf_fsu_save (net);
+   pf_fsu_reset (net);
+   pf_fsu_init (net);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0u);
+   EXPECT_EQ (net->fsu_nonvolatile.nbr_marks, 0);
+}
+
+TEST_F (FsuTest, FsuChangedSubmoduleTest)
+{
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_TRUE (p_subslot->fsu_parameterized);
+
+   /* A replaced submodule needs parameters */
+   p_subslot->owner = NULL;
+   (void)pnet_pull_submodule (net, TEST_API_IDENT, 1, 1);
+   ASSERT_EQ (
+      pnet_plug_submodule (
+         net,
+         TEST_API_IDENT,
+         1,
+         1,
+         TEST_MOD_8_0_IDENT,
+         TEST_SUBMOD_CUSTOM_IDENT,
+         PNET_DIR_INPUT,
+         1,
+         0),
+      0);
+   ASSERT_EQ (
+      pf_cmdev_get_subslot_full (net, TEST_API_IDENT, 1, 1, &p_subslot),
+      0);
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x1234);
+   EXPECT_TRUE (ar.fast_startup_data.parameters_unchanged);
+   EXPECT_FALSE (pf_fsu_skip_write (net, &ar, p_subslot, &write_request));
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_TRUE (p_subslot->fsu_parameterized);
+
+   /* New parameter set */
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x5678);
+   EXPECT_FALSE (ar.fast_startup_data.parameters_unchanged);
+   pf_fsu_cmdev_state_ind (net, &ar, PNET_EVENT_DATA);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0x5678u);
+
+   /* Reset of application parameters */
+   pf_fsu_reset (net);
+   EXPECT_FALSE (p_subslot->fsu_parameterized);
+   EXPECT_EQ (net->fsu_nonvolatile.fs_parameter_uuid.data1, 0u);
+   start_ar (PF_FS_PARAMETER_MODE_ON, 0x5678);
+   EXPECT_FALSE (ar.fast_startup_data.parameters_unchanged);
+}
+
+#endif
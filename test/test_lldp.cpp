@@ -26,6 +26,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 #define LOCAL_PORT 1
 
 #define MAX_ETH_FRAME_SIZE   1514u
@@ -1152,3 +1155,156 @@ TEST_F (LldpTest, LldpConstructFrame)
 
    EXPECT_EQ (size, returned_size);
 }
+
+TEST_F (LldpTest, LldpTxFrameCache)
+{
+   uint8_t frame[MAX_ETH_FRAME_SIZE];
+   size_t size;
+   const pf_port_t * p_port_data = pf_port_get_state (net, LOCAL_PORT);
+
+   /* The frame was built when sending at init */
+   EXPECT_TRUE (p_port_data->lldp.p_tx_buffer != NULL);
+   EXPECT_TRUE (p_port_data->lldp.is_tx_frame_valid);
+
+   /* Station name or IP address changed */
+   pf_lldp_invalidate_tx_frames (net);
+   EXPECT_FALSE (p_port_data->lldp.is_tx_frame_valid);
+
+   mock_clear();
+   pf_lldp_send_enable (net, LOCAL_PORT);
+   EXPECT_EQ (mock_os_data.eth_send_count, 1);
+   EXPECT_TRUE (p_port_data->lldp.is_tx_frame_valid);
+   size = pf_lldp_construct_frame (net, LOCAL_PORT, frame);
+   EXPECT_EQ (mock_os_data.eth_send_len, size);
+   EXPECT_EQ (memcmp (mock_os_data.eth_send_copy, frame, size), 0);
+
+   /* A changed link status is detected at next periodic transmission */
+   mock_os_data.eth_status[LOCAL_PORT].operational_mau_type =
+      PNAL_ETH_MAU_COPPER_100BaseTX_HALF_DUPLEX;
+   pf_pdport_update_eth_status (net);
+   run_stack ((PF_LLDP_SEND_INTERVAL + 100) * 1000);
+   EXPECT_GT (mock_os_data.eth_send_count, 1);
+   EXPECT_TRUE (p_port_data->lldp.is_tx_frame_valid);
+   EXPECT_EQ (
+      p_port_data->lldp.tx_link_status.operational_mau_type,
+      PNAL_ETH_MAU_COPPER_100BaseTX_HALF_DUPLEX);
+}
+
+TEST_F (LldpTest, LldpTxBufferFreedWhenDisabled)
+{
+   const pf_port_t * p_port_data = pf_port_get_state (net, LOCAL_PORT);
+
+   EXPECT_TRUE (p_port_data->lldp.p_tx_buffer != NULL);
+
+   pf_lldp_send_disable (net, LOCAL_PORT);
+   EXPECT_TRUE (p_port_data->lldp.p_tx_buffer == NULL);
+   EXPECT_FALSE (p_port_data->lldp.is_tx_frame_valid);
+
+   /* The buffer is allocated again when sending */
+   mock_clear();
+   pf_lldp_send_enable (net, LOCAL_PORT);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, 1);
+   EXPECT_EQ (mock_os_data.eth_send_count, 1);
+   EXPECT_TRUE (p_port_data->lldp.p_tx_buffer != NULL);
+
+   pf_lldp_exit (net);
+   EXPECT_TRUE (p_port_data->lldp.p_tx_buffer == NULL);
+}
+
+TEST_F (LldpTest, LldpRecvUnchangedFrame)
+{
+   uint8_t packet[MAX_ETH_PAYLOAD_SIZE];
+   size_t size;
+   pnal_buf_t * p_buf;
+   pf_lldp_peer_info_t peer = fake_peer_info();
+   pf_port_t * p_port_data = pf_port_get_state (net, LOCAL_PORT);
+
+   size = construct_packet (packet, &peer);
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, packet, size);
+   p_buf->len = size;
+   EXPECT_EQ (pf_lldp_recv (net, LOCAL_PORT, p_buf, 0), 1);
+   EXPECT_TRUE (p_port_data->lldp.is_peer_info_received);
+   EXPECT_TRUE (p_port_data->lldp.is_rx_frame_valid);
+   EXPECT_EQ (p_port_data->lldp.peer_info.ttl, peer.ttl);
+
+   /* Identical frame is not decoded. Verify by tampering with stored data */
+   p_port_data->lldp.peer_info.port_description.is_valid = false;
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, packet, size);
+   p_buf->len = size;
+   EXPECT_EQ (pf_lldp_recv (net, LOCAL_PORT, p_buf, 0), 1);
+   EXPECT_FALSE (p_port_data->lldp.peer_info.port_description.is_valid);
+
+   /* Frame with matching length but different content is decoded */
+   p_port_data->lldp.rx_frame[0] ^= 0xff;
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, packet, size);
+   p_buf->len = size;
+   EXPECT_EQ (pf_lldp_recv (net, LOCAL_PORT, p_buf, 0), 1);
+   EXPECT_TRUE (p_port_data->lldp.peer_info.port_description.is_valid);
+   EXPECT_EQ (p_port_data->lldp.rx_frame[0], packet[0]);
+
+   /* Changed frame is decoded */
+   p_port_data->lldp.peer_info.port_description.is_valid = false;
+   peer.ttl = peer.ttl + 1;
+   size = construct_packet (packet, &peer);
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, packet, size);
+   p_buf->len = size;
+   EXPECT_EQ (pf_lldp_recv (net, LOCAL_PORT, p_buf, 0), 1);
+   EXPECT_EQ (p_port_data->lldp.peer_info.ttl, peer.ttl);
+   EXPECT_TRUE (p_port_data->lldp.peer_info.port_description.is_valid);
+
+   /* Same frame is decoded again after peer info has been invalidated */
+   pf_lldp_invalidate_peer_info (net, LOCAL_PORT);
+   EXPECT_FALSE (p_port_data->lldp.is_rx_frame_valid);
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   memcpy (p_buf->payload, packet, size);
+   p_buf->len = size;
+   EXPECT_EQ (pf_lldp_recv (net, LOCAL_PORT, p_buf, 0), 1);
+   EXPECT_TRUE (p_port_data->lldp.is_peer_info_received);
+   EXPECT_EQ (p_port_data->lldp.peer_info.ttl, peer.ttl);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (LldpTest, DISABLED_LldpRecvBenchmark)
+{
+   const uint32_t nbr_frames = 10000;
+   uint8_t packet[MAX_ETH_PAYLOAD_SIZE];
+   size_t size;
+   pnal_buf_t * p_buf;
+   pf_lldp_peer_info_t peer = fake_peer_info();
+   pf_port_t * p_port_data = pf_port_get_state (net, LOCAL_PORT);
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration[2];
+   uint32_t ix;
+   uint16_t unchanged;
+
+   size = construct_packet (packet, &peer);
+   for (unchanged = 0; unchanged < 2; unchanged++)
+   {
+      duration[unchanged] = std::chrono::nanoseconds (0);
+      for (ix = 0; ix < nbr_frames; ix++)
+      {
+         if (unchanged == 0)
+         {
+            p_port_data->lldp.is_rx_frame_valid = false;
+         }
+
+         p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+         memcpy (p_buf->payload, packet, size);
+         p_buf->len = size;
+         start = std::chrono::steady_clock::now();
+         (void)pf_lldp_recv (net, LOCAL_PORT, p_buf, 0);
+         duration[unchanged] += std::chrono::steady_clock::now() - start;
+      }
+   }
+   EXPECT_TRUE (p_port_data->lldp.is_peer_info_received);
+
+   std::cout << "LLDP receive on one port: "
+             << nbr_frames * 1000000000ULL / duration[0].count()
+             << " frames/s decoding every frame, "
+             << nbr_frames * 1000000000ULL / duration[1].count()
+             << " frames/s skipping unchanged frames\n";
+}
@@ -32,10 +32,30 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 class PnetapiTest : public PnetIntegrationTest
 {
 };
 
+class PnetapiDeferredInitTest : public PnetIntegrationTestBase
+{
+ protected:
+   virtual void SetUp() override
+   {
+      mock_init();
+      cfg_init();
+      appdata_init();
+      available_modules_and_submodules_init();
+
+      callcounter_reset();
+
+      pnet_default_cfg.defer_noncritical_init = true;
+      pnet_init_only (net, &pnet_default_cfg);
+   };
+};
+
 // clang-format off
 
 static uint8_t connect_req[] =
@@ -161,6 +181,56 @@ static uint8_t data_packet4_good_iops_good_iocs[] =
 
 // clang-format on
 
+/**
+ * Simulate a high priority alarm ACK from the IO-controller.
+ *
+ * It also acknowledges the alarm frame on transport level.
+ *
+ * @param net              InOut: The p-net stack instance
+ * @param p_apmx           In:    The high priority APMX of the AR.
+ */
+static void send_high_prio_alarm_ack (pnet_t * net, const pf_apmx_t * p_apmx)
+{
+   uint8_t alarm_ack[40];
+   uint16_t len = 0;
+   pnal_buf_t * p_buf;
+   int ret;
+
+   memcpy (alarm_ack, data_packet4_good_iops_good_iocs, 12); /* MAC addr */
+   len = 12;
+   alarm_ack[len++] = 0x88; /* Ethertype */
+   alarm_ack[len++] = 0x92;
+   alarm_ack[len++] = 0xfc; /* Frame ID, high prio alarm */
+   alarm_ack[len++] = 0x01;
+   alarm_ack[len++] = p_apmx->src_ref >> 8; /* AlarmDstEndpoint */
+   alarm_ack[len++] = p_apmx->src_ref & 0xff;
+   alarm_ack[len++] = p_apmx->dst_ref >> 8; /* AlarmSrcEndpoint */
+   alarm_ack[len++] = p_apmx->dst_ref & 0xff;
+   alarm_ack[len++] = 0x11; /* Version 1, PDU type DATA */
+   alarm_ack[len++] = 0x11; /* TACK, window size 1 */
+   alarm_ack[len++] = p_apmx->exp_seq_count >> 8; /* SendSeqNum */
+   alarm_ack[len++] = p_apmx->exp_seq_count & 0xff;
+   alarm_ack[len++] = p_apmx->send_seq_count >> 8; /* AckSeqNum */
+   alarm_ack[len++] = p_apmx->send_seq_count & 0xff;
+   alarm_ack[len++] = 0x00; /* VarPartLen */
+   alarm_ack[len++] = 0x0a;
+   alarm_ack[len++] = PF_BT_ALARM_ACK_HIGH >> 8;
+   alarm_ack[len++] = PF_BT_ALARM_ACK_HIGH & 0xff;
+   alarm_ack[len++] = 0x00; /* Block length */
+   alarm_ack[len++] = 0x06;
+   alarm_ack[len++] = 0x01; /* Block version */
+   alarm_ack[len++] = 0x00;
+   memset (&alarm_ack[len], 0, 4); /* PNIO status */
+   len += 4;
+
+   p_buf = pnal_buf_alloc (PF_FRAME_BUFFER_SIZE);
+   ASSERT_TRUE (p_buf != NULL);
+   memcpy (p_buf->payload, alarm_ack, len);
+   p_buf->len = len;
+   ret = pf_eth_recv (mock_os_data.eth_if_handle, net, p_buf);
+   EXPECT_EQ (ret, 1);
+}
+
 TEST_F (PnetapiTest, PnetapiRunTest)
 {
    int ret;
@@ -409,6 +479,300 @@ TEST_F (PnetapiTest, PnetapiRunTest)
    EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
 }
 
+TEST_F (PnetapiTest, PnetapiNoHeapAllocationDuringCyclicData)
+{
+   pnet_alarm_statistics_t statistics;
+   pf_ar_t * p_ar = NULL;
+   const uint8_t payload[] = {0x01, 0x02};
+   uint16_t buf_alloc_count;
+   uint32_t fallback_allocations;
+   int ret;
+   uint32_t ix;
+
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (write_req, sizeof (write_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (prm_end_req, sizeof (prm_end_req));
+   run_stack (TEST_UDP_DELAY);
+   ret = pnet_application_ready (net, appdata.main_arep);
+   EXPECT_EQ (ret, 0);
+   mock_set_pnal_udp_recvfrom_buffer (appl_rdy_rsp, sizeof (appl_rdy_rsp));
+   run_stack (TEST_UDP_DELAY);
+
+   for (ix = 0; ix < 100; ix++)
+   {
+      send_data (
+         data_packet4_good_iops_good_iocs,
+         sizeof (data_packet4_good_iops_good_iocs));
+      run_stack (TEST_DATA_DELAY);
+   }
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+   ASSERT_EQ (pf_ar_find_by_arep (net, appdata.main_arep, &p_ar), 0);
+
+   /* Steady state, including periodic LLDP frames and alarms. Alarm
+    * frames and their transport ACKs use buffers from the frame pool. */
+   buf_alloc_count = mock_os_data.buf_alloc_count;
+   fallback_allocations = net->frame_pool.fallback_allocations;
+   for (ix = 0; ix < 10000; ix++)
+   {
+      if (ix % 1000 == 0)
+      {
+         ret = pnet_alarm_send_process_alarm (
+            net,
+            appdata.main_arep,
+            TEST_API_IDENT,
+            1,
+            1,
+            0x0010,
+            sizeof (payload),
+            payload);
+         EXPECT_EQ (ret, 0);
+      }
+      else if (ix % 1000 == 10)
+      {
+         send_high_prio_alarm_ack (net, &p_ar->apmx[1]);
+      }
+
+      send_data (
+         data_packet4_good_iops_good_iocs,
+         sizeof (data_packet4_good_iops_good_iocs));
+      run_stack (TEST_DATA_DELAY);
+   }
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+   ret = pnet_get_alarm_statistics (net, appdata.main_arep, &statistics);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (statistics.high_prio.sent, 10u);
+   EXPECT_EQ (statistics.high_prio.acknowledged, 10u);
+   EXPECT_EQ (mock_os_data.buf_alloc_count, buf_alloc_count);
+   EXPECT_EQ (net->frame_pool.fallback_allocations, fallback_allocations);
+
+   mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+}
+
+TEST_F (PnetapiTest, PnetapiAlarmStatistics)
+{
+   pnet_alarm_statistics_t statistics;
+   pf_ar_t * p_ar = NULL;
+   pf_apmx_t * p_apmx;
+   const uint8_t payload[] = {0x01, 0x02};
+   int ret;
+   uint32_t ix;
+
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (write_req, sizeof (write_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (prm_end_req, sizeof (prm_end_req));
+   run_stack (TEST_UDP_DELAY);
+   ret = pnet_application_ready (net, appdata.main_arep);
+   EXPECT_EQ (ret, 0);
+   mock_set_pnal_udp_recvfrom_buffer (appl_rdy_rsp, sizeof (appl_rdy_rsp));
+   run_stack (TEST_UDP_DELAY);
+
+   for (ix = 0; ix < 100; ix++)
+   {
+      send_data (
+         data_packet4_good_iops_good_iocs,
+         sizeof (data_packet4_good_iops_good_iocs));
+      run_stack (TEST_DATA_DELAY);
+   }
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+   ASSERT_EQ (pf_ar_find_by_arep (net, appdata.main_arep, &p_ar), 0);
+   p_apmx = &p_ar->apmx[1]; /* Process alarms have high priority */
+
+   ret = pnet_alarm_send_process_alarm (
+      net,
+      appdata.main_arep,
+      TEST_API_IDENT,
+      1,
+      1,
+      0x0010,
+      sizeof (payload),
+      payload);
+   EXPECT_EQ (ret, 0);
+
+   /* No transport ACK from the IO-controller, so the alarm is resent */
+   memset (&statistics, 0, sizeof (statistics));
+   for (ix = 0; (ix < 1000) && (statistics.high_prio.retransmissions == 0);
+        ix++)
+   {
+      send_data (
+         data_packet4_good_iops_good_iocs,
+         sizeof (data_packet4_good_iops_good_iocs));
+      run_stack (TEST_DATA_DELAY);
+      ret = pnet_get_alarm_statistics (net, appdata.main_arep, &statistics);
+      EXPECT_EQ (ret, 0);
+   }
+   EXPECT_EQ (statistics.high_prio.queued, 1u);
+   EXPECT_EQ (statistics.high_prio.sent, 1u);
+   EXPECT_EQ (statistics.high_prio.retransmissions, 1u);
+   EXPECT_EQ (statistics.high_prio.acknowledged, 0u);
+   EXPECT_EQ (statistics.high_prio.queue_time_histogram[0], 1u);
+   EXPECT_EQ (statistics.low_prio.queued, 0u);
+
+   /* Alarm ACK from the IO-controller. It also acknowledges the alarm
+    * frame on transport level. */
+   send_high_prio_alarm_ack (net, p_apmx);
+   send_data (
+      data_packet4_good_iops_good_iocs,
+      sizeof (data_packet4_good_iops_good_iocs));
+   run_stack (TEST_DATA_DELAY);
+
+   ret = pnet_get_alarm_statistics (net, appdata.main_arep, &statistics);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (statistics.high_prio.acknowledged, 1u);
+   EXPECT_EQ (statistics.high_prio.timeouts, 0u);
+   EXPECT_EQ (statistics.high_prio.retransmission_histogram[0], 0u);
+   EXPECT_EQ (statistics.high_prio.retransmission_histogram[1], 1u);
+   EXPECT_GE (statistics.high_prio.ack_time_last_us, p_apmx->timeout_us);
+   EXPECT_EQ (
+      statistics.high_prio.ack_time_max_us,
+      statistics.high_prio.ack_time_last_us);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+
+   mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+}
+
+TEST_F (PnetapiTest, PnetapiIocrStatistics)
+{
+   pnet_ar_iocr_statistics_t statistics;
+   const pnet_iocr_statistics_t * p_output = NULL;
+   const pnet_iocr_statistics_t * p_input = NULL;
+   uint8_t bad_packet[sizeof (data_packet4_good_iops_good_iocs)];
+   uint16_t step;
+   int ret;
+   uint32_t ix;
+
+   ret = pnet_get_iocr_statistics (net, appdata.main_arep, &statistics);
+   EXPECT_EQ (ret, -1);
+
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (write_req, sizeof (write_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (prm_end_req, sizeof (prm_end_req));
+   run_stack (TEST_UDP_DELAY);
+   ret = pnet_application_ready (net, appdata.main_arep);
+   EXPECT_EQ (ret, 0);
+   mock_set_pnal_udp_recvfrom_buffer (appl_rdy_rsp, sizeof (appl_rdy_rsp));
+   run_stack (TEST_UDP_DELAY);
+
+   for (ix = 0; ix < 100; ix++)
+   {
+      send_data (
+         data_packet4_good_iops_good_iocs,
+         sizeof (data_packet4_good_iops_good_iocs));
+      run_stack (TEST_DATA_DELAY);
+   }
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+
+   ret = pnet_get_iocr_statistics (net, appdata.main_arep, &statistics);
+   EXPECT_EQ (ret, 0);
+   ASSERT_EQ (statistics.nbr_iocrs, 2);
+   for (ix = 0; ix < statistics.nbr_iocrs; ix++)
+   {
+      if (statistics.iocr[ix].provider)
+      {
+         p_input = &statistics.iocr[ix];
+      }
+      else
+      {
+         p_output = &statistics.iocr[ix];
+      }
+   }
+   ASSERT_TRUE (p_input != NULL);
+   ASSERT_TRUE (p_output != NULL);
+   EXPECT_GT (p_input->ppm.frames_sent, 0u);
+   EXPECT_EQ (p_output->cpm.frames_received, 100u);
+   EXPECT_EQ (p_output->cpm.frames_accepted, 100u);
+   EXPECT_EQ (p_output->cpm.invalid_transfer_status, 0u);
+   EXPECT_EQ (p_output->cpm.cycle_counter_gaps, 0u);
+   EXPECT_EQ (p_output->cpm.frames_missed, 0u);
+   EXPECT_GT (p_output->cpm.dht_max, 0);
+   EXPECT_LT (p_output->cpm.dht_max, p_output->cpm.data_hold_factor);
+
+   /* Invalid frames. Do not run the stack, to avoid that the data hold
+    * timer expires. */
+   memcpy (
+      bad_packet,
+      data_packet4_good_iops_good_iocs,
+      sizeof (data_packet4_good_iops_good_iocs));
+   bad_packet[sizeof (bad_packet) - 1] = 0x01; /* Transfer status */
+   send_data (bad_packet, sizeof (bad_packet));
+
+   appdata.data_cycle_ctr -= 2; /* Same as the last accepted frame */
+   send_data (
+      data_packet4_good_iops_good_iocs,
+      sizeof (data_packet4_good_iops_good_iocs));
+
+   /* Three frames missing */
+   step = p_output->control_interval_us * 32 / 1000;
+   appdata.data_cycle_ctr += step * 4 - 1;
+   send_data (
+      data_packet4_good_iops_good_iocs,
+      sizeof (data_packet4_good_iops_good_iocs));
+   run_stack (TEST_DATA_DELAY);
+
+   ret = pnet_get_iocr_statistics (net, appdata.main_arep, &statistics);
+   EXPECT_EQ (ret, 0);
+   EXPECT_EQ (p_output->cpm.frames_received, 103u);
+   EXPECT_EQ (p_output->cpm.frames_accepted, 101u);
+   EXPECT_EQ (p_output->cpm.invalid_transfer_status, 1u);
+   EXPECT_EQ (p_output->cpm.invalid_cycle_counter, 1u);
+   EXPECT_EQ (p_output->cpm.cycle_counter_gaps, 1u);
+   EXPECT_EQ (p_output->cpm.frames_missed, 3u);
+
+   mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+}
+
+/* Benchmark. Run with --gtest_also_run_disabled_tests */
+TEST_F (PnetapiTest, DISABLED_PnetapiIocrStatisticsBenchmark)
+{
+   const uint32_t rounds = 1000;
+   pnet_ar_iocr_statistics_t statistics;
+   std::chrono::steady_clock::time_point start;
+   std::chrono::nanoseconds duration;
+   uint32_t round;
+   int ret;
+
+   mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (write_req, sizeof (write_req));
+   run_stack (TEST_UDP_DELAY);
+   mock_set_pnal_udp_recvfrom_buffer (prm_end_req, sizeof (prm_end_req));
+   run_stack (TEST_UDP_DELAY);
+   ret = pnet_application_ready (net, appdata.main_arep);
+   EXPECT_EQ (ret, 0);
+   mock_set_pnal_udp_recvfrom_buffer (appl_rdy_rsp, sizeof (appl_rdy_rsp));
+   run_stack (TEST_UDP_DELAY);
+   send_data (
+      data_packet4_good_iops_good_iocs,
+      sizeof (data_packet4_good_iops_good_iocs));
+   run_stack (TEST_DATA_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_DATA);
+
+   start = std::chrono::steady_clock::now();
+   for (round = 0; round < rounds; round++)
+   {
+      ret = pnet_get_iocr_statistics (net, appdata.main_arep, &statistics);
+      EXPECT_EQ (ret, 0);
+   }
+   duration = std::chrono::steady_clock::now() - start;
+   std::cout << "IOCR statistics: average " << duration.count() / rounds
+             << " ns\n";
+
+   mock_set_pnal_udp_recvfrom_buffer (release_req, sizeof (release_req));
+   run_stack (TEST_UDP_DELAY);
+   EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
+}
+
 TEST_F (PnetapiTest, PnetapiShowTest)
 {
    mock_set_pnal_udp_recvfrom_buffer (connect_req, sizeof (connect_req));
@@ -427,3 +791,41 @@ TEST_F (PnetapiTest, PnetapiShowTest)
    EXPECT_EQ (appdata.call_counters.state_calls, 2);
    EXPECT_EQ (appdata.cmdev_state, PNET_EVENT_ABORT);
 }
+
+TEST_F (PnetapiDeferredInitTest, PnetapiDeferredInit)
+{
+   pnet_init_profile_t profile;
+   uint16_t file_load_count = mock_os_data.file_load_count;
+   int ret;
+
+   ret = pnet_get_init_profile (net, &profile);
+   EXPECT_EQ (ret, 0);
+   EXPECT_TRUE (profile.deferred);
+   EXPECT_FALSE (profile.deferred_done);
+   EXPECT_FALSE (profile.dcp_ready);
+   EXPECT_TRUE (pf_fspm_init_deferred_pending (net));
+
+   /* Port data is loaded by the first periodic call, after the scheduler
+    * has sent any DCP responses. Missing port files are saved in the
+    * background. */
+   run_stack (TEST_TICK_INTERVAL_US);
+   EXPECT_GT (mock_os_data.file_load_count, file_load_count);
+   EXPECT_EQ (mock_os_data.file_save_count, 0);
+   EXPECT_GT (
+      mock_os_data.bg_job_start_count[PF_BGJOB_SAVE_PDPORT_NVM_DATA],
+      0);
+   ret = pnet_get_init_profile (net, &profile);
+   EXPECT_EQ (ret, 0);
+   EXPECT_TRUE (profile.dcp_ready);
+   EXPECT_TRUE (profile.deferred_done);
+   EXPECT_LE (profile.dcp_ready_us, profile.deferred_done_us);
+   EXPECT_FALSE (pf_fspm_init_deferred_pending (net));
+
+   /* Only once */
+   file_load_count = mock_os_data.file_load_count;
+   run_stack (TEST_DATA_DELAY);
+   EXPECT_EQ (mock_os_data.file_load_count, file_load_count);
+
+   ret = pnet_get_init_profile (net, NULL);
+   EXPECT_EQ (ret, -1);
+}
@@ -247,3 +247,73 @@ TEST_F (PortUnitTest, PortGetNumberOfPorts)
 
    EXPECT_EQ (pf_port_get_number_of_ports (&dummystack), 4);
 }
+
+TEST_F (PortTest, PortLinkChangeIsHandledWithoutWaitingForPoll)
+{
+   const int loc_port_num = 1;
+   pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
+
+   EXPECT_FALSE (net->pf_interface.is_link_monitor_event_driven);
+
+   /* Link up */
+   mock_os_data.eth_status[loc_port_num].running = true;
+   pf_pdport_update_eth_status (net);
+   pf_pdport_periodic (net);
+   EXPECT_TRUE (p_port_data->netif.previous_is_link_up);
+   EXPECT_EQ ((uint32_t)net->pf_interface.link_change_pending, 0u);
+
+   /* No change */
+   pf_pdport_update_eth_status (net);
+   EXPECT_EQ ((uint32_t)net->pf_interface.link_change_pending, 0u);
+
+   /* Link down is handled on next periodic call */
+   mock_os_data.eth_status[loc_port_num].running = false;
+   pf_pdport_update_eth_status (net);
+   EXPECT_GT ((uint32_t)net->pf_interface.link_change_pending, 0u);
+   pf_pdport_periodic (net);
+   EXPECT_FALSE (p_port_data->netif.previous_is_link_up);
+   EXPECT_EQ ((uint32_t)net->pf_interface.link_change_pending, 0u);
+}
+
+TEST_F (PortTest, PortLinkChangeIsReportedByEvent)
+{
+   const int loc_port_num = 1;
+   pf_port_t * p_port_data = pf_port_get_state (net, loc_port_num);
+
+   pf_pdport_periodic (net);
+   EXPECT_TRUE (p_port_data->netif.previous_is_link_up);
+
+   /* Restart link monitoring with event support in pnal */
+   pf_scheduler_remove_if_running (
+      net,
+      &net->pf_interface.link_monitor_timeout);
+   mock_os_data.is_link_monitor_supported = true;
+   pf_pdport_start_linkmonitor (net);
+   EXPECT_TRUE (net->pf_interface.is_link_monitor_event_driven);
+   EXPECT_FALSE (
+      pf_scheduler_is_running (&net->pf_interface.link_monitor_timeout));
+   ASSERT_TRUE (mock_os_data.link_callback != NULL);
+   EXPECT_EQ (mock_os_data.link_callback_arg, net);
+   EXPECT_EQ (mock_os_data.bg_job_start_count[PF_BGJOB_UPDATE_PORTS_STATUS], 1);
+
+   /* Link down event starts the background job reading the status */
+   mock_os_data.eth_status[loc_port_num].running = false;
+   mock_os_data.link_callback ("eth0", mock_os_data.link_callback_arg);
+   EXPECT_EQ (mock_os_data.bg_job_start_count[PF_BGJOB_UPDATE_PORTS_STATUS], 2);
+   EXPECT_TRUE (p_port_data->netif.previous_is_link_up);
+
+   /* Status read by the background worker is handled by the stack */
+   pf_pdport_update_eth_status (net);
+   EXPECT_GT ((uint32_t)net->pf_interface.link_change_pending, 0u);
+   pf_pdport_periodic (net);
+   EXPECT_FALSE (p_port_data->netif.previous_is_link_up);
+   EXPECT_EQ ((uint32_t)net->pf_interface.link_change_pending, 0u);
+
+   /* Link up event */
+   mock_os_data.eth_status[loc_port_num].running = true;
+   mock_os_data.link_callback ("eth0", mock_os_data.link_callback_arg);
+   EXPECT_EQ (mock_os_data.bg_job_start_count[PF_BGJOB_UPDATE_PORTS_STATUS], 3);
+   pf_pdport_update_eth_status (net);
+   pf_pdport_periodic (net);
+   EXPECT_TRUE (p_port_data->netif.previous_is_link_up);
+}
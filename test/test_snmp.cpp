@@ -47,6 +47,7 @@ TEST_F (SnmpTest, SnmpGetManagementAddress)
    mock_lldp_data.management_address.value[3] = 100;
    mock_lldp_data.management_address.len = 4;
 
+   pf_snmp_publish_snapshot (net);
    pf_snmp_get_management_address (net, &address);
    EXPECT_EQ (address.subtype, 1);
    EXPECT_EQ (address.value[0], 4); /* len */
@@ -71,6 +72,7 @@ TEST_F (SnmpTest, SnmpGetPeerManagementAddress)
    mock_lldp_data.peer_management_address.len = 4;
    mock_lldp_data.error = 0;
 
+   pf_snmp_publish_snapshot (net);
    error = pf_snmp_get_peer_management_address (net, LOCAL_PORT, &address);
    EXPECT_EQ (error, 0);
    EXPECT_EQ (address.subtype, 1);
@@ -82,6 +84,7 @@ TEST_F (SnmpTest, SnmpGetPeerManagementAddress)
    EXPECT_EQ (address.len, 5u);
 
    mock_lldp_data.error = -1;
+   pf_snmp_publish_snapshot (net);
    error = pf_snmp_get_peer_management_address (net, LOCAL_PORT, &address);
    EXPECT_EQ (error, -1);
 }
@@ -102,6 +105,7 @@ TEST_F (SnmpTest, SnmpGetLinkStatus)
    mock_lldp_data.link_status.operational_mau_type =
       PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX;
 
+   pf_snmp_publish_snapshot (net);
    pf_snmp_get_link_status (net, LOCAL_PORT, &status);
    EXPECT_EQ (status.auto_neg_supported, 1); /* true */
    EXPECT_EQ (status.auto_neg_enabled, 1);   /* true */
@@ -117,6 +121,7 @@ TEST_F (SnmpTest, SnmpGetLinkStatus)
    mock_lldp_data.link_status.operational_mau_type =
       PNAL_ETH_MAU_COPPER_100BaseTX_HALF_DUPLEX;
 
+   pf_snmp_publish_snapshot (net);
    pf_snmp_get_link_status (net, LOCAL_PORT, &status);
    EXPECT_EQ (status.auto_neg_supported, 1); /* true */
    EXPECT_EQ (status.auto_neg_enabled, 2);   /* false */
@@ -139,6 +144,7 @@ TEST_F (SnmpTest, SnmpGetPeerLinkStatus)
       PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX;
    mock_lldp_data.error = 0;
 
+   pf_snmp_publish_snapshot (net);
    error = pf_snmp_get_peer_link_status (net, LOCAL_PORT, &status);
    EXPECT_EQ (error, 0);
    EXPECT_EQ (status.auto_neg_supported, 1); /* true */
@@ -156,6 +162,7 @@ TEST_F (SnmpTest, SnmpGetPeerLinkStatus)
       PNAL_ETH_MAU_COPPER_100BaseTX_HALF_DUPLEX;
    mock_lldp_data.error = 0;
 
+   pf_snmp_publish_snapshot (net);
    error = pf_snmp_get_peer_link_status (net, LOCAL_PORT, &status);
    EXPECT_EQ (error, 0);
    EXPECT_EQ (status.auto_neg_supported, 1); /* true */
@@ -165,6 +172,7 @@ TEST_F (SnmpTest, SnmpGetPeerLinkStatus)
    EXPECT_EQ (status.oper_mau_type, PNAL_ETH_MAU_COPPER_100BaseTX_HALF_DUPLEX);
 
    mock_lldp_data.error = -1;
+   pf_snmp_publish_snapshot (net);
    error = pf_snmp_get_peer_link_status (net, LOCAL_PORT, &status);
    EXPECT_EQ (error, -1);
 }
@@ -176,7 +184,12 @@ TEST_F (SnmpTest, SnmpGetLocationGivenLargeString)
    pf_snmp_system_location_t actual;
 
    memset (&actual, 0xff, sizeof (actual));
-   mock_pf_file_save (NULL, PF_FILENAME_SNMP_SYSLOCATION, &stored, sizeof (stored));
+   mock_pf_file_save (
+      net,
+      NULL,
+      PF_FILENAME_SNMP_SYSLOCATION,
+      &stored,
+      sizeof (stored));
    pf_snmp_data_init (net);
 
    pf_snmp_get_system_location (net, &actual);
@@ -191,7 +204,12 @@ TEST_F (SnmpTest, SnmpGetLocationGivenSmallString)
    pf_snmp_system_location_t actual;
 
    memset (&actual, 0xcd, sizeof (actual));
-   mock_pf_file_save (NULL, PF_FILENAME_SNMP_SYSLOCATION, &stored, sizeof (stored));
+   mock_pf_file_save (
+      net,
+      NULL,
+      PF_FILENAME_SNMP_SYSLOCATION,
+      &stored,
+      sizeof (stored));
    pf_snmp_data_init (net);
 
    pf_snmp_get_system_location (net, &actual);
@@ -261,3 +279,155 @@ TEST_F (SnmpTest, SnmpSetLocationGivenError)
    EXPECT_EQ (error, -1);
    EXPECT_STREQ (mock_fspm_data.im_location, "1234567890123456789012");
 }
+
+TEST_F (SnmpTest, SnmpSnapshotIsPublishedWhenInvalidated)
+{
+   pf_snmp_management_address_t address;
+
+   /* Handle changes done during test setup */
+   pf_snmp_periodic (net);
+
+   mock_lldp_data.management_address.subtype = 1;
+   mock_lldp_data.management_address.value[0] = 192;
+   mock_lldp_data.management_address.value[1] = 168;
+   mock_lldp_data.management_address.value[2] = 1;
+   mock_lldp_data.management_address.value[3] = 100;
+   mock_lldp_data.management_address.len = 4;
+
+   /* Changed value is not visible until published */
+   pf_snmp_periodic (net);
+   pf_snmp_get_management_address (net, &address);
+   EXPECT_EQ (address.len, 1u);
+
+   pf_snmp_invalidate_snapshot (net);
+   EXPECT_GT ((uint32_t)net->snmp_data.snapshot_outdated, 0u);
+   pf_snmp_periodic (net);
+   EXPECT_EQ ((uint32_t)net->snmp_data.snapshot_outdated, 0u);
+
+   pf_snmp_get_management_address (net, &address);
+   EXPECT_EQ (address.len, 5u);
+   EXPECT_EQ (address.value[4], 100);
+
+   /* Writes are done in pairs, so a reader sees an even number */
+   EXPECT_EQ ((uint32_t)net->snmp_data.snapshot_sequence % 2, 0u);
+}
+
+TEST_F (SnmpTest, SnmpSetSystemNameIsVisibleDirectly)
+{
+   const pf_snmp_system_name_t written = {"new_name"};
+   pf_snmp_system_name_t actual;
+   int error;
+
+   error = pf_snmp_set_system_name (net, &written);
+   EXPECT_EQ (error, 0);
+
+   memset (&actual, 0xff, sizeof (actual));
+   pf_snmp_get_system_name (net, &actual);
+   EXPECT_STREQ (actual.string, "new_name");
+}
+
+TEST_F (SnmpTest, SnmpGetLocalPortRows)
+{
+   pf_snmp_local_port_row_t rows[PNET_MAX_PHYSICAL_PORTS];
+   pf_snmp_link_status_t expected_link_status;
+   int number_of_rows;
+   int ix;
+
+   mock_lldp_data.link_status.is_autonegotiation_supported = true;
+   mock_lldp_data.link_status.is_autonegotiation_enabled = false;
+   mock_lldp_data.link_status.autonegotiation_advertised_capabilities = 0xF00F;
+   mock_lldp_data.link_status.operational_mau_type =
+      PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX;
+   pf_snmp_publish_snapshot (net);
+   pf_snmp_get_link_status (net, LOCAL_PORT, &expected_link_status);
+
+   memset (rows, 0xff, sizeof (rows));
+   number_of_rows =
+      pf_snmp_get_local_port_rows (net, 1, rows, PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, PNET_MAX_PHYSICAL_PORTS);
+   for (ix = 0; ix < number_of_rows; ix++)
+   {
+      EXPECT_EQ (rows[ix].loc_port_num, ix + 1);
+      EXPECT_EQ (
+         rows[ix].link_status.auto_neg_supported,
+         expected_link_status.auto_neg_supported);
+      EXPECT_EQ (
+         rows[ix].link_status.auto_neg_enabled,
+         expected_link_status.auto_neg_enabled);
+      EXPECT_EQ (rows[ix].link_status.auto_neg_advertised_cap[0], 0xF0);
+      EXPECT_EQ (rows[ix].link_status.auto_neg_advertised_cap[1], 0x0F);
+      EXPECT_EQ (
+         rows[ix].link_status.oper_mau_type,
+         PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX);
+   }
+
+   /* Continue a walk */
+   number_of_rows = pf_snmp_get_local_port_rows (
+      net,
+      PNET_MAX_PHYSICAL_PORTS,
+      rows,
+      PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, 1);
+   EXPECT_EQ (rows[0].loc_port_num, PNET_MAX_PHYSICAL_PORTS);
+
+   number_of_rows = pf_snmp_get_local_port_rows (
+      net,
+      PNET_MAX_PHYSICAL_PORTS + 1,
+      rows,
+      PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, 0);
+
+   /* Limited by size of buffer */
+   number_of_rows = pf_snmp_get_local_port_rows (net, 1, rows, 1);
+   EXPECT_EQ (number_of_rows, 1);
+   EXPECT_EQ (rows[0].loc_port_num, 1);
+}
+
+TEST_F (SnmpTest, SnmpGetRemoteRows)
+{
+   pf_snmp_remote_row_t rows[PNET_MAX_PHYSICAL_PORTS];
+   pf_lldp_peer_info_t peer;
+   int number_of_rows;
+
+   pf_snmp_publish_snapshot (net);
+   number_of_rows =
+      pf_snmp_get_remote_rows (net, 1, rows, PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, 0);
+
+   /* Receive info from remote device */
+   memset (&peer, 0, sizeof (peer));
+   snprintf (peer.chassis_id.string, sizeof (peer.chassis_id.string), "peer");
+   peer.chassis_id.len = strlen (peer.chassis_id.string);
+   peer.chassis_id.subtype = PF_LLDP_SUBTYPE_LOCALLY_ASSIGNED;
+   peer.chassis_id.is_valid = true;
+   mock_os_data.system_uptime_10ms = 1234;
+   pf_lldp_store_peer_info (net, LOCAL_PORT, &peer);
+
+   mock_lldp_data.peer_link_status.is_autonegotiation_supported = true;
+   mock_lldp_data.peer_link_status.operational_mau_type =
+      PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX;
+   mock_lldp_data.error = 0;
+   pf_snmp_publish_snapshot (net);
+
+   memset (rows, 0xff, sizeof (rows));
+   number_of_rows =
+      pf_snmp_get_remote_rows (net, 1, rows, PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, 1);
+   EXPECT_EQ (rows[0].loc_port_num, LOCAL_PORT);
+   EXPECT_EQ (rows[0].timestamp_10ms, 1234u);
+   EXPECT_TRUE (rows[0].chassis_id.is_valid);
+   EXPECT_STREQ (rows[0].chassis_id.string, "peer");
+   EXPECT_FALSE (rows[0].port_id.is_valid);
+   EXPECT_TRUE (rows[0].is_link_status_valid);
+   EXPECT_EQ (rows[0].link_status.auto_neg_supported, 1); /* true */
+   EXPECT_EQ (
+      rows[0].link_status.oper_mau_type,
+      PNAL_ETH_MAU_COPPER_100BaseTX_FULL_DUPLEX);
+
+   number_of_rows = pf_snmp_get_remote_rows (
+      net,
+      LOCAL_PORT + 1,
+      rows,
+      PNET_MAX_PHYSICAL_PORTS);
+   EXPECT_EQ (number_of_rows, 0);
+}
@@ -463,6 +463,9 @@ void PnetIntegrationTestBase::available_modules_and_submodules_init()
 
 void PnetIntegrationTestBase::cfg_init()
 {
+   /* Options not set below are disabled */
+   memset (&pnet_default_cfg, 0, sizeof (pnet_default_cfg));
+
    pnet_default_cfg.tick_us = TEST_TICK_INTERVAL_US;
    pnet_default_cfg.state_cb = my_state_ind;
    pnet_default_cfg.connect_cb = my_connect_ind;